@@ -0,0 +1,144 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageBufferAllocator_h
+#define __itkImageBufferAllocator_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+#include "itkThreadSupport.h"
+
+namespace itk
+{
+/** \class ImageBufferAllocator
+ * \brief Allocation policy for the pixel buffers of ImportImageContainer.
+ *
+ * By default ImportImageContainer allocates its buffer with new[]. When an
+ * ImageBufferAllocator is attached to the container, either directly with
+ * ImportImageContainer::SetBufferAllocator() or for every container created
+ * afterwards with SetGlobalDefaultAllocator(), the raw memory is obtained
+ * from Allocate() and released with Deallocate() instead. Since Image and
+ * VectorImage store their pixels in an ImportImageContainer, the policy
+ * applies to both.
+ *
+ * The default implementation returns buffers aligned to Alignment bytes
+ * (64 by default, one cache line). When UseHugePages is on, buffers of at
+ * least one huge page are aligned to the huge page size and the kernel is
+ * advised to back them with transparent huge pages. This is only
+ * available on Linux and silently ignored elsewhere.
+ *
+ * On NUMA systems a page is placed on the node of the thread that first
+ * writes it. When ParallelFirstTouch is on, the elements are therefore
+ * initialized by NumberOfThreads threads, each one writing the slabs
+ * that ImageSource::SplitRequestedRegion() will later hand to the thread
+ * with the same id. The elements are value initialized in that case, that
+ * is, scalar pixel buffers are zero filled.
+ *
+ * Subclasses may override Allocate() and Deallocate() to plug in another
+ * memory source.
+ *
+ * \sa ImportImageContainer
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferAllocator:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageBufferAllocator       Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferAllocator, Object);
+
+  /** Signature of the functions that initialize the elements
+   * [begin, end) of a raw buffer. */
+  typedef void ( *InitializeFunctionType )(void *buffer, SizeValueType begin, SizeValueType end);
+
+  /** Set/Get the allocator given to newly created ImportImageContainers.
+   * The default is NULL, in which case the containers use new[]. */
+  static void SetGlobalDefaultAllocator(Self *allocator);
+  static Pointer GetGlobalDefaultAllocator();
+
+  /** Set/Get the alignment of the buffers in bytes. It must be a power of
+   * two and a multiple of sizeof(void *). Defaults to 64. */
+  virtual void SetAlignment(SizeValueType alignment);
+  itkGetConstMacro(Alignment, SizeValueType);
+
+  /** Request transparent huge pages for large buffers. Off by default. */
+  itkSetMacro(UseHugePages, bool);
+  itkGetConstMacro(UseHugePages, bool);
+  itkBooleanMacro(UseHugePages);
+
+  /** Initialize new buffers from several threads so that their pages end
+   * up on the NUMA node of the thread that processes them. Off by
+   * default. */
+  itkSetMacro(ParallelFirstTouch, bool);
+  itkGetConstMacro(ParallelFirstTouch, bool);
+  itkBooleanMacro(ParallelFirstTouch);
+
+  /** Set/Get the number of threads used for the first touch. Defaults to
+   * MultiThreader::GetGlobalDefaultNumberOfThreads(), which is also the
+   * number of threads used by the filters. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
+  /** Size of a transparent huge page in bytes. */
+  static SizeValueType GetHugePageSize();
+
+  /** Return numberOfBytes of uninitialized memory, or NULL when the
+   * allocation fails. */
+  virtual void * Allocate(SizeValueType numberOfBytes);
+
+  /** Release a buffer returned by Allocate(). */
+  virtual void Deallocate(void *buffer, SizeValueType numberOfBytes);
+
+  /** Call function on the whole buffer, or, when ParallelFirstTouch is on,
+   * on the same contiguous pieces that ImageSource assigns to its threads.
+   * numberOfElementsPerSlice is the number of elements in one slice along
+   * the axis that is split. */
+  void InitializeBuffer(void *buffer, SizeValueType numberOfElements,
+                        SizeValueType numberOfElementsPerSlice,
+                        InitializeFunctionType function) const;
+
+protected:
+  ImageBufferAllocator();
+  ~ImageBufferAllocator();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  ImageBufferAllocator(const Self &); //purposely not implemented
+  void operator=(const Self &);       //purposely not implemented
+
+  static ITK_THREAD_RETURN_TYPE InitializeBufferThreaderCallback(void *arg);
+
+  static Pointer m_GlobalDefaultAllocator;
+
+  SizeValueType m_Alignment;
+  bool          m_UseHugePages;
+  bool          m_ParallelFirstTouch;
+  ThreadIdType  m_NumberOfThreads;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageBufferPool_h
+#define __itkImageBufferPool_h
+
+#include "itkImageBufferAllocator.h"
+#include "itkSimpleFastMutexLock.h"
+#include <map>
+#include <vector>
+
+namespace itk
+{
+/** \class ImageBufferPool
+ * \brief An ImageBufferAllocator that recycles released buffers.
+ *
+ * Buffers given back through Deallocate() are kept in size buckets and
+ * handed out again by Allocate() instead of being returned to the
+ * operating system. Pipelines that are updated repeatedly, and iterative
+ * filters that allocate intermediate images on every iteration, then
+ * reuse memory whose pages are already mapped.
+ *
+ * Requested sizes are rounded up to the bucket size: a multiple of the
+ * page size for small buffers, and a multiple of a quarter of the largest
+ * power of two below the size otherwise, so that no more than 25% is
+ * wasted.
+ *
+ * The pool keeps at most MaximumCachedBytes of released memory; buffers
+ * that do not fit are freed right away. Trim() frees cached buffers on
+ * request.
+ *
+ * A buffer goes back to the pool when the ImportImageContainer that owns
+ * it is destroyed or reallocated, which is what DataObject::ReleaseData()
+ * does for Image and VectorImage. To pool every image buffer in the
+ * process, install the pool with
+ * ImageBufferAllocator::SetGlobalDefaultAllocator(). To pool only the
+ * images of one pipeline, set it on their pixel containers with
+ * ImportImageContainer::SetBufferAllocator().
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferPool:public ImageBufferAllocator
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageBufferPool              Self;
+  typedef ImageBufferAllocator         Superclass;
+  typedef SmartPointer< Self >         Pointer;
+  typedef SmartPointer< const Self >   ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferPool, ImageBufferAllocator);
+
+  /** Set/Get the maximum number of bytes kept in the pool. Defaults to
+   * 1 GiB. Lowering it trims the pool. */
+  virtual void SetMaximumCachedBytes(SizeValueType bytes);
+  itkGetConstMacro(MaximumCachedBytes, SizeValueType);
+
+  /** Number of bytes and buffers currently kept in the pool. */
+  SizeValueType GetCachedBytes() const;
+  SizeValueType GetNumberOfCachedBuffers() const;
+
+  /** Number of allocations served from, respectively not found in, the
+   * pool. */
+  SizeValueType GetNumberOfHits() const;
+  SizeValueType GetNumberOfMisses() const;
+
+  /** Reset the hit and miss counters. */
+  void ResetStatistics();
+
+  /** Free cached buffers, largest first, until at most maximumBytes are
+   * kept. Trim() empties the pool. */
+  void Trim(SizeValueType maximumBytes = 0);
+
+  /** The size of the bucket that serves a request of numberOfBytes. */
+  static SizeValueType GetBucketSize(SizeValueType numberOfBytes);
+
+  virtual void * Allocate(SizeValueType numberOfBytes);
+
+  virtual void Deallocate(void *buffer, SizeValueType numberOfBytes);
+
+protected:
+  ImageBufferPool();
+  ~ImageBufferPool();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  ImageBufferPool(const Self &); //purposely not implemented
+  void operator=(const Self &);  //purposely not implemented
+
+  /** Must be called with m_Lock held. */
+  void TrimUnlocked(SizeValueType maximumBytes);
+
+  typedef std::map< SizeValueType, std::vector< void * > > BucketMapType;
+
+  BucketMapType m_Buckets;
+  SizeValueType m_MaximumCachedBytes;
+  SizeValueType m_CachedBytes;
+  SizeValueType m_NumberOfCachedBuffers;
+  SizeValueType m_NumberOfHits;
+  SizeValueType m_NumberOfMisses;
+
+  mutable SimpleFastMutexLock m_Lock;
+};
+} // end namespace itk
+
+#endif
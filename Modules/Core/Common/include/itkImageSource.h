@@ -30,6 +30,8 @@
 
 #include "itkProcessObject.h"
 #include "itkImage.h"
+#include "itkRealTimeClock.h"
+#include "itkSimpleFastMutexLock.h"
 
 namespace itk
 {
@@ -53,6 +55,16 @@ namespace itk
  * ProcessObject::ReleaseDataBeforeUpdateFlagOn().  A user may want to
  * set this flag to limit peak memory usage during a pipeline update.
  *
+ * By default the output requested region is split into one piece per
+ * thread. When DynamicMultiThreading is on, the region is split into
+ * NumberOfChunksPerThread pieces per thread instead, and the threads take
+ * the next unprocessed piece from a shared counter until all pieces are
+ * done. This balances filters whose cost per pixel varies across the
+ * image. ThreadedGenerateData() is then called several times per thread,
+ * always with a threadId below the number of threads; filters that
+ * assume a single call per thread should not enable this mode. The time
+ * spent on each piece is available from GetChunkInformation().
+ *
  * \ingroup DataSources
  * \ingroup ITKCommon
  *
@@ -209,9 +221,37 @@ public:
   using Superclass::MakeOutput;
   virtual ProcessObject::DataObjectPointer MakeOutput(ProcessObject::DataObjectPointerArraySizeType idx);
 
+  /** Set/Get whether the output requested region is split into many more
+   * pieces than there are threads and the pieces are handed out to the
+   * threads dynamically. Off by default. */
+  itkSetMacro(DynamicMultiThreading, bool);
+  itkGetConstMacro(DynamicMultiThreading, bool);
+  itkBooleanMacro(DynamicMultiThreading);
+
+  /** Set/Get the number of pieces per thread the output requested region
+   * is split into when DynamicMultiThreading is on. */
+  itkSetClampMacro(NumberOfChunksPerThread, unsigned int, 1, NumericTraits< unsigned int >::max());
+  itkGetConstMacro(NumberOfChunksPerThread, unsigned int);
+
+  /** Region, executing thread and elapsed wall time of one piece of the
+   * output requested region processed with DynamicMultiThreading on. */
+  struct ChunkInformation {
+    OutputImageRegionType         Region;
+    ThreadIdType                  ThreadId;
+    RealTimeClock::TimeStampType  ElapsedTime;
+  };
+  typedef std::vector< ChunkInformation > ChunkInformationContainerType;
+
+  /** Get the pieces processed by the last execution with
+   * DynamicMultiThreading on, in the order returned by
+   * SplitRequestedRegion(). Useful to tune NumberOfChunksPerThread. */
+  const ChunkInformationContainerType & GetChunkInformation() const
+  { return m_ChunkInformation; }
+
 protected:
   ImageSource();
   virtual ~ImageSource() {}
+  void PrintSelf(std::ostream & os, Indent indent) const;
 
   /** A version of GenerateData() specific for image processing
    * filters.  This implementation will split the processing across
@@ -305,9 +345,30 @@ protected:
   struct ThreadStruct {
     Pointer Filter;
   };
+
+  /** Static function used as a "callback" by the MultiThreader when
+   * DynamicMultiThreading is on. Each thread repeatedly takes the next
+   * piece of the output requested region and calls ThreadedGenerateData()
+   * on it. */
+  static ITK_THREAD_RETURN_TYPE DynamicThreaderCallback(void *arg);
+
+  /** Internal structure shared by the threads when DynamicMultiThreading
+   * is on. */
+  struct DynamicThreadStruct {
+    Pointer                 Filter;
+    unsigned int            NumberOfRequestedChunks;
+    unsigned int            NumberOfChunks;
+    unsigned int            NextChunk;
+    SimpleFastMutexLock     ChunkLock;
+    RealTimeClock::Pointer  Clock;
+  };
 private:
   ImageSource(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
+
+  bool                          m_DynamicMultiThreading;
+  unsigned int                  m_NumberOfChunksPerThread;
+  ChunkInformationContainerType m_ChunkInformation;
 };
 } // end namespace itk
 
@@ -30,6 +30,7 @@
 #include "itkImageSource.h"
 
 #include "itkOutputDataObjectIterator.h"
+#include "itkPipelineProfiler.h"
 
 #include "vnl/vnl_math.h"
 
@@ -53,6 +54,9 @@ ImageSource< TOutputImage >
   // output bulk data prior to GenerateData() in case that bulk data
   // can be reused (an thus avoid a costly deallocate/allocate cycle).
   this->ReleaseDataBeforeUpdateFlagOff();
+
+  m_DynamicMultiThreading = false;
+  m_NumberOfChunksPerThread = 8;
 }
 
 /**
@@ -265,14 +269,53 @@ ImageSource< TOutputImage >
   this->BeforeThreadedGenerateData();
 
   // Set up the multithreaded processing
-  ThreadStruct str;
-  str.Filter = this;
-
   this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
-  this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
 
-  // multithread the execution
-  this->GetMultiThreader()->SingleMethodExecute();
+  PipelineProfiler *profiler = 0;
+  if ( PipelineProfiler::GetEnabled() )
+    {
+    profiler = PipelineProfiler::GetInstance();
+    profiler->StartThreadedSection( this, this->GetMultiThreader()->GetNumberOfThreads() );
+    }
+
+  if ( m_DynamicMultiThreading )
+    {
+    DynamicThreadStruct str;
+    str.Filter = this;
+    str.NumberOfRequestedChunks =
+      this->GetMultiThreader()->GetNumberOfThreads() * m_NumberOfChunksPerThread;
+    str.NextChunk = 0;
+    str.Clock = RealTimeClock::New();
+
+    // find out how many pieces the requested region can be split into
+    OutputImageRegionType splitRegion;
+    str.NumberOfChunks = this->SplitRequestedRegion(0, str.NumberOfRequestedChunks, splitRegion);
+
+    ChunkInformation unprocessed;
+    unprocessed.ThreadId = 0;
+    unprocessed.ElapsedTime = 0.0;
+    m_ChunkInformation.assign(str.NumberOfChunks, unprocessed);
+
+    this->GetMultiThreader()->SetSingleMethod(this->DynamicThreaderCallback, &str);
+
+    // multithread the execution
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+  else
+    {
+    ThreadStruct str;
+    str.Filter = this;
+
+    this->GetMultiThreader()->SetSingleMethod(this->ThreaderCallback, &str);
+
+    // multithread the execution
+    this->GetMultiThreader()->SingleMethodExecute();
+    }
+
+  if ( profiler )
+    {
+    profiler->StopThreadedSection(this);
+    }
 
   // Call a method that can be overridden by a subclass to perform
   // some calculations after all the threads have completed
@@ -325,7 +368,17 @@ ImageSource< TOutputImage >
 
   if ( threadId < total )
     {
-    str->Filter->ThreadedGenerateData(splitRegion, threadId);
+    if ( PipelineProfiler::GetEnabled() )
+      {
+      PipelineProfiler::Pointer profiler = PipelineProfiler::GetInstance();
+      const PipelineProfiler::TimeStampType start = profiler->GetTime();
+      str->Filter->ThreadedGenerateData(splitRegion, threadId);
+      profiler->RecordThreadBusyTime(str->Filter, threadId, start, profiler->GetTime());
+      }
+    else
+      {
+      str->Filter->ThreadedGenerateData(splitRegion, threadId);
+      }
     }
   // else
   //   {
@@ -336,6 +389,67 @@ ImageSource< TOutputImage >
 
   return ITK_THREAD_RETURN_VALUE;
 }
+
+// Callback routine used by the threading library when
+// DynamicMultiThreading is on. Each thread processes pieces of the
+// requested region until there are none left.
+template< class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSource< TOutputImage >
+::DynamicThreaderCallback(void *arg)
+{
+  ThreadIdType threadId = ( (MultiThreader::ThreadInfoStruct *)( arg ) )->ThreadID;
+
+  DynamicThreadStruct *str =
+    (DynamicThreadStruct *)( ( (MultiThreader::ThreadInfoStruct *)( arg ) )->UserData );
+
+  typename TOutputImage::RegionType splitRegion;
+  while ( true )
+    {
+    str->ChunkLock.Lock();
+    const unsigned int chunk = str->NextChunk++;
+    str->ChunkLock.Unlock();
+
+    if ( chunk >= str->NumberOfChunks )
+      {
+      break;
+      }
+
+    str->Filter->SplitRequestedRegion(chunk, str->NumberOfRequestedChunks, splitRegion);
+
+    const RealTimeClock::TimeStampType start = str->Clock->GetTimeInSeconds();
+    str->Filter->ThreadedGenerateData(splitRegion, threadId);
+
+    // each piece is processed by exactly one thread, so no locking is
+    // needed to record its timing
+    ChunkInformation & info = str->Filter->m_ChunkInformation[chunk];
+    info.Region = splitRegion;
+    info.ThreadId = threadId;
+    info.ElapsedTime = str->Clock->GetTimeInSeconds() - start;
+
+    if ( PipelineProfiler::GetEnabled() )
+      {
+      PipelineProfiler::Pointer profiler = PipelineProfiler::GetInstance();
+      const PipelineProfiler::TimeStampType stop = profiler->GetTime();
+      profiler->RecordThreadBusyTime(str->Filter, threadId, stop - info.ElapsedTime, stop);
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TOutputImage >
+void
+ImageSource< TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "DynamicMultiThreading: "
+     << ( m_DynamicMultiThreading ? "On" : "Off" ) << std::endl;
+  os << indent << "NumberOfChunksPerThread: " << m_NumberOfChunksPerThread << std::endl;
+  os << indent << "Number of chunks in last execution: " << m_ChunkInformation.size() << std::endl;
+}
 } // end namespace itk
 
 #endif
@@ -20,6 +20,7 @@
 
 #include "itkObject.h"
 #include "itkObjectFactory.h"
+#include "itkImageBufferAllocator.h"
 #include <utility>
 
 namespace itk
@@ -36,6 +37,10 @@ namespace itk
  *
  * \tparam TElement The element type stored in the container.
  *
+ * The memory allocated by the container itself comes from new[], unless
+ * an ImageBufferAllocator has been set with SetBufferAllocator() or
+ * ImageBufferAllocator::SetGlobalDefaultAllocator().
+ *
  * \ingroup ImageObjects
  * \ingroup IOFilters
  * \ingroup ITKCommon
@@ -131,6 +136,23 @@ public:
   itkSetMacro(ContainerManageMemory, bool);
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
+
+  /** Set/Get the policy used to allocate the buffer. When NULL, the buffer
+   * is allocated with new[]. Defaults to
+   * ImageBufferAllocator::GetGlobalDefaultAllocator(). Changing the
+   * allocator does not affect the current buffer. A buffer obtained from
+   * an allocator and released from the container's management with
+   * ContainerManageMemoryOff() must be freed with
+   * ImageBufferAllocator::Deallocate() instead of delete[]. */
+  itkSetObjectMacro(BufferAllocator, ImageBufferAllocator);
+  itkGetObjectMacro(BufferAllocator, ImageBufferAllocator);
+
+  /** Set/Get the number of contiguous elements in one slice along the
+   * axis that ImageSource splits between threads. The buffer allocator
+   * uses it to initialize the buffer in the same pieces. Image and
+   * VectorImage set it in Allocate(). */
+  itkSetMacro(NumberOfElementsPerSlice, TElementIdentifier);
+  itkGetConstMacro(NumberOfElementsPerSlice, TElementIdentifier);
 protected:
   ImportImageContainer();
   virtual ~ImportImageContainer();
@@ -169,10 +191,22 @@ private:
   ImportImageContainer(const Self &); //purposely not implemented
   void operator=(const Self &);       //purposely not implemented
 
+  /** Construct or destroy the elements [begin, end) of a raw buffer. */
+  static void DefaultConstructElements(void *buffer, SizeValueType begin, SizeValueType end);
+  static void ValueConstructElements(void *buffer, SizeValueType begin, SizeValueType end);
+  static void DestroyElements(TElement *buffer, SizeValueType size);
+
   TElement *         m_ImportPointer;
   TElementIdentifier m_Size;
   TElementIdentifier m_Capacity;
   bool               m_ContainerManageMemory;
+  TElementIdentifier m_NumberOfElementsPerSlice;
+
+  ImageBufferAllocator::Pointer m_BufferAllocator;
+
+  /** The allocator m_ImportPointer was obtained from, NULL when it was
+   * allocated with new[] or imported. */
+  ImageBufferAllocator::Pointer m_ImportPointerAllocator;
 };
 } // end namespace itk
 
@@ -29,7 +29,9 @@
 #define __itkImportImageContainer_hxx
 
 #include "itkImportImageContainer.h"
+#include "itkPipelineProfiler.h"
 #include <cstring>
+#include <new>
 #include <stdlib.h>
 #include <string.h>
 
@@ -43,6 +45,8 @@ ImportImageContainer< TElementIdentifier, TElement >
   m_ContainerManageMemory = true;
   m_Capacity = 0;
   m_Size = 0;
+  m_NumberOfElementsPerSlice = 1;
+  m_BufferAllocator = ImageBufferAllocator::GetGlobalDefaultAllocator();
 }
 
 template< typename TElementIdentifier, typename TElement >
@@ -75,6 +79,7 @@ ImportImageContainer< TElementIdentifier, TElement >
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_ImportPointerAllocator = m_BufferAllocator;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -89,6 +94,7 @@ ImportImageContainer< TElementIdentifier, TElement >
   else
     {
     m_ImportPointer = this->AllocateElements(size);
+    m_ImportPointerAllocator = m_BufferAllocator;
     m_Capacity = size;
     m_Size = size;
     m_ContainerManageMemory = true;
@@ -116,6 +122,7 @@ ImportImageContainer< TElementIdentifier, TElement >
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_ImportPointerAllocator = m_BufferAllocator;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -176,13 +183,34 @@ TElement *ImportImageContainer< TElementIdentifier, TElement >
   // does not do this by default.
   TElement *data;
 
-  try
+  if ( m_BufferAllocator )
     {
-    data = new TElement[size];
+    data = static_cast< TElement * >( m_BufferAllocator->Allocate( size * sizeof( TElement ) ) );
+    if ( data )
+      {
+      // Value initialization is what makes the first touch write the
+      // pages from the threads that will process them.
+      if ( m_BufferAllocator->GetParallelFirstTouch() )
+        {
+        m_BufferAllocator->InitializeBuffer(data, size, m_NumberOfElementsPerSlice,
+                                            &Self::ValueConstructElements);
+        }
+      else
+        {
+        DefaultConstructElements(data, 0, size);
+        }
+      }
     }
-  catch ( ... )
+  else
     {
-    data = 0;
+    try
+      {
+      data = new TElement[size];
+      }
+    catch ( ... )
+      {
+      data = 0;
+      }
     }
   if ( !data )
     {
@@ -192,6 +220,10 @@ TElement *ImportImageContainer< TElementIdentifier, TElement >
                                 "Failed to allocate memory for image.",
                                 ITK_LOCATION);
     }
+  if ( PipelineProfiler::GetEnabled() )
+    {
+    PipelineProfiler::GetInstance()->RecordAllocation( size * sizeof( TElement ) );
+    }
   return data;
 }
 
@@ -202,9 +234,18 @@ void ImportImageContainer< TElementIdentifier, TElement >
   // Encapsulate all image memory deallocation here
   if ( m_ImportPointer && m_ContainerManageMemory )
     {
-    delete[] m_ImportPointer;
+    if ( m_ImportPointerAllocator )
+      {
+      DestroyElements(m_ImportPointer, m_Capacity);
+      m_ImportPointerAllocator->Deallocate( m_ImportPointer, m_Capacity * sizeof( TElement ) );
+      }
+    else
+      {
+      delete[] m_ImportPointer;
+      }
     }
   m_ImportPointer = 0;
+  m_ImportPointerAllocator = 0;
   m_Capacity = 0;
   m_Size = 0;
 }
@@ -221,6 +262,43 @@ ImportImageContainer< TElementIdentifier, TElement >
      << ( m_ContainerManageMemory ? "true" : "false" ) << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  os << indent << "NumberOfElementsPerSlice: " << m_NumberOfElementsPerSlice << std::endl;
+  os << indent << "BufferAllocator: " << m_BufferAllocator.GetPointer() << std::endl;
+}
+
+template< typename TElementIdentifier, typename TElement >
+void
+ImportImageContainer< TElementIdentifier, TElement >
+::DefaultConstructElements(void *buffer, SizeValueType begin, SizeValueType end)
+{
+  TElement *elements = static_cast< TElement * >( buffer );
+  for ( SizeValueType i = begin; i < end; ++i )
+    {
+    new( elements + i ) TElement;
+    }
+}
+
+template< typename TElementIdentifier, typename TElement >
+void
+ImportImageContainer< TElementIdentifier, TElement >
+::ValueConstructElements(void *buffer, SizeValueType begin, SizeValueType end)
+{
+  TElement *elements = static_cast< TElement * >( buffer );
+  for ( SizeValueType i = begin; i < end; ++i )
+    {
+    new( elements + i ) TElement();
+    }
+}
+
+template< typename TElementIdentifier, typename TElement >
+void
+ImportImageContainer< TElementIdentifier, TElement >
+::DestroyElements(TElement *buffer, SizeValueType size)
+{
+  for ( SizeValueType i = 0; i < size; ++i )
+    {
+    buffer[i].~TElement();
+    }
 }
 } // end namespace itk
 
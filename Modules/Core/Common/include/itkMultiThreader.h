@@ -31,6 +31,8 @@
 #include "itkMutexLock.h"
 #include "itkThreadSupport.h"
 #include "itkIntTypes.h"
+#include "itkThreadPool.h"
+#include <vector>
 
 namespace itk
 {
@@ -47,6 +49,12 @@ namespace itk
  * If ITK_USE_PTHREADS is defined, then
  * pthread_create() will be used to create multiple threads (on
  * a sun, for example).
+ *
+ * When UseThreadPool is on, the threads are not created for each
+ * execution. Instead the methods are dispatched onto the persistent
+ * workers of the process wide ThreadPool. The ThreadInfoStruct passed to
+ * the methods is the same in both modes. The global default is taken from
+ * the ITK_USE_THREAD_POOL environment variable.
  * \ingroup ITKCommon
  */
 
@@ -73,8 +81,9 @@ public:
   itkGetConstMacro(NumberOfThreads, ThreadIdType);
 
   /** Set/Get the maximum number of threads to use when multithreading.  It
-   * will be clamped to the range [ 1, ITK_MAX_THREADS ] because several arrays
-   * are already statically allocated using the ITK_MAX_THREADS number.
+   * will be clamped to the range [ 1, ITK_MAX_THREADS ]. ITK_MAX_THREADS can
+   * be raised at configuration time; the per thread storage is allocated
+   * for the number of threads actually used.
    * Therefore the caller of this method should check that the requested number
    * of threads was accepted. */
   static void SetGlobalMaximumNumberOfThreads(ThreadIdType val);
@@ -89,6 +98,20 @@ public:
 
   static ThreadIdType  GetGlobalDefaultNumberOfThreads();
 
+  /** Set/Get whether SingleMethodExecute() and MultipleMethodExecute()
+   * dispatch onto the persistent ThreadPool instead of creating new
+   * threads. */
+  void SetUseThreadPool(bool flag);
+  itkGetConstMacro(UseThreadPool, bool);
+  itkBooleanMacro(UseThreadPool);
+
+  /** Set/Get the value which is used to initialize UseThreadPool in the
+   * constructor. If it has not been set, the ITK_USE_THREAD_POOL environment
+   * variable is checked; the default is off. */
+  static void SetGlobalDefaultUseThreadPool(bool flag);
+
+  static bool GetGlobalDefaultUseThreadPool();
+
   /** Execute the SingleMethod (as define by SetSingleMethod) using
    * m_NumberOfThreads threads. As a side effect the m_NumberOfThreads will be
    * checked against the current m_GlobalMaximumNumberOfThreads and clamped if
@@ -153,13 +176,13 @@ private:
   void operator=(const Self &); //purposely not implemented
 
   /** An array of thread info containing a thread id
-   *  (0, 1, 2, .. ITK_MAX_THREADS-1), the thread count, and a pointer
+   *  (0, 1, 2, .. m_NumberOfThreads-1), the thread count, and a pointer
    *  to void so that user data can be passed to each thread. */
-  ThreadInfoStruct m_ThreadInfoArray[ITK_MAX_THREADS];
+  std::vector< ThreadInfoStruct > m_ThreadInfoArray;
 
   /** The methods to invoke. */
-  ThreadFunctionType m_SingleMethod;
-  ThreadFunctionType m_MultipleMethod[ITK_MAX_THREADS];
+  ThreadFunctionType                m_SingleMethod;
+  std::vector< ThreadFunctionType > m_MultipleMethod;
 
   /** Storage of MutexFunctions and ints used to control spawned
    *  threads and the spawned thread ids. */
@@ -169,8 +192,8 @@ private:
   ThreadInfoStruct    m_SpawnedThreadInfoArray[ITK_MAX_THREADS];
 
   /** Internal storage of the data. */
-  void *m_SingleData;
-  void *m_MultipleData[ITK_MAX_THREADS];
+  void *                m_SingleData;
+  std::vector< void * > m_MultipleData;
 
   /** Global variable defining the maximum number of threads that can be used.
    *  The m_GlobalMaximumNumberOfThreads must always be less than or equal to
@@ -185,6 +208,10 @@ private:
    */
   static ThreadIdType m_GlobalDefaultNumberOfThreads;
 
+  /** Global variable defining the default value of m_UseThreadPool. */
+  static bool m_GlobalDefaultUseThreadPool;
+  static bool m_GlobalDefaultUseThreadPoolIsInitialized;
+
   /**  Platform specific number of threads */
   static ThreadIdType  GetGlobalDefaultNumberOfThreadsByPlatform();
 
@@ -199,6 +226,18 @@ private:
    */
   ThreadIdType m_NumberOfThreads;
 
+  /** Whether to dispatch onto the ThreadPool. The pool is referenced for
+   * the lifetime of the MultiThreader while it is in use. */
+  bool                m_UseThreadPool;
+  ThreadPool::Pointer m_ThreadPool;
+
+  /** Grow the per thread storage to hold m_NumberOfThreads entries. */
+  void AllocateThreadArrays();
+
+  /** Run the MultipleMethods with threads 1 .. m_NumberOfThreads-1 taken
+   * from the ThreadPool. Thread 0 is run by the caller. */
+  void MultipleMethodExecuteOnThreadPool();
+
   /** Static function used as a "proxy callback" by the MultiThreader.  The
    * threading library will call this routine for each thread, which
    * will delegate the control to the prescribed SingleMethod. This
@@ -0,0 +1,217 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkPipelineProfiler_h
+#define __itkPipelineProfiler_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkRealTimeClock.h"
+#include "itkSimpleFastMutexLock.h"
+#include <map>
+#include <vector>
+
+namespace itk
+{
+class ProcessObject;
+class TimeProbesCollectorBase;
+
+/** \class PipelineProfiler
+ * \brief Records where the time of a pipeline update is spent.
+ *
+ * When enabled, ProcessObject::UpdateOutputData() and
+ * ImageSource::GenerateData() report to the profiler. For every filter
+ * the profiler records, keyed by its position in the update call tree:
+ *
+ * - the wall time of UpdateOutputData(), which includes the update of the
+ *   upstream filters, and of GenerateData(), which does not;
+ * - how many times GenerateData() was executed;
+ * - the time each thread spent in ThreadedGenerateData() and the time it
+ *   waited for the other threads of the same execution;
+ * - the number of bytes allocated by the ImportImageContainers while the
+ *   filter was generating its data.
+ *
+ * Timings are aggregated with a TimeProbesCollectorBase keyed by call
+ * path. Report() prints them as a call tree and WriteChromeTrace() writes
+ * every event in the Chrome trace event format, which can be loaded in
+ * chrome://tracing.
+ *
+ * Filters updated from inside a multi-threaded section, e.g. by a
+ * mini-pipeline run in ThreadedGenerateData(), are not recorded
+ * separately; their time is part of the busy time of the thread.
+ * Likewise, only the thread that started the outermost recorded update is
+ * followed. Pipelines updated concurrently by other threads, e.g. the
+ * per-slice readers of ImageSeriesReader, are not recorded separately;
+ * their time is part of the filter that started them.
+ *
+ * Profiling is off by default. The hooks then cost a single test of a
+ * static flag.
+ *
+ * The profiler is a singleton; use GetInstance() to access it.
+ *
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT PipelineProfiler:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef PipelineProfiler           Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PipelineProfiler, Object);
+
+  /** Return the single instance of the PipelineProfiler. */
+  static Pointer GetInstance();
+
+  /** This is a singleton pattern New. There will only be ONE
+   * reference to a PipelineProfiler object per process. */
+  static Pointer New();
+
+  typedef RealTimeClock::TimeStampType TimeStampType;
+
+  /** Enable or disable the recording of pipeline events. */
+  static void SetEnabled(bool enabled);
+  static bool GetEnabled() { return m_Enabled; }
+  static void EnabledOn() { SetEnabled(true); }
+  static void EnabledOff() { SetEnabled(false); }
+
+  /** Statistics of one node of the call tree. */
+  struct NodeStatistics {
+    std::string   Name;
+    unsigned int  Depth;
+    SizeValueType NumberOfExecutions;
+    TimeStampType UpdateTime;
+    TimeStampType ThreadBusyTime;
+    TimeStampType ThreadIdleTime;
+    SizeValueType BytesAllocated;
+  };
+  typedef std::map< std::string, NodeStatistics > NodeStatisticsMapType;
+
+  /** Per call path statistics. The keys are the call paths used for the
+   * probes returned by GetGenerateDataProbes(). */
+  const NodeStatisticsMapType & GetNodeStatistics() const { return m_Nodes; }
+
+  /** Probes timing GenerateData(), keyed by call path. The number of
+   * starts is the number of executions of the filter. */
+  const TimeProbesCollectorBase & GetGenerateDataProbes() const;
+
+  /** Print the call tree. */
+  void Report(std::ostream & os = std::cout) const;
+
+  /** Write the recorded events in the Chrome trace event JSON format. */
+  void WriteChromeTrace(std::ostream & os) const;
+  void WriteChromeTrace(const std::string & fileName) const;
+
+  /** Discard everything recorded so far. */
+  void Clear();
+
+  /** Seconds since the profiler was created. */
+  TimeStampType GetTime() const;
+
+  /** Hooks called by ProcessObject::UpdateOutputData(). */
+  void StartUpdate(const ProcessObject *filter);
+  void StopUpdate(const ProcessObject *filter);
+  void StartGenerateData(const ProcessObject *filter);
+  void StopGenerateData(const ProcessObject *filter);
+
+  /** Hooks called by ImageSource around the execution of its threads and
+   * by each thread around ThreadedGenerateData(). */
+  void StartThreadedSection(const ProcessObject *filter, ThreadIdType numberOfThreads);
+  void StopThreadedSection(const ProcessObject *filter);
+  void RecordThreadBusyTime(const ProcessObject *filter, ThreadIdType threadId,
+                            TimeStampType start, TimeStampType stop);
+
+  /** Hook called by ImportImageContainer when it allocates memory. */
+  void RecordAllocation(SizeValueType numberOfBytes);
+
+protected:
+  PipelineProfiler();
+  ~PipelineProfiler();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  PipelineProfiler(const Self &); //purposely not implemented
+  void operator=(const Self &);   //purposely not implemented
+
+  /** A complete event of the trace. */
+  struct TraceEvent {
+    std::string   Name;
+    const char *  Category;
+    TimeStampType Start;
+    TimeStampType Duration;
+    ThreadIdType  Thread;
+  };
+
+  /** An UpdateOutputData() in progress. */
+  struct Frame {
+    const ProcessObject *Filter;
+    std::string          Path;
+    TimeStampType        UpdateStart;
+    TimeStampType        GenerateDataStart;
+  };
+
+  /** The multi-threaded section in progress. */
+  struct ThreadedSection {
+    const ProcessObject *        Filter;
+    std::string                  Path;
+    TimeStampType                Start;
+    std::vector< TimeStampType > BusyTime;
+  };
+
+  /** Gives access to the aggregated probes for the report. */
+  class ProbesCollector;
+
+  static std::string GetFilterName(const ProcessObject *filter);
+
+  /** Must be called with m_Lock held. */
+  void CloseThreadedSection(TimeStampType stop);
+
+  /** Identifies a thread. */
+#if defined(ITK_USE_PTHREADS)
+  typedef pthread_t ThreadIdentifierType;
+#elif defined(ITK_USE_WIN32_THREADS)
+  typedef DWORD ThreadIdentifierType;
+#else
+  typedef int ThreadIdentifierType;
+#endif
+  static ThreadIdentifierType GetCurrentThreadIdentifier();
+
+  /** Whether the calling thread started the outermost update in progress.
+   * Must be called with m_Lock held and a non-empty stack. */
+  bool IsOwnerThread() const;
+
+  static Pointer m_Instance;
+  static bool    m_Enabled;
+
+  RealTimeClock::Pointer    m_Clock;
+  TimeStampType             m_Origin;
+  ProbesCollector *         m_GenerateDataProbes;
+  NodeStatisticsMapType     m_Nodes;
+  std::vector< Frame >      m_Stack;
+  ThreadIdentifierType      m_OwnerThread;
+  ThreadedSection           m_Section;
+  bool                      m_InThreadedSection;
+  std::vector< TraceEvent > m_Events;
+
+  mutable SimpleFastMutexLock m_Lock;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,273 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkPixelwiseFunctorStage_h
+#define __itkPixelwiseFunctorStage_h
+
+#include "itkLightObject.h"
+#include "itkObjectFactory.h"
+#include "itkDataObject.h"
+#include "itkConceptChecking.h"
+#include "itkScanlineFunctorEvaluator.h"
+#include <typeinfo>
+
+namespace itk
+{
+/** \class PixelwiseFunctorStage
+ * \brief One pixel-wise operation of a fused chain of functors.
+ *
+ * A stage applies a functor to a run of pixels of a scanline. The pixel
+ * types are hidden behind void pointers so that stages of different
+ * pixel types can be chained; GetInputPixelType() and
+ * GetOutputPixelType() tell which types the pointers must point to.
+ *
+ * Binary stages take their second operand from an image, the operand
+ * image, at the index of the pixels, or from a constant.
+ *
+ * \sa FusedFunctorImageFilter
+ * \ingroup ITKCommon
+ */
+template< unsigned int VDimension >
+class PixelwiseFunctorStage:public LightObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef PixelwiseFunctorStage      Self;
+  typedef LightObject                Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PixelwiseFunctorStage, LightObject);
+
+  typedef Index< VDimension > IndexType;
+
+  /** Type of the pixels read and written by Evaluate(). */
+  virtual const std::type_info & GetInputPixelType() const = 0;
+  virtual const std::type_info & GetOutputPixelType() const = 0;
+
+  /** sizeof() the output pixel type. */
+  virtual SizeValueType GetOutputPixelSize() const = 0;
+
+  /** The image holding the second operand, if any. */
+  virtual const DataObject * GetOperandImage() const { return 0; }
+
+  /** Apply the functor to length pixels, the first of which is at index.
+   * May be called concurrently by several threads. */
+  virtual void Evaluate(const void *input, void *output, const IndexType & index,
+                        SizeValueType length) = 0;
+
+protected:
+  PixelwiseFunctorStage() {}
+  ~PixelwiseFunctorStage() {}
+
+private:
+  PixelwiseFunctorStage(const Self &); //purposely not implemented
+  void operator=(const Self &);         //purposely not implemented
+};
+
+/** \class UnaryPixelwiseFunctorStage
+ * \brief PixelwiseFunctorStage applying a unary functor.
+ *
+ * \ingroup ITKCommon
+ */
+template< class TFunctor, class TInputPixel, class TOutputPixel, unsigned int VDimension >
+class UnaryPixelwiseFunctorStage:public PixelwiseFunctorStage< VDimension >
+{
+public:
+  /** Standard class typedefs. */
+  typedef UnaryPixelwiseFunctorStage              Self;
+  typedef PixelwiseFunctorStage< VDimension >     Superclass;
+  typedef SmartPointer< Self >                    Pointer;
+  typedef SmartPointer< const Self >              ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(UnaryPixelwiseFunctorStage, PixelwiseFunctorStage);
+
+  typedef TFunctor                       FunctorType;
+  typedef typename Superclass::IndexType IndexType;
+
+  FunctorType & GetFunctor() { return m_Functor; }
+  void SetFunctor(const FunctorType & functor) { m_Functor = functor; }
+
+  virtual const std::type_info & GetInputPixelType() const { return typeid( TInputPixel ); }
+  virtual const std::type_info & GetOutputPixelType() const { return typeid( TOutputPixel ); }
+  virtual SizeValueType GetOutputPixelSize() const { return sizeof( TOutputPixel ); }
+
+  virtual void Evaluate(const void *input, void *output, const IndexType &, SizeValueType length)
+  {
+    UnaryScanlineFunctorEvaluator< FunctorType, TInputPixel, TOutputPixel >
+    ::Evaluate( m_Functor, static_cast< const TInputPixel * >( input ),
+                static_cast< TOutputPixel * >( output ), length );
+  }
+
+protected:
+  UnaryPixelwiseFunctorStage() {}
+  ~UnaryPixelwiseFunctorStage() {}
+
+private:
+  UnaryPixelwiseFunctorStage(const Self &); //purposely not implemented
+  void operator=(const Self &);             //purposely not implemented
+
+  FunctorType m_Functor;
+};
+
+/** \class BinaryPixelwiseFunctorStage
+ * \brief PixelwiseFunctorStage applying a binary functor.
+ *
+ * The pixels flowing through the stage are the first operand of the
+ * functor, and the second operand is read from the operand image or is
+ * the constant set with SetConstant2(); or, after SetConstant1(), the
+ * first operand is a constant and the pixels flowing through the stage
+ * are the second operand.
+ *
+ * \ingroup ITKCommon
+ */
+template< class TFunctor, class TInput1, class TInput2, class TOutputPixel, class TOperandImage >
+class BinaryPixelwiseFunctorStage:public PixelwiseFunctorStage< TOperandImage::ImageDimension >
+{
+public:
+  /** Standard class typedefs. */
+  typedef BinaryPixelwiseFunctorStage                            Self;
+  typedef PixelwiseFunctorStage< TOperandImage::ImageDimension > Superclass;
+  typedef SmartPointer< Self >                                   Pointer;
+  typedef SmartPointer< const Self >                             ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(BinaryPixelwiseFunctorStage, PixelwiseFunctorStage);
+
+  typedef TFunctor                       FunctorType;
+  typedef TOperandImage                  OperandImageType;
+  typedef typename Superclass::IndexType IndexType;
+
+  FunctorType & GetFunctor() { return m_Functor; }
+  void SetFunctor(const FunctorType & functor) { m_Functor = functor; }
+
+  /** Read the second operand from image. */
+  void SetOperandImage(const OperandImageType *image)
+  {
+    m_OperandImage = image;
+    m_Mode = OperandImageSecond;
+  }
+
+  /** Use a constant as the first operand. */
+  void SetConstant1(const TInput1 & constant)
+  {
+    m_Constant1 = constant;
+    m_OperandImage = 0;
+    m_Mode = ConstantFirst;
+  }
+
+  /** Use a constant as the second operand. */
+  void SetConstant2(const TInput2 & constant)
+  {
+    m_Constant2 = constant;
+    m_OperandImage = 0;
+    m_Mode = ConstantSecond;
+  }
+
+  virtual const std::type_info & GetInputPixelType() const
+  {
+    return m_Mode == ConstantFirst ? typeid( TInput2 ) : typeid( TInput1 );
+  }
+
+  virtual const std::type_info & GetOutputPixelType() const { return typeid( TOutputPixel ); }
+  virtual SizeValueType GetOutputPixelSize() const { return sizeof( TOutputPixel ); }
+
+  virtual const DataObject * GetOperandImage() const { return m_OperandImage.GetPointer(); }
+
+  virtual void Evaluate(const void *input, void *output, const IndexType & index, SizeValueType length)
+  {
+    typedef BinaryScanlineFunctorEvaluator< FunctorType, TInput1, TInput2, TOutputPixel > EvaluatorType;
+    TOutputPixel *out = static_cast< TOutputPixel * >( output );
+    switch ( m_Mode )
+      {
+      case OperandImageSecond:
+        EvaluatorType::Evaluate( m_Functor, static_cast< const TInput1 * >( input ),
+                                 m_OperandImage->GetBufferPointer() + m_OperandImage->ComputeOffset(index),
+                                 out, length );
+        break;
+      case ConstantSecond:
+        EvaluatorType::EvaluateConstant2( m_Functor, static_cast< const TInput1 * >( input ),
+                                          m_Constant2, out, length );
+        break;
+      case ConstantFirst:
+        EvaluatorType::EvaluateConstant1( m_Functor, m_Constant1,
+                                          static_cast< const TInput2 * >( input ), out, length );
+        break;
+      }
+  }
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+  itkConceptMacro( OperandImageContiguousCheck,
+                   ( Concept::SameType< typename ScanlineDispatch< ImageScanlineTraits< TOperandImage >::IsContiguous >::Type,
+                                        TrueType > ) );
+  /** End concept checking */
+#endif
+
+protected:
+  BinaryPixelwiseFunctorStage():m_Mode(ConstantSecond), m_Constant1(), m_Constant2() {}
+  ~BinaryPixelwiseFunctorStage() {}
+
+private:
+  BinaryPixelwiseFunctorStage(const Self &); //purposely not implemented
+  void operator=(const Self &);              //purposely not implemented
+
+  typedef enum { OperandImageSecond, ConstantSecond, ConstantFirst } ModeType;
+
+  FunctorType                                 m_Functor;
+  ModeType                                    m_Mode;
+  TInput1                                     m_Constant1;
+  TInput2                                     m_Constant2;
+  typename OperandImageType::ConstPointer     m_OperandImage;
+};
+
+/** \class FusableFunctorFilter
+ * \brief Interface of the filters that can be replaced by a
+ * PixelwiseFunctorStage.
+ *
+ * UnaryFunctorImageFilter and BinaryFunctorImageFilter implement this
+ * interface, which FusedFunctorImageFilter::FuseUpstream() uses to
+ * collapse a chain of them into a single pass.
+ *
+ * \ingroup ITKCommon
+ */
+template< unsigned int VDimension >
+class FusableFunctorFilter
+{
+public:
+  typedef PixelwiseFunctorStage< VDimension > StageType;
+  typedef typename StageType::Pointer         StagePointer;
+
+  virtual ~FusableFunctorFilter() {}
+
+  /** Create a stage doing what the filter does to the pixels of
+   * chainInput, which is set to the input the pixels are read from.
+   * The stage holds a copy of the functor and constants of the filter.
+   * Returns a null pointer when the filter cannot be fused. */
+  virtual StagePointer CreatePixelwiseStage(const DataObject * & chainInput) = 0;
+};
+} // end namespace itk
+
+#endif
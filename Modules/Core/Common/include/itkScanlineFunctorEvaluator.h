@@ -0,0 +1,306 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkScanlineFunctorEvaluator_h
+#define __itkScanlineFunctorEvaluator_h
+
+#include "itkImageRegion.h"
+#include "itkDefaultPixelAccessor.h"
+#include "itkIsSame.h"
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define ITK_SCANLINE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace itk
+{
+/** \class ImageScanlineTraits
+ * \brief Tells whether the pixels of an image can be read and written
+ * directly in its buffer.
+ *
+ * This is the case when the image stores one PixelType per pixel and
+ * accesses it with the DefaultPixelAccessor, i.e. for itk::Image. The
+ * pixels of a scanline, a run of pixels along the first dimension, are
+ * then contiguous in memory.
+ *
+ * \ingroup ITKCommon
+ */
+template< class TImage >
+struct ImageScanlineTraits
+{
+  static const bool IsContiguous =
+    IsSame< typename TImage::AccessorType, DefaultPixelAccessor< typename TImage::PixelType > >::Value
+    && IsSame< typename TImage::InternalPixelType, typename TImage::PixelType >::Value;
+};
+
+/** \cond HIDE_META_PROGRAMMING */
+/** Converts a compile time condition to TrueType or FalseType, to select
+ * an overload. */
+template< bool VCondition >
+struct ScanlineDispatch
+{
+  typedef FalseType Type;
+};
+
+template< >
+struct ScanlineDispatch< true >
+{
+  typedef TrueType Type;
+};
+/** \endcond */
+
+/** Move index to the first pixel of the next scanline of region. */
+template< unsigned int VDimension >
+inline void
+IncrementScanlineIndex(Index< VDimension > & index, const ImageRegion< VDimension > & region)
+{
+  for ( unsigned int d = 1; d < VDimension; ++d )
+    {
+    ++index[d];
+    if ( index[d] < region.GetIndex(d) + static_cast< IndexValueType >( region.GetSize(d) ) )
+      {
+      return;
+      }
+    index[d] = region.GetIndex(d);
+    }
+}
+
+/** \class UnaryScanlineFunctorEvaluator
+ * \brief Applies a unary functor to a scanline of contiguous pixels.
+ *
+ * UnaryFunctorImageFilter calls Evaluate() once per scanline when the
+ * input and output images are contiguous (see ImageScanlineTraits). The
+ * default implementation is a plain loop over the pixels, which
+ * the compiler is free to vectorize. Functors can specialize this class
+ * to process several pixels per instruction; such specializations must
+ * produce the same values as the functor.
+ *
+ * \sa BinaryScanlineFunctorEvaluator TernaryScanlineFunctorEvaluator
+ * \ingroup ITKCommon
+ */
+template< class TFunctor, class TInput, class TOutput >
+struct UnaryScanlineFunctorEvaluator
+{
+  static void Evaluate(TFunctor & functor, const TInput *input, TOutput *output,
+                       SizeValueType length)
+  {
+    for ( SizeValueType i = 0; i < length; ++i )
+      {
+      output[i] = functor(input[i]);
+      }
+  }
+};
+
+/** \class BinaryScanlineFunctorEvaluator
+ * \brief Applies a binary functor to a scanline of contiguous pixels.
+ *
+ * EvaluateConstant1() and EvaluateConstant2() are used when the first
+ * or the second operand of BinaryFunctorImageFilter is a constant.
+ *
+ * \sa UnaryScanlineFunctorEvaluator
+ * \ingroup ITKCommon
+ */
+template< class TFunctor, class TInput1, class TInput2, class TOutput >
+struct BinaryScanlineFunctorEvaluator
+{
+  static void Evaluate(TFunctor & functor, const TInput1 *input1, const TInput2 *input2,
+                       TOutput *output, SizeValueType length)
+  {
+    for ( SizeValueType i = 0; i < length; ++i )
+      {
+      output[i] = functor(input1[i], input2[i]);
+      }
+  }
+
+  static void EvaluateConstant1(TFunctor & functor, const TInput1 & input1, const TInput2 *input2,
+                                TOutput *output, SizeValueType length)
+  {
+    for ( SizeValueType i = 0; i < length; ++i )
+      {
+      output[i] = functor(input1, input2[i]);
+      }
+  }
+
+  static void EvaluateConstant2(TFunctor & functor, const TInput1 *input1, const TInput2 & input2,
+                                TOutput *output, SizeValueType length)
+  {
+    for ( SizeValueType i = 0; i < length; ++i )
+      {
+      output[i] = functor(input1[i], input2);
+      }
+  }
+};
+
+/** \class TernaryScanlineFunctorEvaluator
+ * \brief Applies a ternary functor to a scanline of contiguous pixels.
+ *
+ * \sa UnaryScanlineFunctorEvaluator
+ * \ingroup ITKCommon
+ */
+template< class TFunctor, class TInput1, class TInput2, class TInput3, class TOutput >
+struct TernaryScanlineFunctorEvaluator
+{
+  static void Evaluate(TFunctor & functor, const TInput1 *input1, const TInput2 *input2,
+                       const TInput3 *input3, TOutput *output, SizeValueType length)
+  {
+    for ( SizeValueType i = 0; i < length; ++i )
+      {
+      output[i] = functor(input1[i], input2[i], input3[i]);
+      }
+  }
+};
+
+#if defined( ITK_SCANLINE_SSE2 )
+/** \cond HIDE_META_PROGRAMMING */
+/** Building blocks of the SSE2 specializations of the scanline
+ * evaluators. A Packet loads and stores as many float or double values
+ * as fit in a 128 bit register; the operations are overloaded on the
+ * register type. */
+namespace ScanlineSSE2
+{
+template< class TReal >
+struct Packet;
+
+template< >
+struct Packet< float >
+{
+  typedef __m128 Type;
+  static const unsigned int Length = 4;
+  static Type Load(const float *p) { return _mm_loadu_ps(p); }
+  static void Store(float *p, const Type & v) { _mm_storeu_ps(p, v); }
+  static Type Broadcast(float v) { return _mm_set1_ps(v); }
+};
+
+template< >
+struct Packet< double >
+{
+  typedef __m128d Type;
+  static const unsigned int Length = 2;
+  static Type Load(const double *p) { return _mm_loadu_pd(p); }
+  static void Store(double *p, const Type & v) { _mm_storeu_pd(p, v); }
+  static Type Broadcast(double v) { return _mm_set1_pd(v); }
+};
+
+struct Add
+{
+  static __m128 Apply(const __m128 & a, const __m128 & b) { return _mm_add_ps(a, b); }
+  static __m128d Apply(const __m128d & a, const __m128d & b) { return _mm_add_pd(a, b); }
+};
+
+struct Subtract
+{
+  static __m128 Apply(const __m128 & a, const __m128 & b) { return _mm_sub_ps(a, b); }
+  static __m128d Apply(const __m128d & a, const __m128d & b) { return _mm_sub_pd(a, b); }
+};
+
+struct Multiply
+{
+  static __m128 Apply(const __m128 & a, const __m128 & b) { return _mm_mul_ps(a, b); }
+  static __m128d Apply(const __m128d & a, const __m128d & b) { return _mm_mul_pd(a, b); }
+};
+
+struct Sqrt
+{
+  static __m128 Apply(const __m128 & a) { return _mm_sqrt_ps(a); }
+  static __m128d Apply(const __m128d & a) { return _mm_sqrt_pd(a); }
+};
+
+/** Clears the sign bit. */
+struct Abs
+{
+  static __m128 Apply(const __m128 & a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+  static __m128d Apply(const __m128d & a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+};
+} // end namespace ScanlineSSE2
+
+/** Unary evaluator processing a Packet at a time with TOperation. The
+ * pixels left over at the end of the scanline go through the functor. */
+template< class TFunctor, class TReal, class TOperation >
+struct SSE2UnaryScanlineFunctorEvaluator
+{
+  static void Evaluate(TFunctor & functor, const TReal *input, TReal *output, SizeValueType length)
+  {
+    typedef ScanlineSSE2::Packet< TReal > PacketType;
+    SizeValueType i = 0;
+    for (; i + PacketType::Length <= length; i += PacketType::Length )
+      {
+      PacketType::Store( output + i, TOperation::Apply( PacketType::Load(input + i) ) );
+      }
+    for (; i < length; ++i )
+      {
+      output[i] = functor(input[i]);
+      }
+  }
+};
+
+/** Binary evaluator processing a Packet at a time with TOperation. */
+template< class TFunctor, class TReal, class TOperation >
+struct SSE2BinaryScanlineFunctorEvaluator
+{
+  typedef ScanlineSSE2::Packet< TReal > PacketType;
+
+  static void Evaluate(TFunctor & functor, const TReal *input1, const TReal *input2,
+                       TReal *output, SizeValueType length)
+  {
+    SizeValueType i = 0;
+    for (; i + PacketType::Length <= length; i += PacketType::Length )
+      {
+      PacketType::Store( output + i,
+                         TOperation::Apply( PacketType::Load(input1 + i), PacketType::Load(input2 + i) ) );
+      }
+    for (; i < length; ++i )
+      {
+      output[i] = functor(input1[i], input2[i]);
+      }
+  }
+
+  static void EvaluateConstant1(TFunctor & functor, const TReal & input1, const TReal *input2,
+                                TReal *output, SizeValueType length)
+  {
+    const typename PacketType::Type constant = PacketType::Broadcast(input1);
+    SizeValueType                   i = 0;
+    for (; i + PacketType::Length <= length; i += PacketType::Length )
+      {
+      PacketType::Store( output + i, TOperation::Apply( constant, PacketType::Load(input2 + i) ) );
+      }
+    for (; i < length; ++i )
+      {
+      output[i] = functor(input1, input2[i]);
+      }
+  }
+
+  static void EvaluateConstant2(TFunctor & functor, const TReal *input1, const TReal & input2,
+                                TReal *output, SizeValueType length)
+  {
+    const typename PacketType::Type constant = PacketType::Broadcast(input2);
+    SizeValueType                   i = 0;
+    for (; i + PacketType::Length <= length; i += PacketType::Length )
+      {
+      PacketType::Store( output + i, TOperation::Apply( PacketType::Load(input1 + i), constant ) );
+      }
+    for (; i < length; ++i )
+      {
+      output[i] = functor(input1[i], input2);
+      }
+  }
+};
+/** \endcond */
+#endif
+} // end namespace itk
+
+#endif
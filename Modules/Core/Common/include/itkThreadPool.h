@@ -0,0 +1,177 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkThreadPool_h
+#define __itkThreadPool_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkConditionVariable.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkIntTypes.h"
+#include <deque>
+#include <vector>
+
+namespace itk
+{
+/** \class ThreadPool
+ * \brief A process wide pool of persistent worker threads.
+ *
+ * The ThreadPool keeps its worker threads alive between executions so that
+ * MultiThreader::SingleMethodExecute() and
+ * MultiThreader::MultipleMethodExecute() do not pay for thread creation and
+ * joining on every filter update.
+ *
+ * Jobs are kept in a fixed number of double ended queues, one per hardware
+ * thread. New jobs are distributed round robin over the queues. A worker
+ * takes jobs from the back of its own queue and, when that queue is empty,
+ * steals jobs from the front of the other queues.
+ *
+ * The pool grows on demand so that every pending job has an idle worker
+ * available to run it. Jobs submitted together are therefore run
+ * concurrently, which is required by threaded methods that synchronize
+ * through a Barrier.
+ *
+ * A thread waiting in WaitForJobs() runs pending jobs itself instead of
+ * sleeping, so that nested executions issued from inside a job cannot
+ * exhaust the pool.
+ *
+ * The pool is a singleton; use GetInstance() to access it.
+ *
+ * \sa MultiThreader
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ThreadPool:public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ThreadPool                 Self;
+  typedef Object                     Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ThreadPool, Object);
+
+  /** Return the single instance of the ThreadPool. */
+  static Pointer GetInstance();
+
+  /** This is a singleton pattern New. There will only be ONE
+   * reference to a ThreadPool object per process. */
+  static Pointer New();
+
+  /** \class JobGroup
+   * \brief Counts the outstanding jobs of one execution so that the
+   * submitting thread can wait for exactly those jobs, and keeps the first
+   * exception thrown by one of them.
+   * \ingroup ITKCommon */
+  class JobGroup
+  {
+  public:
+    JobGroup():m_NumberOfRemainingJobs(0), m_ExceptionOccurred(false) {}
+  private:
+    friend class ThreadPool;
+    SizeValueType   m_NumberOfRemainingJobs;
+    bool            m_ExceptionOccurred;
+    ExceptionObject m_Exception;
+  };
+
+  /** Queue function(data) for execution by a worker thread. The job is
+   * accounted to the given group. */
+  void AddJob(ThreadFunctionType function, void *data, JobGroup & group);
+
+  /** Block until every job of the group has completed. The calling thread
+   * runs pending jobs while it waits. If jobs of the group threw, the
+   * exception of the first one to complete is then rethrown; exceptions
+   * other than ExceptionObjects are rethrown as ExceptionObjects with the
+   * same description. */
+  void WaitForJobs(JobGroup & group);
+
+  /** Number of worker threads currently owned by the pool. */
+  ThreadIdType GetNumberOfWorkerThreads() const;
+
+  /** Number of work-stealing queues. */
+  ThreadIdType GetNumberOfQueues() const;
+
+protected:
+  ThreadPool();
+  ~ThreadPool();
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  ThreadPool(const Self &);     //purposely not implemented
+  void operator=(const Self &); //purposely not implemented
+
+  /** A unit of work together with the group it belongs to. */
+  struct ThreadJob {
+    ThreadFunctionType ThreadFunction;
+    void *UserData;
+    JobGroup *Group;
+  };
+
+  /** A double ended job queue. The owner pops from the back, thieves
+   * steal from the front. */
+  struct JobQueue {
+    std::deque< ThreadJob > Jobs;
+    SimpleFastMutexLock     Lock;
+  };
+
+  /** Data passed to a worker thread at creation time. */
+  struct WorkerInfo {
+    ThreadPool *Pool;
+    ThreadIdType QueueIndex;
+    ThreadProcessIDType ThreadHandle;
+  };
+
+  /** Create a new worker. Must be called with m_Mutex locked. */
+  void AddWorker();
+
+  /** Take one job from the queues, looking first at the back of the
+   * queue with index home and then at the front of the others. The caller
+   * must have reserved the job by decrementing m_NumberOfPendingJobs. */
+  ThreadJob DequeueJob(ThreadIdType home);
+
+  /** Run a job and report its completion, and its exception if it threw
+   * one, to its group. Must be called with m_Mutex unlocked; returns with
+   * m_Mutex locked. */
+  void RunJob(const ThreadJob & job);
+
+  /** Main loop of the worker threads. */
+  static ITK_THREAD_RETURN_TYPE WorkerThreadEntry(void *arg);
+
+  /** Platform specific creation and joining of the worker threads. */
+  ThreadProcessIDType SpawnWorkerThread(WorkerInfo *info);
+  void JoinWorkerThread(ThreadProcessIDType threadHandle);
+
+  static Pointer m_Instance;
+
+  std::vector< JobQueue * >   m_Queues;
+  std::vector< WorkerInfo * > m_Workers;
+
+  /** Protects the counters below and the worker list. */
+  mutable SimpleMutexLock    m_Mutex;
+  ConditionVariable::Pointer m_WorkAvailable;
+  ConditionVariable::Pointer m_JobsCompleted;
+
+  SizeValueType m_NumberOfPendingJobs;
+  ThreadIdType  m_NumberOfIdleWorkers;
+  ThreadIdType  m_NextQueue;
+  bool          m_Stopping;
+};
+}  // end namespace itk
+#endif
@@ -18,6 +18,7 @@
 #ifndef __itkThreadSupport_h
 #define __itkThreadSupport_h
 
+#include "itkConfigure.h"
 
 // This implementation uses a routine called SignalObjectAndWait()
 // which is only defined on WinNT 4.0 or greater systems.  We need to
@@ -41,7 +42,7 @@ namespace itk
   /** Platform specific typedefs for simple types
    */
 #if defined(ITK_USE_PTHREADS)
-#define ITK_MAX_THREADS              128
+#define ITK_MAX_THREADS              ITK_CONFIGURED_MAX_THREADS
   typedef pthread_mutex_t MutexType;
   typedef pthread_mutex_t FastMutexType;
   typedef void *( * ThreadFunctionType )(void *);
@@ -51,7 +52,7 @@ namespace itk
 
 #elif defined(ITK_USE_WIN32_THREADS)
 
-#define ITK_MAX_THREADS              128
+#define ITK_MAX_THREADS              ITK_CONFIGURED_MAX_THREADS
   typedef HANDLE                 MutexType;
   typedef CRITICAL_SECTION       FastMutexType;
   typedef LPTHREAD_START_ROUTINE ThreadFunctionType;
@@ -20,6 +20,7 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkPixelwiseFunctorStage.h"
 
 namespace itk
 {
@@ -35,6 +36,15 @@ namespace itk
  * UnaryFunctorImageFilter (like the CastImageFilter) can be used
  * to promote a 2D image to a 3D image, etc.
  *
+ * When the input and output images have the same dimension and store
+ * their pixels contiguously (see ImageScanlineTraits), the functor is
+ * applied a scanline at a time, straight from the image buffers, through
+ * UnaryScanlineFunctorEvaluator. Other images are walked with iterators.
+ *
+ * Such a filter can also be fused with its neighbours into a single
+ * FusedFunctorImageFilter, see CreatePixelwiseStage(). Subclasses that
+ * set up their functor while they execute must turn Fusable off.
+ *
  * \sa BinaryFunctorImageFilter TernaryFunctorImageFilter
  *
  * \ingroup   IntensityImageFilters     MultiThreaded
@@ -45,7 +55,9 @@ namespace itk
  * \endwiki
  */
 template< class TInputImage, class TOutputImage, class TFunction >
-class ITK_EXPORT UnaryFunctorImageFilter:public InPlaceImageFilter< TInputImage, TOutputImage >
+class ITK_EXPORT UnaryFunctorImageFilter:
+  public InPlaceImageFilter< TInputImage, TOutputImage >,
+  public FusableFunctorFilter< TOutputImage::ImageDimension >
 {
 public:
   /** Standard class typedefs. */
@@ -95,6 +107,19 @@ public:
       }
   }
 
+  /** Whether FusedFunctorImageFilter may replace this filter by a
+   * PixelwiseFunctorStage. On by default. */
+  itkSetMacro(Fusable, bool);
+  itkGetConstMacro(Fusable, bool);
+  itkBooleanMacro(Fusable);
+
+  typedef typename FusableFunctorFilter< TOutputImage::ImageDimension >::StagePointer StagePointer;
+
+  /** Create a stage applying a copy of the functor to the pixels of the
+   * input. Returns a null pointer if Fusable is off or if the images are
+   * not both contiguous images of the same dimension. */
+  virtual StagePointer CreatePixelwiseStage(const DataObject * & chainInput);
+
 protected:
   UnaryFunctorImageFilter();
   virtual ~UnaryFunctorImageFilter() {}
@@ -126,7 +151,27 @@ private:
   UnaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);          //purposely not implemented
 
+  /** TrueType when the scanlines of both images can be processed straight
+   * from their buffers. */
+  typedef typename ScanlineDispatch<
+    ImageScanlineTraits< TInputImage >::IsContiguous
+    && ImageScanlineTraits< TOutputImage >::IsContiguous
+    && static_cast< unsigned int >( TInputImage::ImageDimension )
+    == static_cast< unsigned int >( TOutputImage::ImageDimension ) >::Type ScanlineDispatchType;
+
+  /** Process the region a scanline at a time. */
+  void DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                      ThreadIdType threadId, TrueType);
+
+  /** Process the region with iterators. */
+  void DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                      ThreadIdType threadId, FalseType);
+
+  StagePointer DispatchedCreatePixelwiseStage(TrueType);
+  StagePointer DispatchedCreatePixelwiseStage(FalseType) { return 0; }
+
   FunctorType m_Functor;
+  bool        m_Fusable;
 };
 } // end namespace itk
 
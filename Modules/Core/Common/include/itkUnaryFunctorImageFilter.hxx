@@ -33,6 +33,32 @@ UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
 {
   this->SetNumberOfRequiredInputs(1);
   this->InPlaceOff();
+  m_Fusable = true;
+}
+
+template< class TInputImage, class TOutputImage, class TFunction  >
+typename UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >::StagePointer
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::CreatePixelwiseStage(const DataObject * & chainInput)
+{
+  chainInput = this->GetInput();
+  if ( !m_Fusable || !chainInput )
+    {
+    return 0;
+    }
+  return this->DispatchedCreatePixelwiseStage( ScanlineDispatchType() );
+}
+
+template< class TInputImage, class TOutputImage, class TFunction  >
+typename UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >::StagePointer
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::DispatchedCreatePixelwiseStage(TrueType)
+{
+  typedef UnaryPixelwiseFunctorStage< FunctorType, InputImagePixelType, OutputImagePixelType,
+                                      TOutputImage::ImageDimension > StageType;
+  typename StageType::Pointer stage = StageType::New();
+  stage->SetFunctor(m_Functor);
+  return stage.GetPointer();
 }
 
 /**
@@ -150,6 +176,62 @@ void
 UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
+{
+  this->DispatchedThreadedGenerateData( outputRegionForThread, threadId, ScanlineDispatchType() );
+}
+
+template< class TInputImage, class TOutputImage, class TFunction  >
+void
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                 ThreadIdType threadId, TrueType)
+{
+  InputImagePointer  inputPtr = this->GetInput();
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  InputImageRegionType inputRegionForThread;
+
+  this->CallCopyOutputRegionToInputRegion(inputRegionForThread, outputRegionForThread);
+
+  if ( outputRegionForThread.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+  if ( inputRegionForThread.GetSize() != outputRegionForThread.GetSize() )
+    {
+    this->DispatchedThreadedGenerateData( outputRegionForThread, threadId, FalseType() );
+    return;
+    }
+
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+  const SizeValueType numberOfLines = outputRegionForThread.GetNumberOfPixels() / lineLength;
+
+  const InputImagePixelType *inputBuffer = inputPtr->GetBufferPointer();
+  OutputImagePixelType *     outputBuffer = outputPtr->GetBufferPointer();
+
+  typename InputImageType::IndexType  inputIndex = inputRegionForThread.GetIndex();
+  typename OutputImageType::IndexType outputIndex = outputRegionForThread.GetIndex();
+
+  ProgressReporter progress(this, threadId, numberOfLines);
+
+  for ( SizeValueType line = 0; line < numberOfLines; ++line )
+    {
+    UnaryScanlineFunctorEvaluator< FunctorType, InputImagePixelType, OutputImagePixelType >
+    ::Evaluate( m_Functor,
+                inputBuffer + inputPtr->ComputeOffset(inputIndex),
+                outputBuffer + outputPtr->ComputeOffset(outputIndex),
+                lineLength );
+    IncrementScanlineIndex(inputIndex, inputRegionForThread);
+    IncrementScanlineIndex(outputIndex, outputRegionForThread);
+    progress.CompletedPixel();  // potential exception thrown here
+    }
+}
+
+template< class TInputImage, class TOutputImage, class TFunction  >
+void
+UnaryFunctorImageFilter< TInputImage, TOutputImage, TFunction >
+::DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                 ThreadIdType threadId, FalseType)
 {
   InputImagePointer  inputPtr = this->GetInput();
   OutputImagePointer outputPtr = this->GetOutput(0);
@@ -58,6 +58,16 @@ VectorImage< TPixel, VImageDimension >
   this->ComputeOffsetTable();
   num = this->GetOffsetTable()[VImageDimension];
 
+  // Let a parallel first touch of the buffer follow the split of
+  // ImageSource::SplitRequestedRegion().
+  const SizeType & size = this->GetBufferedRegion().GetSize();
+  unsigned int     splitAxis = VImageDimension - 1;
+  while ( splitAxis > 0 && size[splitAxis] == 1 )
+    {
+    --splitAxis;
+    }
+  m_Buffer->SetNumberOfElementsPerSlice(this->GetOffsetTable()[splitAxis] * m_VectorLength);
+
   m_Buffer->Reserve(num * m_VectorLength);
 }
 
@@ -76,8 +86,15 @@ VectorImage< TPixel, VImageDimension >
 
   // Replace the handle to the buffer. This is the safest thing to do,
   // since the same container can be shared by multiple images (e.g.
-  // Grafted outputs and in place filters).
+  // Grafted outputs and in place filters). The new container keeps the
+  // allocation policy of the old one.
+  ImageBufferAllocator::Pointer allocator;
+  if ( m_Buffer )
+    {
+    allocator = m_Buffer->GetBufferAllocator();
+    }
   m_Buffer = PixelContainer::New();
+  m_Buffer->SetBufferAllocator(allocator);
 }
 
 template< class TPixel, unsigned int VImageDimension >
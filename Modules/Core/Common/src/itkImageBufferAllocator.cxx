@@ -0,0 +1,228 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferAllocator.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
+#include <stdlib.h>
+
+#if defined( _WIN32 )
+#include <malloc.h>
+#endif
+
+#if defined( __linux__ )
+#include <sys/mman.h>
+#endif
+
+namespace itk
+{
+ImageBufferAllocator::Pointer ImageBufferAllocator:: m_GlobalDefaultAllocator = 0;
+
+// Guards m_GlobalDefaultAllocator, which is read by every new container.
+static SimpleFastMutexLock ImageBufferAllocatorGlobalDefaultLock;
+
+namespace
+{
+// Data shared by the threads of a parallel InitializeBuffer().
+struct InitializeBufferStruct {
+  void *Buffer;
+  SizeValueType NumberOfElements;
+  SizeValueType NumberOfElementsPerPiece;
+  ImageBufferAllocator::InitializeFunctionType Function;
+};
+}
+
+ImageBufferAllocator
+::ImageBufferAllocator()
+{
+  m_Alignment = 64;
+  m_UseHugePages = false;
+  m_ParallelFirstTouch = false;
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+}
+
+ImageBufferAllocator
+::~ImageBufferAllocator()
+{}
+
+void
+ImageBufferAllocator
+::SetGlobalDefaultAllocator(Self *allocator)
+{
+  ImageBufferAllocatorGlobalDefaultLock.Lock();
+  m_GlobalDefaultAllocator = allocator;
+  ImageBufferAllocatorGlobalDefaultLock.Unlock();
+}
+
+ImageBufferAllocator::Pointer
+ImageBufferAllocator
+::GetGlobalDefaultAllocator()
+{
+  ImageBufferAllocatorGlobalDefaultLock.Lock();
+  Pointer allocator = m_GlobalDefaultAllocator;
+  ImageBufferAllocatorGlobalDefaultLock.Unlock();
+  return allocator;
+}
+
+void
+ImageBufferAllocator
+::SetAlignment(SizeValueType alignment)
+{
+  if ( alignment < sizeof( void * )
+       || ( alignment & ( alignment - 1 ) ) != 0
+       || alignment % sizeof( void * ) != 0 )
+    {
+    itkExceptionMacro(<< "Alignment must be a power of two and a multiple of "
+                      << sizeof( void * ) << ", got " << alignment);
+    }
+  if ( m_Alignment != alignment )
+    {
+    m_Alignment = alignment;
+    this->Modified();
+    }
+}
+
+SizeValueType
+ImageBufferAllocator
+::GetHugePageSize()
+{
+  // The size of a transparent huge page on x86 and most other platforms.
+  return 2 * 1024 * 1024;
+}
+
+void *
+ImageBufferAllocator
+::Allocate(SizeValueType numberOfBytes)
+{
+  SizeValueType alignment = m_Alignment;
+  const SizeValueType hugePageSize = GetHugePageSize();
+  const bool useHugePages = m_UseHugePages && numberOfBytes >= hugePageSize;
+
+  if ( useHugePages && alignment < hugePageSize )
+    {
+    alignment = hugePageSize;
+    }
+
+  // Never request an empty block, so that a valid pointer is returned for
+  // empty images as new[] does.
+  const size_t size = numberOfBytes > 0 ? static_cast< size_t >( numberOfBytes ) : 1;
+  void *buffer = 0;
+
+#if defined( _WIN32 )
+  buffer = _aligned_malloc(size, alignment);
+#else
+  if ( posix_memalign(&buffer, alignment, size) != 0 )
+    {
+    buffer = 0;
+    }
+#endif
+
+#if defined( __linux__ ) && defined( MADV_HUGEPAGE )
+  if ( buffer && useHugePages )
+    {
+    // Only a hint; the buffer is usable whether or not it is honored.
+    madvise(buffer, size - size % hugePageSize, MADV_HUGEPAGE);
+    }
+#endif
+
+  return buffer;
+}
+
+void
+ImageBufferAllocator
+::Deallocate(void *buffer, SizeValueType itkNotUsed(numberOfBytes))
+{
+#if defined( _WIN32 )
+  _aligned_free(buffer);
+#else
+  free(buffer);
+#endif
+}
+
+void
+ImageBufferAllocator
+::InitializeBuffer(void *buffer, SizeValueType numberOfElements,
+                   SizeValueType numberOfElementsPerSlice,
+                   InitializeFunctionType function) const
+{
+  if ( numberOfElementsPerSlice == 0 || numberOfElements % numberOfElementsPerSlice != 0 )
+    {
+    numberOfElementsPerSlice = 1;
+    }
+
+  // Same split as ImageSource::SplitRequestedRegion(): the slices are
+  // divided into pieces of ceil(slices / threads) slices.
+  const SizeValueType numberOfSlices = numberOfElements / numberOfElementsPerSlice;
+  ThreadIdType        numberOfPieces = 1;
+  SizeValueType       slicesPerPiece = numberOfSlices;
+  if ( m_ParallelFirstTouch && m_NumberOfThreads > 1 && numberOfSlices > 1 )
+    {
+    slicesPerPiece = ( numberOfSlices + m_NumberOfThreads - 1 ) / m_NumberOfThreads;
+    numberOfPieces = static_cast< ThreadIdType >( ( numberOfSlices + slicesPerPiece - 1 ) / slicesPerPiece );
+    }
+
+  if ( numberOfPieces <= 1 )
+    {
+    ( *function )(buffer, 0, numberOfElements);
+    return;
+    }
+
+  InitializeBufferStruct str;
+  str.Buffer = buffer;
+  str.NumberOfElements = numberOfElements;
+  str.NumberOfElementsPerPiece = slicesPerPiece * numberOfElementsPerSlice;
+  str.Function = function;
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads(numberOfPieces);
+  threader->SetSingleMethod(InitializeBufferThreaderCallback, &str);
+  threader->SingleMethodExecute();
+}
+
+ITK_THREAD_RETURN_TYPE
+ImageBufferAllocator
+::InitializeBufferThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const InitializeBufferStruct *   str = static_cast< InitializeBufferStruct * >( info->UserData );
+
+  const SizeValueType begin = info->ThreadID * str->NumberOfElementsPerPiece;
+  if ( begin < str->NumberOfElements )
+    {
+    SizeValueType end = begin + str->NumberOfElementsPerPiece;
+    if ( end > str->NumberOfElements )
+      {
+      end = str->NumberOfElements;
+      }
+    ( *str->Function )(str->Buffer, begin, end);
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+ImageBufferAllocator
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Alignment: " << m_Alignment << std::endl;
+  os << indent << "UseHugePages: " << ( m_UseHugePages ? "On" : "Off" ) << std::endl;
+  os << indent << "ParallelFirstTouch: " << ( m_ParallelFirstTouch ? "On" : "Off" ) << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+}
+} // end namespace itk
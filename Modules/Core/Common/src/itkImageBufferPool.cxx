@@ -0,0 +1,221 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferPool.h"
+
+namespace itk
+{
+ImageBufferPool
+::ImageBufferPool()
+{
+  m_MaximumCachedBytes = static_cast< SizeValueType >( 1024 ) * 1024 * 1024;
+  m_CachedBytes = 0;
+  m_NumberOfCachedBuffers = 0;
+  m_NumberOfHits = 0;
+  m_NumberOfMisses = 0;
+}
+
+ImageBufferPool
+::~ImageBufferPool()
+{
+  this->Trim();
+}
+
+SizeValueType
+ImageBufferPool
+::GetBucketSize(SizeValueType numberOfBytes)
+{
+  const SizeValueType pageSize = 4096;
+
+  if ( numberOfBytes <= 4 * pageSize )
+    {
+    return ( ( numberOfBytes + pageSize - 1 ) / pageSize ) * pageSize;
+    }
+
+  // Four buckets between consecutive powers of two.
+  SizeValueType step = pageSize;
+  while ( step * 8 <= numberOfBytes )
+    {
+    step *= 2;
+    }
+  return ( ( numberOfBytes + step - 1 ) / step ) * step;
+}
+
+void *
+ImageBufferPool
+::Allocate(SizeValueType numberOfBytes)
+{
+  const SizeValueType bucketSize = GetBucketSize(numberOfBytes);
+
+  m_Lock.Lock();
+  BucketMapType::iterator bucket = m_Buckets.find(bucketSize);
+  if ( bucket != m_Buckets.end() && !bucket->second.empty() )
+    {
+    void *buffer = bucket->second.back();
+    bucket->second.pop_back();
+    m_CachedBytes -= bucketSize;
+    --m_NumberOfCachedBuffers;
+    ++m_NumberOfHits;
+    m_Lock.Unlock();
+    return buffer;
+    }
+  ++m_NumberOfMisses;
+  m_Lock.Unlock();
+
+  void *buffer = Superclass::Allocate(bucketSize);
+  if ( !buffer )
+    {
+    // Give the cached memory back and try once more.
+    this->Trim();
+    buffer = Superclass::Allocate(bucketSize);
+    }
+  return buffer;
+}
+
+void
+ImageBufferPool
+::Deallocate(void *buffer, SizeValueType numberOfBytes)
+{
+  if ( !buffer )
+    {
+    return;
+    }
+
+  const SizeValueType bucketSize = GetBucketSize(numberOfBytes);
+
+  m_Lock.Lock();
+  if ( m_CachedBytes + bucketSize <= m_MaximumCachedBytes )
+    {
+    m_Buckets[bucketSize].push_back(buffer);
+    m_CachedBytes += bucketSize;
+    ++m_NumberOfCachedBuffers;
+    m_Lock.Unlock();
+    return;
+    }
+  m_Lock.Unlock();
+
+  Superclass::Deallocate(buffer, bucketSize);
+}
+
+void
+ImageBufferPool
+::SetMaximumCachedBytes(SizeValueType bytes)
+{
+  m_Lock.Lock();
+  const bool changed = ( m_MaximumCachedBytes != bytes );
+  m_MaximumCachedBytes = bytes;
+  this->TrimUnlocked(bytes);
+  m_Lock.Unlock();
+
+  if ( changed )
+    {
+    this->Modified();
+    }
+}
+
+SizeValueType
+ImageBufferPool
+::GetCachedBytes() const
+{
+  m_Lock.Lock();
+  const SizeValueType bytes = m_CachedBytes;
+  m_Lock.Unlock();
+  return bytes;
+}
+
+SizeValueType
+ImageBufferPool
+::GetNumberOfCachedBuffers() const
+{
+  m_Lock.Lock();
+  const SizeValueType buffers = m_NumberOfCachedBuffers;
+  m_Lock.Unlock();
+  return buffers;
+}
+
+SizeValueType
+ImageBufferPool
+::GetNumberOfHits() const
+{
+  m_Lock.Lock();
+  const SizeValueType hits = m_NumberOfHits;
+  m_Lock.Unlock();
+  return hits;
+}
+
+SizeValueType
+ImageBufferPool
+::GetNumberOfMisses() const
+{
+  m_Lock.Lock();
+  const SizeValueType misses = m_NumberOfMisses;
+  m_Lock.Unlock();
+  return misses;
+}
+
+void
+ImageBufferPool
+::ResetStatistics()
+{
+  m_Lock.Lock();
+  m_NumberOfHits = 0;
+  m_NumberOfMisses = 0;
+  m_Lock.Unlock();
+}
+
+void
+ImageBufferPool
+::Trim(SizeValueType maximumBytes)
+{
+  m_Lock.Lock();
+  this->TrimUnlocked(maximumBytes);
+  m_Lock.Unlock();
+}
+
+void
+ImageBufferPool
+::TrimUnlocked(SizeValueType maximumBytes)
+{
+  // Free the largest buffers first; they are the most expensive to keep.
+  BucketMapType::iterator bucket = m_Buckets.end();
+  while ( m_CachedBytes > maximumBytes && bucket != m_Buckets.begin() )
+    {
+    --bucket;
+    std::vector< void * > & buffers = bucket->second;
+    while ( m_CachedBytes > maximumBytes && !buffers.empty() )
+      {
+      Superclass::Deallocate(buffers.back(), bucket->first);
+      buffers.pop_back();
+      m_CachedBytes -= bucket->first;
+      --m_NumberOfCachedBuffers;
+      }
+    }
+}
+
+void
+ImageBufferPool
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "MaximumCachedBytes: " << m_MaximumCachedBytes << std::endl;
+  os << indent << "CachedBytes: " << m_CachedBytes << std::endl;
+  os << indent << "NumberOfCachedBuffers: " << m_NumberOfCachedBuffers << std::endl;
+  os << indent << "NumberOfHits: " << m_NumberOfHits << std::endl;
+  os << indent << "NumberOfMisses: " << m_NumberOfMisses << std::endl;
+}
+} // end namespace itk
@@ -48,6 +48,11 @@ ThreadIdType MultiThreader:: m_GlobalMaximumNumberOfThreads = ITK_MAX_THREADS;
 // => Not initialized.
 ThreadIdType MultiThreader:: m_GlobalDefaultNumberOfThreads = 0;
 
+// Initialize static members that control whether the thread pool is used by
+// default. The environment is only queried once.
+bool MultiThreader:: m_GlobalDefaultUseThreadPool = false;
+bool MultiThreader:: m_GlobalDefaultUseThreadPoolIsInitialized = false;
+
 void MultiThreader::SetGlobalMaximumNumberOfThreads(ThreadIdType val)
 {
   m_GlobalMaximumNumberOfThreads = val;
@@ -95,6 +100,67 @@ void MultiThreader::SetNumberOfThreads(ThreadIdType numberOfThreads)
                                  m_GlobalMaximumNumberOfThreads );
   m_NumberOfThreads  = std::max( m_NumberOfThreads, NumericTraits<ThreadIdType>::One );
 
+  this->AllocateThreadArrays();
+}
+
+void MultiThreader::SetGlobalDefaultUseThreadPool(bool flag)
+{
+  m_GlobalDefaultUseThreadPool = flag;
+  m_GlobalDefaultUseThreadPoolIsInitialized = true;
+}
+
+void MultiThreader::SetUseThreadPool(bool flag)
+{
+  if ( m_UseThreadPool == flag )
+    {
+    return;
+    }
+
+  m_UseThreadPool = flag;
+  if ( m_UseThreadPool )
+    {
+    m_ThreadPool = ThreadPool::GetInstance();
+    }
+  else
+    {
+    m_ThreadPool = 0;
+    }
+  this->Modified();
+}
+
+bool MultiThreader::GetGlobalDefaultUseThreadPool()
+{
+  if ( !m_GlobalDefaultUseThreadPoolIsInitialized )
+    {
+    itksys_stl::string useThreadPoolEnv;
+    if ( itksys::SystemTools::GetEnv("ITK_USE_THREAD_POOL", useThreadPoolEnv) )
+      {
+      useThreadPoolEnv = itksys::SystemTools::UpperCase(useThreadPoolEnv);
+      m_GlobalDefaultUseThreadPool = ( useThreadPoolEnv == "ON" || useThreadPoolEnv == "1"
+                                       || useThreadPoolEnv == "TRUE" || useThreadPoolEnv == "YES" );
+      }
+    m_GlobalDefaultUseThreadPoolIsInitialized = true;
+    }
+  return m_GlobalDefaultUseThreadPool;
+}
+
+void MultiThreader::AllocateThreadArrays()
+{
+  const ThreadIdType oldSize = static_cast< ThreadIdType >( m_ThreadInfoArray.size() );
+  if ( oldSize >= m_NumberOfThreads )
+    {
+    return;
+    }
+
+  m_ThreadInfoArray.resize(m_NumberOfThreads);
+  m_MultipleMethod.resize(m_NumberOfThreads, 0);
+  m_MultipleData.resize(m_NumberOfThreads, 0);
+  for ( ThreadIdType i = oldSize; i < m_NumberOfThreads; i++ )
+    {
+    m_ThreadInfoArray[i].ThreadID           = i;
+    m_ThreadInfoArray[i].ActiveFlag         = 0;
+    m_ThreadInfoArray[i].ActiveFlagLock     = 0;
+    }
 }
 
 
@@ -179,20 +245,13 @@ ThreadIdType MultiThreader::GetGlobalDefaultNumberOfThreads()
 }
 
 
-// Constructor. Default all the methods to NULL. Since the
-// ThreadInfoArray is static, the ThreadIDs can be initialized here
-// and will not change.
+// Constructor. Default all the methods to NULL. The ThreadInfoArray
+// only grows, so the ThreadIDs are initialized once when an entry is
+// allocated and will not change.
 MultiThreader::MultiThreader()
 {
   for ( ThreadIdType i = 0; i < ITK_MAX_THREADS; i++ )
     {
-    m_ThreadInfoArray[i].ThreadID           = i;
-    m_ThreadInfoArray[i].ActiveFlag         = 0;
-    m_ThreadInfoArray[i].ActiveFlagLock     = 0;
-
-    m_MultipleMethod[i]                     = 0;
-    m_MultipleData[i]                       = 0;
-
     m_SpawnedThreadActiveFlag[i]            = 0;
     m_SpawnedThreadActiveFlagLock[i]        = 0;
     m_SpawnedThreadInfoArray[i].ThreadID    = i;
@@ -201,6 +260,12 @@ MultiThreader::MultiThreader()
   m_SingleMethod = 0;
   m_SingleData = 0;
   m_NumberOfThreads = this->GetGlobalDefaultNumberOfThreads();
+  m_UseThreadPool = this->GetGlobalDefaultUseThreadPool();
+  if ( m_UseThreadPool )
+    {
+    m_ThreadPool = ThreadPool::GetInstance();
+    }
+  this->AllocateThreadArrays();
 }
 
 MultiThreader::~MultiThreader()
@@ -236,7 +301,6 @@ void MultiThreader::SetMultipleMethod(ThreadIdType index, ThreadFunctionType f,
 void MultiThreader::SingleMethodExecute()
 {
   ThreadIdType                 thread_loop = 0;
-  ThreadProcessIDType process_id[ITK_MAX_THREADS];
 
   if ( !m_SingleMethod )
     {
@@ -247,6 +311,13 @@ void MultiThreader::SingleMethodExecute()
   // obey the global maximum number of threads limit
   m_NumberOfThreads = std::min( m_GlobalMaximumNumberOfThreads, m_NumberOfThreads );
 
+  std::vector< ThreadProcessIDType > process_id(m_NumberOfThreads);
+
+  // When the thread pool is used, the threads 1..m_NumberOfThreads-1 are
+  // jobs of this group instead of newly created threads.
+  ThreadPool *         threadPool = m_ThreadPool.GetPointer();
+  ThreadPool::JobGroup poolJobs;
+
   // Spawn a set of threads through the SingleMethodProxy. Exceptions
   // thrown from a thread will be caught by the SingleMethodProxy. A
   // naive mechanism is in place for determining whether a thread
@@ -264,8 +335,15 @@ void MultiThreader::SingleMethodExecute()
       m_ThreadInfoArray[thread_loop].NumberOfThreads = m_NumberOfThreads;
       m_ThreadInfoArray[thread_loop].ThreadFunction = m_SingleMethod;
 
-      process_id[thread_loop] =
-        this->DispatchSingleMethodThread(&m_ThreadInfoArray[thread_loop]);
+      if ( threadPool )
+        {
+        threadPool->AddJob(this->SingleMethodProxy, &m_ThreadInfoArray[thread_loop], poolJobs);
+        }
+      else
+        {
+        process_id[thread_loop] =
+          this->DispatchSingleMethodThread(&m_ThreadInfoArray[thread_loop]);
+        }
       }
     }
   catch ( std::exception & e )
@@ -296,14 +374,21 @@ void MultiThreader::SingleMethodExecute()
     {
     // Need cleanup and rethrow ProcessAborted
     // close down other threads
-    for ( thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
+    if ( threadPool )
       {
-      try
+      threadPool->WaitForJobs(poolJobs);
+      }
+    else
+      {
+      for ( thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
         {
-        this->WaitForSingleMethodThread(process_id[thread_loop]);
+        try
+          {
+          this->WaitForSingleMethodThread(process_id[thread_loop]);
+          }
+        catch ( ... )
+                {}
         }
-      catch ( ... )
-              {}
       }
     // rethrow
     throw excp;
@@ -325,11 +410,18 @@ void MultiThreader::SingleMethodExecute()
 
   // The parent thread has finished this->SingleMethod() - so now it
   // waits for each of the other processes to exit
+  if ( threadPool )
+    {
+    threadPool->WaitForJobs(poolJobs);
+    }
   for ( thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
     {
     try
       {
-      this->WaitForSingleMethodThread(process_id[thread_loop]);
+      if ( !threadPool )
+        {
+        this->WaitForSingleMethodThread(process_id[thread_loop]);
+        }
       if ( m_ThreadInfoArray[thread_loop].ThreadExitCode
            != ThreadInfoStruct::SUCCESS )
         {
@@ -360,6 +452,44 @@ void MultiThreader::SingleMethodExecute()
       }
     }
 }
+
+void MultiThreader::MultipleMethodExecuteOnThreadPool()
+{
+  ThreadPool *         threadPool = m_ThreadPool.GetPointer();
+  ThreadPool::JobGroup poolJobs;
+
+  for ( ThreadIdType thread_loop = 1; thread_loop < m_NumberOfThreads; thread_loop++ )
+    {
+    m_ThreadInfoArray[thread_loop].UserData = m_MultipleData[thread_loop];
+    m_ThreadInfoArray[thread_loop].NumberOfThreads = m_NumberOfThreads;
+    m_ThreadInfoArray[thread_loop].ThreadFunction = m_MultipleMethod[thread_loop];
+    threadPool->AddJob(m_MultipleMethod[thread_loop], &m_ThreadInfoArray[thread_loop], poolJobs);
+    }
+
+  // The parent thread calls the first method itself. The queued jobs refer
+  // to m_ThreadInfoArray, so they must complete before an exception leaves
+  // this method. An exception of the parent thread takes precedence over
+  // those of the jobs, which WaitForJobs() rethrows.
+  m_ThreadInfoArray[0].UserData = m_MultipleData[0];
+  m_ThreadInfoArray[0].NumberOfThreads = m_NumberOfThreads;
+  try
+    {
+    ( m_MultipleMethod[0] )( (void *)( &m_ThreadInfoArray[0] ) );
+    }
+  catch ( ... )
+    {
+    try
+      {
+      threadPool->WaitForJobs(poolJobs);
+      }
+    catch ( ... )
+      {
+      }
+    throw;
+    }
+  threadPool->WaitForJobs(poolJobs);
+}
+
 ITK_THREAD_RETURN_TYPE
 MultiThreader
 ::SingleMethodProxy(void *arg)
@@ -407,6 +537,9 @@ void MultiThreader::PrintSelf(std::ostream & os, Indent indent) const
      << m_GlobalMaximumNumberOfThreads << std::endl;
   os << indent << "Global Default Number Of Threads: "
      << m_GlobalDefaultNumberOfThreads << std::endl;
+  os << indent << "Use Thread Pool: " << m_UseThreadPool << std::endl;
+  os << indent << "Global Default Use Thread Pool: "
+     << m_GlobalDefaultUseThreadPool << std::endl;
 }
 
 
@@ -78,8 +78,6 @@ void MultiThreader::MultipleMethodExecute()
 {
   ThreadIdType thread_loop;
 
-  pthread_t process_id[ITK_MAX_THREADS];
-
   // obey the global maximum number of threads limit
   if ( m_NumberOfThreads > m_GlobalMaximumNumberOfThreads )
     {
@@ -95,6 +93,14 @@ void MultiThreader::MultipleMethodExecute()
       }
     }
 
+  if ( m_UseThreadPool )
+    {
+    this->MultipleMethodExecuteOnThreadPool();
+    return;
+    }
+
+  std::vector< pthread_t > process_id(m_NumberOfThreads);
+
   // Using POSIX threads
   //
   // We want to use pthread_create to start m_NumberOfThreads - 1
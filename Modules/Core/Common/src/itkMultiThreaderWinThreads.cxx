@@ -48,7 +48,6 @@ void MultiThreader::MultipleMethodExecute()
   ThreadIdType thread_loop;
 
   DWORD  threadId;
-  HANDLE process_id[ITK_MAX_THREADS];
 
   // obey the global maximum number of threads limit
   if ( m_NumberOfThreads > m_GlobalMaximumNumberOfThreads )
@@ -65,6 +64,14 @@ void MultiThreader::MultipleMethodExecute()
       }
     }
 
+  if ( m_UseThreadPool )
+    {
+    this->MultipleMethodExecuteOnThreadPool();
+    return;
+    }
+
+  std::vector< HANDLE > process_id(m_NumberOfThreads);
+
   // Using _beginthreadex on a PC
   //
   // We want to use _beginthreadex to start m_NumberOfThreads - 1
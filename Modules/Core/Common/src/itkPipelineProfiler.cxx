@@ -0,0 +1,470 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkPipelineProfiler.h"
+#include "itkProcessObject.h"
+#include "itkTimeProbesCollectorBase.h"
+#include <fstream>
+#include <sstream>
+
+namespace itk
+{
+PipelineProfiler::Pointer PipelineProfiler:: m_Instance = 0;
+bool                      PipelineProfiler:: m_Enabled = false;
+
+// Guards the lazy creation of the singleton.
+static SimpleFastMutexLock PipelineProfilerInstanceLock;
+
+class PipelineProfiler::ProbesCollector:public TimeProbesCollectorBase
+{
+public:
+  const MapType & GetProbes() const { return m_Probes; }
+};
+
+namespace
+{
+// Write a string as a JSON string literal.
+void WriteJSONString(std::ostream & os, const std::string & s)
+{
+  os << '"';
+  for ( std::string::const_iterator it = s.begin(); it != s.end(); ++it )
+    {
+    if ( *it == '"' || *it == '\\' )
+      {
+      os << '\\';
+      }
+    os << *it;
+    }
+  os << '"';
+}
+}
+
+PipelineProfiler::Pointer
+PipelineProfiler
+::GetInstance()
+{
+  PipelineProfilerInstanceLock.Lock();
+  if ( !PipelineProfiler::m_Instance )
+    {
+    PipelineProfiler::m_Instance = new PipelineProfiler;
+    // Remove extra reference from construction.
+    PipelineProfiler::m_Instance->UnRegister();
+    }
+  PipelineProfilerInstanceLock.Unlock();
+  return PipelineProfiler::m_Instance;
+}
+
+PipelineProfiler::Pointer
+PipelineProfiler
+::New()
+{
+  return GetInstance();
+}
+
+PipelineProfiler
+::PipelineProfiler()
+{
+  m_Clock = RealTimeClock::New();
+  m_Origin = m_Clock->GetTimeInSeconds();
+  m_GenerateDataProbes = new ProbesCollector;
+  m_OwnerThread = GetCurrentThreadIdentifier();
+  m_InThreadedSection = false;
+}
+
+PipelineProfiler
+::~PipelineProfiler()
+{
+  delete m_GenerateDataProbes;
+}
+
+const TimeProbesCollectorBase &
+PipelineProfiler
+::GetGenerateDataProbes() const
+{
+  return *m_GenerateDataProbes;
+}
+
+void
+PipelineProfiler
+::SetEnabled(bool enabled)
+{
+  if ( enabled )
+    {
+    // Create the instance now rather than in the middle of an update.
+    GetInstance();
+    }
+  m_Enabled = enabled;
+}
+
+PipelineProfiler::TimeStampType
+PipelineProfiler
+::GetTime() const
+{
+  return m_Clock->GetTimeInSeconds() - m_Origin;
+}
+
+PipelineProfiler::ThreadIdentifierType
+PipelineProfiler
+::GetCurrentThreadIdentifier()
+{
+#if defined(ITK_USE_PTHREADS)
+  return pthread_self();
+#elif defined(ITK_USE_WIN32_THREADS)
+  return GetCurrentThreadId();
+#else
+  return 0;
+#endif
+}
+
+bool
+PipelineProfiler
+::IsOwnerThread() const
+{
+#if defined(ITK_USE_PTHREADS)
+  return pthread_equal(m_OwnerThread, pthread_self()) != 0;
+#else
+  return m_OwnerThread == GetCurrentThreadIdentifier();
+#endif
+}
+
+std::string
+PipelineProfiler
+::GetFilterName(const ProcessObject *filter)
+{
+  std::ostringstream name;
+  name << filter->GetNameOfClass() << " (" << static_cast< const void * >( filter ) << ")";
+  return name.str();
+}
+
+void
+PipelineProfiler
+::StartUpdate(const ProcessObject *filter)
+{
+  const TimeStampType now = this->GetTime();
+
+  m_Lock.Lock();
+  if ( m_Stack.empty() )
+    {
+    m_OwnerThread = GetCurrentThreadIdentifier();
+    }
+  if ( !m_InThreadedSection && this->IsOwnerThread() )
+    {
+    Frame frame;
+    frame.Filter = filter;
+    frame.Path = GetFilterName(filter);
+    if ( !m_Stack.empty() )
+      {
+      frame.Path = m_Stack.back().Path + "/" + frame.Path;
+      }
+    frame.UpdateStart = now;
+    frame.GenerateDataStart = now;
+
+    NodeStatistics & node = m_Nodes[frame.Path];
+    if ( node.Name.empty() )
+      {
+      node.Name = GetFilterName(filter);
+      node.Depth = static_cast< unsigned int >( m_Stack.size() );
+      node.NumberOfExecutions = 0;
+      node.UpdateTime = 0.0;
+      node.ThreadBusyTime = 0.0;
+      node.ThreadIdleTime = 0.0;
+      node.BytesAllocated = 0;
+      }
+    m_Stack.push_back(frame);
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::StopUpdate(const ProcessObject *filter)
+{
+  const TimeStampType now = this->GetTime();
+
+  m_Lock.Lock();
+  // Updates by other threads than the owner were not recorded.
+  bool found = false;
+  if ( !m_Stack.empty() && this->IsOwnerThread() )
+    {
+    for ( size_t i = 0; i < m_Stack.size(); ++i )
+      {
+      found = found || m_Stack[i].Filter == filter;
+      }
+    }
+
+  // Pop the frames left open by an exception along with the filter's own.
+  while ( found && !m_Stack.empty() )
+    {
+    const Frame frame = m_Stack.back();
+    m_Stack.pop_back();
+
+    if ( m_InThreadedSection && m_Section.Filter == frame.Filter )
+      {
+      this->CloseThreadedSection(now);
+      }
+    m_Nodes[frame.Path].UpdateTime += now - frame.UpdateStart;
+
+    TraceEvent event;
+    event.Name = GetFilterName(frame.Filter);
+    event.Category = "UpdateOutputData";
+    event.Start = frame.UpdateStart;
+    event.Duration = now - frame.UpdateStart;
+    event.Thread = 0;
+    m_Events.push_back(event);
+
+    if ( frame.Filter == filter )
+      {
+      break;
+      }
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::StartGenerateData(const ProcessObject *filter)
+{
+  const TimeStampType now = this->GetTime();
+
+  m_Lock.Lock();
+  if ( !m_InThreadedSection && !m_Stack.empty() && this->IsOwnerThread()
+       && m_Stack.back().Filter == filter )
+    {
+    m_Stack.back().GenerateDataStart = now;
+    m_GenerateDataProbes->Start( m_Stack.back().Path.c_str() );
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::StopGenerateData(const ProcessObject *filter)
+{
+  const TimeStampType now = this->GetTime();
+
+  m_Lock.Lock();
+  if ( !m_Stack.empty() && this->IsOwnerThread() && m_Stack.back().Filter == filter )
+    {
+    const Frame & frame = m_Stack.back();
+    if ( m_InThreadedSection && m_Section.Filter == filter )
+      {
+      this->CloseThreadedSection(now);
+      }
+    m_GenerateDataProbes->Stop( frame.Path.c_str() );
+    ++m_Nodes[frame.Path].NumberOfExecutions;
+
+    TraceEvent event;
+    event.Name = GetFilterName(filter);
+    event.Category = "GenerateData";
+    event.Start = frame.GenerateDataStart;
+    event.Duration = now - frame.GenerateDataStart;
+    event.Thread = 0;
+    m_Events.push_back(event);
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::StartThreadedSection(const ProcessObject *filter, ThreadIdType numberOfThreads)
+{
+  const TimeStampType now = this->GetTime();
+
+  m_Lock.Lock();
+  if ( !m_InThreadedSection && !m_Stack.empty() && this->IsOwnerThread()
+       && m_Stack.back().Filter == filter )
+    {
+    m_InThreadedSection = true;
+    m_Section.Filter = filter;
+    m_Section.Path = m_Stack.back().Path;
+    m_Section.Start = now;
+    m_Section.BusyTime.assign(numberOfThreads, 0.0);
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::StopThreadedSection(const ProcessObject *filter)
+{
+  const TimeStampType now = this->GetTime();
+
+  m_Lock.Lock();
+  if ( m_InThreadedSection && m_Section.Filter == filter )
+    {
+    this->CloseThreadedSection(now);
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::CloseThreadedSection(TimeStampType stop)
+{
+  const TimeStampType wallTime = stop - m_Section.Start;
+  NodeStatistics &    node = m_Nodes[m_Section.Path];
+
+  for ( size_t i = 0; i < m_Section.BusyTime.size(); ++i )
+    {
+    node.ThreadBusyTime += m_Section.BusyTime[i];
+    if ( wallTime > m_Section.BusyTime[i] )
+      {
+      node.ThreadIdleTime += wallTime - m_Section.BusyTime[i];
+      }
+    }
+  m_InThreadedSection = false;
+}
+
+void
+PipelineProfiler
+::RecordThreadBusyTime(const ProcessObject *filter, ThreadIdType threadId,
+                       TimeStampType start, TimeStampType stop)
+{
+  m_Lock.Lock();
+  if ( m_InThreadedSection && m_Section.Filter == filter
+       && threadId < m_Section.BusyTime.size() )
+    {
+    m_Section.BusyTime[threadId] += stop - start;
+
+    TraceEvent event;
+    event.Name = GetFilterName(filter);
+    event.Category = "ThreadedGenerateData";
+    event.Start = start;
+    event.Duration = stop - start;
+    event.Thread = threadId + 1;
+    m_Events.push_back(event);
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::RecordAllocation(SizeValueType numberOfBytes)
+{
+  m_Lock.Lock();
+  if ( m_InThreadedSection )
+    {
+    m_Nodes[m_Section.Path].BytesAllocated += numberOfBytes;
+    }
+  else if ( !m_Stack.empty() )
+    {
+    m_Nodes[m_Stack.back().Path].BytesAllocated += numberOfBytes;
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::Clear()
+{
+  m_Lock.Lock();
+  m_GenerateDataProbes->Clear();
+  m_Nodes.clear();
+  m_Stack.clear();
+  m_Events.clear();
+  m_InThreadedSection = false;
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::Report(std::ostream & os) const
+{
+  m_Lock.Lock();
+  if ( m_Nodes.empty() )
+    {
+    os << "No pipeline updates have been recorded" << std::endl;
+    m_Lock.Unlock();
+    return;
+    }
+
+  os << "Execs   Update (s)   GenerateData (s)   Busy (s)   Idle (s)   Allocated (bytes)   Filter"
+     << std::endl;
+
+  const TimeProbesCollectorBase::MapType & probes = m_GenerateDataProbes->GetProbes();
+  for ( NodeStatisticsMapType::const_iterator it = m_Nodes.begin(); it != m_Nodes.end(); ++it )
+    {
+    const NodeStatistics & node = it->second;
+
+    TimeStampType generateDataTime = 0.0;
+    TimeProbesCollectorBase::MapType::const_iterator probe = probes.find(it->first);
+    if ( probe != probes.end() )
+      {
+      generateDataTime = probe->second.GetTotal();
+      }
+
+    os.width(5);
+    os << node.NumberOfExecutions << "   ";
+    os.width(10);
+    os << node.UpdateTime << "   ";
+    os.width(16);
+    os << generateDataTime << "   ";
+    os.width(8);
+    os << node.ThreadBusyTime << "   ";
+    os.width(8);
+    os << node.ThreadIdleTime << "   ";
+    os.width(17);
+    os << node.BytesAllocated << "   ";
+    os << std::string(2 * node.Depth, ' ') << node.Name << std::endl;
+    }
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::WriteChromeTrace(std::ostream & os) const
+{
+  m_Lock.Lock();
+  os << "{\"traceEvents\":[";
+  for ( size_t i = 0; i < m_Events.size(); ++i )
+    {
+    const TraceEvent & event = m_Events[i];
+    os << ( i == 0 ? "\n" : ",\n" );
+    os << "{\"name\":";
+    WriteJSONString(os, event.Name);
+    os << ",\"cat\":\"" << event.Category << "\",\"ph\":\"X\""
+       << ",\"ts\":" << static_cast< long long >( event.Start * 1.0e6 )
+       << ",\"dur\":" << static_cast< long long >( event.Duration * 1.0e6 )
+       << ",\"pid\":0,\"tid\":" << event.Thread << "}";
+    }
+  os << "\n],\"displayTimeUnit\":\"ms\"}" << std::endl;
+  m_Lock.Unlock();
+}
+
+void
+PipelineProfiler
+::WriteChromeTrace(const std::string & fileName) const
+{
+  std::ofstream file( fileName.c_str() );
+  if ( !file )
+    {
+    itkExceptionMacro(<< "Could not open " << fileName << " for writing");
+    }
+  this->WriteChromeTrace(file);
+}
+
+void
+PipelineProfiler
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Enabled: " << ( m_Enabled ? "On" : "Off" ) << std::endl;
+  os << indent << "Number Of Nodes: " << m_Nodes.size() << std::endl;
+  os << indent << "Number Of Events: " << m_Events.size() << std::endl;
+}
+} // end namespace itk
@@ -26,11 +26,45 @@
  *
  *=========================================================================*/
 #include "itkProcessObject.h"
+#include "itkPipelineProfiler.h"
 
 #include <stdio.h>
 
 namespace itk
 {
+namespace
+{
+/** Reports an UpdateOutputData() to the PipelineProfiler, closing it on
+ * every exit path, including exceptions thrown upstream. */
+class ProcessObjectProfilerGuard
+{
+public:
+  ProcessObjectProfilerGuard(const ProcessObject *filter):
+    m_Filter(filter), m_Profiler(0)
+  {
+    if ( PipelineProfiler::GetEnabled() )
+      {
+      m_Profiler = PipelineProfiler::GetInstance();
+      m_Profiler->StartUpdate(m_Filter);
+      }
+  }
+
+  ~ProcessObjectProfilerGuard()
+  {
+    if ( m_Profiler )
+      {
+      m_Profiler->StopUpdate(m_Filter);
+      }
+  }
+
+  PipelineProfiler * GetProfiler() const { return m_Profiler; }
+
+private:
+  const ProcessObject *m_Filter;
+  PipelineProfiler *   m_Profiler;
+};
+}
+
 /**
  * Instantiate object with no start, end, or progress methods.
  */
@@ -1442,6 +1476,9 @@ ProcessObject
     return;
     }
 
+  ProcessObjectProfilerGuard profilerGuard(this);
+  PipelineProfiler *         profiler = profilerGuard.GetProfiler();
+
   /**
    * Prepare all the outputs. This may deallocate previous bulk data.
    */
@@ -1495,6 +1532,11 @@ ProcessObject
   m_AbortGenerateData = false;
   m_Progress = 0.0f;
 
+  if ( profiler )
+    {
+    profiler->StartGenerateData(this);
+    }
+
   try
     {
     this->GenerateData();
@@ -1513,6 +1555,11 @@ ProcessObject
     throw;
     }
 
+  if ( profiler )
+    {
+    profiler->StopGenerateData(this);
+    }
+
   /**
    * If we ended due to aborting, push the progress up to 1.0 (since
    * it probably didn't end there)
@@ -0,0 +1,318 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkThreadPool.h"
+#include "itkMultiThreader.h"
+
+#if defined(ITK_USE_PTHREADS)
+#include "itkThreadPoolPThreads.cxx"
+#elif defined(ITK_USE_WIN32_THREADS)
+#include "itkThreadPoolWinThreads.cxx"
+#else
+#include "itkThreadPoolNoThreads.cxx"
+#endif
+
+namespace itk
+{
+ThreadPool::Pointer ThreadPool:: m_Instance = 0;
+
+// Guards the lazy creation of the singleton.
+static SimpleFastMutexLock ThreadPoolInstanceLock;
+
+ThreadPool::Pointer
+ThreadPool
+::GetInstance()
+{
+  ThreadPoolInstanceLock.Lock();
+  if ( !ThreadPool::m_Instance )
+    {
+    ThreadPool::m_Instance = new ThreadPool;
+    // Remove extra reference from construction.
+    ThreadPool::m_Instance->UnRegister();
+    }
+  ThreadPoolInstanceLock.Unlock();
+  return ThreadPool::m_Instance;
+}
+
+ThreadPool::Pointer
+ThreadPool
+::New()
+{
+  return GetInstance();
+}
+
+ThreadPool
+::ThreadPool()
+{
+  m_WorkAvailable = ConditionVariable::New();
+  m_JobsCompleted = ConditionVariable::New();
+  m_NumberOfPendingJobs = 0;
+  m_NumberOfIdleWorkers = 0;
+  m_NextQueue = 0;
+  m_Stopping = false;
+
+  const ThreadIdType numberOfQueues = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  for ( ThreadIdType i = 0; i < numberOfQueues; ++i )
+    {
+    m_Queues.push_back( new JobQueue );
+    }
+}
+
+ThreadPool
+::~ThreadPool()
+{
+  m_Mutex.Lock();
+  m_Stopping = true;
+  m_WorkAvailable->Broadcast();
+  m_Mutex.Unlock();
+
+  for ( size_t i = 0; i < m_Workers.size(); ++i )
+    {
+    this->JoinWorkerThread(m_Workers[i]->ThreadHandle);
+    delete m_Workers[i];
+    }
+  for ( size_t i = 0; i < m_Queues.size(); ++i )
+    {
+    delete m_Queues[i];
+    }
+}
+
+void
+ThreadPool
+::AddJob(ThreadFunctionType function, void *data, JobGroup & group)
+{
+  ThreadJob job;
+  job.ThreadFunction = function;
+  job.UserData = data;
+  job.Group = &group;
+
+  m_Mutex.Lock();
+  JobQueue *queue = m_Queues[m_NextQueue];
+  m_NextQueue = ( m_NextQueue + 1 ) % static_cast< ThreadIdType >( m_Queues.size() );
+
+  queue->Lock.Lock();
+  queue->Jobs.push_back(job);
+  queue->Lock.Unlock();
+
+  ++group.m_NumberOfRemainingJobs;
+  ++m_NumberOfPendingJobs;
+
+  // Make sure that each pending job can be picked up right away, so that
+  // the jobs of one execution always run concurrently.
+  try
+    {
+    while ( m_NumberOfIdleWorkers < m_NumberOfPendingJobs )
+      {
+      this->AddWorker();
+      }
+    }
+  catch ( ... )
+    {
+    // The job stays queued; it will be run by the submitting thread in
+    // WaitForJobs().
+    }
+  m_WorkAvailable->Signal();
+  m_Mutex.Unlock();
+}
+
+void
+ThreadPool
+::WaitForJobs(JobGroup & group)
+{
+  m_Mutex.Lock();
+  while ( group.m_NumberOfRemainingJobs > 0 )
+    {
+    if ( m_NumberOfPendingJobs > 0 )
+      {
+      // Help instead of sleeping.
+      --m_NumberOfPendingJobs;
+      m_Mutex.Unlock();
+      this->RunJob( this->DequeueJob(0) );
+      }
+    else
+      {
+      m_JobsCompleted->Wait(&m_Mutex);
+      }
+    }
+  m_Mutex.Unlock();
+
+  // No job of the group is left to touch it.
+  if ( group.m_ExceptionOccurred )
+    {
+    group.m_ExceptionOccurred = false;
+    throw group.m_Exception;
+    }
+}
+
+ThreadIdType
+ThreadPool
+::GetNumberOfWorkerThreads() const
+{
+  m_Mutex.Lock();
+  const ThreadIdType numberOfWorkers = static_cast< ThreadIdType >( m_Workers.size() );
+  m_Mutex.Unlock();
+  return numberOfWorkers;
+}
+
+ThreadIdType
+ThreadPool
+::GetNumberOfQueues() const
+{
+  return static_cast< ThreadIdType >( m_Queues.size() );
+}
+
+void
+ThreadPool
+::AddWorker()
+{
+  WorkerInfo *info = new WorkerInfo;
+  info->Pool = this;
+  info->QueueIndex = static_cast< ThreadIdType >( m_Workers.size() % m_Queues.size() );
+  try
+    {
+    info->ThreadHandle = this->SpawnWorkerThread(info);
+    }
+  catch ( ... )
+    {
+    delete info;
+    throw;
+    }
+  m_Workers.push_back(info);
+  ++m_NumberOfIdleWorkers;
+}
+
+ThreadPool::ThreadJob
+ThreadPool
+::DequeueJob(ThreadIdType home)
+{
+  const ThreadIdType numberOfQueues = static_cast< ThreadIdType >( m_Queues.size() );
+  ThreadJob job;
+
+  // A job has been reserved, so the loop terminates once the job that
+  // was counted for us has been pushed into one of the queues.
+  while ( true )
+    {
+    JobQueue *own = m_Queues[home];
+    own->Lock.Lock();
+    if ( !own->Jobs.empty() )
+      {
+      job = own->Jobs.back();
+      own->Jobs.pop_back();
+      own->Lock.Unlock();
+      return job;
+      }
+    own->Lock.Unlock();
+
+    for ( ThreadIdType i = 1; i < numberOfQueues; ++i )
+      {
+      JobQueue *victim = m_Queues[( home + i ) % numberOfQueues];
+      victim->Lock.Lock();
+      if ( !victim->Jobs.empty() )
+        {
+        job = victim->Jobs.front();
+        victim->Jobs.pop_front();
+        victim->Lock.Unlock();
+        return job;
+        }
+      victim->Lock.Unlock();
+      }
+    }
+}
+
+void
+ThreadPool
+::RunJob(const ThreadJob & job)
+{
+  // Exceptions must not escape into the worker loop: they are handed to
+  // the thread waiting for the group instead.
+  bool            exceptionOccurred = false;
+  ExceptionObject exception;
+  try
+    {
+    ( *job.ThreadFunction )(job.UserData);
+    }
+  catch ( ExceptionObject & e )
+    {
+    exceptionOccurred = true;
+    exception = e;
+    }
+  catch ( std::exception & e )
+    {
+    exceptionOccurred = true;
+    exception = ExceptionObject(__FILE__, __LINE__, e.what(), ITK_LOCATION);
+    }
+  catch ( ... )
+    {
+    exceptionOccurred = true;
+    exception = ExceptionObject(__FILE__, __LINE__, "Unknown exception thrown by a thread pool job",
+                                ITK_LOCATION);
+    }
+
+  m_Mutex.Lock();
+  if ( exceptionOccurred && !job.Group->m_ExceptionOccurred )
+    {
+    job.Group->m_ExceptionOccurred = true;
+    job.Group->m_Exception = exception;
+    }
+  if ( --job.Group->m_NumberOfRemainingJobs == 0 )
+    {
+    m_JobsCompleted->Broadcast();
+    }
+}
+
+ITK_THREAD_RETURN_TYPE
+ThreadPool
+::WorkerThreadEntry(void *arg)
+{
+  WorkerInfo *info = static_cast< WorkerInfo * >( arg );
+  ThreadPool *pool = info->Pool;
+
+  pool->m_Mutex.Lock();
+  while ( true )
+    {
+    while ( pool->m_NumberOfPendingJobs == 0 && !pool->m_Stopping )
+      {
+      pool->m_WorkAvailable->Wait(&pool->m_Mutex);
+      }
+    if ( pool->m_NumberOfPendingJobs == 0 )
+      {
+      break;
+      }
+    --pool->m_NumberOfPendingJobs;
+    --pool->m_NumberOfIdleWorkers;
+    pool->m_Mutex.Unlock();
+
+    pool->RunJob( pool->DequeueJob(info->QueueIndex) );
+    ++pool->m_NumberOfIdleWorkers;
+    }
+  pool->m_Mutex.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+void
+ThreadPool
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number Of Queues: " << m_Queues.size() << std::endl;
+  os << indent << "Number Of Worker Threads: " << m_Workers.size() << std::endl;
+  os << indent << "Number Of Idle Workers: " << m_NumberOfIdleWorkers << std::endl;
+  os << indent << "Number Of Pending Jobs: " << m_NumberOfPendingJobs << std::endl;
+}
+} // end namespace itk
@@ -0,0 +1,205 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageBufferAllocator.h"
+#include "itkImage.h"
+#include "itkVectorImage.h"
+#include "itkSimpleFastMutexLock.h"
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace
+{
+typedef std::pair< itk::SizeValueType, itk::SizeValueType > RangeType;
+
+itk::SimpleFastMutexLock RangesLock;
+std::vector< RangeType > Ranges;
+
+void RecordRange(void *, itk::SizeValueType begin, itk::SizeValueType end)
+{
+  RangesLock.Lock();
+  Ranges.push_back( RangeType(begin, end) );
+  RangesLock.Unlock();
+}
+
+bool IsAligned(const void *ptr, itk::SizeValueType alignment)
+{
+  return reinterpret_cast< size_t >( ptr ) % alignment == 0;
+}
+}
+
+int itkImageBufferAllocatorTest(int, char *[])
+{
+  bool result = true;
+
+  itk::ImageBufferAllocator::Pointer allocator = itk::ImageBufferAllocator::New();
+  allocator->SetNumberOfThreads(4);
+  allocator->ParallelFirstTouchOn();
+  allocator->Print(std::cout);
+
+  // Invalid alignments are rejected.
+  bool caught = false;
+  try
+    {
+    allocator->SetAlignment(48);
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  if ( !caught )
+    {
+    std::cerr << "An alignment of 48 bytes was accepted" << std::endl;
+    result = false;
+    }
+
+  // The pieces initialized in parallel are the slabs ImageSource would
+  // give to each thread: 20 slices of 100 elements over 4 threads.
+  Ranges.clear();
+  allocator->InitializeBuffer(0, 2000, 100, RecordRange);
+  std::sort( Ranges.begin(), Ranges.end() );
+  if ( Ranges.size() != 4 )
+    {
+    std::cerr << "Expected 4 pieces, got " << Ranges.size() << std::endl;
+    result = false;
+    }
+  for ( unsigned int i = 0; i < Ranges.size(); ++i )
+    {
+    std::cout << "Piece [" << Ranges[i].first << ", " << Ranges[i].second << ")" << std::endl;
+    if ( Ranges[i].first != i * 500 || Ranges[i].second != ( i + 1 ) * 500 )
+      {
+      std::cerr << "Unexpected piece" << std::endl;
+      result = false;
+      }
+    }
+
+  // 6 slices over 4 threads are split into 3 pieces of 2 slices.
+  Ranges.clear();
+  allocator->InitializeBuffer(0, 600, 100, RecordRange);
+  if ( Ranges.size() != 3 )
+    {
+    std::cerr << "Expected 3 pieces, got " << Ranges.size() << std::endl;
+    result = false;
+    }
+
+  // Images created while the allocator is the global default use it.
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(allocator);
+
+  typedef itk::Image< float, 3 > ImageType;
+  ImageType::Pointer image = ImageType::New();
+  ImageType::SizeType size;
+  size.Fill(20);
+  image->SetRegions(size);
+  image->Allocate();
+  if ( image->GetPixelContainer()->GetBufferAllocator() != allocator.GetPointer()
+       || image->GetPixelContainer()->GetNumberOfElementsPerSlice() != 400 )
+    {
+    std::cerr << "The image buffer was not set up by the allocator" << std::endl;
+    result = false;
+    }
+  if ( !IsAligned(image->GetBufferPointer(), 64) )
+    {
+    std::cerr << "The image buffer is not aligned" << std::endl;
+    result = false;
+    }
+  const ImageType::PixelType *pixels = image->GetBufferPointer();
+  for ( itk::SizeValueType i = 0; i < image->GetPixelContainer()->Size(); ++i )
+    {
+    if ( pixels[i] != 0 )
+      {
+      std::cerr << "The first touch did not zero the buffer" << std::endl;
+      result = false;
+      break;
+      }
+    }
+
+  // The allocator survives Initialize().
+  image->Initialize();
+  if ( image->GetPixelContainer()->GetBufferAllocator() != allocator.GetPointer() )
+    {
+    std::cerr << "Initialize() dropped the allocator" << std::endl;
+    result = false;
+    }
+
+  typedef itk::VectorImage< float, 3 > VectorImageType;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetVectorLength(3);
+  vectorImage->SetRegions(size);
+  vectorImage->Allocate();
+  if ( !IsAligned(vectorImage->GetBufferPointer(), 64)
+       || vectorImage->GetPixelContainer()->GetNumberOfElementsPerSlice() != 1200 )
+    {
+    std::cerr << "The vector image buffer was not set up by the allocator" << std::endl;
+    result = false;
+    }
+
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(0);
+
+  // Growing a container copies the elements into the new buffer.
+  typedef itk::ImportImageContainer< itk::SizeValueType, int > IntContainerType;
+  IntContainerType::Pointer intContainer = IntContainerType::New();
+  intContainer->SetBufferAllocator(allocator);
+  intContainer->Reserve(10);
+  for ( int i = 0; i < 10; ++i )
+    {
+    ( *intContainer )[i] = i;
+    }
+  intContainer->Reserve(1000);
+  for ( int i = 0; i < 10; ++i )
+    {
+    if ( ( *intContainer )[i] != i )
+      {
+      std::cerr << "Reserve() lost the content of the container" << std::endl;
+      result = false;
+      break;
+      }
+    }
+
+  // Huge pages imply huge page alignment for large buffers.
+  allocator->UseHugePagesOn();
+  allocator->ParallelFirstTouchOff();
+  intContainer->Reserve(itk::ImageBufferAllocator::GetHugePageSize());
+  if ( !IsAligned( intContainer->GetBufferPointer(), itk::ImageBufferAllocator::GetHugePageSize() ) )
+    {
+    std::cerr << "The huge page buffer is not aligned to the huge page size" << std::endl;
+    result = false;
+    }
+  intContainer->Print(std::cout);
+
+  // Elements with constructors and destructors.
+  typedef itk::ImportImageContainer< itk::SizeValueType, std::string > StringContainerType;
+  StringContainerType::Pointer stringContainer = StringContainerType::New();
+  stringContainer->SetBufferAllocator(allocator);
+  stringContainer->Reserve(50);
+  ( *stringContainer )[4] = "a string that does not fit in a small string buffer";
+  if ( !( *stringContainer )[49].empty() )
+    {
+    std::cerr << "The string elements were not constructed" << std::endl;
+    result = false;
+    }
+  stringContainer->Initialize();
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
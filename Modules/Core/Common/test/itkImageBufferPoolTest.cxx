@@ -0,0 +1,125 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageBufferPool.h"
+#include "itkImage.h"
+
+int itkImageBufferPoolTest(int, char *[])
+{
+  bool result = true;
+
+  // Bucket sizes waste at most 25%.
+  const itk::SizeValueType requests[] = { 1, 4096, 5000, 20000, 100000, 1000000, 123456789 };
+  for ( unsigned int i = 0; i < sizeof( requests ) / sizeof( requests[0] ); ++i )
+    {
+    const itk::SizeValueType bucketSize = itk::ImageBufferPool::GetBucketSize(requests[i]);
+    std::cout << requests[i] << " bytes -> bucket of " << bucketSize << std::endl;
+    if ( bucketSize < requests[i]
+         || ( requests[i] > 16384 && bucketSize - requests[i] >= requests[i] / 4 ) )
+      {
+      std::cerr << "Bad bucket size" << std::endl;
+      result = false;
+      }
+    }
+
+  itk::ImageBufferPool::Pointer pool = itk::ImageBufferPool::New();
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(pool);
+
+  typedef itk::Image< float, 3 > ImageType;
+  ImageType::SizeType size;
+  size.Fill(64);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  float *firstBuffer = image->GetBufferPointer();
+
+  // Releasing the data returns the buffer to the pool...
+  image->ReleaseData();
+  if ( pool->GetNumberOfCachedBuffers() != 1
+       || pool->GetCachedBytes() != itk::ImageBufferPool::GetBucketSize(64 * 64 * 64 * sizeof( float ) ) )
+    {
+    std::cerr << "ReleaseData() did not return the buffer to the pool" << std::endl;
+    result = false;
+    }
+
+  // ... and the next allocation of the same size reuses it.
+  image->SetRegions(size);
+  image->Allocate();
+  if ( image->GetBufferPointer() != firstBuffer || pool->GetNumberOfHits() != 1
+       || pool->GetNumberOfMisses() != 1 || pool->GetNumberOfCachedBuffers() != 0 )
+    {
+    std::cerr << "The cached buffer was not reused" << std::endl;
+    result = false;
+    }
+
+  // Buffers exceeding the cap are freed instead of cached.
+  pool->SetMaximumCachedBytes(1024);
+  image = 0;
+  if ( pool->GetNumberOfCachedBuffers() != 0 )
+    {
+    std::cerr << "The pool exceeded its cap" << std::endl;
+    result = false;
+    }
+  pool->SetMaximumCachedBytes(100 * 1024 * 1024);
+
+  // Several images released at once are all kept and trimmed on request.
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    ImageType::Pointer temporary = ImageType::New();
+    ImageType::SizeType temporarySize;
+    temporarySize.Fill(16 * ( i + 1 ));
+    temporary->SetRegions(temporarySize);
+    temporary->Allocate();
+    }
+  std::cout << "Cached bytes: " << pool->GetCachedBytes() << std::endl;
+  if ( pool->GetNumberOfCachedBuffers() != 3 )
+    {
+    std::cerr << "Expected 3 cached buffers" << std::endl;
+    result = false;
+    }
+  pool->Trim(200000);
+  if ( pool->GetCachedBytes() > 200000 || pool->GetNumberOfCachedBuffers() != 2 )
+    {
+    std::cerr << "Trim() did not free the largest buffer" << std::endl;
+    result = false;
+    }
+  pool->Print(std::cout);
+  pool->Trim();
+  if ( pool->GetCachedBytes() != 0 || pool->GetNumberOfCachedBuffers() != 0 )
+    {
+    std::cerr << "Trim() did not empty the pool" << std::endl;
+    result = false;
+    }
+
+  pool->ResetStatistics();
+  if ( pool->GetNumberOfHits() != 0 || pool->GetNumberOfMisses() != 0 )
+    {
+    std::cerr << "ResetStatistics() failed" << std::endl;
+    result = false;
+    }
+
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(0);
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSource.h"
+#include "itkImageRegionIterator.h"
+
+namespace itk
+{
+/** A source that counts how often each output pixel is visited and how
+ * many pixels each thread has processed. */
+template< class TOutputImage >
+class ImageSourceDynamicMultiThreadingTestSource:
+  public ImageSource< TOutputImage >
+{
+public:
+  typedef ImageSourceDynamicMultiThreadingTestSource Self;
+  typedef ImageSource< TOutputImage >                Superclass;
+  typedef SmartPointer< Self >                       Pointer;
+  typedef SmartPointer< const Self >                 ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ImageSourceDynamicMultiThreadingTestSource, ImageSource);
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  std::vector< SizeValueType > m_PixelsPerThread;
+
+protected:
+  ImageSourceDynamicMultiThreadingTestSource() {}
+
+  virtual void GenerateOutputInformation()
+  {
+    typename TOutputImage::SizeType size;
+    size.Fill(20);
+    typename TOutputImage::RegionType region;
+    region.SetSize(size);
+    this->GetOutput()->SetLargestPossibleRegion(region);
+  }
+
+  virtual void BeforeThreadedGenerateData()
+  {
+    this->GetOutput()->FillBuffer(0);
+    m_PixelsPerThread.assign(this->GetNumberOfThreads(), 0);
+  }
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & region, ThreadIdType threadId)
+  {
+    ImageRegionIterator< TOutputImage > it(this->GetOutput(), region);
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set( it.Get() + 1 );
+      }
+    m_PixelsPerThread[threadId] += region.GetNumberOfPixels();
+  }
+
+private:
+  ImageSourceDynamicMultiThreadingTestSource(const Self &); //purposely not implemented
+  void operator=(const Self &);                             //purposely not implemented
+};
+}
+
+int itkImageSourceDynamicMultiThreadingTest(int, char *[])
+{
+  typedef itk::Image< unsigned short, 3 >                           ImageType;
+  typedef itk::ImageSourceDynamicMultiThreadingTestSource< ImageType > SourceType;
+
+  SourceType::Pointer source = SourceType::New();
+  source->SetNumberOfThreads(4);
+  source->DynamicMultiThreadingOn();
+  source->SetNumberOfChunksPerThread(3);
+  source->Update();
+
+  bool result = true;
+
+  ImageType::Pointer output = source->GetOutput();
+  itk::ImageRegionIterator< ImageType > it( output, output->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != 1 )
+      {
+      std::cerr << "Pixel " << it.GetIndex() << " was visited " << it.Get() << " times" << std::endl;
+      result = false;
+      break;
+      }
+    }
+
+  const SourceType::ChunkInformationContainerType & chunks = source->GetChunkInformation();
+  std::cout << "Number of chunks: " << chunks.size() << std::endl;
+  // 20 slices split into at most 4 * 3 pieces of 2 slices each
+  if ( chunks.size() != 10 )
+    {
+    std::cerr << "Expected 10 chunks" << std::endl;
+    result = false;
+    }
+
+  itk::SizeValueType chunkPixels = 0;
+  for ( unsigned int i = 0; i < chunks.size(); ++i )
+    {
+    std::cout << "  " << chunks[i].Region.GetIndex() << " " << chunks[i].Region.GetSize()
+              << " thread " << chunks[i].ThreadId << " " << chunks[i].ElapsedTime << " s" << std::endl;
+    chunkPixels += chunks[i].Region.GetNumberOfPixels();
+    if ( chunks[i].ThreadId >= source->GetNumberOfThreads() )
+      {
+      std::cerr << "Invalid thread id " << chunks[i].ThreadId << std::endl;
+      result = false;
+      }
+    }
+
+  itk::SizeValueType threadPixels = 0;
+  for ( unsigned int i = 0; i < source->m_PixelsPerThread.size(); ++i )
+    {
+    threadPixels += source->m_PixelsPerThread[i];
+    }
+
+  const itk::SizeValueType numberOfPixels = output->GetBufferedRegion().GetNumberOfPixels();
+  if ( chunkPixels != numberOfPixels || threadPixels != numberOfPixels )
+    {
+    std::cerr << "The chunks do not cover the requested region" << std::endl;
+    result = false;
+    }
+
+  // More chunks requested than the region can be split into.
+  source->SetNumberOfChunksPerThread(100);
+  source->Modified();
+  source->Update();
+  if ( source->GetChunkInformation().size() != 20 )
+    {
+    std::cerr << "Expected the split to be limited to 20 chunks, got "
+              << source->GetChunkInformation().size() << std::endl;
+    result = false;
+    }
+
+  source->Print(std::cout);
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,277 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPipelineProfiler.h"
+#include "itkTimeProbesCollectorBase.h"
+#include "itkImageToImageFilter.h"
+#include "itkImageRegionIterator.h"
+#include "itkMultiThreader.h"
+#include <sstream>
+
+namespace itk
+{
+/** A source producing an image of ones. */
+template< class TOutputImage >
+class PipelineProfilerTestSource:public ImageSource< TOutputImage >
+{
+public:
+  typedef PipelineProfilerTestSource  Self;
+  typedef ImageSource< TOutputImage > Superclass;
+  typedef SmartPointer< Self >        Pointer;
+  typedef SmartPointer< const Self >  ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(PipelineProfilerTestSource, ImageSource);
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+protected:
+  PipelineProfilerTestSource() {}
+
+  virtual void GenerateOutputInformation()
+  {
+    typename TOutputImage::SizeType size;
+    size.Fill(20);
+    typename TOutputImage::RegionType region;
+    region.SetSize(size);
+    this->GetOutput()->SetLargestPossibleRegion(region);
+  }
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & region, ThreadIdType)
+  {
+    ImageRegionIterator< TOutputImage > it(this->GetOutput(), region);
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      it.Set(1);
+      }
+  }
+
+private:
+  PipelineProfilerTestSource(const Self &); //purposely not implemented
+  void operator=(const Self &);             //purposely not implemented
+};
+
+/** A filter adding one to its input. */
+template< class TImage >
+class PipelineProfilerTestFilter:public ImageToImageFilter< TImage, TImage >
+{
+public:
+  typedef PipelineProfilerTestFilter          Self;
+  typedef ImageToImageFilter< TImage, TImage > Superclass;
+  typedef SmartPointer< Self >                Pointer;
+  typedef SmartPointer< const Self >          ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(PipelineProfilerTestFilter, ImageToImageFilter);
+
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+protected:
+  PipelineProfilerTestFilter() {}
+
+  virtual void ThreadedGenerateData(const OutputImageRegionType & region, ThreadIdType)
+  {
+    ImageRegionConstIterator< TImage > in(this->GetInput(), region);
+    ImageRegionIterator< TImage >      out(this->GetOutput(), region);
+    for ( in.GoToBegin(), out.GoToBegin(); !out.IsAtEnd(); ++in, ++out )
+      {
+      out.Set( in.Get() + 1 );
+      }
+  }
+
+private:
+  PipelineProfilerTestFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);             //purposely not implemented
+};
+
+/** A source updating a pipeline in each of its threads, outside of a
+ * threaded section, like ImageSeriesReader does. */
+template< class TOutputImage >
+class PipelineProfilerTestConcurrentSource:public ImageSource< TOutputImage >
+{
+public:
+  typedef PipelineProfilerTestConcurrentSource Self;
+  typedef ImageSource< TOutputImage >          Superclass;
+  typedef SmartPointer< Self >                 Pointer;
+  typedef SmartPointer< const Self >           ConstPointer;
+
+  itkNewMacro(Self);
+  itkTypeMacro(PipelineProfilerTestConcurrentSource, ImageSource);
+
+protected:
+  PipelineProfilerTestConcurrentSource() {}
+
+  virtual void GenerateOutputInformation()
+  {
+    typename TOutputImage::SizeType size;
+    size.Fill(2);
+    typename TOutputImage::RegionType region;
+    region.SetSize(size);
+    this->GetOutput()->SetLargestPossibleRegion(region);
+  }
+
+  virtual void GenerateData()
+  {
+    this->AllocateOutputs();
+    for ( unsigned int i = 0; i < 4; ++i )
+      {
+      m_Sources.push_back( PipelineProfilerTestSource< TOutputImage >::New() );
+      m_Sources.back()->SetNumberOfThreads(1);
+      }
+    MultiThreader::Pointer threader = MultiThreader::New();
+    threader->SetNumberOfThreads(4);
+    threader->SetSingleMethod(UpdateSource, this);
+    threader->SingleMethodExecute();
+  }
+
+  static ITK_THREAD_RETURN_TYPE UpdateSource(void *arg)
+  {
+    MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+    Self *self = static_cast< Self * >( info->UserData );
+    self->m_Sources[info->ThreadID]->Update();
+    return ITK_THREAD_RETURN_VALUE;
+  }
+
+private:
+  PipelineProfilerTestConcurrentSource(const Self &); //purposely not implemented
+  void operator=(const Self &);                       //purposely not implemented
+
+  std::vector< typename PipelineProfilerTestSource< TOutputImage >::Pointer > m_Sources;
+};
+}
+
+int itkPipelineProfilerTest(int argc, char *argv[])
+{
+  typedef itk::Image< unsigned short, 3 >                ImageType;
+  typedef itk::PipelineProfilerTestSource< ImageType > SourceType;
+  typedef itk::PipelineProfilerTestFilter< ImageType > FilterType;
+  typedef itk::PipelineProfiler                         ProfilerType;
+
+  bool result = true;
+
+  SourceType::Pointer source = SourceType::New();
+  source->SetNumberOfThreads(2);
+  FilterType::Pointer filter = FilterType::New();
+  filter->SetInput( source->GetOutput() );
+  filter->SetNumberOfThreads(2);
+
+  ProfilerType::EnabledOn();
+  ProfilerType::Pointer profiler = ProfilerType::GetInstance();
+  filter->Update();
+  // Only the filter re-executes.
+  filter->Modified();
+  filter->Update();
+
+  // Nothing is recorded while the profiler is disabled.
+  ProfilerType::EnabledOff();
+  source->Modified();
+  filter->Update();
+
+  profiler->Report(std::cout);
+
+  const ProfilerType::NodeStatisticsMapType & nodes = profiler->GetNodeStatistics();
+  if ( nodes.size() != 2 )
+    {
+    std::cerr << "Expected 2 nodes in the call tree, got " << nodes.size() << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const itk::TimeProbesCollectorBase & probes = profiler->GetGenerateDataProbes();
+  for ( ProfilerType::NodeStatisticsMapType::const_iterator it = nodes.begin(); it != nodes.end(); ++it )
+    {
+    const ProfilerType::NodeStatistics & node = it->second;
+    const bool isFilter = ( node.Depth == 0 );
+    if ( isFilter != ( node.Name.find("PipelineProfilerTestFilter") == 0 ) )
+      {
+      std::cerr << "The source is not a child of the filter: " << it->first << std::endl;
+      result = false;
+      }
+
+    const itk::SizeValueType expectedExecutions = isFilter ? 2 : 1;
+    if ( node.NumberOfExecutions != expectedExecutions )
+      {
+      std::cerr << node.Name << " executed " << node.NumberOfExecutions << " times" << std::endl;
+      result = false;
+      }
+
+    // The outputs are allocated by the first execution and reused after.
+    if ( node.BytesAllocated != 20 * 20 * 20 * sizeof( ImageType::PixelType ) )
+      {
+      std::cerr << node.Name << " allocated " << node.BytesAllocated << " bytes" << std::endl;
+      result = false;
+      }
+    if ( node.UpdateTime <= 0.0 || node.ThreadBusyTime < 0.0 || node.ThreadIdleTime < 0.0 )
+      {
+      std::cerr << node.Name << " has invalid timings" << std::endl;
+      result = false;
+      }
+    }
+  probes.Report(std::cout);
+
+  std::ostringstream trace;
+  profiler->WriteChromeTrace(trace);
+  const std::string json = trace.str();
+  if ( json.find("{\"traceEvents\":[") != 0
+       || json.find("\"cat\":\"ThreadedGenerateData\"") == std::string::npos
+       || json.find("\"tid\":2") == std::string::npos )
+    {
+    std::cerr << "Unexpected trace:" << std::endl << json << std::endl;
+    result = false;
+    }
+  if ( argc > 1 )
+    {
+    profiler->WriteChromeTrace( std::string(argv[1]) );
+    }
+
+  profiler->Clear();
+  if ( !profiler->GetNodeStatistics().empty() )
+    {
+    std::cerr << "Clear() failed" << std::endl;
+    result = false;
+    }
+
+  // Pipelines updated by other threads than the one that started the
+  // update are not recorded; the calling thread runs the first thread.
+  typedef itk::PipelineProfilerTestConcurrentSource< ImageType > ConcurrentSourceType;
+  ConcurrentSourceType::Pointer concurrentSource = ConcurrentSourceType::New();
+  ProfilerType::EnabledOn();
+  concurrentSource->Update();
+  ProfilerType::EnabledOff();
+  profiler->Report(std::cout);
+  if ( nodes.size() != 2 )
+    {
+    std::cerr << "Expected 2 nodes for the concurrent updates, got " << nodes.size() << std::endl;
+    result = false;
+    }
+  for ( ProfilerType::NodeStatisticsMapType::const_iterator it = nodes.begin(); it != nodes.end(); ++it )
+    {
+    const bool isRoot = ( it->second.Name.find("PipelineProfilerTestConcurrentSource") == 0 );
+    if ( it->second.Depth != ( isRoot ? 0u : 1u ) || it->second.NumberOfExecutions != 1 )
+      {
+      std::cerr << "Unexpected node for the concurrent updates: " << it->first << std::endl;
+      result = false;
+      }
+    }
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
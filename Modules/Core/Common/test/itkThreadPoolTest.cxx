@@ -0,0 +1,237 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkThreadPool.h"
+#include "itkMultiThreader.h"
+#include "itkBarrier.h"
+
+class ThreadPoolTestUserData
+{
+public:
+  itk::SimpleFastMutexLock  m_Lock;
+  std::vector< unsigned int > m_Calls;
+  itk::Barrier::Pointer     m_Barrier;
+  bool                      m_Nested;
+  bool                      m_Failure;
+
+  ThreadPoolTestUserData(unsigned int numberOfThreads)
+  {
+    m_Calls.resize(numberOfThreads, 0);
+    m_Barrier = itk::Barrier::New();
+    m_Barrier->Initialize(numberOfThreads);
+    m_Nested = false;
+    m_Failure = false;
+  }
+};
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestCount( void *ptr )
+{
+  itk::MultiThreader::ThreadInfoStruct *info = (itk::MultiThreader::ThreadInfoStruct *)(ptr);
+  ThreadPoolTestUserData *data = static_cast< ThreadPoolTestUserData * >( info->UserData );
+
+  data->m_Lock.Lock();
+  if ( info->ThreadID >= data->m_Calls.size()
+       || info->NumberOfThreads != data->m_Calls.size() )
+    {
+    data->m_Failure = true;
+    }
+  else
+    {
+    data->m_Calls[info->ThreadID]++;
+    }
+  data->m_Lock.Unlock();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestBarrier( void *ptr )
+{
+  ThreadPoolTestCount(ptr);
+
+  // Every job of the execution has to run concurrently to get past here.
+  ThreadPoolTestUserData *data = static_cast< ThreadPoolTestUserData * >(
+    ( (itk::MultiThreader::ThreadInfoStruct *)(ptr) )->UserData );
+  data->m_Barrier->Wait();
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestNested( void *ptr )
+{
+  ThreadPoolTestCount(ptr);
+
+  ThreadPoolTestUserData *outer = static_cast< ThreadPoolTestUserData * >(
+    ( (itk::MultiThreader::ThreadInfoStruct *)(ptr) )->UserData );
+
+  ThreadPoolTestUserData inner(3);
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->UseThreadPoolOn();
+  threader->SetNumberOfThreads(3);
+  threader->SetSingleMethod(ThreadPoolTestCount, &inner);
+  threader->SingleMethodExecute();
+  for ( unsigned int i = 0; i < inner.m_Calls.size(); i++ )
+    {
+    if ( inner.m_Calls[i] != 1 )
+      {
+      outer->m_Failure = true;
+      }
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+ITK_THREAD_RETURN_TYPE ThreadPoolTestThrow( void *ptr )
+{
+  if ( ( (itk::MultiThreader::ThreadInfoStruct *)(ptr) )->ThreadID == 1 )
+    {
+    throw itk::ExceptionObject(__FILE__, __LINE__, "Expected exception", "ThreadPoolTestThrow");
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+static bool CheckCalls(const ThreadPoolTestUserData & data, unsigned int expected, const char *name)
+{
+  bool ok = !data.m_Failure;
+  for ( unsigned int i = 0; i < data.m_Calls.size(); i++ )
+    {
+    if ( data.m_Calls[i] != expected )
+      {
+      ok = false;
+      }
+    }
+  if ( !ok )
+    {
+    std::cerr << "Test failed: " << name << std::endl;
+    }
+  return ok;
+}
+
+int itkThreadPoolTest(int argc, char *argv[])
+{
+  unsigned int numberOfThreads = 8;
+  if ( argc > 1 )
+    {
+    numberOfThreads = atoi(argv[1]);
+    }
+
+  bool result = true;
+
+  itk::MultiThreader::Pointer threader = itk::MultiThreader::New();
+  threader->SetUseThreadPool(true);
+  threader->SetNumberOfThreads(numberOfThreads);
+  numberOfThreads = threader->GetNumberOfThreads();
+
+  // Repeated executions reuse the same workers.
+  const unsigned int numberOfExecutions = 100;
+  ThreadPoolTestUserData counted(numberOfThreads);
+  threader->SetSingleMethod(ThreadPoolTestCount, &counted);
+  for ( unsigned int i = 0; i < numberOfExecutions; i++ )
+    {
+    threader->SingleMethodExecute();
+    }
+  result &= CheckCalls(counted, numberOfExecutions, "SingleMethodExecute");
+
+  itk::ThreadPool::Pointer pool = itk::ThreadPool::GetInstance();
+  const itk::ThreadIdType numberOfWorkers = pool->GetNumberOfWorkerThreads();
+  std::cout << "Worker threads after " << numberOfExecutions << " executions: "
+            << numberOfWorkers << std::endl;
+#if defined(ITK_USE_PTHREADS) || defined(ITK_USE_WIN32_THREADS)
+  if ( numberOfWorkers > numberOfThreads )
+    {
+    std::cerr << "Test failed: the pool created more workers than needed" << std::endl;
+    result = false;
+    }
+#endif
+
+  // The jobs of an execution must run concurrently.
+  ThreadPoolTestUserData synchronized(numberOfThreads);
+  threader->SetSingleMethod(ThreadPoolTestBarrier, &synchronized);
+  for ( unsigned int i = 0; i < 10; i++ )
+    {
+    threader->SingleMethodExecute();
+    }
+  result &= CheckCalls(synchronized, 10, "Barrier");
+
+  // MultipleMethodExecute
+  ThreadPoolTestUserData multiple(numberOfThreads);
+  for ( unsigned int i = 0; i < numberOfThreads; i++ )
+    {
+    threader->SetMultipleMethod(i, ThreadPoolTestCount, &multiple);
+    }
+  threader->MultipleMethodExecute();
+  result &= CheckCalls(multiple, 1, "MultipleMethodExecute");
+
+  // Executions started from inside a job.
+  ThreadPoolTestUserData nested(numberOfThreads);
+  threader->SetSingleMethod(ThreadPoolTestNested, &nested);
+  threader->SingleMethodExecute();
+  result &= CheckCalls(nested, 1, "Nested");
+
+  // Exceptions thrown by a job are reported to the caller.
+  if ( numberOfThreads > 1 )
+    {
+    bool caught = false;
+    threader->SetSingleMethod(ThreadPoolTestThrow, 0);
+    try
+      {
+      threader->SingleMethodExecute();
+      }
+    catch ( itk::ExceptionObject & e )
+      {
+      std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+      caught = true;
+      }
+    if ( !caught )
+      {
+      std::cerr << "Test failed: exception was not propagated" << std::endl;
+      result = false;
+      }
+
+    // The jobs of MultipleMethodExecute run the methods directly, so the
+    // pool hands their exceptions to the caller.
+    std::string description;
+    for ( unsigned int i = 0; i < numberOfThreads; i++ )
+      {
+      threader->SetMultipleMethod(i, ThreadPoolTestThrow, 0);
+      }
+    try
+      {
+      threader->MultipleMethodExecute();
+      }
+    catch ( itk::ExceptionObject & e )
+      {
+      std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+      description = e.GetDescription();
+      }
+    if ( description != "Expected exception" )
+      {
+      std::cerr << "Test failed: the exception of a job was not rethrown" << std::endl;
+      result = false;
+      }
+    }
+
+  pool->Print(std::cout);
+  threader->Print(std::cout);
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -161,6 +161,25 @@ public:
     return ( this->EvaluateAtContinuousIndex(index, threadID) );
   }
 
+  /** Interpolate the image at a block of point positions.  The working
+   * space is allocated once for the whole block. */
+  virtual void EvaluatePoints(const PointType *points, OutputType *values,
+                              SizeValueType numberOfPoints) const
+  {
+    vnl_matrix< long >   evaluateIndex( ImageDimension, ( m_SplineOrder + 1 ) );
+    vnl_matrix< double > weights( ImageDimension, ( m_SplineOrder + 1 ) );
+    ContinuousIndexType  index;
+
+    for ( SizeValueType i = 0; i < numberOfPoints; ++i )
+      {
+      this->GetInputImage()->TransformPhysicalPointToContinuousIndex(points[i],
+                                                                     index);
+      values[i] = this->EvaluateAtContinuousIndexInternal(index,
+                                                          evaluateIndex,
+                                                          weights);
+      }
+  }
+
   virtual OutputType EvaluateAtContinuousIndex(const ContinuousIndexType &
                                                index) const
   {
@@ -311,6 +330,20 @@ public:
   itkSetMacro(UseImageDirection, bool);
   itkGetConstMacro(UseImageDirection, bool);
   itkBooleanMacro(UseImageDirection);
+
+  /** The UseWeightTable flag selects, for cubic splines, weights looked up
+   * in a table sampled WeightTableResolution times per voxel instead of
+   * weights computed exactly at each position. Values and derivatives are
+   * then approximate: the position is rounded to the nearest of the table
+   * samples. The flag is ignored for other spline orders.
+   * The default value of this flag is Off. */
+  void SetUseWeightTable(bool useWeightTable);
+  itkGetConstMacro(UseWeightTable, bool);
+  itkBooleanMacro(UseWeightTable);
+
+  /** Number of weight table samples per voxel. The default is 1000. */
+  void SetWeightTableResolution(unsigned int resolution);
+  itkGetConstMacro(WeightTableResolution, unsigned int);
 protected:
 
   /** The following methods take working space (evaluateIndex, weights, weightsDerivative)
@@ -349,6 +382,11 @@ protected:
                                                                           vnl_matrix< double > & weightsDerivative
                                                                           ) const;
 
+  /** Precomputation of the buffer offsets of the interpolation
+   *  neighborhood in m_Coefficients. Subclasses that set m_Coefficients
+   *  themselves must call it. */
+  void GeneratePointsToOffset();
+
   BSplineInterpolateImageFunction();
   ~BSplineInterpolateImageFunction();
   void PrintSelf(std::ostream & os, Indent indent) const;
@@ -393,6 +431,35 @@ private:
   void ApplyMirrorBoundaryConditions(vnl_matrix< long > & evaluateIndex,
                                      unsigned int splineOrder) const;
 
+  /** Returns the coefficient at the first corner of the region of support
+   *  when the whole region lies inside the image, so that no boundary
+   *  condition applies, and NULL otherwise. */
+  const CoefficientDataType * GetInteriorSupport(const vnl_matrix< long > & evaluateIndex) const;
+
+  /** Returns the coefficient at the p-th point of the region of support,
+   *  through m_PointsToOffset from an interior support or by index. */
+  double GetSupportCoefficient(unsigned int p,
+                               const vnl_matrix< long > & evaluateIndex,
+                               const CoefficientDataType *interiorSupport) const
+  {
+    if ( interiorSupport )
+      {
+      return interiorSupport[m_PointsToOffset[p]];
+      }
+    IndexType coefficientIndex;
+    for ( unsigned int n = 0; n < ImageDimension; n++ )
+      {
+      coefficientIndex[n] = evaluateIndex[n][m_PointsToIndex[p][n]];
+      }
+    return m_Coefficients->GetPixel(coefficientIndex);
+  }
+
+  /** Precomputation of the cubic weights for UseWeightTable. */
+  void GenerateWeightTable();
+
+  /** Returns the table entries of the weights at the fraction w of a voxel. */
+  const double * GetTableWeights(const std::vector< double > & table, double w) const;
+
   Iterator m_CIterator;                                    // Iterator for
                                                            // traversing spline
                                                            // coefficients.
@@ -404,6 +471,9 @@ private:
                                                            // interpolation
                                                            // neighborhood
                                                            // indicies
+  std::vector< OffsetValueType > m_PointsToOffset;         // Buffer offsets of
+                                                           // the neighborhood
+                                                           // points
 
   CoefficientFilterPointer m_CoefficientFilter;
 
@@ -411,6 +481,13 @@ private:
   // derivatives.
   bool m_UseImageDirection;
 
+  // cubic weights and derivative weights, sampled at m_WeightTableResolution
+  // positions per voxel.
+  bool                  m_UseWeightTable;
+  unsigned int          m_WeightTableResolution;
+  std::vector< double > m_WeightTable;
+  std::vector< double > m_DerivativeWeightTable;
+
   ThreadIdType          m_NumberOfThreads;
   vnl_matrix< long > *  m_ThreadedEvaluateIndex;
   vnl_matrix< double > *m_ThreadedWeights;
@@ -54,6 +54,9 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
   m_CoefficientFilter = CoefficientFilter::New();
   m_Coefficients = CoefficientImageType::New();
 
+  m_UseWeightTable = false;
+  m_WeightTableResolution = 1000;
+
   m_SplineOrder = 0;
   unsigned int SplineOrder = 3;
   this->SetSplineOrder(SplineOrder);
@@ -96,6 +99,9 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
   os << indent << "UseImageDirection = "
      << ( this->m_UseImageDirection ? "On" : "Off" ) << std::endl;
   os << indent << "NumberOfThreads: " << m_NumberOfThreads  << std::endl;
+  os << indent << "UseWeightTable = "
+     << ( this->m_UseWeightTable ? "On" : "Off" ) << std::endl;
+  os << indent << "WeightTableResolution: " << m_WeightTableResolution << std::endl;
 }
 
 template< class TImageType, class TCoordRep, class TCoefficientType >
@@ -115,6 +121,7 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
     Superclass::SetInputImage(inputData);
 
     m_DataLength = inputData->GetBufferedRegion().GetSize();
+    this->GeneratePointsToOffset();
     }
   else
     {
@@ -141,6 +148,7 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
     m_MaxNumberInterpolationPoints *= ( m_SplineOrder + 1 );
     }
   this->GeneratePointsToIndex();
+  this->GenerateWeightTable();
 }
 
 template< class TImageType, class TCoordRep, class TCoefficientType >
@@ -152,6 +160,38 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
   this->GeneratePointsToIndex();
 }
 
+template< class TImageType, class TCoordRep, class TCoefficientType >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::SetUseWeightTable(bool useWeightTable)
+{
+  if ( useWeightTable == m_UseWeightTable )
+    {
+    return;
+    }
+  m_UseWeightTable = useWeightTable;
+  this->GenerateWeightTable();
+  this->Modified();
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::SetWeightTableResolution(unsigned int resolution)
+{
+  if ( resolution < 1 )
+    {
+    itkExceptionMacro(<< "WeightTableResolution must be at least 1.");
+    }
+  if ( resolution == m_WeightTableResolution )
+    {
+    return;
+    }
+  m_WeightTableResolution = resolution;
+  this->GenerateWeightTable();
+  this->Modified();
+}
+
 template< class TImageType, class TCoordRep, class TCoefficientType >
 typename
 BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
@@ -402,6 +442,19 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
     {
     case 3:
       {
+      if ( !m_WeightTable.empty() )
+        {
+        for ( unsigned int n = 0; n < ImageDimension; n++ )
+          {
+          const double *tableWeights =
+            this->GetTableWeights(m_WeightTable, x[n] - (double)EvaluateIndex[n][1]);
+          for ( unsigned int k = 0; k < 4; k++ )
+            {
+            weights[n][k] = tableWeights[k];
+            }
+          }
+        break;
+        }
       for ( unsigned int n = 0; n < ImageDimension; n++ )
         {
         w = x[n] - (double)EvaluateIndex[n][1];
@@ -553,6 +606,21 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
       }
     case 2:
       {
+      if ( !m_DerivativeWeightTable.empty() )
+        {
+        // The table is indexed like the cubic weights, by the position
+        // relative to EvaluateIndex[n][1].
+        for ( unsigned int n = 0; n < ImageDimension; n++ )
+          {
+          const double *tableWeights =
+            this->GetTableWeights(m_DerivativeWeightTable, x[n] - (double)EvaluateIndex[n][1]);
+          for ( unsigned int k = 0; k < 4; k++ )
+            {
+            weights[n][k] = tableWeights[k];
+            }
+          }
+        break;
+        }
       for ( unsigned int n = 0; n < ImageDimension; n++ )
         {
         w = x[n] + .5 - (double)EvaluateIndex[n][2];
@@ -671,6 +739,90 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
       pp = pp % indexFactor[j];
       }
     }
+  this->GeneratePointsToOffset();
+}
+
+// Generates m_PointsToOffset;
+template< class TImageType, class TCoordRep, class TCoefficientType >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::GeneratePointsToOffset()
+{
+  // m_PointsToOffset holds the buffer offset of each point of the
+  // interpolation neighborhood from its first corner, so that interior
+  // neighborhoods are read without computing an index per point.
+  m_PointsToOffset.resize(m_MaxNumberInterpolationPoints);
+  if ( m_Coefficients.IsNull() )
+    {
+    return;
+    }
+  const OffsetValueType *offsetTable = m_Coefficients->GetOffsetTable();
+  for ( unsigned int p = 0; p < m_MaxNumberInterpolationPoints; p++ )
+    {
+    m_PointsToOffset[p] = 0;
+    for ( unsigned int n = 0; n < ImageDimension; n++ )
+      {
+      m_PointsToOffset[p] += m_PointsToIndex[p][n] * offsetTable[n];
+      }
+    }
+}
+
+// Generates m_WeightTable and m_DerivativeWeightTable;
+template< class TImageType, class TCoordRep, class TCoefficientType >
+void
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::GenerateWeightTable()
+{
+  m_WeightTable.clear();
+  m_DerivativeWeightTable.clear();
+  if ( !m_UseWeightTable || m_SplineOrder != 3 )
+    {
+    return;
+    }
+
+  // Sample i holds the four weights at the position i / resolution from
+  // the second point of the region of support, computed as in
+  // SetInterpolationWeights and SetDerivativeWeights.
+  m_WeightTable.resize( 4 * ( m_WeightTableResolution + 1 ) );
+  m_DerivativeWeightTable.resize( 4 * ( m_WeightTableResolution + 1 ) );
+  for ( unsigned int i = 0; i <= m_WeightTableResolution; i++ )
+    {
+    double *weights = &m_WeightTable[4 * i];
+    double  w = static_cast< double >( i ) / m_WeightTableResolution;
+    weights[3] = ( 1.0 / 6.0 ) * w * w * w;
+    weights[0] = ( 1.0 / 6.0 ) + 0.5 * w * ( w - 1.0 ) - weights[3];
+    weights[2] = w + weights[0] - 2.0 * weights[3];
+    weights[1] = 1.0 - weights[0] - weights[2] - weights[3];
+
+    double *derivativeWeights = &m_DerivativeWeightTable[4 * i];
+    w -= 0.5;
+    const double w2 = 0.75 - w * w;
+    const double w3 = 0.5 * ( w - w2 + 1.0 );
+    const double w1 = 1.0 - w2 - w3;
+    derivativeWeights[0] = 0.0 - w1;
+    derivativeWeights[1] = w1 - w2;
+    derivativeWeights[2] = w2 - w3;
+    derivativeWeights[3] = w3;
+    }
+}
+
+template< class TImageType, class TCoordRep, class TCoefficientType >
+const double *
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::GetTableWeights(const std::vector< double > & table, double w) const
+{
+  // w lies in [0, 1], up to the single precision rounding of
+  // DetermineRegionOfSupport.
+  long sample = Math::Round< long >(w * m_WeightTableResolution);
+  if ( sample < 0 )
+    {
+    sample = 0;
+    }
+  else if ( sample > static_cast< long >( m_WeightTableResolution ) )
+    {
+    sample = m_WeightTableResolution;
+    }
+  return &table[4 * sample];
 }
 
 template< class TImageType, class TCoordRep, class TCoefficientType >
@@ -730,6 +882,32 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
     }
 }
 
+template< class TImageType, class TCoordRep, class TCoefficientType >
+const typename
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::CoefficientDataType *
+BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
+::GetInteriorSupport(const vnl_matrix< long > & evaluateIndex) const
+{
+  const IndexType startIndex = this->GetStartIndex();
+  const IndexType endIndex = this->GetEndIndex();
+
+  IndexType cornerIndex;
+  for ( unsigned int n = 0; n < ImageDimension; n++ )
+    {
+    // Same tests as ApplyMirrorBoundaryConditions, on the first and last
+    // index of the support along each dimension.
+    if ( m_DataLength[n] == 1
+         || evaluateIndex[n][0] < startIndex[n]
+         || evaluateIndex[n][m_SplineOrder] > endIndex[n] )
+      {
+      return NULL;
+      }
+    cornerIndex[n] = evaluateIndex[n][0];
+    }
+  return m_Coefficients->GetBufferPointer() + m_Coefficients->ComputeOffset(cornerIndex);
+}
+
 template< class TImageType, class TCoordRep, class TCoefficientType >
 typename
 BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
@@ -745,23 +923,25 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
   // Determine weights
   SetInterpolationWeights(x, ( evaluateIndex ), ( weights ), m_SplineOrder);
 
-  // Modify evaluateIndex at the boundaries using mirror boundary conditions
-  this->ApplyMirrorBoundaryConditions( ( evaluateIndex ), m_SplineOrder );
+  // Modify evaluateIndex at the boundaries using mirror boundary conditions,
+  // unless the region of support lies inside the image.
+  const CoefficientDataType *interiorSupport = this->GetInteriorSupport(evaluateIndex);
+  if ( !interiorSupport )
+    {
+    this->ApplyMirrorBoundaryConditions( ( evaluateIndex ), m_SplineOrder );
+    }
 
   // perform interpolation
-  double    interpolated = 0.0;
-  IndexType coefficientIndex;
+  double interpolated = 0.0;
   // Step through eachpoint in the N-dimensional interpolation cube.
   for ( unsigned int p = 0; p < m_MaxNumberInterpolationPoints; p++ )
     {
     double w = 1.0;
     for ( unsigned int n = 0; n < ImageDimension; n++ )
       {
-      unsigned int indx = m_PointsToIndex[p][n];
-      w *= ( weights )[n][indx];
-      coefficientIndex[n] = ( evaluateIndex )[n][indx];
+      w *= ( weights )[n][m_PointsToIndex[p][n]];
       }
-    interpolated += w * m_Coefficients->GetPixel(coefficientIndex);
+    interpolated += w * this->GetSupportCoefficient(p, evaluateIndex, interiorSupport);
     }
 
   return ( interpolated );
@@ -787,60 +967,57 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
                        ( weightsDerivative ),
                        m_SplineOrder);
 
-  // Modify EvaluateIndex at the boundaries using mirror boundary conditions
-  this->ApplyMirrorBoundaryConditions( ( evaluateIndex ), m_SplineOrder );
+  // Modify EvaluateIndex at the boundaries using mirror boundary conditions,
+  // unless the region of support lies inside the image.
+  const CoefficientDataType *interiorSupport = this->GetInteriorSupport(evaluateIndex);
+  if ( !interiorSupport )
+    {
+    this->ApplyMirrorBoundaryConditions( ( evaluateIndex ), m_SplineOrder );
+    }
 
-  unsigned int indx;
-  double       tmpV;
-  double       w, w1, tmpW;
-  IndexType    coefficientIndex;
-  value = 0.0;
-  unsigned int p, n, n1;
-  derivativeValue[0] = 0.0;
-  for ( p = 0; p < m_MaxNumberInterpolationPoints; p++ )
+  const InputImageType *inputImage = this->GetInputImage();
+  const typename InputImageType::SpacingType & spacing = inputImage->GetSpacing();
+
+  // Read each coefficient once, for the value and all the derivatives.
+  double value0 = 0.0;
+  double derivative[ImageDimension];
+  for ( unsigned int n = 0; n < ImageDimension; n++ )
     {
-    indx = m_PointsToIndex[p][0];
-    coefficientIndex[0] = ( evaluateIndex )[0][indx];
-    w = ( weights )[0][indx];
-    w1 = ( weightsDerivative )[0][indx];
-    for ( n = 1; n < ImageDimension; n++ )
-      {
-      indx = m_PointsToIndex[p][n];
-      coefficientIndex[n] = ( evaluateIndex )[n][indx];
-      tmpW = ( weights )[n][indx];
-      w *= tmpW;
-      w1 *= tmpW;
-      }
-    tmpV = m_Coefficients->GetPixel(coefficientIndex);
-    value += w * tmpV;
-    derivativeValue[0] += w1 * tmpV;
+    derivative[n] = 0.0;
     }
-  derivativeValue[0] /= this->GetInputImage()->GetSpacing()[0];
-  for ( n = 1; n < ImageDimension; n++ )
+  for ( unsigned int p = 0; p < m_MaxNumberInterpolationPoints; p++ )
     {
-    derivativeValue[n] = 0.0;
-    for ( p = 0; p < m_MaxNumberInterpolationPoints; p++ )
+    const double coefficient = this->GetSupportCoefficient(p, evaluateIndex, interiorSupport);
+    double       w = 1.0;
+    for ( unsigned int n = 0; n < ImageDimension; n++ )
       {
-      w1 = 1.0;
-      for ( n1 = 0; n1 < ImageDimension; n1++ )
+      w *= ( weights )[n][m_PointsToIndex[p][n]];
+      }
+    value0 += w * coefficient;
+    for ( unsigned int n = 0; n < ImageDimension; n++ )
+      {
+      double w1 = 1.0;
+      for ( unsigned int n1 = 0; n1 < ImageDimension; n1++ )
         {
-        indx = m_PointsToIndex[p][n1];
-        coefficientIndex[n1] = ( evaluateIndex )[n1][indx];
-
-        if ( n1 == n )
-          {
-          w1 *= ( weightsDerivative )[n1][indx];
-          }
-        else
-          {
-          w1 *= ( weights )[n1][indx];
-          }
+        const unsigned int indx = m_PointsToIndex[p][n1];
+        w1 *= ( n1 == n ) ? ( weightsDerivative )[n1][indx] : ( weights )[n1][indx];
         }
-      derivativeValue[n] += m_Coefficients->GetPixel(coefficientIndex)
-                            * w1;
+      derivative[n] += w1 * coefficient;
       }
+    }
+
+  value = value0;
+  for ( unsigned int n = 0; n < ImageDimension; n++ )
+    {
     // take spacing into account
-    derivativeValue[n] /= this->GetInputImage()->GetSpacing()[n];
+    derivativeValue[n] = derivative[n] / spacing[n];
+    }
+
+  if ( this->m_UseImageDirection )
+    {
+    CovariantVectorType orientedDerivative;
+    inputImage->TransformLocalVectorToPhysicalVector(derivativeValue, orientedDerivative);
+    derivativeValue = orientedDerivative;
     }
 }
 
@@ -864,40 +1041,42 @@ BSplineInterpolateImageFunction< TImageType, TCoordRep, TCoefficientType >
                        ( weightsDerivative ),
                        m_SplineOrder);
 
-  // Modify EvaluateIndex at the boundaries using mirror boundary conditions
-  this->ApplyMirrorBoundaryConditions( ( evaluateIndex ), m_SplineOrder );
+  // Modify EvaluateIndex at the boundaries using mirror boundary conditions,
+  // unless the region of support lies inside the image.
+  const CoefficientDataType *interiorSupport = this->GetInteriorSupport(evaluateIndex);
+  if ( !interiorSupport )
+    {
+    this->ApplyMirrorBoundaryConditions( ( evaluateIndex ), m_SplineOrder );
+    }
 
   const InputImageType *inputImage = this->GetInputImage();
   const typename InputImageType::SpacingType & spacing = inputImage->GetSpacing();
 
-  // Calculate derivative
-  CovariantVectorType derivativeValue;
-  double              tempValue;
-  IndexType           coefficientIndex;
+  // Calculate derivative, reading each coefficient once.
+  double derivative[ImageDimension];
   for ( unsigned int n = 0; n < ImageDimension; n++ )
     {
-    derivativeValue[n] = 0.0;
-    for ( unsigned int p = 0; p < m_MaxNumberInterpolationPoints; p++ )
+    derivative[n] = 0.0;
+    }
+  for ( unsigned int p = 0; p < m_MaxNumberInterpolationPoints; p++ )
+    {
+    const double coefficient = this->GetSupportCoefficient(p, evaluateIndex, interiorSupport);
+    for ( unsigned int n = 0; n < ImageDimension; n++ )
       {
-      tempValue = 1.0;
+      double tempValue = 1.0;
       for ( unsigned int n1 = 0; n1 < ImageDimension; n1++ )
         {
-        unsigned int indx;
-        indx = m_PointsToIndex[p][n1];
-        coefficientIndex[n1] = ( evaluateIndex )[n1][indx];
-
-        if ( n1 == n )
-          {
-          tempValue *= ( weightsDerivative )[n1][indx];
-          }
-        else
-          {
-          tempValue *= ( weights )[n1][indx];
-          }
+        const unsigned int indx = m_PointsToIndex[p][n1];
+        tempValue *= ( n1 == n ) ? ( weightsDerivative )[n1][indx] : ( weights )[n1][indx];
         }
-      derivativeValue[n] += m_Coefficients->GetPixel(coefficientIndex) * tempValue;
+      derivative[n] += coefficient * tempValue;
       }
-    derivativeValue[n] /= spacing[n];
+    }
+
+  CovariantVectorType derivativeValue;
+  for ( unsigned int n = 0; n < ImageDimension; n++ )
+    {
+    derivativeValue[n] = derivative[n] / spacing[n];
     }
 
   if ( this->m_UseImageDirection )
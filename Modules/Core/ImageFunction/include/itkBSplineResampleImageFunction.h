@@ -82,6 +82,7 @@ public:
     if ( this->m_Coefficients.IsNotNull() )
       {
       this->m_DataLength = this->m_Coefficients->GetBufferedRegion().GetSize();
+      this->GeneratePointsToOffset();
       }
   }
 
@@ -97,6 +97,21 @@ public:
     return ( this->EvaluateAtContinuousIndex(index) );
   }
 
+  /** Interpolate the image at a block of point positions
+   *
+   * Stores in \c values[i] the same value as Evaluate( points[i] ).
+   * Subclasses override this method to interpolate the whole block
+   * without a virtual call per point. No bounds checking is done.
+   * \warning This method must be thread-safe. */
+  virtual void EvaluatePoints(const PointType *points, OutputType *values,
+                              SizeValueType numberOfPoints) const
+  {
+    for ( SizeValueType i = 0; i < numberOfPoints; ++i )
+      {
+      values[i] = this->Evaluate(points[i]);
+      }
+  }
+
   /** Interpolate the image at a continuous index position
    *
    * Returns the interpolated image intensity at a
@@ -76,6 +76,9 @@ public:
   /** Dimension underlying input image. */
   itkStaticConstMacro(ImageDimension, unsigned int, Superclass::ImageDimension);
 
+  /** Point typedef support. */
+  typedef typename Superclass::PointType PointType;
+
   /** Index typedef support. */
   typedef typename Superclass::IndexType      IndexType;
 
@@ -97,6 +100,21 @@ public:
     return this->EvaluateOptimized(Dispatch< ImageDimension >(), index);
   }
 
+  /** Interpolate the image at a block of point positions, calling the
+   * dimension specific kernel directly for each point. */
+  virtual void EvaluatePoints(const PointType *points, OutputType *values,
+                              SizeValueType numberOfPoints) const
+  {
+    const InputImageType *image = this->GetInputImage();
+    ContinuousIndexType   index;
+
+    for ( SizeValueType i = 0; i < numberOfPoints; ++i )
+      {
+      image->TransformPhysicalPointToContinuousIndex(points[i], index);
+      values[i] = this->EvaluateOptimized(Dispatch< ImageDimension >(), index);
+      }
+  }
+
 protected:
   LinearInterpolateImageFunction();
   ~LinearInterpolateImageFunction();
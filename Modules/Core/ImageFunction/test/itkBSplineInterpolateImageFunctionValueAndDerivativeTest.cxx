@@ -0,0 +1,227 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBSplineInterpolateImageFunction.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+const unsigned int Dimension = 3;
+typedef itk::Image< float, Dimension >                                  ImageType;
+typedef itk::BSplineInterpolateImageFunction< ImageType, double, double > InterpolatorType;
+typedef InterpolatorType::ContinuousIndexType                           ContinuousIndexType;
+typedef InterpolatorType::CovariantVectorType                           CovariantVectorType;
+typedef InterpolatorType::OutputType                                    OutputType;
+
+/* Positions across the image, near the boundaries and in the interior. */
+std::vector< ContinuousIndexType > TestPositions(const ImageType *image)
+{
+  const ImageType::RegionType region = image->GetBufferedRegion();
+  std::vector< ContinuousIndexType > positions;
+  for ( unsigned int i = 0; i < 200; i++ )
+    {
+    ContinuousIndexType x;
+    for ( unsigned int d = 0; d < Dimension; d++ )
+      {
+      const double fraction = 0.5 + 0.5 * vcl_sin( 1.3 * i + 2.1 * d );
+      x[d] = region.GetIndex(d) + fraction * ( region.GetSize(d) - 1 );
+      }
+    positions.push_back(x);
+    }
+  return positions;
+}
+
+/* EvaluateValueAndDerivative gives what Evaluate and EvaluateDerivative
+ * give separately, with or without a thread identifier. */
+bool TestValueAndDerivative(InterpolatorType *interpolator,
+                            const std::vector< ContinuousIndexType > & positions)
+{
+  for ( unsigned int i = 0; i < positions.size(); i++ )
+    {
+    const OutputType          value = interpolator->EvaluateAtContinuousIndex(positions[i]);
+    const CovariantVectorType derivative =
+      interpolator->EvaluateDerivativeAtContinuousIndex(positions[i]);
+
+    OutputType          fusedValue[2];
+    CovariantVectorType fusedDerivative[2];
+    interpolator->EvaluateValueAndDerivativeAtContinuousIndex(positions[i], fusedValue[0], fusedDerivative[0]);
+    interpolator->EvaluateValueAndDerivativeAtContinuousIndex(positions[i], fusedValue[1], fusedDerivative[1], 0);
+    for ( unsigned int j = 0; j < 2; j++ )
+      {
+      bool same = vcl_fabs(fusedValue[j] - value) < 1e-9;
+      for ( unsigned int d = 0; d < Dimension; d++ )
+        {
+        same &= vcl_fabs(fusedDerivative[j][d] - derivative[d]) < 1e-9;
+        }
+      if ( !same )
+        {
+        std::cerr << "Order " << interpolator->GetSplineOrder() << " at " << positions[i]
+                  << ": value and derivative " << fusedValue[j] << " " << fusedDerivative[j]
+                  << ", expected " << value << " " << derivative << std::endl;
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
+/* The spline goes through the image values at the pixel positions, on the
+ * boundaries as in the interior. */
+bool TestInterpolation(InterpolatorType *interpolator, const ImageType *image)
+{
+  itk::ImageRegionConstIteratorWithIndex< ImageType > it( image, image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    ContinuousIndexType x;
+    for ( unsigned int d = 0; d < Dimension; d++ )
+      {
+      x[d] = it.GetIndex()[d];
+      }
+    const OutputType value = interpolator->EvaluateAtContinuousIndex(x);
+    if ( vcl_fabs(value - it.Get()) > 1e-3 )
+      {
+      std::cerr << "Order " << interpolator->GetSplineOrder() << " at " << it.GetIndex()
+                << ": value " << value << ", expected " << it.Get() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+int itkBSplineInterpolateImageFunctionValueAndDerivativeTest(int, char *[])
+{
+  ImageType::RegionType region;
+  region.SetIndex(0, -3);
+  region.SetIndex(1, 5);
+  region.SetIndex(2, 0);
+  region.SetSize(0, 12);
+  region.SetSize(1, 9);
+  region.SetSize(2, 7);
+
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.8;
+  spacing[1] = 1.5;
+  spacing[2] = 2.0;
+
+  ImageType::DirectionType direction;
+  direction.SetIdentity();
+  direction[0][0] = vcl_cos(0.3);
+  direction[0][1] = -vcl_sin(0.3);
+  direction[1][0] = vcl_sin(0.3);
+  direction[1][1] = vcl_cos(0.3);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->SetSpacing(spacing);
+  image->SetDirection(direction);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set( 10.0 * vcl_sin(0.4 * index[0]) * vcl_cos(0.3 * index[1]) + 0.5 * index[2] * index[2] );
+    }
+
+  const std::vector< ContinuousIndexType > positions = TestPositions(image);
+
+  bool pass = true;
+  InterpolatorType::Pointer interpolator = InterpolatorType::New();
+  for ( unsigned int order = 0; order <= 5; order++ )
+    {
+    interpolator->SetSplineOrder(order);
+    interpolator->SetInputImage(image);
+    pass &= TestValueAndDerivative(interpolator, positions);
+    if ( order > 0 )
+      {
+      pass &= TestInterpolation(interpolator, image);
+      }
+    }
+
+  // Cubic weights looked up in a table are close to the exact ones, and
+  // the values and derivatives are still consistent.
+  interpolator->SetSplineOrder(3);
+  interpolator->SetInputImage(image);
+  std::vector< OutputType >          exactValues;
+  std::vector< CovariantVectorType > exactDerivatives;
+  for ( unsigned int i = 0; i < positions.size(); i++ )
+    {
+    exactValues.push_back( interpolator->EvaluateAtContinuousIndex(positions[i]) );
+    exactDerivatives.push_back( interpolator->EvaluateDerivativeAtContinuousIndex(positions[i]) );
+    }
+
+  interpolator->UseWeightTableOn();
+  interpolator->Print(std::cout);
+  const unsigned int resolutions[] = { 1000, 10000 };
+  for ( unsigned int r = 0; r < 2; r++ )
+    {
+    interpolator->SetWeightTableResolution(resolutions[r]);
+    pass &= TestValueAndDerivative(interpolator, positions);
+
+    double maximumError = 0.0;
+    for ( unsigned int i = 0; i < positions.size(); i++ )
+      {
+      maximumError = std::max( maximumError,
+                               vcl_fabs(interpolator->EvaluateAtContinuousIndex(positions[i]) - exactValues[i]) );
+      const CovariantVectorType derivative = interpolator->EvaluateDerivativeAtContinuousIndex(positions[i]);
+      for ( unsigned int d = 0; d < Dimension; d++ )
+        {
+        maximumError = std::max( maximumError, vcl_fabs(derivative[d] - exactDerivatives[i][d]) );
+        }
+      }
+    std::cout << "Resolution " << resolutions[r] << ": maximum error " << maximumError << std::endl;
+    if ( maximumError > 50.0 / resolutions[r] )
+      {
+      std::cerr << "Weight table error too large." << std::endl;
+      pass = false;
+      }
+    }
+
+  // Back to exact weights
+  interpolator->UseWeightTableOff();
+  for ( unsigned int i = 0; i < positions.size(); i++ )
+    {
+    if ( interpolator->EvaluateAtContinuousIndex(positions[i]) != exactValues[i] )
+      {
+      std::cerr << "Exact weights not restored." << std::endl;
+      pass = false;
+      break;
+      }
+    }
+
+  bool caught = false;
+  try
+    {
+    interpolator->SetWeightTableResolution(0);
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  pass &= caught;
+
+  if ( !pass )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -134,6 +134,17 @@ public:
   /** Transform from azimuth-elevation to cartesian. */
   OutputPointType     TransformPoint(const InputPointType  & point) const;
 
+  /** Transform a block of points from azimuth-elevation to cartesian. */
+  virtual void TransformPoints(const InputPointType *inputPoints,
+                               OutputPointType *outputPoints,
+                               SizeValueType numberOfPoints) const
+  {
+    for ( SizeValueType i = 0; i < numberOfPoints; i++ )
+      {
+      outputPoints[i] = this->TransformPoint(inputPoints[i]);
+      }
+  }
+
   /** Back transform from cartesian to azimuth-elevation.  */
   inline InputPointType  BackTransform(const OutputPointType  & point) const
   {
@@ -234,6 +234,12 @@ public:
   virtual void TransformPoint( const InputPointType & inputPoint, OutputPointType & outputPoint,
     WeightsType & weights, ParameterIndexArrayType & indices, bool & inside ) const = 0;
 
+  /** Transform a block of points.  The interpolation weights and support
+   * indices are allocated once for the whole block instead of once per
+   * point. */
+  virtual void TransformPoints( const InputPointType *inputPoints, OutputPointType *outputPoints,
+    SizeValueType numberOfPoints ) const;
+
   /** Get number of weights. */
   unsigned long GetNumberOfWeights() const
   {
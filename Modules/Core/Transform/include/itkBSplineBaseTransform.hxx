@@ -374,5 +374,24 @@ BSplineBaseTransform<TScalarType, NDimensions, VSplineOrder>
   return outputPoint;
 }
 
+// Transform a block of points
+template <class TScalarType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+BSplineBaseTransform<TScalarType, NDimensions, VSplineOrder>
+::TransformPoints( const InputPointType *inputPoints, OutputPointType *outputPoints,
+  SizeValueType numberOfPoints ) const
+{
+  WeightsType             weights( this->m_WeightsFunction->GetNumberOfWeights() );
+  ParameterIndexArrayType indices( this->m_WeightsFunction->GetNumberOfWeights() );
+  bool                    inside;
+
+  for( SizeValueType i = 0; i < numberOfPoints; i++ )
+    {
+    // Copy the point, the output may overwrite it
+    const InputPointType point = inputPoints[i];
+    this->TransformPoint( point, outputPoints[i], weights, indices, inside );
+    }
+}
+
 } // namespace
 #endif
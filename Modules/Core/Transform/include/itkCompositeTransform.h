@@ -305,6 +305,12 @@ public:
   */
   virtual OutputPointType TransformPoint( const InputPointType & inputPoint ) const;
 
+  /** Transform a block of points.  Each transform in the queue maps the
+   * whole block in turn, in the same order as TransformPoint. */
+  virtual void TransformPoints( const InputPointType *inputPoints,
+                                OutputPointType *outputPoints,
+                                SizeValueType numberOfPoints ) const;
+
   /* Note: why was the 'isInsideTransformRegion' flag used below?
   {
     bool isInside = true;
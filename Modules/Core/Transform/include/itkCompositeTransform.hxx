@@ -20,6 +20,7 @@
 
 #include "itkCompositeTransform.h"
 #include <string.h> // for memcpy on some platforms
+#include <algorithm>
 
 namespace itk
 {
@@ -90,6 +91,34 @@ CompositeTransform<TScalar, NDimensions>
   return outputPoint;
 }
 
+/**
+ * Transform a block of points
+ */
+template
+<class TScalar, unsigned int NDimensions>
+void
+CompositeTransform<TScalar, NDimensions>
+::TransformPoints( const InputPointType *inputPoints,
+                   OutputPointType *outputPoints,
+                   SizeValueType numberOfPoints ) const
+{
+  if( outputPoints != inputPoints )
+    {
+    std::copy( inputPoints, inputPoints + numberOfPoints, outputPoints );
+    }
+
+  typename TransformQueueType::const_iterator it;
+  /* Apply in reverse queue order, in place.  */
+  it = this->m_TransformQueue.end();
+
+  do
+    {
+    it--;
+    (*it)->TransformPoints( outputPoints, outputPoints, numberOfPoints );
+    }
+  while( it != this->m_TransformQueue.begin() );
+}
+
 /**
  * Transform vector
  */
@@ -342,6 +342,12 @@ public:
 
   OutputPointType       TransformPoint(const InputPointType & point) const;
 
+  /** Transform a block of points with the matrix and offset, without a
+   * virtual call per point. */
+  virtual void TransformPoints(const InputPointType *inputPoints,
+                               OutputPointType *outputPoints,
+                               SizeValueType numberOfPoints) const;
+
   using Superclass::TransformVector;
 
   OutputVectorType      TransformVector(const InputVectorType & vector) const;
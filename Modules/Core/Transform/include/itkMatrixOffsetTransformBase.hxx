@@ -185,6 +185,35 @@ MatrixOffsetTransformBase<TScalarType, NInputDimensions, NOutputDimensions>
   return m_Matrix * point + m_Offset;
 }
 
+// Transform a block of points
+template <class TScalarType, unsigned int NInputDimensions,
+          unsigned int NOutputDimensions>
+void
+MatrixOffsetTransformBase<TScalarType, NInputDimensions, NOutputDimensions>
+::TransformPoints(const InputPointType *inputPoints,
+                  OutputPointType *outputPoints,
+                  SizeValueType numberOfPoints) const
+{
+  // Same arithmetic as TransformPoint, with the matrix read from its
+  // buffer so the loops can be unrolled and vectorized.
+  const TScalarType *matrix = m_Matrix.GetVnlMatrix().data_block();
+
+  for( SizeValueType n = 0; n < numberOfPoints; n++ )
+    {
+    const InputPointType point = inputPoints[n];
+    OutputPointType &    outputPoint = outputPoints[n];
+    for( unsigned int i = 0; i < NOutputDimensions; i++ )
+      {
+      TScalarType sum = NumericTraits<TScalarType>::Zero;
+      for( unsigned int j = 0; j < NInputDimensions; j++ )
+        {
+        sum += matrix[i * NInputDimensions + j] * point[j];
+        }
+      outputPoint[i] = sum + m_Offset[i];
+      }
+    }
+}
+
 // Transform a vector
 template <class TScalarType, unsigned int NInputDimensions,
           unsigned int NOutputDimensions>
@@ -160,6 +160,11 @@ public:
    * vector. */
   OutputPointType     TransformPoint(const InputPointType  & point) const;
 
+  /** Transform a block of points by the scale transformation. */
+  virtual void TransformPoints(const InputPointType *inputPoints,
+                               OutputPointType *outputPoints,
+                               SizeValueType numberOfPoints) const;
+
   using Superclass::TransformVector;
   OutputVectorType    TransformVector(const InputVectorType & vector) const;
 
@@ -130,6 +130,22 @@ ScaleTransform<ScalarType, NDimensions>::TransformPoint(const InputPointType & p
   return result;
 }
 
+// Transform a block of points
+template <class ScalarType, unsigned int NDimensions>
+void
+ScaleTransform<ScalarType, NDimensions>::TransformPoints(const InputPointType *inputPoints,
+                                                         OutputPointType *outputPoints,
+                                                         SizeValueType numberOfPoints) const
+{
+  for( SizeValueType n = 0; n < numberOfPoints; n++ )
+    {
+    for( unsigned int i = 0; i < SpaceDimension; i++ )
+      {
+      outputPoints[n][i] = ( inputPoints[n][i] - m_Center[i] ) * m_Scale[i] + m_Center[i];
+      }
+    }
+}
+
 // Transform a vector
 template <class ScalarType, unsigned int NDimensions>
 typename ScaleTransform<ScalarType, NDimensions>::OutputVectorType
@@ -204,6 +204,15 @@ public:
    */
   virtual OutputPointType TransformPoint(const InputPointType  &) const = 0;
 
+  /** Method to transform a block of points.  The result is the same as
+   * calling TransformPoint on each point, but transforms with a closed
+   * form override it to avoid a virtual call and temporary objects per
+   * point.  \c inputPoints and \c outputPoints may be the same array.
+   * \warning This method must be thread-safe. */
+  virtual void TransformPoints(const InputPointType *inputPoints,
+                               OutputPointType *outputPoints,
+                               SizeValueType numberOfPoints) const;
+
   /**  Method to transform a vector. */
   virtual OutputVectorType  TransformVector(const InputVectorType &) const
   {
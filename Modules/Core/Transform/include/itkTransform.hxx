@@ -165,6 +165,24 @@ Transform<TScalarType, NInputDimensions, NOutputDimensions>
   this->Modified();
 }
 
+/**
+ * Transform a block of points
+ */
+template <class TScalarType,
+          unsigned int NInputDimensions,
+          unsigned int NOutputDimensions>
+void
+Transform<TScalarType, NInputDimensions, NOutputDimensions>
+::TransformPoints( const InputPointType *inputPoints,
+                   OutputPointType *outputPoints,
+                   SizeValueType numberOfPoints ) const
+{
+  for( SizeValueType i = 0; i < numberOfPoints; i++ )
+    {
+    outputPoints[i] = this->TransformPoint( inputPoints[i] );
+    }
+}
+
 /**
  * Transform vector
  */
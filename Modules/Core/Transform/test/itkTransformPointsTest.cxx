@@ -0,0 +1,156 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkEuler3DTransform.h"
+#include "itkScaleTransform.h"
+#include "itkTranslationTransform.h"
+#include <vector>
+
+namespace
+{
+const unsigned int Dimension = 3;
+typedef itk::Transform< double, Dimension, Dimension > TransformType;
+typedef TransformType::InputPointType                  PointType;
+
+/* Check that TransformPoints gives the result of TransformPoint on each
+ * point, both into another array and in place. */
+bool TestTransformPoints( const char *name, const TransformType *transform,
+                          const std::vector< PointType > & points )
+{
+  const itk::SizeValueType numberOfPoints = points.size();
+  std::vector< PointType > outputPoints( numberOfPoints );
+  std::vector< PointType > inPlacePoints( points );
+
+  transform->TransformPoints( &points[0], &outputPoints[0], numberOfPoints );
+  transform->TransformPoints( &inPlacePoints[0], &inPlacePoints[0], numberOfPoints );
+
+  for( itk::SizeValueType i = 0; i < numberOfPoints; i++ )
+    {
+    const PointType expected = transform->TransformPoint( points[i] );
+    for( unsigned int d = 0; d < Dimension; d++ )
+      {
+      if( vcl_fabs( outputPoints[i][d] - expected[d] ) > 1e-9
+          || vcl_fabs( inPlacePoints[i][d] - expected[d] ) > 1e-9 )
+        {
+        std::cerr << name << ": point " << points[i] << " was transformed to "
+                  << outputPoints[i] << " and, in place, to " << inPlacePoints[i]
+                  << ", expected " << expected << std::endl;
+        return false;
+        }
+      }
+    }
+  std::cout << name << ": passed." << std::endl;
+  return true;
+}
+}
+
+int itkTransformPointsTest(int, char *[])
+{
+  std::vector< PointType > points( 300 );
+  for( unsigned int i = 0; i < points.size(); i++ )
+    {
+    points[i][0] = -20.0 + 0.37 * i;
+    points[i][1] = 15.0 - 0.11 * ( i % 97 );
+    points[i][2] = 3.0 * vcl_sin( 0.1 * i );
+    }
+
+  bool pass = true;
+
+  typedef itk::AffineTransform< double, Dimension > AffineTransformType;
+  AffineTransformType::Pointer affine = AffineTransformType::New();
+  AffineTransformType::OutputVectorType axis;
+  axis[0] = 1.0;
+  axis[1] = -2.0;
+  axis[2] = 0.5;
+  affine->Rotate3D( axis, 0.7 );
+  affine->Scale( 1.3 );
+  affine->Shear( 0, 2, 0.2 );
+  axis[0] = 4.0;
+  axis[1] = -1.5;
+  axis[2] = 12.0;
+  affine->Translate( axis );
+  pass &= TestTransformPoints( "Affine", affine, points );
+
+  typedef itk::Euler3DTransform< double > EulerTransformType;
+  EulerTransformType::Pointer euler = EulerTransformType::New();
+  euler->SetRotation( 0.1, -0.4, 1.2 );
+  EulerTransformType::InputPointType center;
+  center[0] = 5.0;
+  center[1] = -3.0;
+  center[2] = 1.0;
+  euler->SetCenter( center );
+  pass &= TestTransformPoints( "Euler3D", euler, points );
+
+  typedef itk::ScaleTransform< double, Dimension > ScaleTransformType;
+  ScaleTransformType::Pointer scale = ScaleTransformType::New();
+  ScaleTransformType::ScaleType scaleFactors;
+  scaleFactors[0] = 0.5;
+  scaleFactors[1] = 2.0;
+  scaleFactors[2] = -1.25;
+  scale->SetScale( scaleFactors );
+  scale->SetCenter( center );
+  pass &= TestTransformPoints( "Scale", scale, points );
+
+  typedef itk::TranslationTransform< double, Dimension > TranslationTransformType;
+  TranslationTransformType::Pointer translation = TranslationTransformType::New();
+  TranslationTransformType::OutputVectorType translationVector;
+  translationVector.Fill( 2.5 );
+  translation->Translate( translationVector );
+  pass &= TestTransformPoints( "Translation", translation, points );
+
+  typedef itk::BSplineTransform< double, Dimension, 3 > BSplineTransformType;
+  BSplineTransformType::Pointer bspline = BSplineTransformType::New();
+  BSplineTransformType::PhysicalDimensionsType fixedPhysicalDimensions;
+  fixedPhysicalDimensions.Fill( 60.0 );
+  BSplineTransformType::OriginType fixedOrigin;
+  fixedOrigin.Fill( -30.0 );
+  BSplineTransformType::MeshSizeType meshSize;
+  meshSize.Fill( 4 );
+  bspline->SetTransformDomainOrigin( fixedOrigin );
+  bspline->SetTransformDomainPhysicalDimensions( fixedPhysicalDimensions );
+  bspline->SetTransformDomainMeshSize( meshSize );
+  BSplineTransformType::ParametersType parameters( bspline->GetNumberOfParameters() );
+  for( unsigned int i = 0; i < parameters.Size(); i++ )
+    {
+    parameters[i] = vcl_cos( 1.7 * i );
+    }
+  bspline->SetParameters( parameters );
+  pass &= TestTransformPoints( "BSpline", bspline, points );
+
+  typedef itk::CompositeTransform< double, Dimension > CompositeTransformType;
+  CompositeTransformType::Pointer composite = CompositeTransformType::New();
+  composite->AddTransform( affine );
+  composite->AddTransform( bspline );
+  composite->AddTransform( euler );
+  pass &= TestTransformPoints( "Composite", composite, points );
+
+  // A block of a single point, and an empty block
+  std::vector< PointType > single( points.begin(), points.begin() + 1 );
+  pass &= TestTransformPoints( "Single point", composite, single );
+  affine->TransformPoints( &points[0], &single[0], 0 );
+
+  if( !pass )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -20,6 +20,7 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkSimpleDataObjectDecorator.h"
+#include "itkPixelwiseFunctorStage.h"
 
 namespace itk
 {
@@ -36,6 +37,15 @@ namespace itk
  * the pipeline. The SetConstant() and GetConstant() methods are provided as shortcuts
  * to set or get the constant value without manipulating the decorator.
  *
+ * When all the images store their pixels contiguously (see
+ * ImageScanlineTraits), the functor is applied a scanline at a time,
+ * straight from the image buffers, through BinaryScanlineFunctorEvaluator.
+ * Other images are walked with iterators.
+ *
+ * Such a filter can also be fused with its neighbours into a single
+ * FusedFunctorImageFilter, see CreatePixelwiseStage(). Subclasses that
+ * set up their functor while they execute must turn Fusable off.
+ *
  * \sa UnaryFunctorImageFilter TernaryFunctorImageFilter
  *
  * \ingroup IntensityImageFilters   MultiThreaded
@@ -49,7 +59,8 @@ namespace itk
 template< class TInputImage1, class TInputImage2,
           class TOutputImage, class TFunction    >
 class ITK_EXPORT BinaryFunctorImageFilter:
-  public InPlaceImageFilter< TInputImage1, TOutputImage >
+  public InPlaceImageFilter< TInputImage1, TOutputImage >,
+  public FusableFunctorFilter< TOutputImage::ImageDimension >
 {
 public:
   /** Standard class typedefs. */
@@ -149,6 +160,21 @@ public:
       }
   }
 
+  /** Whether FusedFunctorImageFilter may replace this filter by a
+   * PixelwiseFunctorStage. On by default. */
+  itkSetMacro(Fusable, bool);
+  itkGetConstMacro(Fusable, bool);
+  itkBooleanMacro(Fusable);
+
+  typedef typename FusableFunctorFilter< TOutputImage::ImageDimension >::StagePointer StagePointer;
+
+  /** Create a stage applying a copy of the functor. The pixels flowing
+   * through the stage are those of the first input, or of the second
+   * one when the first operand is a constant; the other operand is read
+   * from the second input or copied from the constant. Returns a null
+   * pointer if Fusable is off or if the images are not contiguous. */
+  virtual StagePointer CreatePixelwiseStage(const DataObject * & chainInput);
+
   /** ImageDimension constants */
   itkStaticConstMacro(
     InputImage1Dimension, unsigned int, TInputImage1::ImageDimension);
@@ -192,7 +218,26 @@ private:
   BinaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);           //purposely not implemented
 
+  /** TrueType when the scanlines of all the images can be processed
+   * straight from their buffers. */
+  typedef typename ScanlineDispatch<
+    ImageScanlineTraits< TInputImage1 >::IsContiguous
+    && ImageScanlineTraits< TInputImage2 >::IsContiguous
+    && ImageScanlineTraits< TOutputImage >::IsContiguous >::Type ScanlineDispatchType;
+
+  /** Process the region a scanline at a time. */
+  void DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                      ThreadIdType threadId, TrueType);
+
+  /** Process the region with iterators. */
+  void DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                      ThreadIdType threadId, FalseType);
+
+  StagePointer DispatchedCreatePixelwiseStage(const DataObject * & chainInput, TrueType);
+  StagePointer DispatchedCreatePixelwiseStage(const DataObject * &, FalseType) { return 0; }
+
   FunctorType m_Functor;
+  bool        m_Fusable;
 };
 } // end namespace itk
 
@@ -34,6 +34,57 @@ BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
 {
   this->SetNumberOfRequiredInputs(2);
   this->InPlaceOff();
+  m_Fusable = true;
+}
+
+template< class TInputImage1, class TInputImage2,
+          class TOutputImage, class TFunction  >
+typename BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >::StagePointer
+BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
+::CreatePixelwiseStage(const DataObject * & chainInput)
+{
+  chainInput = 0;
+  if ( !m_Fusable )
+    {
+    return 0;
+    }
+  return this->DispatchedCreatePixelwiseStage( chainInput, ScanlineDispatchType() );
+}
+
+template< class TInputImage1, class TInputImage2,
+          class TOutputImage, class TFunction  >
+typename BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >::StagePointer
+BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
+::DispatchedCreatePixelwiseStage(const DataObject * & chainInput, TrueType)
+{
+  typedef BinaryPixelwiseFunctorStage< FunctorType, Input1ImagePixelType, Input2ImagePixelType,
+                                       OutputImagePixelType, TInputImage2 > StageType;
+
+  const TInputImage1 *input1 = dynamic_cast< const TInputImage1 * >( ProcessObject::GetInput(0) );
+  const TInputImage2 *input2 = dynamic_cast< const TInputImage2 * >( ProcessObject::GetInput(1) );
+
+  typename StageType::Pointer stage = StageType::New();
+  stage->SetFunctor(m_Functor);
+  if ( input1 && input2 )
+    {
+    stage->SetOperandImage(input2);
+    chainInput = input1;
+    }
+  else if ( input1 )
+    {
+    stage->SetConstant2( this->GetConstant2() );
+    chainInput = input1;
+    }
+  else if ( input2 )
+    {
+    stage->SetConstant1( this->GetConstant1() );
+    chainInput = input2;
+    }
+  else
+    {
+    return 0;
+    }
+  return stage.GetPointer();
 }
 
 /**
@@ -204,6 +255,82 @@ void
 BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
+{
+  this->DispatchedThreadedGenerateData( outputRegionForThread, threadId, ScanlineDispatchType() );
+}
+
+template< class TInputImage1, class TInputImage2, class TOutputImage, class TFunction  >
+void
+BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
+::DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                 ThreadIdType threadId, TrueType)
+{
+  typedef BinaryScanlineFunctorEvaluator< FunctorType, Input1ImagePixelType,
+                                          Input2ImagePixelType, OutputImagePixelType > EvaluatorType;
+
+  // We use dynamic_cast since inputs are stored as DataObjects.  The
+  // ImageToImageFilter::GetInput(int) always returns a pointer to a
+  // TInputImage1 so it cannot be used for the second input.
+  Input1ImagePointer inputPtr1 =
+    dynamic_cast< const TInputImage1 * >( ProcessObject::GetInput(0) );
+  Input2ImagePointer inputPtr2 =
+    dynamic_cast< const TInputImage2 * >( ProcessObject::GetInput(1) );
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  if ( !inputPtr1 && !inputPtr2 )
+    {
+    itkGenericExceptionMacro(<<"At most one of the inputs can be a constant.");
+    }
+  if ( outputRegionForThread.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+  const SizeValueType numberOfLines = outputRegionForThread.GetNumberOfPixels() / lineLength;
+
+  const Input1ImagePixelType *input1Buffer = inputPtr1 ? inputPtr1->GetBufferPointer() : 0;
+  const Input2ImagePixelType *input2Buffer = inputPtr2 ? inputPtr2->GetBufferPointer() : 0;
+  OutputImagePixelType *      outputBuffer = outputPtr->GetBufferPointer();
+
+  typename OutputImageType::IndexType index = outputRegionForThread.GetIndex();
+
+  ProgressReporter progress(this, threadId, numberOfLines);
+
+  for ( SizeValueType line = 0; line < numberOfLines; ++line )
+    {
+    OutputImagePixelType *output = outputBuffer + outputPtr->ComputeOffset(index);
+    if( inputPtr1 && inputPtr2 )
+      {
+      EvaluatorType::Evaluate( m_Functor,
+                               input1Buffer + inputPtr1->ComputeOffset(index),
+                               input2Buffer + inputPtr2->ComputeOffset(index),
+                               output, lineLength );
+      }
+    else if( inputPtr1 )
+      {
+      EvaluatorType::EvaluateConstant2( m_Functor,
+                                        input1Buffer + inputPtr1->ComputeOffset(index),
+                                        this->GetConstant2(),
+                                        output, lineLength );
+      }
+    else
+      {
+      EvaluatorType::EvaluateConstant1( m_Functor,
+                                        this->GetConstant1(),
+                                        input2Buffer + inputPtr2->ComputeOffset(index),
+                                        output, lineLength );
+      }
+    IncrementScanlineIndex(index, outputRegionForThread);
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+}
+
+template< class TInputImage1, class TInputImage2, class TOutputImage, class TFunction  >
+void
+BinaryFunctorImageFilter< TInputImage1, TInputImage2, TOutputImage, TFunction >
+::DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                 ThreadIdType threadId, FalseType)
 {
   // We use dynamic_cast since inputs are stored as DataObjects.  The
   // ImageToImageFilter::GetInput(int) always returns a pointer to a
@@ -0,0 +1,186 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkFusedFunctorImageFilter_h
+#define __itkFusedFunctorImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkPixelwiseFunctorStage.h"
+#include "itkImage.h"
+#include <vector>
+
+namespace itk
+{
+/** \class FusedFunctorImageFilter
+ * \brief Applies a chain of pixel-wise functors in a single pass.
+ *
+ * A chain of pixel-wise filters, e.g. Cast, Multiply by a constant,
+ * Clamp and Mask, reads and writes a whole image at every filter. This
+ * filter applies the whole chain at once: each scanline of the input is
+ * pushed through the stages using small per-thread buffers, and only the
+ * result of the last stage is written to the output. No intermediate
+ * image is allocated.
+ *
+ * Stages are appended with AddUnaryFunctor(), AddBinaryFunctor() and
+ * AddBinaryFunctorWithConstant(); the input pixel type of a stage must
+ * be the output pixel type of the previous one. The operand images of
+ * the binary stages become inputs of this filter.
+ *
+ * Alternatively, FuseUpstream() builds the stages from an existing chain
+ * of UnaryFunctorImageFilters and BinaryFunctorImageFilters: the output
+ * of this filter then replaces the output of the last filter of the
+ * chain. The functors and constants are copied when the chain is fused.
+ *
+ * All the images must be contiguous, see ImageScanlineTraits; this is
+ * enforced by concept checks.
+ *
+ * \sa UnaryFunctorImageFilter BinaryFunctorImageFilter PixelwiseFunctorStage
+ *
+ * \ingroup IntensityImageFilters MultiThreaded
+ * \ingroup ITKImageFilterBase
+ */
+template< class TInputImage, class TOutputImage >
+class ITK_EXPORT FusedFunctorImageFilter:
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard class typedefs. */
+  typedef FusedFunctorImageFilter                         Self;
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+  typedef SmartPointer< Self >                            Pointer;
+  typedef SmartPointer< const Self >                      ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(FusedFunctorImageFilter, ImageToImageFilter);
+
+  /** Some convenient typedefs. */
+  typedef TInputImage                            InputImageType;
+  typedef typename InputImageType::PixelType     InputImagePixelType;
+  typedef TOutputImage                           OutputImageType;
+  typedef typename OutputImageType::PixelType    OutputImagePixelType;
+  typedef typename OutputImageType::RegionType   OutputImageRegionType;
+
+  itkStaticConstMacro(ImageDimension, unsigned int, TOutputImage::ImageDimension);
+
+  typedef PixelwiseFunctorStage< itkGetStaticConstMacro(ImageDimension) > StageType;
+  typedef typename StageType::Pointer                                     StagePointer;
+
+  /** Append a stage. An exception is thrown if its input pixel type is
+   * not the output pixel type of the previous stage. */
+  void AddStage(StageType *stage);
+
+  /** Append a stage applying functor to pixels of type TInputPixel. */
+  template< class TInputPixel, class TOutputPixel, class TFunctor >
+  void AddUnaryFunctor(const TFunctor & functor)
+  {
+    typedef UnaryPixelwiseFunctorStage< TFunctor, TInputPixel, TOutputPixel,
+                                        itkGetStaticConstMacro(ImageDimension) > UnaryStageType;
+    typename UnaryStageType::Pointer stage = UnaryStageType::New();
+    stage->SetFunctor(functor);
+    this->AddStage(stage);
+  }
+
+  /** Append a stage applying functor to pixels of type TInputPixel and to
+   * the pixels of operandImage. */
+  template< class TInputPixel, class TOutputPixel, class TFunctor, class TOperandImage >
+  void AddBinaryFunctor(const TFunctor & functor, const TOperandImage *operandImage)
+  {
+    typedef BinaryPixelwiseFunctorStage< TFunctor, TInputPixel, typename TOperandImage::PixelType,
+                                         TOutputPixel, TOperandImage > BinaryStageType;
+    typename BinaryStageType::Pointer stage = BinaryStageType::New();
+    stage->SetFunctor(functor);
+    stage->SetOperandImage(operandImage);
+    this->AddStage(stage);
+  }
+
+  /** Append a stage applying functor to pixels of type TInputPixel and to
+   * a constant. */
+  template< class TInputPixel, class TOutputPixel, class TFunctor, class TConstant >
+  void AddBinaryFunctorWithConstant(const TFunctor & functor, const TConstant & constant)
+  {
+    typedef Image< TConstant, itkGetStaticConstMacro(ImageDimension) > UnusedOperandImageType;
+    typedef BinaryPixelwiseFunctorStage< TFunctor, TInputPixel, TConstant,
+                                         TOutputPixel, UnusedOperandImageType > BinaryStageType;
+    typename BinaryStageType::Pointer stage = BinaryStageType::New();
+    stage->SetFunctor(functor);
+    stage->SetConstant2(constant);
+    this->AddStage(stage);
+  }
+
+  /** Remove all the stages and their operand images. */
+  void ClearStages();
+
+  /** Number of stages. */
+  unsigned int GetNumberOfStages() const
+  {
+    return static_cast< unsigned int >( m_Stages.size() );
+  }
+
+  /** Replace the stages by those of the longest chain of fusable functor
+   * filters ending with filter, and connect the input of the first filter
+   * of the chain as the input of this filter. The chain goes upstream
+   * through the input whose pixels flow through each filter, and starts
+   * at the farthest filter whose input is a TInputImage. Returns the
+   * number of fused filters; an exception is thrown if filter cannot be
+   * fused. The filters themselves are not modified.
+   *
+   * Only fuse filters whose intermediate outputs are not needed
+   * elsewhere, since these are not computed by this filter. */
+  unsigned int FuseUpstream(ProcessObject *filter);
+
+#ifdef ITK_USE_CONCEPT_CHECKING
+  /** Begin concept checking */
+  itkConceptMacro( SameDimensionCheck,
+                   ( Concept::SameDimension< TInputImage::ImageDimension, TOutputImage::ImageDimension > ) );
+  itkConceptMacro( InputContiguousCheck,
+                   ( Concept::SameType< typename ScanlineDispatch< ImageScanlineTraits< TInputImage >::IsContiguous >::Type,
+                                        TrueType > ) );
+  itkConceptMacro( OutputContiguousCheck,
+                   ( Concept::SameType< typename ScanlineDispatch< ImageScanlineTraits< TOutputImage >::IsContiguous >::Type,
+                                        TrueType > ) );
+  /** End concept checking */
+#endif
+
+protected:
+  FusedFunctorImageFilter();
+  virtual ~FusedFunctorImageFilter() {}
+
+  /** Check that the stages go from the input to the output pixel type. */
+  void BeforeThreadedGenerateData();
+
+  void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                            ThreadIdType threadId);
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  FusedFunctorImageFilter(const Self &); //purposely not implemented
+  void operator=(const Self &);          //purposely not implemented
+
+  std::vector< StagePointer > m_Stages;
+  unsigned int                m_NumberOfOperandImages;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkFusedFunctorImageFilter.hxx"
+#endif
+
+#endif
@@ -0,0 +1,215 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkFusedFunctorImageFilter_hxx
+#define __itkFusedFunctorImageFilter_hxx
+
+#include "itkFusedFunctorImageFilter.h"
+#include "itkProgressReporter.h"
+#include <algorithm>
+
+namespace itk
+{
+template< class TInputImage, class TOutputImage >
+FusedFunctorImageFilter< TInputImage, TOutputImage >
+::FusedFunctorImageFilter()
+{
+  m_NumberOfOperandImages = 0;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+FusedFunctorImageFilter< TInputImage, TOutputImage >
+::AddStage(StageType *stage)
+{
+  if ( !stage )
+    {
+    itkExceptionMacro(<< "The stage is null");
+    }
+
+  const std::type_info & expected =
+    m_Stages.empty() ? typeid( InputImagePixelType ) : m_Stages.back()->GetOutputPixelType();
+  if ( stage->GetInputPixelType() != expected )
+    {
+    itkExceptionMacro(<< "Stage " << m_Stages.size() << " reads pixels of type "
+                      << stage->GetInputPixelType().name() << " instead of " << expected.name());
+    }
+
+  if ( stage->GetOperandImage() )
+    {
+    ++m_NumberOfOperandImages;
+    this->SetNthInput( m_NumberOfOperandImages, const_cast< DataObject * >( stage->GetOperandImage() ) );
+    }
+  m_Stages.push_back(stage);
+  this->Modified();
+}
+
+template< class TInputImage, class TOutputImage >
+void
+FusedFunctorImageFilter< TInputImage, TOutputImage >
+::ClearStages()
+{
+  m_Stages.clear();
+  m_NumberOfOperandImages = 0;
+  this->SetNumberOfIndexedInputs(1);
+  this->Modified();
+}
+
+template< class TInputImage, class TOutputImage >
+unsigned int
+FusedFunctorImageFilter< TInputImage, TOutputImage >
+::FuseUpstream(ProcessObject *filter)
+{
+  typedef FusableFunctorFilter< itkGetStaticConstMacro(ImageDimension) > FusableType;
+
+  // Walk upstream, from the last filter of the chain.
+  std::vector< StagePointer > stages;
+  const InputImageType *      chainInput = 0;
+  unsigned int                numberOfFusedFilters = 0;
+  while ( filter )
+    {
+    FusableType *fusable = dynamic_cast< FusableType * >( filter );
+    if ( !fusable )
+      {
+      break;
+      }
+    const DataObject *input = 0;
+    StagePointer      stage = fusable->CreatePixelwiseStage(input);
+    if ( !stage || !input )
+      {
+      break;
+      }
+    stages.push_back(stage);
+    if ( dynamic_cast< const InputImageType * >( input ) )
+      {
+      chainInput = static_cast< const InputImageType * >( input );
+      numberOfFusedFilters = static_cast< unsigned int >( stages.size() );
+      }
+    filter = input->GetSource();
+    }
+
+  if ( numberOfFusedFilters == 0 )
+    {
+    itkExceptionMacro(<< "No fusable chain of functor filters reads a "
+                      << typeid( InputImageType ).name());
+    }
+
+  this->ClearStages();
+  for ( unsigned int i = numberOfFusedFilters; i > 0; --i )
+    {
+    this->AddStage(stages[i - 1]);
+    }
+  this->SetInput(chainInput);
+  return numberOfFusedFilters;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+FusedFunctorImageFilter< TInputImage, TOutputImage >
+::BeforeThreadedGenerateData()
+{
+  if ( m_Stages.empty() )
+    {
+    itkExceptionMacro(<< "No stage to apply");
+    }
+  if ( m_Stages.back()->GetOutputPixelType() != typeid( OutputImagePixelType ) )
+    {
+    itkExceptionMacro(<< "The last stage writes pixels of type "
+                      << m_Stages.back()->GetOutputPixelType().name() << " instead of "
+                      << typeid( OutputImagePixelType ).name());
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+FusedFunctorImageFilter< TInputImage, TOutputImage >
+::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                       ThreadIdType threadId)
+{
+  // Long scanlines are processed in blocks so that the intermediate
+  // values stay in the cache.
+  const SizeValueType maximumBlockLength = 1024;
+
+  const InputImageType *inputPtr = this->GetInput();
+  OutputImageType *     outputPtr = this->GetOutput();
+
+  const SizeValueType numberOfPixels = outputRegionForThread.GetNumberOfPixels();
+  if ( numberOfPixels == 0 )
+    {
+    return;
+    }
+
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+  const SizeValueType blockLength = std::min(lineLength, maximumBlockLength);
+  const SizeValueType numberOfLines = numberOfPixels / lineLength;
+  const size_t        numberOfStages = m_Stages.size();
+
+  // One buffer per intermediate result.
+  std::vector< std::vector< char > > buffers(numberOfStages - 1);
+  for ( size_t s = 0; s + 1 < numberOfStages; ++s )
+    {
+    buffers[s].resize( blockLength * m_Stages[s]->GetOutputPixelSize() );
+    }
+
+  const InputImagePixelType *inputBuffer = inputPtr->GetBufferPointer();
+  OutputImagePixelType *     outputBuffer = outputPtr->GetBufferPointer();
+
+  typename OutputImageType::IndexType lineIndex = outputRegionForThread.GetIndex();
+
+  ProgressReporter progress(this, threadId, numberOfLines);
+
+  for ( SizeValueType line = 0; line < numberOfLines; ++line )
+    {
+    typename OutputImageType::IndexType index = lineIndex;
+    for ( SizeValueType done = 0; done < lineLength; done += blockLength )
+      {
+      const SizeValueType length = std::min(blockLength, lineLength - done);
+      const void *        in = inputBuffer + inputPtr->ComputeOffset(index);
+      for ( size_t s = 0; s < numberOfStages; ++s )
+        {
+        void *out = ( s + 1 < numberOfStages )
+                    ? static_cast< void * >( &buffers[s][0] )
+                    : static_cast< void * >( outputBuffer + outputPtr->ComputeOffset(index) );
+        m_Stages[s]->Evaluate(in, out, index, length);
+        in = out;
+        }
+      index[0] += static_cast< IndexValueType >( length );
+      }
+    IncrementScanlineIndex(lineIndex, outputRegionForThread);
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+FusedFunctorImageFilter< TInputImage, TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfStages: " << m_Stages.size() << std::endl;
+  for ( size_t s = 0; s < m_Stages.size(); ++s )
+    {
+    os << indent.GetNextIndent() << s << ": " << m_Stages[s]->GetNameOfClass()
+       << " (" << m_Stages[s]->GetInputPixelType().name() << " -> "
+       << m_Stages[s]->GetOutputPixelType().name() << ")" << std::endl;
+    }
+  os << indent << "NumberOfOperandImages: " << m_NumberOfOperandImages << std::endl;
+}
+} // end namespace itk
+
+#endif
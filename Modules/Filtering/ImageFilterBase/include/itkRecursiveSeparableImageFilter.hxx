@@ -23,6 +23,8 @@
 #include "itkImageLinearIteratorWithIndex.h"
 #include "itkProgressReporter.h"
 #include <new>
+#include <vector>
+#include <algorithm>
 
 namespace itk
 {
@@ -152,6 +154,98 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
     }
 }
 
+/**
+ * Apply Recursive Filter to a block of lines
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::FilterDataBlock(RealType *outs, const RealType *data,
+                  RealType *scratch, unsigned int ln, unsigned int width)
+{
+  // The coefficients are copied so that the compiler knows that they are
+  // not modified by the stores to the arrays. The terms are summed in the
+  // same order as in FilterDataArray().
+  const ScalarRealType n0 = m_N0, n1 = m_N1, n2 = m_N2, n3 = m_N3;
+  const ScalarRealType m1 = m_M1, m2 = m_M2, m3 = m_M3, m4 = m_M4;
+  const ScalarRealType d1 = m_D1, d2 = m_D2, d3 = m_D3, d4 = m_D4;
+  const OffsetValueType w = width;
+
+  /**
+   * Causal direction pass
+   */
+  for ( OffsetValueType b = 0; b < w; ++b )
+    {
+    const RealType *x = data + b;
+    RealType *      y = scratch + b;
+
+    // this value is assumed to exist from the border to infinity.
+    const RealType outV1 = x[0];
+
+    y[0]     = RealType(outV1    * n0 +   outV1 * n1 + outV1    * n2 + outV1 * n3);
+    y[w]     = RealType(x[w]     * n0 +   outV1 * n1 + outV1    * n2 + outV1 * n3);
+    y[2 * w] = RealType(x[2 * w] * n0 + x[w]    * n1 + outV1    * n2 + outV1 * n3);
+    y[3 * w] = RealType(x[3 * w] * n0 + x[2 * w] * n1 + x[w]    * n2 + outV1 * n3);
+
+    y[0]     -= RealType(outV1    * m_BN1 + outV1 * m_BN2 + outV1 * m_BN3 + outV1 * m_BN4);
+    y[w]     -= RealType(y[0]     * d1 + outV1    * m_BN2 + outV1 * m_BN3 + outV1 * m_BN4);
+    y[2 * w] -= RealType(y[w]     * d1 + y[0]     * d2 + outV1 * m_BN3 + outV1 * m_BN4);
+    y[3 * w] -= RealType(y[2 * w] * d1 + y[w]     * d2 + y[0]  * d3 + outV1 * m_BN4);
+    }
+
+  for ( unsigned int i = 4; i < ln; i++ )
+    {
+    const RealType *x = data + i * w;
+    RealType *      y = scratch + i * w;
+    for ( OffsetValueType b = 0; b < w; ++b )
+      {
+      y[b]  = RealType(x[b] * n0 + x[b - w] * n1 + x[b - 2 * w] * n2 + x[b - 3 * w] * n3);
+      y[b] -= RealType(y[b - w] * d1 + y[b - 2 * w] * d2 + y[b - 3 * w] * d3 + y[b - 4 * w] * d4);
+      }
+    }
+
+  std::copy(scratch, scratch + ln * w, outs);
+
+  /**
+   * AntiCausal direction pass
+   */
+  const OffsetValueType last = ( ln - 1 ) * w;
+  for ( OffsetValueType b = 0; b < w; ++b )
+    {
+    const RealType *x = data + last + b;
+    RealType *      y = scratch + last + b;
+
+    // this value is assumed to exist from the border to infinity.
+    const RealType outV2 = x[0];
+
+    y[0]      = RealType(outV2 * m1 + outV2 * m2 + outV2 * m3 + outV2 * m4);
+    y[-w]     = RealType(x[0]  * m1 + outV2 * m2 + outV2 * m3 + outV2 * m4);
+    y[-2 * w] = RealType(x[-w] * m1 + x[0]  * m2 + outV2 * m3 + outV2 * m4);
+    y[-3 * w] = RealType(x[-2 * w] * m1 + x[-w] * m2 + x[0] * m3 + outV2 * m4);
+
+    y[0]      -= RealType(outV2     * m_BM1 + outV2 * m_BM2 + outV2 * m_BM3 + outV2 * m_BM4);
+    y[-w]     -= RealType(y[0]      * d1 + outV2     * m_BM2 + outV2 * m_BM3 + outV2 * m_BM4);
+    y[-2 * w] -= RealType(y[-w]     * d1 + y[0]      * d2 + outV2 * m_BM3 + outV2 * m_BM4);
+    y[-3 * w] -= RealType(y[-2 * w] * d1 + y[-w]     * d2 + y[0]  * d3 + outV2 * m_BM4);
+    }
+
+  for ( unsigned int i = ln - 4; i > 0; i-- )
+    {
+    const RealType *x = data + i * w;
+    RealType *      y = scratch + ( i - 1 ) * w;
+    for ( OffsetValueType b = 0; b < w; ++b )
+      {
+      y[b]  = RealType(x[b] * m1 + x[b + w] * m2 + x[b + 2 * w] * m3 + x[b + 3 * w] * m4);
+      y[b] -= RealType(y[b + w] * d1 + y[b + 2 * w] * d2 + y[b + 3 * w] * d3 + y[b + 4 * w] * d4);
+      }
+    }
+
+  for ( OffsetValueType i = 0; i < ln * w; i++ )
+    {
+    outs[i] += scratch[i];
+    }
+}
+
 //
 // we need all of the image in just the "Direction" we are separated into
 //
@@ -284,6 +378,18 @@ template< typename TInputImage, typename TOutputImage >
 void
 RecursiveSeparableImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
+{
+  this->DispatchedThreadedGenerateData( outputRegionForThread, threadId, BlockDispatchType() );
+}
+
+/**
+ * Compute Recursive filter
+ * line by line in one of the dimensions
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::LineThreadedGenerateData(const OutputImageRegionType & outputRegionForThread, ThreadIdType threadId)
 {
   typedef typename TOutputImage::PixelType OutputPixelType;
 
@@ -397,6 +503,97 @@ RecursiveSeparableImageFilter< TInputImage, TOutputImage >
   delete[] scratch;
 }
 
+/**
+ * Compute Recursive filter
+ * by blocks of lines adjacent along the first dimension
+ */
+template< typename TInputImage, typename TOutputImage >
+void
+RecursiveSeparableImageFilter< TInputImage, TOutputImage >
+::DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                 ThreadIdType threadId, TrueType)
+{
+  // The lines along the first dimension are contiguous already.
+  if ( this->m_Direction == 0 )
+    {
+    this->LineThreadedGenerateData(outputRegionForThread, threadId);
+    return;
+    }
+
+  typedef typename TOutputImage::PixelType OutputPixelType;
+  typedef typename TOutputImage::IndexType IndexType;
+
+  const TInputImage *inputImage = this->GetInputImage();
+  TOutputImage *     outputImage = this->GetOutput();
+
+  const unsigned int    direction = this->m_Direction;
+  const unsigned int    ln = outputRegionForThread.GetSize(direction);
+  const SizeValueType   rowLength = outputRegionForThread.GetSize(0);
+  const OffsetValueType inputStride = inputImage->GetOffsetTable()[direction];
+  const OffsetValueType outputStride = outputImage->GetOffsetTable()[direction];
+
+  std::vector< RealType > inps(ln * BlockWidth);
+  std::vector< RealType > outs(ln * BlockWidth);
+  std::vector< RealType > scratch(ln * BlockWidth);
+
+  // The first pixel of each row of lines.
+  OutputImageRegionType rowRegion = outputRegionForThread;
+  rowRegion.SetSize(0, 1);
+  rowRegion.SetSize(direction, 1);
+  const SizeValueType numberOfRows = rowRegion.GetNumberOfPixels();
+
+  ProgressReporter progress(this, threadId, numberOfRows * rowLength, 10);
+
+  IndexType index = rowRegion.GetIndex();
+  for ( SizeValueType row = 0; row < numberOfRows; ++row )
+    {
+    const InputPixelType *inputRow = inputImage->GetBufferPointer() + inputImage->ComputeOffset(index);
+    OutputPixelType *     outputRow = outputImage->GetBufferPointer() + outputImage->ComputeOffset(index);
+
+    for ( SizeValueType first = 0; first < rowLength; first += BlockWidth )
+      {
+      const unsigned int width =
+        static_cast< unsigned int >( std::min( static_cast< SizeValueType >( BlockWidth ), rowLength - first ) );
+
+      const InputPixelType *in = inputRow + first;
+      for ( unsigned int i = 0; i < ln; ++i, in += inputStride )
+        {
+        RealType *block = &inps[i * width];
+        for ( unsigned int b = 0; b < width; ++b )
+          {
+          block[b] = in[b];
+          }
+        }
+
+      this->FilterDataBlock(&outs[0], &inps[0], &scratch[0], ln, width);
+
+      OutputPixelType *out = outputRow + first;
+      for ( unsigned int i = 0; i < ln; ++i, out += outputStride )
+        {
+        const RealType *block = &outs[i * width];
+        for ( unsigned int b = 0; b < width; ++b )
+          {
+          out[b] = static_cast< OutputPixelType >( block[b] );
+          }
+        }
+
+      for ( unsigned int b = 0; b < width; ++b )
+        {
+        progress.CompletedPixel();
+        }
+      }
+
+    for ( unsigned int d = 0; d < TOutputImage::ImageDimension; ++d )
+      {
+      if ( ++index[d] < rowRegion.GetIndex(d) + static_cast< IndexValueType >( rowRegion.GetSize(d) ) )
+        {
+        break;
+        }
+      index[d] = rowRegion.GetIndex(d);
+      }
+    }
+}
+
 template< typename TInputImage, typename TOutputImage >
 void
 RecursiveSeparableImageFilter< TInputImage, TOutputImage >
@@ -20,6 +20,7 @@
 
 #include "itkInPlaceImageFilter.h"
 #include "itkImageRegionIteratorWithIndex.h"
+#include "itkScanlineFunctorEvaluator.h"
 
 namespace itk
 {
@@ -30,6 +31,11 @@ namespace itk
  * and the type of the output image.  It is also parameterized by the
  * operation to be applied, using a Functor style.
  *
+ * When all the images store their pixels contiguously (see
+ * ImageScanlineTraits), the functor is applied a scanline at a time,
+ * straight from the image buffers, through TernaryScanlineFunctorEvaluator.
+ * Other images are walked with iterators.
+ *
  * \sa BinaryFunctorImageFilter UnaryFunctorImageFilter
  *
  * \ingroup IntensityImageFilters MultiThreaded
@@ -156,6 +162,22 @@ private:
   TernaryFunctorImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);            //purposely not implemented
 
+  /** TrueType when the scanlines of all the images can be processed
+   * straight from their buffers. */
+  typedef typename ScanlineDispatch<
+    ImageScanlineTraits< TInputImage1 >::IsContiguous
+    && ImageScanlineTraits< TInputImage2 >::IsContiguous
+    && ImageScanlineTraits< TInputImage3 >::IsContiguous
+    && ImageScanlineTraits< TOutputImage >::IsContiguous >::Type ScanlineDispatchType;
+
+  /** Process the region a scanline at a time. */
+  void DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                      ThreadIdType threadId, TrueType);
+
+  /** Process the region with iterators. */
+  void DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                      ThreadIdType threadId, FalseType);
+
   FunctorType m_Functor;
 };
 } // end namespace itk
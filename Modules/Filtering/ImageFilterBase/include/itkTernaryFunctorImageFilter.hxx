@@ -108,6 +108,63 @@ void
 TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImage, TFunction >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
+{
+  this->DispatchedThreadedGenerateData( outputRegionForThread, threadId, ScanlineDispatchType() );
+}
+
+template< class TInputImage1, class TInputImage2,
+          class TInputImage3, class TOutputImage, class TFunction  >
+void
+TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImage, TFunction >
+::DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                 ThreadIdType threadId, TrueType)
+{
+  Input1ImagePointer inputPtr1 =
+    dynamic_cast< const TInputImage1 * >( ( ProcessObject::GetInput(0) ) );
+  Input2ImagePointer inputPtr2 =
+    dynamic_cast< const TInputImage2 * >( ( ProcessObject::GetInput(1) ) );
+  Input3ImagePointer inputPtr3 =
+    dynamic_cast< const TInputImage3 * >( ( ProcessObject::GetInput(2) ) );
+  OutputImagePointer outputPtr = this->GetOutput(0);
+
+  if ( outputRegionForThread.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+  const SizeValueType numberOfLines = outputRegionForThread.GetNumberOfPixels() / lineLength;
+
+  const Input1ImagePixelType *input1Buffer = inputPtr1->GetBufferPointer();
+  const Input2ImagePixelType *input2Buffer = inputPtr2->GetBufferPointer();
+  const Input3ImagePixelType *input3Buffer = inputPtr3->GetBufferPointer();
+  OutputImagePixelType *      outputBuffer = outputPtr->GetBufferPointer();
+
+  typename OutputImageType::IndexType index = outputRegionForThread.GetIndex();
+
+  ProgressReporter progress(this, threadId, numberOfLines);
+
+  for ( SizeValueType line = 0; line < numberOfLines; ++line )
+    {
+    TernaryScanlineFunctorEvaluator< FunctorType, Input1ImagePixelType, Input2ImagePixelType,
+                                     Input3ImagePixelType, OutputImagePixelType >
+    ::Evaluate( m_Functor,
+                input1Buffer + inputPtr1->ComputeOffset(index),
+                input2Buffer + inputPtr2->ComputeOffset(index),
+                input3Buffer + inputPtr3->ComputeOffset(index),
+                outputBuffer + outputPtr->ComputeOffset(index),
+                lineLength );
+    IncrementScanlineIndex(index, outputRegionForThread);
+    progress.CompletedPixel(); // potential exception thrown here
+    }
+}
+
+template< class TInputImage1, class TInputImage2,
+          class TInputImage3, class TOutputImage, class TFunction  >
+void
+TernaryFunctorImageFilter< TInputImage1, TInputImage2, TInputImage3, TOutputImage, TFunction >
+::DispatchedThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                 ThreadIdType threadId, FalseType)
 {
   // We use dynamic_cast since inputs are stored as DataObjects.  The
   // ImageToImageFilter::GetInput(int) always returns a pointer to a
@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkFusedFunctorImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkClampImageFilter.h"
+#include "itkMultiplyImageFilter.h"
+#include "itkMaskImageFilter.h"
+#include "itkRescaleIntensityImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+
+namespace
+{
+template< class TImage >
+bool
+SameImages(const char *name, const TImage *image, const TImage *reference)
+{
+  itk::ImageRegionConstIterator< TImage > it( image, reference->GetBufferedRegion() );
+  itk::ImageRegionConstIterator< TImage > ref( reference, reference->GetBufferedRegion() );
+  for ( it.GoToBegin(), ref.GoToBegin(); !ref.IsAtEnd(); ++it, ++ref )
+    {
+    if ( it.Get() != ref.Get() )
+      {
+      std::cerr << name << ": got " << static_cast< int >( it.Get() ) << " instead of "
+                << static_cast< int >( ref.Get() ) << std::endl;
+      return false;
+      }
+    }
+  std::cout << name << " passed." << std::endl;
+  return true;
+}
+}
+
+int itkFusedFunctorImageFilterTest(int, char *[])
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< short, Dimension >         InputImageType;
+  typedef itk::Image< float, Dimension >         RealImageType;
+  typedef itk::Image< unsigned char, Dimension > OutputImageType;
+
+  InputImageType::SizeType size;
+  size[0] = 1500; // longer than a block
+  size[1] = 7;
+  size[2] = 3;
+
+  InputImageType::Pointer input = InputImageType::New();
+  input->SetRegions(size);
+  input->Allocate();
+  OutputImageType::Pointer mask = OutputImageType::New();
+  mask->SetRegions(size);
+  mask->Allocate();
+
+  unsigned int seed = 17;
+  for ( itk::SizeValueType i = 0; i < input->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    seed = seed * 1103515245 + 12345;
+    input->GetBufferPointer()[i] = static_cast< short >( ( seed >> 16 ) % 2001 ) - 1000;
+    mask->GetBufferPointer()[i] = ( seed >> 8 ) % 4 ? 1 : 0;
+    }
+
+  // Rescale -> Cast -> Multiply by a constant -> Mask -> Clamp
+  typedef itk::RescaleIntensityImageFilter< InputImageType, InputImageType >            RescaleType;
+  typedef itk::CastImageFilter< InputImageType, RealImageType >                         CastType;
+  typedef itk::MultiplyImageFilter< RealImageType, RealImageType, RealImageType >       MultiplyType;
+  typedef itk::MaskImageFilter< RealImageType, OutputImageType, RealImageType >         MaskType;
+  typedef itk::ClampImageFilter< RealImageType, OutputImageType >                       ClampType;
+
+  RescaleType::Pointer rescale = RescaleType::New();
+  rescale->SetInput(input);
+  rescale->SetOutputMinimum(-600);
+  rescale->SetOutputMaximum(700);
+  CastType::Pointer cast = CastType::New();
+  cast->SetInput( rescale->GetOutput() );
+  MultiplyType::Pointer multiply = MultiplyType::New();
+  multiply->SetInput1( cast->GetOutput() );
+  multiply->SetConstant2(0.5f);
+  MaskType::Pointer maskFilter = MaskType::New();
+  maskFilter->SetInput1( multiply->GetOutput() );
+  maskFilter->SetInput2(mask);
+  maskFilter->SetOutsideValue(42);
+  ClampType::Pointer clamp = ClampType::New();
+  clamp->SetInput( maskFilter->GetOutput() );
+  clamp->Update();
+
+  bool result = true;
+
+  // The rewrite stops at the rescale filter, whose functor depends on the
+  // statistics of its input.
+  typedef itk::FusedFunctorImageFilter< InputImageType, OutputImageType > FusedType;
+  FusedType::Pointer fused = FusedType::New();
+  const unsigned int numberOfFusedFilters = fused->FuseUpstream(clamp);
+  if ( numberOfFusedFilters != 4 || fused->GetNumberOfStages() != 4
+       || fused->GetInput() != rescale->GetOutput() )
+    {
+    std::cerr << "FuseUpstream() fused " << numberOfFusedFilters << " filters" << std::endl;
+    result = false;
+    }
+  fused->SetNumberOfThreads(3);
+  fused->Update();
+  fused->Print(std::cout);
+  result &= SameImages( "FuseUpstream", fused->GetOutput(), clamp->GetOutput() );
+
+  // The same chain, built by hand.
+  fused = FusedType::New();
+  fused->SetInput( rescale->GetOutput() );
+  fused->AddUnaryFunctor< short, float >( itk::Functor::Cast< short, float >() );
+  fused->AddBinaryFunctorWithConstant< float, float >( itk::Functor::Mult< float, float, float >(), 0.5f );
+  itk::Functor::MaskInput< float, unsigned char, float > maskFunctor;
+  maskFunctor.SetOutsideValue(42);
+  fused->AddBinaryFunctor< float, float >( maskFunctor, mask.GetPointer() );
+  fused->AddUnaryFunctor< float, unsigned char >( itk::Functor::Clamp< float, unsigned char >() );
+  fused->Update();
+  result &= SameImages( "AddStage", fused->GetOutput(), clamp->GetOutput() );
+
+  // The pixel types of consecutive stages must match.
+  bool caught = false;
+  try
+    {
+    fused->AddUnaryFunctor< double, float >( itk::Functor::Cast< double, float >() );
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Expected exception: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+
+  // Filters that are not fusable end the chain.
+  clamp->FusableOff();
+  try
+    {
+    fused->FuseUpstream(clamp);
+    caught = false;
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cout << "Expected exception: " << e.GetDescription() << std::endl;
+    }
+  if ( !caught )
+    {
+    std::cerr << "Missing exception" << std::endl;
+    result = false;
+    }
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
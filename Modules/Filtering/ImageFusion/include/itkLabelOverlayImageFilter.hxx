@@ -29,6 +29,8 @@ template< class TInputImage, class TLabelImage, class TOutputImage >
 LabelOverlayImageFilter< TInputImage, TLabelImage, TOutputImage >
 ::LabelOverlayImageFilter()
 {
+  // The functor is set up in BeforeThreadedGenerateData().
+  this->FusableOff();
   m_Opacity = 0.5;
   m_BackgroundValue = NumericTraits< LabelPixelType >::Zero;
 }
@@ -39,6 +39,8 @@ template< class TLabelImage, class TOutputImage >
 LabelToRGBImageFilter< TLabelImage, TOutputImage >
 ::LabelToRGBImageFilter()
 {
+  // The functor is set up in BeforeThreadedGenerateData().
+  this->FusableOff();
   m_BackgroundValue = NumericTraits< LabelPixelType >::Zero;
   NumericTraits< OutputPixelType>::SetLength( m_BackgroundColor, 3);
   m_BackgroundColor.Fill(NumericTraits< OutputPixelValueType >::Zero);
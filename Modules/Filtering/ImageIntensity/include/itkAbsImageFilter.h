@@ -52,6 +52,17 @@ public:
 };
 }
 
+#if defined( ITK_SCANLINE_SSE2 )
+/** Take the absolute value of float and double scanlines with SSE2. */
+template< >
+struct UnaryScanlineFunctorEvaluator< Functor::Abs< float, float >, float, float >:
+  public SSE2UnaryScanlineFunctorEvaluator< Functor::Abs< float, float >, float, ScanlineSSE2::Abs > {};
+
+template< >
+struct UnaryScanlineFunctorEvaluator< Functor::Abs< double, double >, double, double >:
+  public SSE2UnaryScanlineFunctorEvaluator< Functor::Abs< double, double >, double, ScanlineSSE2::Abs > {};
+#endif
+
 /** \class AbsImageFilter
  * \brief Computes the absolute value of each pixel.
  *
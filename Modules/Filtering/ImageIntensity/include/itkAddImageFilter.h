@@ -55,6 +55,18 @@ public:
   }
 };
 }
+
+#if defined( ITK_SCANLINE_SSE2 )
+/** Add float and double scanlines with SSE2. */
+template< >
+struct BinaryScanlineFunctorEvaluator< Functor::Add2< float, float, float >, float, float, float >:
+  public SSE2BinaryScanlineFunctorEvaluator< Functor::Add2< float, float, float >, float, ScanlineSSE2::Add > {};
+
+template< >
+struct BinaryScanlineFunctorEvaluator< Functor::Add2< double, double, double >, double, double, double >:
+  public SSE2BinaryScanlineFunctorEvaluator< Functor::Add2< double, double, double >, double, ScanlineSSE2::Add > {};
+#endif
+
 /** \class AddImageFilter
  * \brief Pixel-wise addition of two images.
  *
@@ -40,6 +40,8 @@ template< class TInputImage, class TOutputImage >
 IntensityWindowingImageFilter< TInputImage, TOutputImage >
 ::IntensityWindowingImageFilter()
 {
+  // The functor is set up in BeforeThreadedGenerateData().
+  this->FusableOff();
   m_OutputMaximum   = NumericTraits< OutputPixelType >::max();
   m_OutputMinimum   = NumericTraits< OutputPixelType >::NonpositiveMin();
 
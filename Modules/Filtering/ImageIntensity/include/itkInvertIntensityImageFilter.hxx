@@ -40,6 +40,8 @@ template< class TInputImage, class TOutputImage >
 InvertIntensityImageFilter< TInputImage, TOutputImage >
 ::InvertIntensityImageFilter()
 {
+  // The functor is set up in BeforeThreadedGenerateData().
+  this->FusableOff();
   m_Maximum = NumericTraits< InputPixelType >::max();
 }
 
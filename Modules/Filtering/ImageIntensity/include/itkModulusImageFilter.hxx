@@ -39,6 +39,8 @@ template< class TInputImage, class TOutputImage >
 ModulusImageFilter< TInputImage, TOutputImage >
 ::ModulusImageFilter()
 {
+  // The functor is set up in BeforeThreadedGenerateData().
+  this->FusableOff();
   m_Dividend = 5;
 }
 
@@ -49,6 +49,18 @@ public:
   { return (TOutput)( A * B ); }
 };
 }
+
+#if defined( ITK_SCANLINE_SSE2 )
+/** Multiply float and double scanlines with SSE2. */
+template< >
+struct BinaryScanlineFunctorEvaluator< Functor::Mult< float, float, float >, float, float, float >:
+  public SSE2BinaryScanlineFunctorEvaluator< Functor::Mult< float, float, float >, float, ScanlineSSE2::Multiply > {};
+
+template< >
+struct BinaryScanlineFunctorEvaluator< Functor::Mult< double, double, double >, double, double, double >:
+  public SSE2BinaryScanlineFunctorEvaluator< Functor::Mult< double, double, double >, double, ScanlineSSE2::Multiply > {};
+#endif
+
 /** \class MultiplyImageFilter
  * \brief Pixel-wise multiplication of two images.
  *
@@ -40,6 +40,8 @@ template< class TInputImage, class TOutputImage >
 RescaleIntensityImageFilter< TInputImage, TOutputImage >
 ::RescaleIntensityImageFilter()
 {
+  // The functor is set up in BeforeThreadedGenerateData().
+  this->FusableOff();
   m_OutputMaximum   = NumericTraits< OutputPixelType >::max();
   m_OutputMinimum   = NumericTraits< OutputPixelType >::NonpositiveMin();
 
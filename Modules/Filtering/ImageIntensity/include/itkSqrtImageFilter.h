@@ -52,6 +52,18 @@ public:
   }
 };
 }
+
+#if defined( ITK_SCANLINE_SSE2 )
+/** Take the square root of float and double scanlines with SSE2. */
+template< >
+struct UnaryScanlineFunctorEvaluator< Functor::Sqrt< float, float >, float, float >:
+  public SSE2UnaryScanlineFunctorEvaluator< Functor::Sqrt< float, float >, float, ScanlineSSE2::Sqrt > {};
+
+template< >
+struct UnaryScanlineFunctorEvaluator< Functor::Sqrt< double, double >, double, double >:
+  public SSE2UnaryScanlineFunctorEvaluator< Functor::Sqrt< double, double >, double, ScanlineSSE2::Sqrt > {};
+#endif
+
 /** \class SqrtImageFilter
  * \brief Computes the square root of each pixel.
  *
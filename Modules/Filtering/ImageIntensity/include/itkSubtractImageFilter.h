@@ -49,6 +49,18 @@ public:
   { return (TOutput)( A - B ); }
 };
 }
+
+#if defined( ITK_SCANLINE_SSE2 )
+/** Subtract float and double scanlines with SSE2. */
+template< >
+struct BinaryScanlineFunctorEvaluator< Functor::Sub2< float, float, float >, float, float, float >:
+  public SSE2BinaryScanlineFunctorEvaluator< Functor::Sub2< float, float, float >, float, ScanlineSSE2::Subtract > {};
+
+template< >
+struct BinaryScanlineFunctorEvaluator< Functor::Sub2< double, double, double >, double, double, double >:
+  public SSE2BinaryScanlineFunctorEvaluator< Functor::Sub2< double, double, double >, double, ScanlineSSE2::Subtract > {};
+#endif
+
 /** \class SubtractImageFilter
  * \brief Pixel-wise subtraction of two images.
  *
@@ -126,7 +126,12 @@ public:
   /** End concept checking */
 #endif
 protected:
-  VectorIndexSelectionCastImageFilter() {}
+  VectorIndexSelectionCastImageFilter()
+  {
+    // The functor is checked in BeforeThreadedGenerateData().
+    this->FusableOff();
+  }
+
   virtual ~VectorIndexSelectionCastImageFilter() {}
 
   virtual void BeforeThreadedGenerateData()
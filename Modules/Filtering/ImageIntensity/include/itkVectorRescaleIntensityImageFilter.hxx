@@ -39,6 +39,8 @@ template< class TInputImage, class TOutputImage >
 VectorRescaleIntensityImageFilter< TInputImage, TOutputImage >
 ::VectorRescaleIntensityImageFilter()
 {
+  // The functor is set up in BeforeThreadedGenerateData().
+  this->FusableOff();
   m_OutputMaximumMagnitude   = NumericTraits< OutputRealType >::Zero;
   m_InputMaximumMagnitude    = NumericTraits< InputRealType  >::Zero;
 
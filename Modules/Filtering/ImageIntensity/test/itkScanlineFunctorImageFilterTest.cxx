@@ -0,0 +1,257 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkAddImageFilter.h"
+#include "itkSubtractImageFilter.h"
+#include "itkMultiplyImageFilter.h"
+#include "itkAbsImageFilter.h"
+#include "itkSqrtImageFilter.h"
+#include "itkTernaryAddImageFilter.h"
+#include "itkVectorImage.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+namespace
+{
+const unsigned int Dimension = 3;
+
+/** An image of odd size, so that scanlines do not hold a whole number of
+ * SIMD registers. */
+template< class TImage >
+typename TImage::Pointer
+CreateImage(unsigned int seed, bool positive)
+{
+  typename TImage::SizeType size;
+  size[0] = 37;
+  size[1] = 5;
+  size[2] = 3;
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  typename TImage::PixelType *buffer = image->GetBufferPointer();
+  const itk::SizeValueType    numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  for ( itk::SizeValueType i = 0; i < numberOfPixels; ++i )
+    {
+    seed = seed * 1103515245 + 12345;
+    const int value = static_cast< int >( ( seed >> 16 ) % 2001 ) - 1000;
+    buffer[i] = static_cast< typename TImage::PixelType >( positive ? vnl_math_abs(value) : value ) / 8;
+    }
+  return image;
+}
+
+/** Restrict the output to an inner region, so that the output scanlines
+ * start at a different offset than the input ones. */
+template< class TImage >
+void
+RequestInnerRegion(TImage *output, const typename TImage::RegionType & largest)
+{
+  typename TImage::RegionType region = largest;
+  region.ShrinkByRadius(1);
+  output->SetRequestedRegion(region);
+}
+
+template< class TFilter >
+bool
+CheckBinary(const char *name, TFilter *filter,
+            const typename TFilter::Input1ImageType *input1,
+            const typename TFilter::Input2ImageType *input2)
+{
+  typedef typename TFilter::OutputImageType OutputImageType;
+
+  filter->SetNumberOfThreads(3);
+  filter->GetOutput()->UpdateOutputInformation();
+  RequestInnerRegion( filter->GetOutput(), filter->GetOutput()->GetLargestPossibleRegion() );
+  filter->Update();
+
+  itk::ImageRegionConstIteratorWithIndex< OutputImageType > it( filter->GetOutput(),
+                                                               filter->GetOutput()->GetRequestedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TFilter::Input1ImagePixelType a =
+      input1 ? input1->GetPixel( it.GetIndex() ) : filter->GetConstant1();
+    const typename TFilter::Input2ImagePixelType b =
+      input2 ? input2->GetPixel( it.GetIndex() ) : filter->GetConstant2();
+    if ( it.Get() != filter->GetFunctor()(a, b) )
+      {
+      std::cerr << name << ": wrong value at " << it.GetIndex() << ": " << it.Get()
+                << " instead of " << filter->GetFunctor()(a, b) << std::endl;
+      return false;
+      }
+    }
+  std::cout << name << " passed." << std::endl;
+  return true;
+}
+
+template< class TFilter >
+bool
+CheckUnary(const char *name, TFilter *filter, const typename TFilter::InputImageType *input)
+{
+  typedef typename TFilter::OutputImageType OutputImageType;
+
+  filter->SetInput(input);
+  filter->SetNumberOfThreads(3);
+  filter->GetOutput()->UpdateOutputInformation();
+  RequestInnerRegion( filter->GetOutput(), filter->GetOutput()->GetLargestPossibleRegion() );
+  filter->Update();
+
+  itk::ImageRegionConstIteratorWithIndex< OutputImageType > it( filter->GetOutput(),
+                                                               filter->GetOutput()->GetRequestedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const typename TFilter::OutputImagePixelType expected =
+      filter->GetFunctor()( input->GetPixel( it.GetIndex() ) );
+    if ( it.Get() != expected )
+      {
+      std::cerr << name << ": wrong value at " << it.GetIndex() << ": " << it.Get()
+                << " instead of " << expected << std::endl;
+      return false;
+      }
+    }
+  std::cout << name << " passed." << std::endl;
+  return true;
+}
+
+template< class TPixel >
+bool
+CheckArithmetic(const char *pixelName)
+{
+  typedef itk::Image< TPixel, Dimension > ImageType;
+  typename ImageType::Pointer input1 = CreateImage< ImageType >(1, false);
+  typename ImageType::Pointer input2 = CreateImage< ImageType >(2, false);
+  typename ImageType::Pointer positive = CreateImage< ImageType >(3, true);
+
+  std::cout << "Pixel type: " << pixelName << std::endl;
+  bool result = true;
+
+  typedef itk::AddImageFilter< ImageType > AddType;
+  typename AddType::Pointer add = AddType::New();
+  add->SetInput1(input1);
+  add->SetInput2(input2);
+  result &= CheckBinary("Add", add.GetPointer(), input1.GetPointer(), input2.GetPointer());
+
+  add = AddType::New();
+  add->SetInput1(input1);
+  add->SetConstant2( static_cast< TPixel >( 3 ) );
+  result &= CheckBinary("Add constant", add.GetPointer(), input1.GetPointer(), 0);
+
+  typedef itk::SubtractImageFilter< ImageType > SubtractType;
+  typename SubtractType::Pointer subtract = SubtractType::New();
+  subtract->SetConstant1( static_cast< TPixel >( 7 ) );
+  subtract->SetInput2(input2);
+  result &= CheckBinary("Subtract from constant", subtract.GetPointer(), 0, input2.GetPointer());
+
+  typedef itk::MultiplyImageFilter< ImageType > MultiplyType;
+  typename MultiplyType::Pointer multiply = MultiplyType::New();
+  multiply->SetInput1(input1);
+  multiply->SetInput2(input2);
+  result &= CheckBinary("Multiply", multiply.GetPointer(), input1.GetPointer(), input2.GetPointer());
+
+  typedef itk::AbsImageFilter< ImageType, ImageType > AbsType;
+  typename AbsType::Pointer abs = AbsType::New();
+  result &= CheckUnary("Abs", abs.GetPointer(), input1.GetPointer());
+
+  typedef itk::SqrtImageFilter< ImageType, ImageType > SqrtType;
+  typename SqrtType::Pointer sqrt = SqrtType::New();
+  result &= CheckUnary("Sqrt", sqrt.GetPointer(), positive.GetPointer());
+
+  return result;
+}
+
+/** Doubles each component of a vector pixel. */
+class VectorDouble
+{
+public:
+  typedef itk::VariableLengthVector< float > PixelType;
+  bool operator!=(const VectorDouble &) const { return false; }
+  bool operator==(const VectorDouble &) const { return true; }
+  PixelType operator()(const PixelType & v) const
+  {
+    PixelType result( v.GetSize() );
+    for ( unsigned int i = 0; i < v.GetSize(); ++i )
+      {
+      result[i] = 2 * v[i];
+      }
+    return result;
+  }
+};
+}
+
+int itkScanlineFunctorImageFilterTest(int, char *[])
+{
+  bool result = true;
+
+  // Specialized evaluators.
+  result &= CheckArithmetic< float >("float");
+  result &= CheckArithmetic< double >("double");
+  // Default evaluator.
+  result &= CheckArithmetic< short >("short");
+
+  typedef itk::Image< int, Dimension > IntImageType;
+  IntImageType::Pointer input1 = CreateImage< IntImageType >(4, false);
+  IntImageType::Pointer input2 = CreateImage< IntImageType >(5, false);
+  IntImageType::Pointer input3 = CreateImage< IntImageType >(6, false);
+
+  typedef itk::TernaryAddImageFilter< IntImageType, IntImageType, IntImageType, IntImageType > TernaryAddType;
+  TernaryAddType::Pointer ternaryAdd = TernaryAddType::New();
+  ternaryAdd->SetInput1(input1);
+  ternaryAdd->SetInput2(input2);
+  ternaryAdd->SetInput3(input3);
+  ternaryAdd->SetNumberOfThreads(3);
+  ternaryAdd->GetOutput()->UpdateOutputInformation();
+  RequestInnerRegion( ternaryAdd->GetOutput(), input1->GetLargestPossibleRegion() );
+  ternaryAdd->Update();
+
+  itk::ImageRegionConstIteratorWithIndex< IntImageType > it( ternaryAdd->GetOutput(),
+                                                            ternaryAdd->GetOutput()->GetRequestedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const IntImageType::IndexType & index = it.GetIndex();
+    if ( it.Get() != input1->GetPixel(index) + input2->GetPixel(index) + input3->GetPixel(index) )
+      {
+      std::cerr << "TernaryAdd: wrong value at " << index << std::endl;
+      result = false;
+      break;
+      }
+    }
+
+  // VectorImage pixels are not stored contiguously as PixelType and go
+  // through the iterators.
+  typedef itk::VectorImage< float, Dimension > VectorImageType;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  VectorImageType::SizeType size;
+  size.Fill(4);
+  vectorImage->SetRegions(size);
+  vectorImage->SetNumberOfComponentsPerPixel(2);
+  vectorImage->Allocate();
+  for ( itk::SizeValueType i = 0; i < 4 * 4 * 4 * 2; ++i )
+    {
+    vectorImage->GetBufferPointer()[i] = static_cast< float >( i );
+    }
+
+  typedef itk::UnaryFunctorImageFilter< VectorImageType, VectorImageType, VectorDouble > VectorFilterType;
+  VectorFilterType::Pointer vectorFilter = VectorFilterType::New();
+  result &= CheckUnary("VectorImage", vectorFilter.GetPointer(), vectorImage.GetPointer());
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
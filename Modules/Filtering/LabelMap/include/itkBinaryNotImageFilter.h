@@ -124,6 +124,8 @@ public:
 protected:
   BinaryNotImageFilter()
     {
+    // The functor is set up in GenerateData().
+    this->FusableOff();
     m_ForegroundValue = NumericTraits<PixelType>::max();
     m_BackgroundValue = NumericTraits<PixelType>::NonpositiveMin();
     }
@@ -20,6 +20,9 @@
 
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
+#include "itkLineConvolutionEvaluator.h"
+#include "itkMultiThreader.h"
+#include <vector>
 
 namespace itk
 {
@@ -43,6 +46,14 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * Images of scalar pixels stored in a contiguous buffer (itk::Image) are
+ * convolved a line at a time: each line is copied with its padding into
+ * a buffer, convolved (see LineConvolutionEvaluator) and written back, one
+ * dimension after the other, in a single temporary image of real pixels.
+ * The output is processed in InternalNumberOfStreamDivisions pieces along
+ * its outermost dimension. Other images go through a pipeline of
+ * NeighborhoodOperatorImageFilters.
+ *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
@@ -244,8 +255,9 @@ protected:
   void PrintSelf(std::ostream & os, Indent indent) const;
 
   /** Standard pipeline method. While this class does not implement a
-   * ThreadedGenerateData(), its GenerateData() delegates all
-   * calculations to an NeighborhoodOperatorImageFilter.  Since the
+   * ThreadedGenerateData(), its GenerateData() either convolves the lines
+   * of the image with several threads, or delegates all calculations to
+   * an NeighborhoodOperatorImageFilter.  Since the
    * NeighborhoodOperatorImageFilter is multithreaded, this filter is
    * multithreaded by default. */
   void GenerateData();
@@ -254,6 +266,49 @@ private:
   DiscreteGaussianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);              //purposely not implemented
 
+  /** Scalar pixels read and written directly in the image buffers are
+   * convolved a line at a time. */
+  typedef typename ScanlineDispatch<
+    IsSame< InputPixelValueType, InputPixelType >::Value
+    && IsSame< OutputPixelValueType, OutputPixelType >::Value
+    && ImageScanlineTraits< TInputImage >::IsContiguous
+    && ImageScanlineTraits< TOutputImage >::IsContiguous >::Type LineConvolutionDispatchType;
+
+  typedef typename NumericTraits< OutputPixelValueType >::RealType              LineRealType;
+  typedef Image< LineRealType, itkGetStaticConstMacro(ImageDimension) >          LineRealImageType;
+  typedef typename TOutputImage::RegionType                                      OutputImageRegionType;
+
+  /** Set the variance, maximum error and maximum width of the Gaussian
+   * operator along dimension. */
+  template< class TOperator >
+  void InitializeOperator(TOperator & oper, unsigned int dimension, const InputImageType *input) const;
+
+  void DispatchedGenerateData(const InputImageType *input, unsigned int filterDimensionality, TrueType);
+
+  void DispatchedGenerateData(const InputImageType *input, unsigned int filterDimensionality, FalseType);
+
+  /** Convolution of the lines along Dimension. The values are read in
+   * Input if it is set, in Buffer otherwise, along the extent of
+   * ReadRegion; those in the extent of WriteRegion are written in Output
+   * if it is set, in Buffer otherwise. LineRegion holds one pixel of
+   * each line. */
+  struct LineConvolutionPass {
+    Self *                      Filter;
+    unsigned int                Dimension;
+    std::vector< LineRealType > Kernel;
+    OutputImageRegionType       LineRegion;
+    OutputImageRegionType       ReadRegion;
+    OutputImageRegionType       WriteRegion;
+    const InputImageType *      Input;
+    LineRealImageType *         Buffer;
+    OutputImageType *           Output;
+  };
+
+  static ITK_THREAD_RETURN_TYPE LineConvolutionThreaderCallback(void *arg);
+
+  void ThreadedConvolveLines(const LineConvolutionPass & pass, ThreadIdType threadId,
+                             ThreadIdType numberOfThreads);
+
   /** The variance of the gaussian blurring kernel in each dimensional
     direction. */
   ArrayType m_Variance;
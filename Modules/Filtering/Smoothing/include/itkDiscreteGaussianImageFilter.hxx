@@ -24,6 +24,8 @@
 #include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
 #include "itkStreamingImageFilter.h"
+#include "itkImageRegionSplitter.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -55,28 +57,7 @@ throw( InvalidRequestedRegionError )
     {
     // Determine the size of the operator in this dimension.  Note that the
     // Gaussian is built as a 1D operator in each of the specified directions.
-    oper.SetDirection(i);
-    if ( m_UseImageSpacing == true )
-      {
-      if ( this->GetInput()->GetSpacing()[i] == 0.0 )
-        {
-        itkExceptionMacro(<< "Pixel spacing cannot be zero");
-        }
-      else
-        {
-        // convert the variance from physical units to pixels
-        double s = this->GetInput()->GetSpacing()[i];
-        s = s * s;
-        oper.SetVariance(m_Variance[i] / s);
-        }
-      }
-    else
-      {
-      oper.SetVariance(m_Variance[i]);
-      }
-    oper.SetMaximumError(m_MaximumError[i]);
-    oper.SetMaximumKernelWidth(m_MaximumKernelWidth);
-    oper.CreateDirectional();
+    this->InitializeOperator( oper, i, this->GetInput() );
 
     radius[i] = oper.GetRadius(i);
     }
@@ -112,6 +93,36 @@ throw( InvalidRequestedRegionError )
     }
 }
 
+template< class TInputImage, class TOutputImage >
+template< class TOperator >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::InitializeOperator(TOperator & oper, unsigned int dimension, const InputImageType *input) const
+{
+  oper.SetDirection(dimension);
+  if ( m_UseImageSpacing == true )
+    {
+    if ( input->GetSpacing()[dimension] == 0.0 )
+      {
+      itkExceptionMacro(<< "Pixel spacing cannot be zero");
+      }
+    else
+      {
+      // convert the variance from physical units to pixels
+      double s = input->GetSpacing()[dimension];
+      s = s * s;
+      oper.SetVariance(m_Variance[dimension] / s);
+      }
+    }
+  else
+    {
+    oper.SetVariance(m_Variance[dimension]);
+    }
+  oper.SetMaximumKernelWidth(m_MaximumKernelWidth);
+  oper.SetMaximumError(m_MaximumError[dimension]);
+  oper.CreateDirectional();
+}
+
 template< class TInputImage, class TOutputImage >
 void
 DiscreteGaussianImageFilter< TInputImage, TOutputImage >
@@ -153,6 +164,16 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     return;
     }
 
+  this->DispatchedGenerateData( localInput, filterDimensionality, LineConvolutionDispatchType() );
+}
+
+template< class TInputImage, class TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::DispatchedGenerateData(const InputImageType *localInput, unsigned int filterDimensionality, FalseType)
+{
+  typename TOutputImage::Pointer output = this->GetOutput();
+
   // Type of the pixel to use for intermediate results
   typedef typename NumericTraits< OutputPixelType >::RealType RealOutputPixelType;
   typedef Image< OutputPixelType, ImageDimension >            RealOutputImageType;
@@ -204,29 +225,7 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     unsigned int reverse_i = filterDimensionality - i - 1;
 
     // Set up the operator for this dimension
-    oper[reverse_i].SetDirection(i);
-    if ( m_UseImageSpacing == true )
-      {
-      if ( localInput->GetSpacing()[i] == 0.0 )
-        {
-        itkExceptionMacro(<< "Pixel spacing cannot be zero");
-        }
-      else
-        {
-        // convert the variance from physical units to pixels
-        double s = localInput->GetSpacing()[i];
-        s = s * s;
-        oper[reverse_i].SetVariance(m_Variance[i] / s);
-        }
-      }
-    else
-      {
-      oper[reverse_i].SetVariance(m_Variance[i]);
-      }
-
-    oper[reverse_i].SetMaximumKernelWidth(m_MaximumKernelWidth);
-    oper[reverse_i].SetMaximumError(m_MaximumError[i]);
-    oper[reverse_i].CreateDirectional();
+    this->InitializeOperator(oper[reverse_i], i, localInput);
     }
 
   // Create a chain of filters
@@ -328,6 +327,200 @@ DiscreteGaussianImageFilter< TInputImage, TOutputImage >
     }
 }
 
+template< class TInputImage, class TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::DispatchedGenerateData(const InputImageType *input, unsigned int filterDimensionality, TrueType)
+{
+  OutputImageType *           output = this->GetOutput();
+  const OutputImageRegionType outputRegion = output->GetRequestedRegion();
+
+  // The kernels, and the radius of the region they read.
+  std::vector< std::vector< LineRealType > > kernels(filterDimensionality);
+  typename OutputImageType::SizeType         radius;
+  radius.Fill(0);
+  for ( unsigned int d = 0; d < filterDimensionality; ++d )
+    {
+    GaussianOperator< LineRealType, ImageDimension > oper;
+    this->InitializeOperator(oper, d, input);
+    radius[d] = oper.GetRadius(d);
+    kernels[d].assign( oper.Begin(), oper.End() );
+    }
+
+  typedef ImageRegionSplitter< ImageDimension > SplitterType;
+  typename SplitterType::Pointer splitter = SplitterType::New();
+  const unsigned int numberOfPieces =
+    splitter->GetNumberOfSplits(outputRegion, m_InternalNumberOfStreamDivisions);
+
+  LineConvolutionPass pass;
+  pass.Filter = this;
+  MultiThreader *threader = this->GetMultiThreader();
+  threader->SetNumberOfThreads( this->GetNumberOfThreads() );
+  threader->SetSingleMethod(Self::LineConvolutionThreaderCallback, &pass);
+
+  typename LineRealImageType::Pointer buffer = LineRealImageType::New();
+  for ( unsigned int piece = 0; piece < numberOfPieces; ++piece )
+    {
+    const OutputImageRegionType pieceRegion = splitter->GetSplit(piece, numberOfPieces, outputRegion);
+
+    // The region of the input the piece depends on.
+    OutputImageRegionType paddedRegion = pieceRegion;
+    paddedRegion.PadByRadius(radius);
+    paddedRegion.Crop( input->GetLargestPossibleRegion() );
+
+    // The first dimension is convolved while reading the input: the
+    // temporary image only spans the piece along it.
+    if ( filterDimensionality > 1 )
+      {
+      OutputImageRegionType bufferRegion = paddedRegion;
+      bufferRegion.SetIndex( 0, pieceRegion.GetIndex(0) );
+      bufferRegion.SetSize( 0, pieceRegion.GetSize(0) );
+      buffer->SetRegions(bufferRegion);
+      buffer->Allocate();
+      }
+
+    for ( unsigned int d = 0; d < filterDimensionality; ++d )
+      {
+      // Only the values in the piece are needed along the dimensions
+      // already convolved.
+      OutputImageRegionType lineRegion = paddedRegion;
+      for ( unsigned int k = 0; k < d; ++k )
+        {
+        lineRegion.SetIndex( k, pieceRegion.GetIndex(k) );
+        lineRegion.SetSize( k, pieceRegion.GetSize(k) );
+        }
+      lineRegion.SetSize(d, 1);
+
+      pass.Dimension = d;
+      pass.Kernel = kernels[d];
+      pass.LineRegion = lineRegion;
+      pass.ReadRegion = paddedRegion;
+      pass.WriteRegion = pieceRegion;
+      pass.Input = ( d == 0 ) ? input : 0;
+      pass.Buffer = buffer;
+      pass.Output = ( d == filterDimensionality - 1 ) ? output : 0;
+      threader->SingleMethodExecute();
+
+      this->UpdateProgress( static_cast< float >( piece * filterDimensionality + d + 1 )
+                            / static_cast< float >( numberOfPieces * filterDimensionality ) );
+      }
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::LineConvolutionThreaderCallback(void *arg)
+{
+  const MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const LineConvolutionPass *            pass = static_cast< LineConvolutionPass * >( info->UserData );
+
+  pass->Filter->ThreadedConvolveLines(*pass, info->ThreadID, info->NumberOfThreads);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TInputImage, class TOutputImage >
+void
+DiscreteGaussianImageFilter< TInputImage, TOutputImage >
+::ThreadedConvolveLines(const LineConvolutionPass & pass, ThreadIdType threadId,
+                        ThreadIdType numberOfThreads)
+{
+  typedef typename OutputImageType::IndexType IndexType;
+
+  const unsigned int  d = pass.Dimension;
+  const SizeValueType numberOfLines = pass.LineRegion.GetNumberOfPixels();
+  const SizeValueType firstLine = numberOfLines * threadId / numberOfThreads;
+  const SizeValueType endLine = numberOfLines * ( threadId + 1 ) / numberOfThreads;
+  if ( firstLine >= endLine )
+    {
+    return;
+    }
+
+  const SizeValueType  kernelSize = static_cast< SizeValueType >( pass.Kernel.size() );
+  const SizeValueType  radius = kernelSize / 2;
+  const IndexValueType readStart = pass.ReadRegion.GetIndex(d);
+  const SizeValueType  readLength = pass.ReadRegion.GetSize(d);
+  const IndexValueType writeStart = pass.WriteRegion.GetIndex(d);
+  const SizeValueType  writeLength = pass.WriteRegion.GetSize(d);
+
+  // The line, padded by replicating its ends as the zero flux Neumann
+  // boundary condition does, and the convolved values.
+  std::vector< LineRealType > padded(readLength + 2 * radius);
+  std::vector< LineRealType > convolved(writeLength);
+  LineRealType *              line = &padded[radius];
+
+  IndexType     index;
+  SizeValueType remainder = firstLine;
+  for ( unsigned int k = 0; k < ImageDimension; ++k )
+    {
+    index[k] = pass.LineRegion.GetIndex(k) + static_cast< IndexValueType >( remainder % pass.LineRegion.GetSize(k) );
+    remainder /= pass.LineRegion.GetSize(k);
+    }
+
+  for ( SizeValueType n = firstLine; n < endLine; ++n )
+    {
+    index[d] = readStart;
+    if ( pass.Input )
+      {
+      const InputPixelType *in = pass.Input->GetBufferPointer() + pass.Input->ComputeOffset(index);
+      const OffsetValueType stride = pass.Input->GetOffsetTable()[d];
+      for ( SizeValueType i = 0; i < readLength; ++i, in += stride )
+        {
+        line[i] = static_cast< LineRealType >( *in );
+        }
+      }
+    else
+      {
+      const LineRealType *  in = pass.Buffer->GetBufferPointer() + pass.Buffer->ComputeOffset(index);
+      const OffsetValueType stride = pass.Buffer->GetOffsetTable()[d];
+      for ( SizeValueType i = 0; i < readLength; ++i, in += stride )
+        {
+        line[i] = *in;
+        }
+      }
+    std::fill(padded.begin(), padded.begin() + radius, line[0]);
+    std::fill(padded.end() - radius, padded.end(), line[readLength - 1]);
+
+    LineConvolutionEvaluator< LineRealType >::Convolve( &padded[writeStart - readStart], &convolved[0],
+                                                       writeLength, &pass.Kernel[0], kernelSize );
+
+    index[d] = writeStart;
+    if ( pass.Output )
+      {
+      OutputPixelType *     out = pass.Output->GetBufferPointer() + pass.Output->ComputeOffset(index);
+      const OffsetValueType stride = pass.Output->GetOffsetTable()[d];
+      for ( SizeValueType i = 0; i < writeLength; ++i, out += stride )
+        {
+        *out = static_cast< OutputPixelType >( convolved[i] );
+        }
+      }
+    else
+      {
+      LineRealType *        out = pass.Buffer->GetBufferPointer() + pass.Buffer->ComputeOffset(index);
+      const OffsetValueType stride = pass.Buffer->GetOffsetTable()[d];
+      for ( SizeValueType i = 0; i < writeLength; ++i, out += stride )
+        {
+        *out = convolved[i];
+        }
+      }
+
+    // Move to the next line.
+    for ( unsigned int k = 0; k < ImageDimension; ++k )
+      {
+      if ( k == d )
+        {
+        continue;
+        }
+      if ( ++index[k] < pass.LineRegion.GetIndex(k) + static_cast< IndexValueType >( pass.LineRegion.GetSize(k) ) )
+        {
+        break;
+        }
+      index[k] = pass.LineRegion.GetIndex(k);
+      }
+    }
+}
+
 template< class TInputImage, class TOutputImage >
 void
 DiscreteGaussianImageFilter< TInputImage, TOutputImage >
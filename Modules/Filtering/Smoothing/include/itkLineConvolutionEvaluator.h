@@ -0,0 +1,106 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkLineConvolutionEvaluator_h
+#define __itkLineConvolutionEvaluator_h
+
+#include "itkScanlineFunctorEvaluator.h"
+
+namespace itk
+{
+/** \class LineConvolutionEvaluator
+ * \brief Convolves a line of contiguous values with a kernel.
+ *
+ * Convolve() computes output[i] as the sum over k of kernel[k] *
+ * input[i + k], for i < length: input holds length + kernelSize - 1
+ * values, i.e. the line padded on both sides by the radius of the
+ * kernel. The kernel is not flipped, which makes no difference for the
+ * symmetric kernels it is used with.
+ *
+ * The float and double versions process several outputs per instruction
+ * when SSE2 is available. The terms are summed in the same order as in
+ * the plain loop, so that the results do not depend on the instruction
+ * set.
+ *
+ * \sa DiscreteGaussianImageFilter
+ * \ingroup ITKSmoothing
+ */
+template< class TReal >
+struct LineConvolutionEvaluator
+{
+  static void Convolve(const TReal *input, TReal *output, SizeValueType length,
+                       const TReal *kernel, SizeValueType kernelSize)
+  {
+    for ( SizeValueType i = 0; i < length; ++i )
+      {
+      TReal sum = kernel[0] * input[i];
+      for ( SizeValueType k = 1; k < kernelSize; ++k )
+        {
+        sum += kernel[k] * input[i + k];
+        }
+      output[i] = sum;
+      }
+  }
+};
+
+#if defined( ITK_SCANLINE_SSE2 )
+/** \cond HIDE_META_PROGRAMMING */
+template< class TReal >
+struct SSE2LineConvolutionEvaluator
+{
+  static void Convolve(const TReal *input, TReal *output, SizeValueType length,
+                       const TReal *kernel, SizeValueType kernelSize)
+  {
+    typedef ScanlineSSE2::Packet< TReal > PacketType;
+    typedef typename PacketType::Type     RegisterType;
+
+    SizeValueType i = 0;
+    for (; i + PacketType::Length <= length; i += PacketType::Length )
+      {
+      RegisterType sum = ScanlineSSE2::Multiply::Apply( PacketType::Broadcast(kernel[0]),
+                                                        PacketType::Load(input + i) );
+      for ( SizeValueType k = 1; k < kernelSize; ++k )
+        {
+        sum = ScanlineSSE2::Add::Apply( sum, ScanlineSSE2::Multiply::Apply( PacketType::Broadcast(kernel[k]),
+                                                                            PacketType::Load(input + i + k) ) );
+        }
+      PacketType::Store(output + i, sum);
+      }
+    for (; i < length; ++i )
+      {
+      TReal sum = kernel[0] * input[i];
+      for ( SizeValueType k = 1; k < kernelSize; ++k )
+        {
+        sum += kernel[k] * input[i + k];
+        }
+      output[i] = sum;
+      }
+  }
+};
+
+template< >
+struct LineConvolutionEvaluator< float >:public SSE2LineConvolutionEvaluator< float >
+{};
+
+template< >
+struct LineConvolutionEvaluator< double >:public SSE2LineConvolutionEvaluator< double >
+{};
+/** \endcond */
+#endif
+} // end namespace itk
+
+#endif
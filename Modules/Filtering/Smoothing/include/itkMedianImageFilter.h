@@ -20,6 +20,8 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include "itkScanlineFunctorEvaluator.h"
+#include <limits>
 
 namespace itk
 {
@@ -35,6 +37,17 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * Two algorithms are available. The selection algorithm copies the
+ * neighborhood of each pixel and partially sorts it, at a cost that grows
+ * with the size of the neighborhood. For images of 8 or 16 bit integer
+ * pixels, the histogram algorithm slides a histogram of the neighborhood
+ * along each scanline: moving to the next pixel only removes and adds one
+ * cross section of the neighborhood, and the median is found by scanning
+ * a two-level histogram in a number of steps that does not depend on the
+ * radius. By default the histogram algorithm is used for these pixel
+ * types when the neighborhood is large enough to benefit from it; both
+ * algorithms produce the same output.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -84,6 +97,20 @@ public:
 
   typedef typename InputImageType::SizeType InputSizeType;
 
+  /** Algorithms computing the median. AutomaticAlgorithm selects the
+   * histogram algorithm when the pixel type supports it and the
+   * neighborhood is large. HistogramAlgorithm falls back to the selection
+   * algorithm for unsupported pixel types. */
+  typedef enum {
+    AutomaticAlgorithm,
+    SelectionAlgorithm,
+    HistogramAlgorithm
+    } AlgorithmType;
+
+  /** Set/Get the algorithm. Defaults to AutomaticAlgorithm. */
+  itkSetMacro(Algorithm, AlgorithmType);
+  itkGetConstMacro(Algorithm, AlgorithmType);
+
 #ifdef ITK_USE_CONCEPT_CHECKING
   /** Begin concept checking */
   itkConceptMacro( SameDimensionCheck,
@@ -111,9 +138,35 @@ protected:
   void ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                             ThreadIdType threadId);
 
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
 private:
   MedianImageFilter(const Self &); //purposely not implemented
   void operator=(const Self &);    //purposely not implemented
+
+  /** The histogram algorithm needs integer pixels of at most 16 bits,
+   * read directly from the input buffer. */
+  typedef typename ScanlineDispatch<
+    std::numeric_limits< InputPixelType >::is_integer
+    && sizeof( InputPixelType ) <= 2
+    && ImageScanlineTraits< TInputImage >::IsContiguous >::Type HistogramDispatchType;
+
+  /** Whether the histogram algorithm is used for the current radius. */
+  bool UseHistogram() const;
+
+  void SelectionThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                     ThreadIdType threadId);
+
+  void HistogramThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                     ThreadIdType threadId, TrueType);
+
+  void HistogramThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                     ThreadIdType threadId, FalseType)
+  {
+    this->SelectionThreadedGenerateData(outputRegionForThread, threadId);
+  }
+
+  AlgorithmType m_Algorithm;
 };
 } // end namespace itk
 
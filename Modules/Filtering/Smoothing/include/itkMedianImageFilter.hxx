@@ -33,14 +33,61 @@ namespace itk
 {
 template< class TInputImage, class TOutputImage >
 MedianImageFilter< TInputImage, TOutputImage >
-::MedianImageFilter()
+::MedianImageFilter():
+  m_Algorithm(AutomaticAlgorithm)
 {}
 
+template< class TInputImage, class TOutputImage >
+bool
+MedianImageFilter< TInputImage, TOutputImage >
+::UseHistogram() const
+{
+  if ( !HistogramDispatchType::Value )
+    {
+    return false;
+    }
+  switch ( m_Algorithm )
+    {
+    case SelectionAlgorithm:
+      return false;
+    case HistogramAlgorithm:
+      return true;
+    default:
+      break;
+    }
+
+  // Finding the median costs up to twice the square root of the number of
+  // bins, and sliding the histogram one cross section of the
+  // neighborhood. The selection costs a few operations per neighbor.
+  SizeValueType neighborhoodSize = 1;
+  for ( unsigned int d = 0; d < InputImageDimension; ++d )
+    {
+    neighborhoodSize *= 2 * this->GetRadius()[d] + 1;
+    }
+  return neighborhoodSize >= ( SizeValueType(1) << ( 4 * sizeof( InputPixelType ) ) );
+}
+
 template< class TInputImage, class TOutputImage >
 void
 MedianImageFilter< TInputImage, TOutputImage >
 ::ThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
                        ThreadIdType threadId)
+{
+  if ( this->UseHistogram() )
+    {
+    this->HistogramThreadedGenerateData( outputRegionForThread, threadId, HistogramDispatchType() );
+    }
+  else
+    {
+    this->SelectionThreadedGenerateData(outputRegionForThread, threadId);
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::SelectionThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                ThreadIdType threadId)
 {
   // Allocate output
   typename OutputImageType::Pointer output = this->GetOutput();
@@ -94,6 +141,172 @@ MedianImageFilter< TInputImage, TOutputImage >
       }
     }
 }
+
+template< class TInputImage, class TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::HistogramThreadedGenerateData(const OutputImageRegionType & outputRegionForThread,
+                                ThreadIdType threadId, TrueType)
+{
+  typedef typename InputImageType::IndexType IndexType;
+
+  OutputImageType *     output = this->GetOutput();
+  const InputImageType *input = this->GetInput();
+  const InputSizeType & radius = this->GetRadius();
+
+  const SizeValueType lineLength = outputRegionForThread.GetSize(0);
+  if ( lineLength == 0 )
+    {
+    return;
+    }
+  const SizeValueType numberOfLines = outputRegionForThread.GetNumberOfPixels() / lineLength;
+  ProgressReporter    progress(this, threadId, numberOfLines);
+
+  // The zero flux Neumann boundary condition replicates the pixels on the
+  // border of the buffered region: clamp the indices of the neighbors.
+  const InputImageRegionType & bufferedRegion = input->GetBufferedRegion();
+  const InputPixelType *       buffer = input->GetBufferPointer();
+  const OffsetValueType *      offsetTable = input->GetOffsetTable();
+  const IndexType              lower = bufferedRegion.GetIndex();
+  const IndexType              upper = bufferedRegion.GetUpperIndex();
+
+  // The bins hold all the values of the pixel type, from the smallest
+  // one. Blocks of bins are counted too, so that the median is found by
+  // scanning the blocks, then the bins of one block.
+  const unsigned int blockBits = 4 * sizeof( InputPixelType );
+  const SizeValueType numberOfBins = SizeValueType(1) << ( 2 * blockBits );
+  const SizeValueType binsPerBlock = SizeValueType(1) << blockBits;
+  const IndexValueType minimum = static_cast< IndexValueType >( std::numeric_limits< InputPixelType >::min() );
+  std::vector< SizeValueType > histogram(numberOfBins, 0);
+  std::vector< SizeValueType > blockHistogram(numberOfBins / binsPerBlock, 0);
+
+  // Buffer offsets of the cross section of the neighborhood orthogonal to
+  // the first dimension, for the current scanline.
+  std::vector< OffsetValueType > crossSection;
+  SizeValueType neighborhoodSize = 2 * radius[0] + 1;
+  for ( unsigned int d = 1; d < InputImageDimension; ++d )
+    {
+    neighborhoodSize *= 2 * radius[d] + 1;
+    }
+  const SizeValueType medianPosition = neighborhoodSize / 2;
+  const IndexValueType radius0 = static_cast< IndexValueType >( radius[0] );
+
+  ImageRegionIterator< OutputImageType > it(output, outputRegionForThread);
+  IndexType lineIndex = outputRegionForThread.GetIndex();
+  for ( SizeValueType line = 0; line < numberOfLines; ++line )
+    {
+    crossSection.clear();
+    IndexType neighbor;
+    for ( unsigned int d = 1; d < InputImageDimension; ++d )
+      {
+      neighbor[d] = lineIndex[d] - static_cast< IndexValueType >( radius[d] );
+      }
+    unsigned int dim;
+    do
+      {
+      OffsetValueType offset = 0;
+      for ( unsigned int d = 1; d < InputImageDimension; ++d )
+        {
+        const IndexValueType clamped = std::max( lower[d], std::min(upper[d], neighbor[d]) );
+        offset += ( clamped - lower[d] ) * offsetTable[d];
+        }
+      crossSection.push_back(offset);
+
+      for ( dim = 1; dim < InputImageDimension; ++dim )
+        {
+        if ( ++neighbor[dim] <= lineIndex[dim] + static_cast< IndexValueType >( radius[dim] ) )
+          {
+          break;
+          }
+        neighbor[dim] = lineIndex[dim] - static_cast< IndexValueType >( radius[dim] );
+        }
+      }
+    while ( dim < InputImageDimension );
+
+    const typename std::vector< OffsetValueType >::const_iterator crossSectionEnd = crossSection.end();
+    typename std::vector< OffsetValueType >::const_iterator       cit;
+
+    // Fill the histogram with the neighborhood of the first pixel.
+    const IndexValueType firstX = lineIndex[0];
+    const IndexValueType lastX = firstX + static_cast< IndexValueType >( lineLength ) - 1;
+    for ( IndexValueType x = firstX - radius0; x <= firstX + radius0; ++x )
+      {
+      const InputPixelType *column = buffer + ( std::max( lower[0], std::min(upper[0], x) ) - lower[0] );
+      for ( cit = crossSection.begin(); cit != crossSectionEnd; ++cit )
+        {
+        const SizeValueType bin = static_cast< SizeValueType >( static_cast< IndexValueType >( column[*cit] ) - minimum );
+        ++histogram[bin];
+        ++blockHistogram[bin >> blockBits];
+        }
+      }
+
+    for ( IndexValueType x = firstX; x <= lastX; ++x )
+      {
+      SizeValueType count = 0;
+      SizeValueType block = 0;
+      while ( count + blockHistogram[block] <= medianPosition )
+        {
+        count += blockHistogram[block++];
+        }
+      SizeValueType bin = block * binsPerBlock;
+      while ( count + histogram[bin] <= medianPosition )
+        {
+        count += histogram[bin++];
+        }
+      it.Set( static_cast< OutputPixelType >( static_cast< InputPixelType >( static_cast< IndexValueType >( bin )
+                                                                             + minimum ) ) );
+      ++it;
+
+      // Slide the neighborhood to the next pixel.
+      if ( x == lastX )
+        {
+        break;
+        }
+      const IndexValueType leavingX = std::max( lower[0], std::min(upper[0], x - radius0) );
+      const IndexValueType enteringX = std::max( lower[0], std::min(upper[0], x + radius0 + 1) );
+      if ( leavingX != enteringX )
+        {
+        const InputPixelType *leaving = buffer + ( leavingX - lower[0] );
+        const InputPixelType *entering = buffer + ( enteringX - lower[0] );
+        for ( cit = crossSection.begin(); cit != crossSectionEnd; ++cit )
+          {
+          const SizeValueType leavingBin =
+            static_cast< SizeValueType >( static_cast< IndexValueType >( leaving[*cit] ) - minimum );
+          --histogram[leavingBin];
+          --blockHistogram[leavingBin >> blockBits];
+          const SizeValueType enteringBin =
+            static_cast< SizeValueType >( static_cast< IndexValueType >( entering[*cit] ) - minimum );
+          ++histogram[enteringBin];
+          ++blockHistogram[enteringBin >> blockBits];
+          }
+        }
+      }
+
+    // Empty the histogram for the next scanline.
+    for ( IndexValueType x = lastX - radius0; x <= lastX + radius0; ++x )
+      {
+      const InputPixelType *column = buffer + ( std::max( lower[0], std::min(upper[0], x) ) - lower[0] );
+      for ( cit = crossSection.begin(); cit != crossSectionEnd; ++cit )
+        {
+        const SizeValueType bin = static_cast< SizeValueType >( static_cast< IndexValueType >( column[*cit] ) - minimum );
+        --histogram[bin];
+        --blockHistogram[bin >> blockBits];
+        }
+      }
+
+    IncrementScanlineIndex(lineIndex, outputRegionForThread);
+    progress.CompletedPixel();
+    }
+}
+
+template< class TInputImage, class TOutputImage >
+void
+MedianImageFilter< TInputImage, TOutputImage >
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Algorithm: " << m_Algorithm << std::endl;
+}
 } // end namespace itk
 
 #endif
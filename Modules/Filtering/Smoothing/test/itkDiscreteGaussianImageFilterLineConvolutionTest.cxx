@@ -0,0 +1,154 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkNeighborhoodOperatorImageFilter.h"
+#include "itkGaussianOperator.h"
+#include "itkImageRegionConstIterator.h"
+
+namespace
+{
+const unsigned int Dimension = 3;
+typedef itk::Image< double, Dimension > ReferenceImageType;
+
+/** Convolve the first filterDimensionality dimensions of input one after
+ * the other with NeighborhoodOperatorImageFilters. */
+template< class TInputImage >
+ReferenceImageType::Pointer
+ComputeReference(const TInputImage *input, const double *variance, unsigned int filterDimensionality)
+{
+  typedef itk::NeighborhoodOperatorImageFilter< TInputImage, ReferenceImageType, double > FirstFilterType;
+  typedef itk::NeighborhoodOperatorImageFilter< ReferenceImageType, ReferenceImageType, double > FilterType;
+  typedef itk::GaussianOperator< double, Dimension > OperatorType;
+
+  OperatorType oper;
+  oper.SetDirection(0);
+  oper.SetVariance(variance[0]);
+  oper.SetMaximumKernelWidth(32);
+  oper.SetMaximumError(0.01);
+  oper.CreateDirectional();
+
+  typename FirstFilterType::Pointer first = FirstFilterType::New();
+  first->SetInput(input);
+  first->SetOperator(oper);
+  first->Update();
+  ReferenceImageType::Pointer reference = first->GetOutput();
+  reference->DisconnectPipeline();
+
+  for ( unsigned int d = 1; d < filterDimensionality; ++d )
+    {
+    oper.SetDirection(d);
+    oper.SetVariance(variance[d]);
+    oper.CreateDirectional();
+
+    FilterType::Pointer filter = FilterType::New();
+    filter->SetInput(reference);
+    filter->SetOperator(oper);
+    filter->Update();
+    reference = filter->GetOutput();
+    reference->DisconnectPipeline();
+    }
+  return reference;
+}
+
+/** Smooth the input and compare the inner region of the output with the
+ * reference. */
+template< class TInputImage, class TOutputImage >
+bool
+CheckFilter(const char *name, const TInputImage *input, const double *variance,
+            unsigned int filterDimensionality, unsigned int numberOfStreamDivisions, double tolerance)
+{
+  typedef itk::DiscreteGaussianImageFilter< TInputImage, TOutputImage > FilterType;
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetVariance(variance);
+  filter->SetFilterDimensionality(filterDimensionality);
+  filter->SetInternalNumberOfStreamDivisions(numberOfStreamDivisions);
+  filter->SetNumberOfThreads(3);
+
+  typename TOutputImage::RegionType region = input->GetLargestPossibleRegion();
+  region.ShrinkByRadius(2);
+  filter->GetOutput()->SetRequestedRegion(region);
+  filter->Update();
+
+  ReferenceImageType::Pointer reference = ComputeReference(input, variance, filterDimensionality);
+
+  itk::ImageRegionConstIterator< TOutputImage >       it(filter->GetOutput(), region);
+  itk::ImageRegionConstIterator< ReferenceImageType > rit(reference, region);
+  for (; !it.IsAtEnd(); ++it, ++rit )
+    {
+    if ( vnl_math_abs( static_cast< double >( it.Get() ) - rit.Get() ) > tolerance )
+      {
+      std::cerr << name << ": got " << static_cast< double >( it.Get() ) << " instead of "
+                << rit.Get() << std::endl;
+      return false;
+      }
+    }
+  std::cout << name << " passed." << std::endl;
+  return true;
+}
+
+template< class TImage >
+typename TImage::Pointer
+CreateImage()
+{
+  typename TImage::SizeType size;
+  size[0] = 37;
+  size[1] = 21;
+  size[2] = 13;
+
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  unsigned int seed = 13;
+  for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    seed = seed * 1103515245 + 12345;
+    image->GetBufferPointer()[i] = static_cast< typename TImage::PixelType >( ( seed >> 16 ) % 1000 );
+    }
+  return image;
+}
+}
+
+int itkDiscreteGaussianImageFilterLineConvolutionTest(int, char *[])
+{
+  typedef itk::Image< float, Dimension > FloatImageType;
+  typedef itk::Image< short, Dimension > ShortImageType;
+
+  FloatImageType::Pointer floatImage = CreateImage< FloatImageType >();
+  ShortImageType::Pointer shortImage = CreateImage< ShortImageType >();
+
+  // Kernels wider than the image along the last dimension.
+  const double variance[Dimension] = { 2.0, 4.5, 12.0 };
+
+  bool result = true;
+  result &= CheckFilter< FloatImageType, FloatImageType >("float", floatImage, variance, 3, 4, 1e-3);
+  result &= CheckFilter< FloatImageType, FloatImageType >("one piece", floatImage, variance, 3, 1, 1e-3);
+  result &= CheckFilter< FloatImageType, FloatImageType >("2D smoothing", floatImage, variance, 2, 5, 1e-3);
+  result &= CheckFilter< FloatImageType, FloatImageType >("1D smoothing", floatImage, variance, 1, 3, 1e-3);
+  result &= CheckFilter< ShortImageType, FloatImageType >("short to float", shortImage, variance, 3, 9, 1e-3);
+  result &= CheckFilter< ShortImageType, ShortImageType >("short", shortImage, variance, 3, 9, 1.0);
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
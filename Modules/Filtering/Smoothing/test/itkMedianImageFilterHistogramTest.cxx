@@ -0,0 +1,154 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMedianImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+
+namespace
+{
+template< class TImage >
+typename TImage::Pointer
+CreateImage(const typename TImage::SizeType & size, int minimum, int maximum)
+{
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  unsigned int seed = 29;
+  typename TImage::PixelType *buffer = image->GetBufferPointer();
+  for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    seed = seed * 1103515245 + 12345;
+    buffer[i] = static_cast< typename TImage::PixelType >(
+      minimum + static_cast< int >( ( seed >> 8 ) % ( maximum - minimum + 1 ) ) );
+    }
+  return image;
+}
+
+/** Compare the histogram algorithm with the selection one, on an inner
+ * requested region and on the whole image. */
+template< class TImage >
+bool
+CompareAlgorithms(const char *name, const TImage *input, const typename TImage::SizeType & radius)
+{
+  typedef itk::MedianImageFilter< TImage, TImage > FilterType;
+
+  bool result = true;
+  for ( unsigned int inner = 0; inner < 2; ++inner )
+    {
+    typename TImage::RegionType region = input->GetLargestPossibleRegion();
+    if ( inner )
+      {
+      region.ShrinkByRadius(2);
+      }
+
+    typename FilterType::Pointer selection = FilterType::New();
+    selection->SetInput(input);
+    selection->SetRadius(radius);
+    selection->SetAlgorithm(FilterType::SelectionAlgorithm);
+    selection->GetOutput()->SetRequestedRegion(region);
+    selection->Update();
+
+    typename FilterType::Pointer histogram = FilterType::New();
+    histogram->SetInput(input);
+    histogram->SetRadius(radius);
+    histogram->SetAlgorithm(FilterType::HistogramAlgorithm);
+    histogram->SetNumberOfThreads(3);
+    histogram->GetOutput()->SetRequestedRegion(region);
+    histogram->Update();
+
+    itk::ImageRegionConstIterator< TImage > sit(selection->GetOutput(), region);
+    itk::ImageRegionConstIterator< TImage > hit(histogram->GetOutput(), region);
+    for (; !sit.IsAtEnd(); ++sit, ++hit )
+      {
+      if ( sit.Get() != hit.Get() )
+        {
+        std::cerr << name << ": got " << static_cast< int >( hit.Get() ) << " instead of "
+                  << static_cast< int >( sit.Get() ) << std::endl;
+        result = false;
+        break;
+        }
+      }
+    }
+  if ( result )
+    {
+    std::cout << name << " passed." << std::endl;
+    }
+  return result;
+}
+}
+
+int itkMedianImageFilterHistogramTest(int, char *[])
+{
+  bool result = true;
+
+  typedef itk::Image< unsigned char, 2 > UCharImageType;
+  UCharImageType::SizeType size2D;
+  size2D[0] = 41;
+  size2D[1] = 23;
+  UCharImageType::Pointer ucharImage = CreateImage< UCharImageType >(size2D, 0, 255);
+  UCharImageType::SizeType radius2D;
+  radius2D[0] = 3;
+  radius2D[1] = 2;
+  result &= CompareAlgorithms("unsigned char", ucharImage.GetPointer(), radius2D);
+
+  // Most of the neighborhoods cross the border of the image.
+  radius2D[0] = 15;
+  radius2D[1] = 1;
+  result &= CompareAlgorithms("large radius", ucharImage.GetPointer(), radius2D);
+
+  typedef itk::Image< short, 3 > ShortImageType;
+  ShortImageType::SizeType size3D;
+  size3D[0] = 19;
+  size3D[1] = 11;
+  size3D[2] = 7;
+  ShortImageType::Pointer shortImage = CreateImage< ShortImageType >(size3D, -1024, 3071);
+  ShortImageType::SizeType radius3D;
+  radius3D[0] = 2;
+  radius3D[1] = 1;
+  radius3D[2] = 3;
+  result &= CompareAlgorithms("short", shortImage.GetPointer(), radius3D);
+
+  typedef itk::Image< unsigned short, 3 > UShortImageType;
+  UShortImageType::Pointer ushortImage = CreateImage< UShortImageType >(size3D, 60000, 65535);
+  result &= CompareAlgorithms("unsigned short", ushortImage.GetPointer(), radius3D);
+
+  // The automatic selection.
+  typedef itk::MedianImageFilter< ShortImageType, ShortImageType > ShortFilterType;
+  ShortFilterType::Pointer filter = ShortFilterType::New();
+  filter->SetInput(shortImage);
+  filter->SetRadius(radius3D);
+  filter->Update();
+  filter->Print(std::cout);
+  typedef itk::MedianImageFilter< itk::Image< float, 2 >, itk::Image< float, 2 > > FloatFilterType;
+  FloatFilterType::Pointer floatFilter = FloatFilterType::New();
+  floatFilter->SetAlgorithm(FloatFilterType::HistogramAlgorithm);
+  if ( filter->GetAlgorithm() != ShortFilterType::AutomaticAlgorithm
+       || floatFilter->GetAlgorithm() != FloatFilterType::HistogramAlgorithm )
+    {
+    std::cerr << "Wrong algorithm" << std::endl;
+    result = false;
+    }
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
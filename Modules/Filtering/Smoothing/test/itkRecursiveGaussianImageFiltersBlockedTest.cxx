@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRecursiveGaussianImageFilter.h"
+#include "itkImageAdaptor.h"
+#include "itkImageRegionConstIterator.h"
+
+namespace
+{
+/** Reads the pixels through an adaptor, which makes the recursive filter
+ * process the lines one at a time. */
+class IdentityPixelAccessor
+{
+public:
+  typedef float InternalType;
+  typedef float ExternalType;
+
+  static void Set(InternalType & output, const ExternalType & input) { output = input; }
+  static ExternalType Get(const InternalType & input) { return input; }
+};
+}
+
+int itkRecursiveGaussianImageFiltersBlockedTest(int, char *[])
+{
+  const unsigned int Dimension = 3;
+
+  typedef itk::Image< float, Dimension >                          ImageType;
+  typedef itk::Image< double, Dimension >                         OutputImageType;
+  typedef itk::ImageAdaptor< ImageType, IdentityPixelAccessor >   AdaptorType;
+
+  ImageType::SizeType size;
+  size[0] = 37; // not a whole number of blocks
+  size[1] = 19;
+  size[2] = 11;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  unsigned int seed = 3;
+  for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    seed = seed * 1103515245 + 12345;
+    image->GetBufferPointer()[i] = static_cast< float >( ( seed >> 16 ) % 1000 );
+    }
+
+  AdaptorType::Pointer adaptor = AdaptorType::New();
+  adaptor->SetImage(image);
+
+  typedef itk::RecursiveGaussianImageFilter< ImageType, OutputImageType >   BlockedFilterType;
+  typedef itk::RecursiveGaussianImageFilter< AdaptorType, OutputImageType > LineFilterType;
+
+  bool result = true;
+  for ( unsigned int direction = 0; direction < Dimension; ++direction )
+    {
+    for ( unsigned int order = 0; order < 3; ++order )
+      {
+      BlockedFilterType::Pointer blocked = BlockedFilterType::New();
+      blocked->SetInput(image);
+      blocked->SetDirection(direction);
+      blocked->SetSigma(1.7);
+      blocked->SetOrder( static_cast< BlockedFilterType::OrderEnumType >( order ) );
+      blocked->SetNumberOfThreads(3);
+      blocked->Update();
+
+      LineFilterType::Pointer line = LineFilterType::New();
+      line->SetInput(adaptor);
+      line->SetDirection(direction);
+      line->SetSigma(1.7);
+      line->SetOrder( static_cast< LineFilterType::OrderEnumType >( order ) );
+      line->Update();
+
+      itk::ImageRegionConstIterator< OutputImageType > bit( blocked->GetOutput(),
+                                                           blocked->GetOutput()->GetBufferedRegion() );
+      itk::ImageRegionConstIterator< OutputImageType > lit( line->GetOutput(),
+                                                           blocked->GetOutput()->GetBufferedRegion() );
+      for (; !bit.IsAtEnd(); ++bit, ++lit )
+        {
+        if ( bit.Get() != lit.Get() )
+          {
+          std::cerr << "Direction " << direction << ", order " << order << ": got " << bit.Get()
+                    << " instead of " << lit.Get() << std::endl;
+          result = false;
+          break;
+          }
+        }
+      }
+    }
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
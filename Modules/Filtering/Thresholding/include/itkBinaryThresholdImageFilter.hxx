@@ -39,6 +39,8 @@ template< class TInputImage, class TOutputImage >
 BinaryThresholdImageFilter< TInputImage, TOutputImage >
 ::BinaryThresholdImageFilter()
 {
+  // The functor is set up in BeforeThreadedGenerateData().
+  this->FusableOff();
   m_OutsideValue   = NumericTraits< OutputPixelType >::Zero;
   m_InsideValue    = NumericTraits< OutputPixelType >::max();
 
@@ -39,6 +39,8 @@ template< class TInputImage, class TOutputImage >
 ThresholdLabelerImageFilter< TInputImage, TOutputImage >
 ::ThresholdLabelerImageFilter()
 {
+  // The functor is set up in BeforeThreadedGenerateData().
+  this->FusableOff();
   m_Thresholds.clear();
   m_RealThresholds.clear();
   m_LabelOffset = NumericTraits< OutputPixelType >::Zero;
@@ -44,6 +44,11 @@ namespace itk
  *    dicom objects, you may want to try calling ->SetUseSeriesDetails(true)
  *    prior to calling SetDirectory().
  *
+ * The files of the directory are parsed by NumberOfThreads threads, up to
+ * their pixel data, which is not read. The headers can also be kept in
+ * an index file, see SetIndexFileName(), so that the files which did not
+ * change are not parsed again when their directory is scanned later.
+ *
  * \ingroup IOFilters
  *
  * \ingroup ITKIOGDCM
@@ -169,6 +174,17 @@ public:
   itkSetMacro(LoadPrivateTags, bool);
   itkGetConstMacro(LoadPrivateTags, bool);
   itkBooleanMacro(LoadPrivateTags);
+
+  /** Set/Get the file holding the index of the DICOM headers read from
+   * the input directory. Files whose path, modification time and size
+   * are found in the index are not parsed again. Only the elements of
+   * up to 256 bytes, outside sequences, are indexed, and the headers
+   * of the series helper hold no others for these files. Private
+   * elements are indexed if LoadPrivateTags is on. The index is
+   * updated by SetInputDirectory(), so it must be set before. Several
+   * directories can share an index. Default is empty, for no index. */
+  itkSetStringMacro(IndexFileName);
+  itkGetStringMacro(IndexFileName);
 protected:
   GDCMSeriesFileNames();
   ~GDCMSeriesFileNames();
@@ -178,6 +194,10 @@ private:
   GDCMSeriesFileNames(const Self &); //purposely not implemented
   void operator=(const Self &);      //purposely not implemented
 
+  /** Add the DICOM files of directory name to the series helper,
+   * reading their headers from the index when possible. */
+  void ScanDirectory(const std::string & name);
+
   /** Contains the input directory where the DICOM serie is found */
   std::string m_InputDirectory;
 
@@ -198,6 +218,8 @@ private:
   bool m_Recursive;
   bool m_LoadSequences;
   bool m_LoadPrivateTags;
+
+  std::string m_IndexFileName;
 };
 } //namespace ITK
 
@@ -21,9 +21,266 @@
 #include "itkGDCMSeriesFileNames.h"
 #include "itksys/SystemTools.hxx"
 #include "itkProgressReporter.h"
+#include "itkMultiThreader.h"
+#include "itkByteSwapper.h"
+#include "gdcmDirectory.h"
+#include "gdcmReader.h"
+#include <fstream>
+#include <map>
+#include <set>
+#include <sstream>
 
 namespace itk
 {
+namespace
+{
+/** Gives access to gdcm::SerieHelper::AddFile(), to add the files read
+ * by GDCMSeriesFileNames. */
+class SerieHelperAccessor:public gdcm::SerieHelper
+{
+public:
+  static void Add(gdcm::SerieHelper *helper, gdcm::FileWithName & file)
+  {
+    bool (gdcm::SerieHelper::*addFile)(gdcm::FileWithName &) = &SerieHelperAccessor::AddFile;
+    ( helper->*addFile )(file);
+  }
+};
+
+typedef gdcm::SmartPointer< gdcm::FileWithName > FileWithNamePointer;
+
+/** Read the header of a DICOM image, without its pixel data. A null
+ * pointer is returned for other files, as gdcm::ImageReader fails on
+ * them. */
+FileWithNamePointer
+ReadHeader(const std::string & fileName)
+{
+  gdcm::Reader reader;
+  reader.SetFileName( fileName.c_str() );
+  const std::set< gdcm::Tag > skipTags;
+  if ( !reader.ReadUpToTag(gdcm::Tag(0x7fe0, 0x0010), skipTags)
+       || !reader.GetFile().GetDataSet().FindDataElement( gdcm::Tag(0x0028, 0x0010) ) )
+    {
+    return FileWithNamePointer();
+    }
+  FileWithNamePointer file = new gdcm::FileWithName( reader.GetFile() );
+  file->filename = fileName;
+  return file;
+}
+
+struct ScanThreadStruct {
+  const std::vector< std::string > * FileNames;
+  std::vector< FileWithNamePointer > *Files;
+};
+
+ITK_THREAD_RETURN_TYPE
+ScanThreaderCallback(void *arg)
+{
+  const MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const ScanThreadStruct *               str = static_cast< ScanThreadStruct * >( info->UserData );
+
+  for ( size_t i = info->ThreadID; i < str->FileNames->size(); i += info->NumberOfThreads )
+    {
+    ( *str->Files )[i] = ReadHeader( ( *str->FileNames )[i] );
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/** The headers of an index file, by file name. The header is empty for
+ * files which are not DICOM images. */
+struct IndexEntry {
+  long int      ModifiedTime;
+  unsigned long Size;
+  std::string   Header;
+};
+typedef std::map< std::string, IndexEntry > IndexType;
+
+const char                IndexSignature[] = "ITK GDCMSeriesFileNames index 1\n";
+const gdcm::VL::Type      MaximumIndexedLength = 256;
+
+template< class T >
+void
+WriteValue(std::ostream & os, T value)
+{
+  ByteSwapper< T >::SwapFromSystemToLittleEndian(&value);
+  os.write(reinterpret_cast< const char * >( &value ), sizeof( T ) );
+}
+
+template< class T >
+bool
+ReadValue(std::istream & is, T & value)
+{
+  is.read(reinterpret_cast< char * >( &value ), sizeof( T ) );
+  ByteSwapper< T >::SwapFromSystemToLittleEndian(&value);
+  return is.good();
+}
+
+void
+WriteString(std::ostream & os, const std::string & value)
+{
+  WriteValue< uint32_t >( os, static_cast< uint32_t >( value.size() ) );
+  os.write( value.data(), value.size() );
+}
+
+bool
+ReadString(std::istream & is, std::string & value)
+{
+  uint32_t length;
+  if ( !ReadValue(is, length) )
+    {
+    return false;
+    }
+  value.resize(length);
+  if ( length > 0 )
+    {
+    is.read(&value[0], length);
+    }
+  return is.good();
+}
+
+/** Encode the elements of the header of file that are indexed in
+ * header. False is returned if file cannot be indexed, because its
+ * ordering depends on elements within sequences. */
+bool
+EncodeHeader(const gdcm::File *file, bool privateTags, std::string & header)
+{
+  header.clear();
+  if ( file == 0 )
+    {
+    return true;
+    }
+  const gdcm::DataSet & dataSet = file->GetDataSet();
+  if ( dataSet.FindDataElement( gdcm::Tag(0x5200, 0x9229) )
+       || dataSet.FindDataElement( gdcm::Tag(0x5200, 0x9230) ) )
+    {
+    return false;
+    }
+
+  std::vector< const gdcm::DataElement * > elements;
+  const gdcm::DataSet *                    dataSets[] = { &file->GetHeader(), &dataSet };
+  for ( unsigned int d = 0; d < 2; d++ )
+    {
+    for ( gdcm::DataSet::ConstIterator it = dataSets[d]->Begin(); it != dataSets[d]->End(); ++it )
+      {
+      const gdcm::ByteValue *value = it->GetByteValue();
+      if ( ( value == 0 && !it->IsEmpty() )
+           || ( value != 0 && value->GetLength() > MaximumIndexedLength )
+           || ( !privateTags && it->GetTag().IsPrivate() ) )
+        {
+        continue;
+        }
+      elements.push_back( &*it );
+      }
+    }
+
+  std::ostringstream os;
+  WriteValue< uint32_t >( os, file->GetHeader().GetDataSetTransferSyntax() );
+  WriteValue< uint32_t >( os, static_cast< uint32_t >( elements.size() ) );
+  for ( size_t e = 0; e < elements.size(); e++ )
+    {
+    const gdcm::ByteValue *value = elements[e]->GetByteValue();
+    WriteValue< uint16_t >( os, elements[e]->GetTag().GetGroup() );
+    WriteValue< uint16_t >( os, elements[e]->GetTag().GetElement() );
+    WriteValue< uint32_t >( os, static_cast< gdcm::VR::VRType >( elements[e]->GetVR() ) );
+    WriteString( os, value ? std::string( value->GetPointer(), value->GetLength() ) : std::string() );
+    }
+  header = os.str();
+  return true;
+}
+
+/** Rebuild the file whose header was encoded by EncodeHeader(). */
+FileWithNamePointer
+DecodeHeader(const std::string & header, const std::string & fileName)
+{
+  if ( header.empty() )
+    {
+    return FileWithNamePointer();
+    }
+  std::istringstream is(header);
+  gdcm::File         file;
+  uint32_t           transferSyntax;
+  uint32_t           numberOfElements;
+  ReadValue(is, transferSyntax);
+  ReadValue(is, numberOfElements);
+  file.GetHeader().SetDataSetTransferSyntax(
+    gdcm::TransferSyntax( static_cast< gdcm::TransferSyntax::TSType >( transferSyntax ) ) );
+  for ( uint32_t e = 0; e < numberOfElements; e++ )
+    {
+    uint16_t    group;
+    uint16_t    element;
+    uint32_t    vr;
+    std::string value;
+    ReadValue(is, group);
+    ReadValue(is, element);
+    ReadValue(is, vr);
+    if ( !ReadString(is, value) )
+      {
+      return FileWithNamePointer();
+      }
+    gdcm::DataElement dataElement( gdcm::Tag(group, element) );
+    dataElement.SetVR( gdcm::VR( static_cast< gdcm::VR::VRType >( vr ) ) );
+    if ( !value.empty() )
+      {
+      dataElement.SetByteValue( value.data(), static_cast< uint32_t >( value.size() ) );
+      }
+    if ( group == 0x0002 )
+      {
+      file.GetHeader().Insert(dataElement);
+      }
+    else
+      {
+      file.GetDataSet().Insert(dataElement);
+      }
+    }
+  FileWithNamePointer fileWithName = new gdcm::FileWithName(file);
+  fileWithName->filename = fileName;
+  return fileWithName;
+}
+
+/** Read the entries of an index file. A missing or invalid index is
+ * empty. */
+void
+ReadIndex(const std::string & indexFileName, IndexType & index)
+{
+  std::ifstream is(indexFileName.c_str(), std::ios::in | std::ios::binary);
+  if ( !is )
+    {
+    return;
+    }
+  std::string signature( sizeof( IndexSignature ) - 1, ' ' );
+  is.read( &signature[0], signature.size() );
+  if ( !is || signature != IndexSignature )
+    {
+    return;
+    }
+  std::string fileName;
+  IndexEntry  entry;
+  uint64_t    modifiedTime;
+  uint64_t    size;
+  while ( ReadString(is, fileName) && ReadValue(is, modifiedTime) && ReadValue(is, size)
+          && ReadString(is, entry.Header) )
+    {
+    entry.ModifiedTime = static_cast< long int >( modifiedTime );
+    entry.Size = static_cast< unsigned long >( size );
+    index[fileName] = entry;
+    }
+}
+
+bool
+WriteIndex(const std::string & indexFileName, const IndexType & index)
+{
+  std::ofstream os(indexFileName.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  os.write( IndexSignature, sizeof( IndexSignature ) - 1 );
+  for ( IndexType::const_iterator it = index.begin(); it != index.end(); ++it )
+    {
+    WriteString(os, it->first);
+    WriteValue< uint64_t >( os, static_cast< uint64_t >( it->second.ModifiedTime ) );
+    WriteValue< uint64_t >( os, it->second.Size );
+    WriteString(os, it->second.Header);
+    }
+  return os.good();
+}
+} // end anonymous namespace
+
 GDCMSeriesFileNames::GDCMSeriesFileNames()
 {
   m_SerieHelper = new gdcm::SerieHelper();
@@ -72,11 +329,111 @@ void GDCMSeriesFileNames::SetInputDirectory(std::string const & name)
   m_SerieHelper->SetUseSeriesDetails(m_UseSeriesDetails);
   m_SerieHelper->SetLoadMode( ( m_LoadSequences ? 0 : gdcm::LD_NOSEQ )
                               | ( m_LoadPrivateTags ? 0 : gdcm::LD_NOSHADOW ) );
-  m_SerieHelper->SetDirectory(name, m_Recursive);
+  this->ScanDirectory(name);
   //as a side effect it also execute
   this->Modified();
 }
 
+void GDCMSeriesFileNames::ScanDirectory(const std::string & name)
+{
+  gdcm::Directory directory;
+  directory.Load(name, m_Recursive);
+  const gdcm::Directory::FilenamesType & fileNames = directory.GetFilenames();
+
+  IndexType index;
+  bool      indexModified = false;
+  if ( !m_IndexFileName.empty() )
+    {
+    ReadIndex(m_IndexFileName, index);
+    }
+
+  // Take the headers of the files which did not change from the index,
+  // and read the others.
+  std::vector< FileWithNamePointer > files( fileNames.size() );
+  std::vector< std::string >         fileNamesToRead;
+  std::vector< size_t >              positionsToRead;
+  std::vector< IndexEntry >          entriesToRead;
+  std::set< std::string >            scannedFileNames;
+  for ( size_t i = 0; i < fileNames.size(); i++ )
+    {
+    IndexEntry entry;
+    if ( !m_IndexFileName.empty() )
+      {
+      scannedFileNames.insert(fileNames[i]);
+      entry.ModifiedTime = itksys::SystemTools::ModifiedTime( fileNames[i].c_str() );
+      entry.Size = itksys::SystemTools::FileLength( fileNames[i].c_str() );
+      IndexType::const_iterator it = index.find(fileNames[i]);
+      if ( it != index.end() && it->second.ModifiedTime == entry.ModifiedTime
+           && it->second.Size == entry.Size )
+        {
+        files[i] = DecodeHeader(it->second.Header, fileNames[i]);
+        continue;
+        }
+      }
+    fileNamesToRead.push_back(fileNames[i]);
+    positionsToRead.push_back(i);
+    entriesToRead.push_back(entry);
+    }
+
+  if ( !fileNamesToRead.empty() )
+    {
+    std::vector< FileWithNamePointer > filesRead( fileNamesToRead.size() );
+    ScanThreadStruct                   str;
+    str.FileNames = &fileNamesToRead;
+    str.Files = &filesRead;
+
+    MultiThreader::Pointer threader = MultiThreader::New();
+    threader->SetNumberOfThreads( std::min( this->GetNumberOfThreads(),
+                                            static_cast< ThreadIdType >( fileNamesToRead.size() ) ) );
+    threader->SetSingleMethod(ScanThreaderCallback, &str);
+    threader->SingleMethodExecute();
+
+    for ( size_t i = 0; i < fileNamesToRead.size(); i++ )
+      {
+      files[positionsToRead[i]] = filesRead[i];
+      if ( !m_IndexFileName.empty()
+           && EncodeHeader(filesRead[i].GetPointer(), m_LoadPrivateTags, entriesToRead[i].Header) )
+        {
+        index[fileNamesToRead[i]] = entriesToRead[i];
+        indexModified = true;
+        }
+      }
+    }
+
+  // The files are added in the order of the directory, as
+  // gdcm::SerieHelper::SetDirectory() does.
+  for ( size_t i = 0; i < files.size(); i++ )
+    {
+    if ( files[i].GetPointer() != 0 )
+      {
+      SerieHelperAccessor::Add(m_SerieHelper, *files[i]);
+      }
+    }
+
+  if ( !m_IndexFileName.empty() )
+    {
+    // Forget the files of the directory which were removed.
+    for ( IndexType::iterator it = index.begin(); it != index.end(); )
+      {
+      if ( it->first.compare(0, name.size(), name) == 0
+           && scannedFileNames.find(it->first) == scannedFileNames.end()
+           && !itksys::SystemTools::FileExists( it->first.c_str() ) )
+        {
+        index.erase(it++);
+        indexModified = true;
+        }
+      else
+        {
+        ++it;
+        }
+      }
+    if ( indexModified && !WriteIndex(m_IndexFileName, index) )
+      {
+      itkWarningMacro(<< "Cannot write the DICOM index file " << m_IndexFileName);
+      }
+    }
+}
+
 const SerieUIDContainer & GDCMSeriesFileNames::GetSeriesUIDs()
 {
   m_SeriesUIDs.clear();
@@ -278,6 +635,7 @@ void GDCMSeriesFileNames::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "InputDirectory: " << m_InputDirectory << std::endl;
   os << indent << "LoadSequences:" << m_LoadSequences << std::endl;
   os << indent << "LoadPrivateTags:" << m_LoadPrivateTags << std::endl;
+  os << indent << "IndexFileName: " << m_IndexFileName << std::endl;
   if ( m_Recursive )
     {
     os << indent << "Recursive: True" << std::endl;
@@ -0,0 +1,90 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGDCMSeriesFileNames.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+// The series UIDs and the file names of each series found in directory.
+std::vector< std::string >
+Scan(const char *directory, const std::string & indexFileName, bool restricted)
+{
+  itk::GDCMSeriesFileNames::Pointer seriesFileNames = itk::GDCMSeriesFileNames::New();
+  if ( restricted )
+    {
+    gdcm::SerieHelper *sh = seriesFileNames->GetSeriesHelper();
+    sh->AddRestriction(0x0010, 0x0010, "Wes Turner", gdcm::GDCM_EQUAL);
+    sh->AddRestriction(0x0020, 0x0013, "75", gdcm::GDCM_GREATEROREQUAL);
+    sh->AddRestriction(0x0020, 0x0013, "77", gdcm::GDCM_LESSOREQUAL);
+    }
+  seriesFileNames->SetIndexFileName(indexFileName);
+  seriesFileNames->SetInputDirectory(directory);
+
+  std::vector< std::string >     result;
+  const itk::SerieUIDContainer & uids = seriesFileNames->GetSeriesUIDs();
+  for ( size_t i = 0; i < uids.size(); i++ )
+    {
+    result.push_back(uids[i]);
+    const itk::FilenamesContainer & fileNames = seriesFileNames->GetFileNames(uids[i]);
+    result.insert( result.end(), fileNames.begin(), fileNames.end() );
+    }
+  return result;
+}
+}
+
+int itkGDCMSeriesFileNamesIndexTest(int argc, char *argv[])
+{
+  if ( argc < 3 )
+    {
+    std::cerr << "Usage: " << argv[0] << " DicomDirectory IndexFile" << std::endl;
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::RemoveFile(argv[2]);
+
+  for ( unsigned int restricted = 0; restricted < 2; restricted++ )
+    {
+    const std::vector< std::string > expected = Scan(argv[1], "", restricted != 0);
+    if ( expected.size() < 2 )
+      {
+      std::cerr << "No series found in " << argv[1] << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // The first scan builds the index, the second one reads it.
+    for ( unsigned int pass = 0; pass < 2; pass++ )
+      {
+      if ( Scan(argv[1], argv[2], restricted != 0) != expected )
+        {
+        std::cerr << "Scan " << pass << " with the index "
+                  << ( restricted ? "and restrictions " : "" )
+                  << "does not find the same series" << std::endl;
+        return EXIT_FAILURE;
+        }
+      if ( !itksys::SystemTools::FileExists(argv[2]) )
+        {
+        std::cerr << "The index " << argv[2] << " was not written" << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    std::cout << expected.size() << " series UIDs and file names found "
+              << ( restricted ? "with" : "without" ) << " restrictions." << std::endl;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -79,6 +79,17 @@ class MetaDataDictionary;
  *                             in the MetaDataDictionary
  * re-arrangement.
  *
+ * The VoxelData is stored in chunks, by default one N-1 dimensional
+ * slice each. SetChunkSize() selects other chunk shapes, e.g. 64x64x64
+ * bricks, so that a streamed read or write of an ImageIORegion only
+ * touches the chunks which intersect it. When UseCompression is on,
+ * each chunk is shuffled and deflated at the CompressionLevel. The
+ * chunk cache is sized from the IORegion of the first read or write,
+ * so that the chunks shared by consecutive stream pieces are only
+ * decompressed, or compressed, once.
+ *
+ * Writing an IORegion smaller than the image into an existing file
+ * pastes it into the VoxelData of that file.
  *
  */
 
@@ -129,6 +140,17 @@ public:
    * that the IORegions has been set properly. */
   virtual void Write(const void *buffer);
 
+  /** Type of the chunk shape, fastest moving dimension first. */
+  typedef std::vector< SizeValueType > ChunkSizeType;
+
+  /** Set/Get the chunk shape used when the VoxelData is written. When
+   * fewer sizes than image dimensions are given the last one is
+   * repeated, and each size is clamped to the image size. The
+   * components of a pixel are always kept in one chunk. An empty
+   * shape, the default, writes chunks of one N-1 dimensional slice. */
+  void SetChunkSize(const ChunkSizeType & chunkSize);
+  const ChunkSizeType & GetChunkSize() const;
+
 protected:
   HDF5ImageIO();
   ~HDF5ImageIO();
@@ -189,6 +211,8 @@ private:
   H5::H5File  *m_H5File;
   H5::DataSet *m_VoxelDataSet;
   bool         m_ImageInformationWritten;
+
+  ChunkSizeType m_ChunkSize;
 };
 } // end namespace itk
 
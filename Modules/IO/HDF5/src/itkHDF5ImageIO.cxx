@@ -21,6 +21,7 @@
 #include "itkArray.h"
 #include "itksys/SystemTools.hxx"
 #include "itk_H5Cpp.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -52,6 +53,30 @@ HDF5ImageIO
   Superclass::PrintSelf(os, indent);
   // just prints out the pointer value.
   os << indent << "H5File: " << this->m_H5File << std::endl;
+  os << indent << "ChunkSize: [";
+  for ( unsigned int i = 0; i < this->m_ChunkSize.size(); ++i )
+    {
+    os << ( i > 0 ? ", " : "" ) << this->m_ChunkSize[i];
+    }
+  os << "]" << std::endl;
+}
+
+void
+HDF5ImageIO
+::SetChunkSize(const ChunkSizeType & chunkSize)
+{
+  if ( this->m_ChunkSize != chunkSize )
+    {
+    this->m_ChunkSize = chunkSize;
+    this->Modified();
+    }
+}
+
+const HDF5ImageIO::ChunkSizeType &
+HDF5ImageIO
+::GetChunkSize() const
+{
+  return this->m_ChunkSize;
 }
 
 //
@@ -69,6 +94,76 @@ const std::string VoxelType("/VoxelType");
 const std::string VoxelData("/VoxelData");
 const std::string MetaDataName("/MetaData");
 
+//
+// the smallest prime not less than n, for the number of hash table
+// slots of a chunk cache.
+size_t NextPrime(size_t n)
+{
+  for(;; ++n)
+    {
+    bool prime = n > 1;
+    for(size_t d = 2; prime && d * d <= n; ++d)
+      {
+      prime = (n % d) != 0;
+      }
+    if(prime)
+      {
+      return n;
+      }
+    }
+}
+
+//
+// Create a data set access property list whose chunk cache holds
+// the chunks intersecting one layer of chunks of the selection of
+// fileSpace: when an image is streamed along its slowest moving
+// dimension, these are the chunks shared by consecutive pieces.
+hid_t CreateChunkCacheAccessList(const H5::DSetCreatPropList &createList,
+                                 const H5::DataSpace &fileSpace,
+                                 size_t elementSize)
+{
+  hid_t accessList = H5Pcreate(H5P_DATASET_ACCESS);
+  if(createList.getLayout() != H5D_CHUNKED)
+    {
+    return accessList;
+    }
+  const int rank = fileSpace.getSimpleExtentNdims();
+  std::vector<hsize_t> chunk(rank), start(rank), end(rank);
+  createList.getChunk(rank,&chunk[0]);
+  fileSpace.getSelectBounds(&start[0],&end[0]);
+  size_t numberOfChunks = 1;
+  size_t chunkBytes = elementSize;
+  for(int i = 0; i < rank; i++)
+    {
+    chunkBytes *= chunk[i];
+    // HDF5 dimensions are listed slowest moving first.
+    if(i > 0)
+      {
+      numberOfChunks *= end[i] / chunk[i] - start[i] / chunk[i] + 1;
+      }
+    }
+  H5Pset_chunk_cache(accessList,NextPrime(100 * numberOfChunks),
+                     numberOfChunks * chunkBytes,
+                     H5D_CHUNK_CACHE_W0_DEFAULT);
+  return accessList;
+}
+
+//
+// open an existing data set with a chunk cache sized for the
+// selection of fileSpace.
+hid_t OpenDataSetWithChunkCache(const H5::H5File &file,
+                                const std::string &name,
+                                const H5::DataSpace &fileSpace)
+{
+  H5::DataSet dataSet = file.openDataSet(name);
+  hid_t accessList =
+    CreateChunkCacheAccessList(dataSet.getCreatePlist(),fileSpace,
+                               dataSet.getDataType().getSize());
+  hid_t dataSetId = H5Dopen2(file.getId(),name.c_str(),accessList);
+  H5Pclose(accessList);
+  return dataSetId;
+}
+
 template <typename TScalar>
 H5::PredType GetType()
 {
@@ -953,8 +1048,18 @@ HDF5ImageIO
   VoxelDataName += VoxelData;
   if(this->m_VoxelDataSet == 0)
     {
-    this->m_VoxelDataSet = new H5::DataSet();
-    *(this->m_VoxelDataSet) = this->m_H5File->openDataSet(VoxelDataName);
+    // the chunk cache is sized for the first region read.
+    H5::DataSpace voxelSpace =
+      this->m_H5File->openDataSet(VoxelDataName).getSpace();
+    H5::DataSpace slabSpace;
+    this->SetupStreaming(&voxelSpace,&slabSpace);
+    hid_t voxelSetId =
+      OpenDataSetWithChunkCache(*this->m_H5File,VoxelDataName,voxelSpace);
+    if(voxelSetId < 0)
+      {
+      itkExceptionMacro(<< "Can't open " << VoxelDataName);
+      }
+    this->m_VoxelDataSet = new H5::DataSet(voxelSetId);
     }
   H5::DataType voxelType = this->m_VoxelDataSet->getDataType();
   H5::DataSpace imageSpace = this->m_VoxelDataSet->getSpace();
@@ -1019,6 +1124,17 @@ HDF5ImageIO
 
   try
     {
+    //
+    // pasting a region into an existing file only writes voxel data;
+    // StreamingImageIOBase has checked that the file matches.
+    if(this->RequestedToStream() &&
+       itksys::SystemTools::FileExists(this->GetFileName()))
+      {
+      this->m_H5File = new H5::H5File(this->GetFileName(),
+                                      H5F_ACC_RDWR);
+      this->m_ImageInformationWritten = true;
+      return;
+      }
     this->m_H5File = new H5::H5File(this->GetFileName(),
                                     H5F_ACC_TRUNC);
     this->WriteString(ItkVersion,
@@ -1244,26 +1360,65 @@ HDF5ImageIO
     VoxelDataName += "/0";
     VoxelDataName += VoxelData;
     // set up properties for chunked, compressed writes.
-    // in this case, set the chunk size to be the N-1 dimension
-    // region
+    // by default, set the chunk size to be the N-1 dimension
+    // region, otherwise clamp the chunk size to the image size and
+    // keep the components of a voxel in one chunk.
     H5::DSetCreatPropList plist;
-    plist.setDeflate(5);
-    dims[0] = 1;
+    if(this->m_ChunkSize.empty())
+      {
+      dims[0] = 1;
+      }
+    else
+      {
+      const int numImageDims = this->GetNumberOfDimensions();
+      for(int i(0), j(numImageDims-1); i < numImageDims; i++, j--)
+        {
+        const SizeValueType chunkSize =
+          (static_cast<size_t>(i) < this->m_ChunkSize.size() ?
+           this->m_ChunkSize[i] : this->m_ChunkSize.back());
+        dims[j] = std::max<hsize_t>(1,std::min<hsize_t>(chunkSize,dims[j]));
+        }
+      }
     plist.setChunk(numDims,dims);
+    delete [] dims;
+    // shuffle the bytes of the voxels so that deflate sees the
+    // slowly varying high order bytes together.
+    if(this->GetUseCompression())
+      {
+      plist.setShuffle();
+      plist.setDeflate(this->GetCompressionLevel());
+      }
+    H5::DataSpace dspace;
+    this->SetupStreaming(&imageSpace,&dspace);
 
     //
-    // Create DataSet Once, potentially write to it many times
+    // Create DataSet Once, potentially write to it many times. The
+    // chunk cache is sized for the first region written.
     if(this->m_VoxelDataSet == 0)
       {
-      this->m_VoxelDataSet = new H5::DataSet();
-      *(this->m_VoxelDataSet) = this->m_H5File->createDataSet(VoxelDataName,
-                                                              dataType,
-                                                              imageSpace,plist);
+      hid_t voxelSetId;
+      if(H5Lexists(this->m_H5File->getId(),VoxelDataName.c_str(),
+                   H5P_DEFAULT) > 0)
+        {
+        voxelSetId =
+          OpenDataSetWithChunkCache(*this->m_H5File,VoxelDataName,imageSpace);
+        }
+      else
+        {
+        hid_t accessList =
+          CreateChunkCacheAccessList(plist,imageSpace,dataType.getSize());
+        voxelSetId = H5Dcreate2(this->m_H5File->getId(),VoxelDataName.c_str(),
+                                dataType.getId(),imageSpace.getId(),
+                                H5P_DEFAULT,plist.getId(),accessList);
+        H5Pclose(accessList);
+        }
+      if(voxelSetId < 0)
+        {
+        itkExceptionMacro(<< "Can't create " << VoxelDataName);
+        }
+      this->m_VoxelDataSet = new H5::DataSet(voxelSetId);
       }
-    H5::DataSpace dspace;
-    this->SetupStreaming(&imageSpace,&dspace);
     this->m_VoxelDataSet->write(buffer,dataType,dspace,imageSpace);
-    delete [] dims;
     }
   // catch failure caused by the H5File operations
   catch( H5::FileIException error )
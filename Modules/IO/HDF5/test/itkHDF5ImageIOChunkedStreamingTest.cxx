@@ -0,0 +1,271 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkHDF5ImageIO.h"
+#include "itkHDF5ImageIOFactory.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkStreamingImageFilter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkRGBPixel.h"
+#include "itk_H5Cpp.h"
+
+namespace
+{
+const char * const VoxelDataName = "/ITKImage/0/VoxelData";
+
+/** Check the chunk shape and the number of filters of the voxel data. */
+bool CheckLayout(const char *fileName, const std::vector< hsize_t > & expectedChunk, int expectedFilters)
+{
+  H5::H5File              file(fileName, H5F_ACC_RDONLY);
+  H5::DataSet             voxelSet = file.openDataSet(VoxelDataName);
+  H5::DSetCreatPropList   plist = voxelSet.getCreatePlist();
+  std::vector< hsize_t >  chunk( expectedChunk.size() );
+
+  if ( plist.getLayout() != H5D_CHUNKED
+       || plist.getChunk(static_cast< int >( chunk.size() ), &chunk[0]) != static_cast< int >( chunk.size() )
+       || chunk != expectedChunk )
+    {
+    std::cerr << fileName << ": wrong chunk layout" << std::endl;
+    return false;
+    }
+  if ( plist.getNfilters() != expectedFilters )
+    {
+    std::cerr << fileName << ": " << plist.getNfilters() << " filters instead of "
+              << expectedFilters << std::endl;
+    return false;
+    }
+  return true;
+}
+
+template< typename TImage >
+bool CompareRegion(const TImage *image, const TImage *expected, const typename TImage::RegionType & region)
+{
+  itk::ImageRegionConstIteratorWithIndex< TImage > it(image, region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != expected->GetPixel( it.GetIndex() ) )
+      {
+      std::cerr << "Wrong pixel at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+}
+
+// Chunked, compressed HDF5 files written and read a region at a time.
+int itkHDF5ImageIOChunkedStreamingTest(int ac, char *av[])
+{
+  if ( ac > 1 )
+    {
+    itksys::SystemTools::ChangeDirectory(av[1]);
+    }
+  itk::ObjectFactoryBase::RegisterFactory( itk::HDF5ImageIOFactory::New() );
+
+  typedef itk::Image< short, 3 > ImageType;
+  ImageType::SizeType size;
+  size[0] = 70;
+  size[1] = 45;
+  size[2] = 33;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  short *buffer = image->GetBufferPointer();
+  for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    buffer[i] = static_cast< short >( i % 1001 - 500 );
+    }
+
+  typedef itk::ImageFileWriter< ImageType > WriterType;
+  typedef itk::ImageFileReader< ImageType > ReaderType;
+  const char *fileName = "itkHDF5ImageIOChunkedStreamingTest.hdf5";
+  try
+    {
+    // 16^3 bricks, ragged at the image border, streamed in slabs
+    // thinner than a brick.
+    itk::HDF5ImageIO::Pointer writeIO = itk::HDF5ImageIO::New();
+    writeIO->SetChunkSize( itk::HDF5ImageIO::ChunkSizeType(1, 16) );
+    writeIO->SetCompressionLevel(9);
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetImageIO(writeIO);
+    writer->SetInput(image);
+    writer->SetFileName(fileName);
+    writer->SetUseCompression(true);
+    writer->SetNumberOfStreamDivisions(5);
+    writer->Update();
+    writer = 0;
+    writeIO = 0;
+
+    std::vector< hsize_t > chunk(3, 16);
+    if ( !CheckLayout(fileName, chunk, 2) )
+      {
+      return EXIT_FAILURE;
+      }
+
+    // the whole image, streamed
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    reader->SetUseStreaming(true);
+    typedef itk::StreamingImageFilter< ImageType, ImageType > StreamerType;
+    StreamerType::Pointer streamer = StreamerType::New();
+    streamer->SetInput( reader->GetOutput() );
+    streamer->SetNumberOfStreamDivisions(7);
+    streamer->Update();
+    if ( !CompareRegion( streamer->GetOutput(), image.GetPointer(), image->GetLargestPossibleRegion() ) )
+      {
+      return EXIT_FAILURE;
+      }
+    std::cout << "Streamed read passed." << std::endl;
+
+    // only a region
+    ImageType::RegionType region;
+    region.SetIndex(0, 20);
+    region.SetIndex(1, 3);
+    region.SetIndex(2, 17);
+    region.SetSize(0, 31);
+    region.SetSize(1, 40);
+    region.SetSize(2, 9);
+    reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    reader->SetUseStreaming(true);
+    reader->GetOutput()->SetRequestedRegion(region);
+    reader->Update();
+    if ( reader->GetOutput()->GetBufferedRegion() != region
+         || !CompareRegion( reader->GetOutput(), image.GetPointer(), region ) )
+      {
+      std::cerr << "Region read failed" << std::endl;
+      return EXIT_FAILURE;
+      }
+    std::cout << "Region read passed." << std::endl;
+
+    // paste a region of another image, read by a streaming reader,
+    // into the file, which the readers above must have closed.
+    streamer = 0;
+    reader = 0;
+    ImageType::Pointer pasted = ImageType::New();
+    pasted->SetRegions(size);
+    pasted->Allocate();
+    pasted->FillBuffer(1234);
+    const char *pastedFileName = "itkHDF5ImageIOChunkedStreamingTestPasted.hdf5";
+    writer = WriterType::New();
+    writer->SetInput(pasted);
+    writer->SetFileName(pastedFileName);
+    writer->Update();
+
+    reader = ReaderType::New();
+    reader->SetFileName(pastedFileName);
+    reader->SetUseStreaming(true);
+    itk::ImageIORegion ioRegion(3);
+    for ( unsigned int i = 0; i < 3; ++i )
+      {
+      ioRegion.SetIndex( i, region.GetIndex(i) );
+      ioRegion.SetSize( i, region.GetSize(i) );
+      }
+    writer = WriterType::New();
+    writer->SetInput( reader->GetOutput() );
+    writer->SetFileName(fileName);
+    writer->SetIORegion(ioRegion);
+    writer->Update();
+    writer = 0;
+    reader = 0;
+
+    reader = ReaderType::New();
+    reader->SetFileName(fileName);
+    reader->Update();
+    itk::ImageRegionConstIteratorWithIndex< ImageType > it(reader->GetOutput(),
+                                                           reader->GetOutput()->GetLargestPossibleRegion());
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      const short value = region.IsInside( it.GetIndex() ) ? 1234 : image->GetPixel( it.GetIndex() );
+      if ( it.Get() != value )
+        {
+        std::cerr << "Wrong pasted pixel at " << it.GetIndex() << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    if ( !CheckLayout(fileName, chunk, 2) )
+      {
+      return EXIT_FAILURE;
+      }
+    std::cout << "Paste passed." << std::endl;
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // the components of a voxel are kept in one chunk, and without
+  // compression there are no filters.
+  typedef itk::Image< itk::RGBPixel< unsigned char >, 3 > RGBImageType;
+  RGBImageType::Pointer rgbImage = RGBImageType::New();
+  rgbImage->SetRegions(size);
+  rgbImage->Allocate();
+  for ( itk::SizeValueType i = 0; i < rgbImage->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    RGBImageType::PixelType pixel;
+    pixel.Set(i % 256, i % 7, i % 13);
+    rgbImage->GetBufferPointer()[i] = pixel;
+    }
+  const char *rgbFileName = "itkHDF5ImageIOChunkedStreamingTestRGB.hdf5";
+  try
+    {
+    itk::HDF5ImageIO::Pointer writeIO = itk::HDF5ImageIO::New();
+    itk::HDF5ImageIO::ChunkSizeType chunkSize;
+    chunkSize.push_back(100);
+    chunkSize.push_back(8);
+    writeIO->SetChunkSize(chunkSize);
+    typedef itk::ImageFileWriter< RGBImageType > RGBWriterType;
+    RGBWriterType::Pointer writer = RGBWriterType::New();
+    writer->SetImageIO(writeIO);
+    writer->SetInput(rgbImage);
+    writer->SetFileName(rgbFileName);
+    writer->SetNumberOfStreamDivisions(4);
+    writer->Update();
+    writer = 0;
+    writeIO = 0;
+
+    std::vector< hsize_t > chunk;
+    chunk.push_back(8);
+    chunk.push_back(8);
+    chunk.push_back(70);
+    chunk.push_back(3);
+    if ( !CheckLayout(rgbFileName, chunk, 0) )
+      {
+      return EXIT_FAILURE;
+      }
+
+    typedef itk::ImageFileReader< RGBImageType > RGBReaderType;
+    RGBReaderType::Pointer reader = RGBReaderType::New();
+    reader->SetFileName(rgbFileName);
+    reader->Update();
+    if ( !CompareRegion( reader->GetOutput(), rgbImage.GetPointer(), rgbImage->GetLargestPossibleRegion() ) )
+      {
+      return EXIT_FAILURE;
+      }
+    std::cout << "RGB passed." << std::endl;
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+  return EXIT_SUCCESS;
+}
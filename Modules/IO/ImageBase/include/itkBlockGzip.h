@@ -0,0 +1,81 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkBlockGzip_h
+#define __itkBlockGzip_h
+
+#include "itkMacro.h"
+#include "itkIntTypes.h"
+#include <iostream>
+#include <vector>
+
+namespace itk
+{
+/** \class BlockGzip
+ * \brief Compresses and decompresses gzip streams with several threads.
+ *
+ * A gzip file may hold several members, each a complete gzip stream,
+ * which gzip readers decompress one after the other. Compress() cuts the
+ * data into blocks of BlockSize bytes and deflates them concurrently,
+ * each into its own member. Every member records its compressed size in
+ * a "BC" extra field of its header, as in the BGZF format, so that
+ * Decompress() can locate the following members without inflating this
+ * one, and inflate them concurrently as well. Members without this
+ * field, as written by gzip or zlib, are inflated by the calling thread.
+ *
+ * The output of Compress() is a standard gzip stream, which can be
+ * appended to a file already holding gzip members, e.g. a header.
+ *
+ * \sa ImageIOBase::SetNumberOfThreads ImageIOBase::SetCompressionLevel
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITK_EXPORT BlockGzip
+{
+public:
+  /** Number of uncompressed bytes of a member written by Compress(). Any
+   * block compresses to less than 64 kB, the largest member size the
+   * extra field can hold. */
+  itkStaticConstMacro(BlockSize, SizeValueType, 0xff00);
+
+  /** Write length bytes of data to os as gzip members compressed at the
+   * given zlib level, followed by an empty member marking the end of
+   * the data. */
+  static void Compress(std::ostream & os, const void *data, SizeValueType length,
+                       int level, ThreadIdType numberOfThreads);
+
+  /** Read the gzip members of is, and store length bytes of the
+   * decompressed data, starting offset bytes after its beginning, in
+   * data. An exception is thrown if the stream is not a gzip stream, is
+   * corrupted, or ends before offset + length bytes. Members written by
+   * Compress() that end before offset are skipped without being read,
+   * so is must be seekable. */
+  static void Decompress(std::istream & is, void *data, SizeValueType offset,
+                         SizeValueType length, ThreadIdType numberOfThreads);
+
+  /** Read the gzip members of is, and store the runs of runLength bytes
+   * of the decompressed data starting at runOffsets, which must be sorted
+   * and must not overlap, one after the other in data. Only the members
+   * overlapping a run are inflated, so that a region made of many runs
+   * is read without decompressing the whole span of the runs at once. */
+  static void Decompress(std::istream & is, void *data,
+                         const std::vector< SizeValueType > & runOffsets,
+                         SizeValueType runLength, ThreadIdType numberOfThreads);
+};
+} // end namespace itk
+
+#endif
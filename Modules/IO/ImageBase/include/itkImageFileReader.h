@@ -77,6 +77,27 @@ public:
  * raw binary format) have no accepted suffix, so you will have to
  * manually create the ImageIO instance of the write type.
  *
+ * With UseMemoryMapping on, the output image shares the memory of a
+ * mapping of the file instead of having its own buffer, so that a large
+ * image is available immediately, its pages being loaded from the file
+ * when they are first accessed. This requires that the whole image is
+ * read, that the pixel type of the output matches the pixel type in the
+ * file, and that the ImageIO finds the data stored uncompressed, in the
+ * native byte order and in the layout of the output buffer (see
+ * ImageIOBase::GetRawDataLocation). Otherwise, the file is read as
+ * usual. The file is never modified through the mapping: a page of the
+ * output that is written to is first copied.
+ *
+ * With ShrinkFactors set, the output is the image ShrinkImageFilter
+ * would produce from the file: along an axis shrunk by a factor f, every
+ * f-th pixel of the file is kept, the spacing is multiplied by f and the
+ * output has the physical center of the file. An ImageIO which decimates
+ * cheaply, e.g. JPEGImageIO by scaling the DCT or TIFFImageIO from a
+ * reduced resolution level, produces the image, or part of the
+ * shrinking, itself. When the ImageIO locates the
+ * raw data of the file, only the kept pixels are read from it. Otherwise
+ * the region covering them is read and then shrunk.
+ *
  * \sa ImageSeriesReader
  * \sa ImageIOBase
  *
@@ -121,6 +142,9 @@ public:
   /** The pixel type of the output image. */
   typedef typename TOutputImage::InternalPixelType OutputImagePixelType;
 
+  /** The factors by which the axes of the image are shrunk. */
+  typedef FixedArray< unsigned int, TOutputImage::ImageDimension > ShrinkFactorsType;
+
   /** Specify the file to read. This is forwarded to the IO instance. */
   itkSetGetDecoratedInputMacro(FileName, std::string);
 
@@ -149,6 +173,20 @@ public:
   itkSetMacro(UseStreaming, bool);
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
+
+  /** Set/Get whether the output image may map the file into memory
+   * instead of reading it. Default is off. */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+
+  /** Set/Get the factors by which the image is shrunk along each axis
+   * while it is read. Values less than 1 are read as 1. Default is 1 for
+   * all axes, i.e. the image is read at full resolution. */
+  itkSetMacro(ShrinkFactors, ShrinkFactorsType);
+  itkGetConstReferenceMacro(ShrinkFactors, ShrinkFactorsType);
+  void SetShrinkFactors(unsigned int factor);
+  void SetShrinkFactor(unsigned int i, unsigned int factor);
 protected:
   ImageFileReader();
   ~ImageFileReader();
@@ -173,15 +211,40 @@ protected:
                                // ImageIO is user specified
 
   bool m_UseStreaming;
+
+  bool m_UseMemoryMapping;
 private:
   ImageFileReader(const Self &); //purposely not implemented
   void operator=(const Self &);  //purposely not implemented
 
+  /** Make the output image share a mapping of the data in the file, if
+   * the file can be mapped. Returns false otherwise. */
+  bool MapOutputBuffer();
+
+  /** Whether the reader shrinks what the ImageIO reads. */
+  bool IsShrinkingRead() const;
+
+  /** Gather the pixels of the output buffered region at the start of a
+   * buffer holding the m_ActualIORegion read by the ImageIO. */
+  void ShrinkBuffer(char *buffer) const;
+
+  /** Read the pixels of the output buffered region from the raw data of
+   * the file, at the given offset, into a buffer. */
+  void ReadShrunkRawData(const std::string & fileName,
+                         ImageIOBase::SizeType offset, char *buffer) const;
+
   std::string m_ExceptionMessage;
 
   // The region that the ImageIO class will return when we ask to
   // produce the requested region.
   ImageIORegion m_ActualIORegion;
+
+  ShrinkFactorsType m_ShrinkFactors;
+
+  // The part of the shrinking left to the reader, and the index of the
+  // pixel read by the ImageIO which is the first pixel of the output.
+  ShrinkFactorsType m_ReaderShrinkFactors;
+  IndexType         m_ReaderShrinkOffset;
 };
 } //namespace ITK
 
@@ -24,8 +24,11 @@
 #include "itkConvertPixelBuffer.h"
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
+#include "itkMemoryMappedImageContainer.h"
 
 #include "itksys/SystemTools.hxx"
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 
 namespace itk
@@ -38,6 +41,10 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
   this->SetFileName("");
   m_UserSpecifiedImageIO = false;
   m_UseStreaming = true;
+  m_UseMemoryMapping = false;
+  m_ShrinkFactors.Fill(1);
+  m_ReaderShrinkFactors.Fill(1);
+  m_ReaderShrinkOffset.Fill(0);
 }
 
 template< class TOutputImage, class ConvertPixelTraits >
@@ -63,6 +70,45 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
 
   os << indent << "UserSpecifiedImageIO flag: " << m_UserSpecifiedImageIO << "\n";
   os << indent << "m_UseStreaming: " << m_UseStreaming << "\n";
+  os << indent << "m_UseMemoryMapping: " << m_UseMemoryMapping << "\n";
+  os << indent << "ShrinkFactors: " << m_ShrinkFactors << "\n";
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+void
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::SetShrinkFactors(unsigned int factor)
+{
+  ShrinkFactorsType factors;
+  factors.Fill(factor);
+  this->SetShrinkFactors(factors);
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+void
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::SetShrinkFactor(unsigned int i, unsigned int factor)
+{
+  if ( m_ShrinkFactors[i] != factor )
+    {
+    m_ShrinkFactors[i] = factor;
+    this->Modified();
+    }
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+bool
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::IsShrinkingRead() const
+{
+  for ( unsigned int i = 0; i < TOutputImage::ImageDimension; i++ )
+    {
+    if ( m_ReaderShrinkFactors[i] > 1 )
+      {
+      return true;
+      }
+    }
+  return false;
 }
 
 template< class TOutputImage, class ConvertPixelTraits >
@@ -149,11 +195,21 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
   // the image.
   //
   m_ImageIO->SetFileName( this->GetFileName().c_str() );
+
+  // The ImageIO may shrink the image itself, or part of it
+  std::vector< unsigned int > shrinkFactors(TOutputImage::ImageDimension);
+  for ( unsigned int i = 0; i < TOutputImage::ImageDimension; i++ )
+    {
+    shrinkFactors[i] = std::max(m_ShrinkFactors[i], 1u);
+    }
+  m_ImageIO->SetShrinkFactors(shrinkFactors);
+
   m_ImageIO->ReadImageInformation();
 
   SizeType dimSize;
   double   spacing[TOutputImage::ImageDimension];
   double   origin[TOutputImage::ImageDimension];
+  double   originShift[TOutputImage::ImageDimension];
   typename TOutputImage::DirectionType direction;
 
   std::vector< std::vector< double > > directionIO;
@@ -185,6 +241,33 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
       spacing[i] = m_ImageIO->GetSpacing(i);
       origin[i]  = m_ImageIO->GetOrigin(i);
 
+      // The reader keeps every few pixels the ImageIO reads, centered
+      // like ShrinkImageFilter does
+      const unsigned int appliedFactor = m_ImageIO->GetAppliedShrinkFactor(i);
+      if ( shrinkFactors[i] % appliedFactor != 0 )
+        {
+        std::ostringstream msg;
+        msg << "The ImageIO shrank axis " << i << " by " << appliedFactor
+            << ", which does not divide the shrink factor " << shrinkFactors[i];
+        ImageFileReaderException e(__FILE__, __LINE__, msg.str().c_str(), ITK_LOCATION);
+        throw e;
+        }
+      m_ReaderShrinkFactors[i] = shrinkFactors[i] / appliedFactor;
+      m_ReaderShrinkOffset[i] = 0;
+      originShift[i] = 0.0;
+      if ( m_ReaderShrinkFactors[i] > 1 && dimSize[i] > 0 )
+        {
+        // The physical centers of the file and of the output are the
+        // same, and each output pixel is the pixel of the file nearest to
+        // it, rounding half pixels up
+        const SizeValueType shrunkSize =
+          std::max< SizeValueType >(dimSize[i] / m_ReaderShrinkFactors[i], 1);
+        const SizeValueType remainder = dimSize[i] - 1 - m_ReaderShrinkFactors[i] * ( shrunkSize - 1 );
+        originShift[i] = remainder / 2.0;
+        m_ReaderShrinkOffset[i] = static_cast< IndexValueType >( ( remainder + 1 ) / 2 );
+        dimSize[i] = shrunkSize;
+        }
+
       // Please note: direction cosines are stored as columns of the
       // direction matrix
       axis = directionIO[i];
@@ -208,6 +291,9 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
       dimSize[i] = 1;
       spacing[i] = 1.0;
       origin[i] = 0.0;
+      m_ReaderShrinkFactors[i] = 1;
+      m_ReaderShrinkOffset[i] = 0;
+      originShift[i] = 0.0;
       for ( unsigned j = 0; j < TOutputImage::ImageDimension; j++ )
         {
         if ( i == j )
@@ -222,6 +308,19 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
       }
     }
 
+  // Shift the origin to the first output pixel
+  for ( unsigned int i = 0; i < TOutputImage::ImageDimension; i++ )
+    {
+    for ( unsigned int j = 0; j < TOutputImage::ImageDimension; j++ )
+      {
+      origin[j] += direction[j][i] * spacing[i] * originShift[i];
+      }
+    }
+  for ( unsigned int i = 0; i < TOutputImage::ImageDimension; i++ )
+    {
+    spacing[i] *= m_ReaderShrinkFactors[i];
+    }
+
   output->SetSpacing(spacing);       // Set the image spacing
   output->SetOrigin(origin);         // Set the image origin
   output->SetDirection(direction);   // Set the image direction cosines
@@ -300,7 +399,22 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
 
   typedef ImageIORegionAdaptor< TOutputImage::ImageDimension > ImageIOAdaptor;
 
-  ImageIOAdaptor::Convert( imageRequestedRegion, ioRequestedRegion, largestRegion.GetIndex() );
+  // When the reader shrinks the image, the ImageIO reads the pixels
+  // spanned by the requested ones
+  ImageRegionType readRequestedRegion = imageRequestedRegion;
+  if ( this->IsShrinkingRead() )
+    {
+    for ( unsigned int i = 0; i < TOutputImage::ImageDimension; i++ )
+      {
+      const SizeValueType size = imageRequestedRegion.GetSize(i);
+      readRequestedRegion.SetIndex(i, imageRequestedRegion.GetIndex(i)
+                                   * static_cast< IndexValueType >( m_ReaderShrinkFactors[i] )
+                                   + m_ReaderShrinkOffset[i]);
+      readRequestedRegion.SetSize(i, size > 0 ? ( size - 1 ) * m_ReaderShrinkFactors[i] + 1 : 0);
+      }
+    }
+
+  ImageIOAdaptor::Convert( readRequestedRegion, ioRequestedRegion, largestRegion.GetIndex() );
 
   // Tell the IO if we should use streaming while reading
   m_ImageIO->SetUseStreamedReading(m_UseStreaming);
@@ -320,6 +434,22 @@ ImageFileReader< TOutputImage, ConvertPixelTraits >
   // truncate the last dimensions
   ImageIOAdaptor::Convert( m_ActualIORegion, streamableRegion, largestRegion.GetIndex() );
 
+  // The output pixels whose pixels are read
+  if ( this->IsShrinkingRead() )
+    {
+    for ( unsigned int i = 0; i < TOutputImage::ImageDimension; i++ )
+      {
+      const IndexValueType factor = m_ReaderShrinkFactors[i];
+      const IndexValueType begin = streamableRegion.GetIndex(i) - m_ReaderShrinkOffset[i];
+      const IndexValueType end = begin + static_cast< IndexValueType >( streamableRegion.GetSize(i) );
+      const IndexValueType first = begin > 0 ? ( begin + factor - 1 ) / factor : 0;
+      const IndexValueType last = std::min( end > 0 ? ( end - 1 ) / factor : -1,
+                                            static_cast< IndexValueType >( largestRegion.GetSize(i) ) - 1 );
+      streamableRegion.SetIndex(i, first);
+      streamableRegion.SetSize(i, last >= first ? last - first + 1 : 0);
+      }
+    }
+
   // Check whether the imageRequestedRegion is fully contained inside the
   // streamable region. Since, ImageRegion::IsInside regards zero
   // sized regions, as not being inside any other region, we must
@@ -353,13 +483,6 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
 {
   typename TOutputImage::Pointer output = this->GetOutput();
 
-  itkDebugMacro (<< "ImageFileReader::GenerateData() \n"
-                 << "Allocating the buffer with the EnlargedRequestedRegion \n"
-                 << output->GetRequestedRegion() << "\n");
-
-  // allocated the output image to the size of the enlarge requested region
-  this->AllocateOutputs();
-
   // Test if the file exists and if it can be opened.
   // An exception will be thrown otherwise, since we can't
   // successfully read the file. We catch the exception because some
@@ -382,6 +505,29 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
   itkDebugMacro (<< "Setting imageIO IORegion to: " << m_ActualIORegion);
   m_ImageIO->SetIORegion(m_ActualIORegion);
 
+  if ( m_UseMemoryMapping && !this->IsShrinkingRead() && this->MapOutputBuffer() )
+    {
+    itkDebugMacro(<< "Output buffer mapped from the file.");
+    return;
+    }
+
+  itkDebugMacro (<< "ImageFileReader::GenerateData() \n"
+                 << "Allocating the buffer with the EnlargedRequestedRegion \n"
+                 << output->GetRequestedRegion() << "\n");
+
+  // A buffer mapped by a previous update is replaced by an allocated one
+  typedef typename TOutputImage::PixelContainer PixelContainerType;
+  typedef MemoryMappedImageContainer< typename PixelContainerType::ElementIdentifier,
+                                      typename PixelContainerType::Element > MappedContainerType;
+  if ( dynamic_cast< MappedContainerType * >( output->GetPixelContainer() ) )
+    {
+    typename PixelContainerType::Pointer container = PixelContainerType::New();
+    output->SetPixelContainer(container);
+    }
+
+  // allocated the output image to the size of the enlarge requested region
+  this->AllocateOutputs();
+
   char *loadBuffer = 0;
   // the size of the buffer is computed based on the actual number of
   // pixels to be read and the actual size of the pixels to be read
@@ -394,9 +540,46 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
     ImageIOBase::IOComponentType ioType =
       ImageIOBase
       ::MapPixelType< typename ConvertPixelTraits::ComponentType >::CType;
-    if ( m_ImageIO->GetComponentType() != ioType
-         || ( m_ImageIO->GetNumberOfComponents() !=
-              ConvertPixelTraits::GetNumberOfComponents() ) )
+    const bool convertBuffer = m_ImageIO->GetComponentType() != ioType
+                               || ( m_ImageIO->GetNumberOfComponents() !=
+                                    ConvertPixelTraits::GetNumberOfComponents() );
+    if ( this->IsShrinkingRead() )
+      {
+      const SizeValueType numberOfPixels = output->GetBufferedRegion().GetNumberOfPixels();
+
+      // Only the pixels kept are read from raw data, otherwise they are
+      // gathered from the region read
+      std::string           fileName;
+      ImageIOBase::SizeType offset;
+      if ( m_ImageIO->GetRawDataLocation(fileName, offset) )
+        {
+        itkDebugMacro(<< "Reading the pixels kept from " << fileName);
+
+        loadBuffer = new char[numberOfPixels * m_ImageIO->GetComponentSize()
+                              * m_ImageIO->GetNumberOfComponents()];
+        this->ReadShrunkRawData(fileName, offset, loadBuffer);
+        }
+      else
+        {
+        itkDebugMacro(<< "Shrinking the region read by the ImageIO");
+
+        loadBuffer = new char[sizeOfActualIORegion];
+        m_ImageIO->Read( static_cast< void * >( loadBuffer ) );
+        this->ShrinkBuffer(loadBuffer);
+        }
+
+      if ( convertBuffer )
+        {
+        this->DoConvertBuffer(static_cast< void * >( loadBuffer ), numberOfPixels);
+        }
+      else
+        {
+        std::copy(reinterpret_cast< const OutputImagePixelType * >( loadBuffer ),
+                  reinterpret_cast< const OutputImagePixelType * >( loadBuffer ) + numberOfPixels,
+                  output->GetPixelContainer()->GetBufferPointer() );
+        }
+      }
+    else if ( convertBuffer )
       {
       // the pixel types don't match so a type conversion needs to be
       // performed
@@ -470,6 +653,234 @@ void ImageFileReader< TOutputImage, ConvertPixelTraits >
     }
 }
 
+template< class TOutputImage, class ConvertPixelTraits >
+bool
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::MapOutputBuffer()
+{
+  typename TOutputImage::Pointer output = this->GetOutput();
+
+  // The file must hold exactly the pixels of the output buffer, in its
+  // pixel type
+  const ImageIOBase::IOComponentType ioType =
+    ImageIOBase::MapPixelType< typename ConvertPixelTraits::ComponentType >::CType;
+  if ( m_ImageIO->GetComponentType() != ioType
+       || m_ImageIO->GetNumberOfComponents() != ConvertPixelTraits::GetNumberOfComponents()
+       || m_ActualIORegion.GetNumberOfPixels() !=
+       static_cast< SizeValueType >( m_ImageIO->GetImageSizeInPixels() )
+       || m_ActualIORegion.GetNumberOfPixels() !=
+       output->GetRequestedRegion().GetNumberOfPixels() )
+    {
+    return false;
+    }
+
+  typedef typename TOutputImage::PixelContainer PixelContainerType;
+  typedef MemoryMappedImageContainer< typename PixelContainerType::ElementIdentifier,
+                                      typename PixelContainerType::Element > MappedContainerType;
+
+  const size_t numberOfBytes = m_ActualIORegion.GetNumberOfPixels()
+                               * ( m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents() );
+  if ( numberOfBytes % sizeof( typename PixelContainerType::Element ) != 0 )
+    {
+    return false;
+    }
+
+  std::string           fileName;
+  ImageIOBase::SizeType offset;
+  if ( !m_ImageIO->GetRawDataLocation(fileName, offset) )
+    {
+    itkDebugMacro(<< "The ImageIO cannot locate the data of " << this->GetFileName());
+    return false;
+    }
+
+  // Mappings start on a page boundary, so the components are aligned in
+  // memory as they are in the file
+  if ( offset % m_ImageIO->GetComponentSize() != 0 )
+    {
+    itkDebugMacro(<< "Misaligned data at offset " << offset << " of " << fileName);
+    return false;
+    }
+
+  MemoryMappedFile::Pointer file = MemoryMappedFile::New();
+  if ( !file->Map(fileName, offset, numberOfBytes) )
+    {
+    itkDebugMacro(<< "Cannot map " << numberOfBytes << " bytes at offset "
+                  << offset << " of " << fileName);
+    return false;
+    }
+
+  typename MappedContainerType::Pointer container = MappedContainerType::New();
+  container->SetMappedFile(file);
+  output->SetBufferedRegion( output->GetRequestedRegion() );
+  output->SetPixelContainer(container);
+  return true;
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+void
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::ShrinkBuffer(char *buffer) const
+{
+  const ImageRegionType & region = this->GetOutput()->GetBufferedRegion();
+  if ( region.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  const SizeValueType pixelSize = m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents();
+  const unsigned int  dimension =
+    std::min(m_ActualIORegion.GetImageDimension(), static_cast< unsigned int >( TOutputImage::ImageDimension ) );
+
+  // Bytes between consecutive pixels of the buffer along each axis
+  OffsetValueType strides[TOutputImage::ImageDimension];
+  OffsetValueType stride = pixelSize;
+  for ( unsigned int i = 0; i < dimension; i++ )
+    {
+    strides[i] = stride;
+    stride *= m_ActualIORegion.GetSize(i);
+    }
+
+  // The pixels are moved row by row towards the start of the buffer, in
+  // the order of the output: a pixel never moves past one not yet moved
+  const IndexType & start = region.GetIndex();
+  const SizeType &  size = region.GetSize();
+  IndexType         index = start;
+  char *            outputPixel = buffer;
+  while ( true )
+    {
+    OffsetValueType position = 0;
+    for ( unsigned int i = 0; i < dimension; i++ )
+      {
+      position += ( index[i] * static_cast< IndexValueType >( m_ReaderShrinkFactors[i] )
+                    + m_ReaderShrinkOffset[i] - m_ActualIORegion.GetIndex(i) ) * strides[i];
+      }
+    const char *inputPixel = buffer + position;
+    for ( SizeValueType x = 0; x < size[0]; x++ )
+      {
+      memmove(outputPixel, inputPixel, pixelSize);
+      outputPixel += pixelSize;
+      inputPixel += static_cast< OffsetValueType >( m_ReaderShrinkFactors[0] ) * strides[0];
+      }
+
+    unsigned int i = 1;
+    for (; i < TOutputImage::ImageDimension; i++ )
+      {
+      if ( ++index[i] < start[i] + static_cast< IndexValueType >( size[i] ) )
+        {
+        break;
+        }
+      index[i] = start[i];
+      }
+    if ( i == TOutputImage::ImageDimension )
+      {
+      break;
+      }
+    }
+}
+
+template< class TOutputImage, class ConvertPixelTraits >
+void
+ImageFileReader< TOutputImage, ConvertPixelTraits >
+::ReadShrunkRawData(const std::string & fileName, ImageIOBase::SizeType offset, char *buffer) const
+{
+  const ImageRegionType & region = this->GetOutput()->GetBufferedRegion();
+  if ( region.GetNumberOfPixels() == 0 )
+    {
+    return;
+    }
+
+  std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+  if ( !file.is_open() )
+    {
+    std::ostringstream msg;
+    msg << "The file couldn't be opened for reading. "
+        << std::endl << "Filename: " << fileName << std::endl;
+    ImageFileReaderException e(__FILE__, __LINE__, msg.str().c_str(), ITK_LOCATION);
+    throw e;
+    }
+
+  const SizeValueType pixelSize = m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents();
+  const unsigned int  fileDimension = m_ImageIO->GetNumberOfDimensions();
+  const unsigned int  dimension =
+    std::min( fileDimension, static_cast< unsigned int >( TOutputImage::ImageDimension ) );
+
+  // Bytes between consecutive pixels of the file along each axis; the
+  // axes the output does not have are read at the start of the IORegion
+  OffsetValueType strides[TOutputImage::ImageDimension];
+  OffsetValueType stride = pixelSize;
+  OffsetValueType dataPosition = offset;
+  for ( unsigned int i = 0; i < fileDimension; i++ )
+    {
+    if ( i < dimension )
+      {
+      strides[i] = stride;
+      }
+    else if ( i < m_ActualIORegion.GetImageDimension() )
+      {
+      dataPosition += m_ActualIORegion.GetIndex(i) * stride;
+      }
+    stride *= m_ImageIO->GetDimensions(i);
+    }
+
+  // A row of the output is read in one piece, from its first to its last
+  // pixel, and every few pixels are kept
+  const IndexType &     start = region.GetIndex();
+  const SizeType &      size = region.GetSize();
+  const SizeValueType   rowFactor = m_ReaderShrinkFactors[0];
+  const std::streamsize rowLength =
+    static_cast< std::streamsize >( ( ( size[0] - 1 ) * rowFactor + 1 ) * pixelSize );
+  std::vector< char >   row( rowFactor > 1 ? rowLength : 0 );
+
+  IndexType index = start;
+  char *    outputPixel = buffer;
+  while ( true )
+    {
+    OffsetValueType position = dataPosition;
+    for ( unsigned int i = 0; i < dimension; i++ )
+      {
+      position += ( index[i] * static_cast< IndexValueType >( m_ReaderShrinkFactors[i] )
+                    + m_ReaderShrinkOffset[i] ) * strides[i];
+      }
+    file.seekg(static_cast< std::streamoff >( position ), std::ios::beg);
+
+    if ( rowFactor > 1 )
+      {
+      file.read(&row[0], rowLength);
+      for ( SizeValueType x = 0; x < size[0]; x++ )
+        {
+        memcpy(outputPixel, &row[x * rowFactor * pixelSize], pixelSize);
+        outputPixel += pixelSize;
+        }
+      }
+    else
+      {
+      file.read(outputPixel, rowLength);
+      outputPixel += rowLength;
+      }
+    if ( file.fail() )
+      {
+      std::ostringstream msg;
+      msg << "Error reading the pixels at offset " << position << " of " << fileName;
+      ImageFileReaderException e(__FILE__, __LINE__, msg.str().c_str(), ITK_LOCATION);
+      throw e;
+      }
+
+    unsigned int i = 1;
+    for (; i < TOutputImage::ImageDimension; i++ )
+      {
+      if ( ++index[i] < start[i] + static_cast< IndexValueType >( size[i] ) )
+        {
+        break;
+        }
+      index[i] = start[i];
+      }
+    if ( i == TOutputImage::ImageDimension )
+      {
+      break;
+      }
+    }
+}
+
 template< class TOutputImage, class ConvertPixelTraits >
 void
 ImageFileReader< TOutputImage, ConvertPixelTraits >
@@ -20,7 +20,10 @@
 
 #include "itkProcessObject.h"
 #include "itkImageIOBase.h"
+#include "itkConditionVariable.h"
+#include "itkMultiThreader.h"
 #include "itkMacro.h"
+#include <deque>
 
 namespace itk
 {
@@ -66,6 +69,9 @@ public:
  * with a suitable suffix (".png", ".jpg", etc) and setting the input
  * to the writer is enough to get the writer to work properly.
  *
+ * When the input is streamed in several pieces, UseAsynchronousWriting
+ * lets the ImageIO write a piece while the next one is computed.
+ *
  * \sa ImageSeriesReader
  * \sa ImageIOBase
  *
@@ -155,6 +161,22 @@ public:
   itkSetMacro(NumberOfStreamDivisions, unsigned int);
   itkGetConstReferenceMacro(NumberOfStreamDivisions, unsigned int);
 
+  /** Set/Get whether the pieces of a streamed write are written by a
+   * separate thread, so that the upstream pipeline computes a piece
+   * while the previous ones are written. Each piece is copied out of
+   * the input before being queued. Default is off. */
+  itkSetMacro(UseAsynchronousWriting, bool);
+  itkGetConstReferenceMacro(UseAsynchronousWriting, bool);
+  itkBooleanMacro(UseAsynchronousWriting);
+
+  /** Set/Get the largest number of pieces queued or being written when
+   * UseAsynchronousWriting is on. The pipeline waits before copying a
+   * piece when the queue is full, which bounds the memory used. Default
+   * is 1, i.e. a piece is written while the next one is computed. */
+  itkSetClampMacro( MaximumNumberOfPendingPieces, unsigned int, 1,
+                    NumericTraits< unsigned int >::max() );
+  itkGetConstReferenceMacro(MaximumNumberOfPendingPieces, unsigned int);
+
   /** Aliased to the Write() method to be consistent with the rest of the
    * pipeline. */
   virtual void Update()
@@ -200,6 +222,33 @@ private:
   ImageFileWriter(const Self &); //purposely not implemented
   void operator=(const Self &);  //purposely not implemented
 
+  /** Pieces waiting to be written by the thread of asynchronous
+   * writing. */
+  struct PendingPieces {
+    typedef std::pair< ImageIORegion, InputImagePointer > PieceType;
+
+    ImageIOBase *              ImageIO;
+    std::deque< PieceType >    Pieces;
+    unsigned int               NumberOfPiecesBeingWritten;
+    unsigned int               MaximumNumberOfPieces;
+    bool                       Done;
+    bool                       Failed;
+    /** The exception of the piece that could not be written, rethrown by
+     * the pipeline thread with its original description and location. */
+    ImageFileWriterException   Error;
+    SimpleMutexLock            Mutex;
+    ConditionVariable::Pointer Condition;
+
+    PendingPieces():Error(__FILE__, __LINE__) {}
+  };
+
+  /** Write the pieces of a PendingPieces until its Done flag is set. */
+  static ITK_THREAD_RETURN_TYPE WritePendingPiecesThreaderCallback(void *arg);
+
+  /** Copy the ioRegion piece of the input, once there is room for it in
+   * pending. */
+  void QueuePiece(PendingPieces & pending, const ImageIORegion & ioRegion);
+
   std::string m_FileName;
 
   ImageIOBase::Pointer m_ImageIO;
@@ -213,6 +262,8 @@ private:
   bool m_FactorySpecifiedImageIO;           //track whether the factory
                                             //  mechanism set the ImageIO
   bool m_UseCompression;
+  bool m_UseAsynchronousWriting;
+  unsigned int m_MaximumNumberOfPendingPieces;
   bool m_UseInputMetaDataDictionary;        // whether to use the
                                             // MetaDataDictionary from the
                                             // input or not.
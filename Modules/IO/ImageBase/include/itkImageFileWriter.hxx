@@ -48,6 +48,8 @@ ImageFileWriter< TInputImage >
   m_UserSpecifiedIORegion = false;
   m_UserSpecifiedImageIO = false;
   m_NumberOfStreamDivisions = 1;
+  m_UseAsynchronousWriting = false;
+  m_MaximumNumberOfPendingPieces = 1;
 }
 
 //---------------------------------------------------------
@@ -294,62 +296,118 @@ ImageFileWriter< TInputImage >
                                                               pasteIORegion,
                                                               largestIORegion);
 
+  // With asynchronous writing, another thread writes the pieces while
+  // the pipeline computes the following ones.
+  MultiThreader::Pointer threader;
+  PendingPieces          pending;
+  int                    writingThread = -1;
+#if defined( ITK_USE_PTHREADS ) || defined( ITK_USE_WIN32_THREADS )
+  if ( m_UseAsynchronousWriting && numDivisions > 1 )
+    {
+    pending.ImageIO = m_ImageIO;
+    pending.NumberOfPiecesBeingWritten = 0;
+    pending.MaximumNumberOfPieces = m_MaximumNumberOfPendingPieces;
+    pending.Done = false;
+    pending.Failed = false;
+    pending.Condition = ConditionVariable::New();
+    threader = MultiThreader::New();
+    writingThread = threader->SpawnThread(WritePendingPiecesThreaderCallback, &pending);
+    }
+#endif
+
   /**
    * Loop over the number of pieces, execute the upstream pipeline on each
    * piece, and copy the results into the output image.
    */
   unsigned int piece;
 
-  for ( piece = 0;
-        piece < numDivisions && !this->GetAbortGenerateData();
-        piece++ )
+  try
     {
-    // get the actual piece to write
-    ImageIORegion streamIORegion = m_ImageIO->GetSplitRegionForWriting(piece, numDivisions,
-                                                                       pasteIORegion, largestIORegion);
-
-    // Check whether the paste region is fully contained inside the
-    // largest region or not.
-    if ( !pasteIORegion.IsInside(streamIORegion) )
+    for ( piece = 0;
+          piece < numDivisions && !this->GetAbortGenerateData();
+          piece++ )
       {
-      itkExceptionMacro(
-        << "ImageIO returns streamable region that is not fully contain in paste IO region"
-        << "Paste IO region: " << pasteIORegion
-        << "Streamable region: " << streamIORegion);
-      }
+      // get the actual piece to write
+      ImageIORegion streamIORegion = m_ImageIO->GetSplitRegionForWriting(piece, numDivisions,
+                                                                         pasteIORegion, largestIORegion);
 
-    InputImageRegionType streamRegion;
-    ImageIORegionAdaptor< TInputImage::ImageDimension >::
-    Convert( streamIORegion, streamRegion, largestRegion.GetIndex() );
+      // Check whether the paste region is fully contained inside the
+      // largest region or not.
+      if ( !pasteIORegion.IsInside(streamIORegion) )
+        {
+        itkExceptionMacro(
+          << "ImageIO returns streamable region that is not fully contain in paste IO region"
+          << "Paste IO region: " << pasteIORegion
+          << "Streamable region: " << streamIORegion);
+        }
 
-    // execute the the upstream pipeline with the requested
-    // region for streaming
-    nonConstInput->SetRequestedRegion(streamRegion);
-    nonConstInput->PropagateRequestedRegion();
-    nonConstInput->UpdateOutputData();
+      InputImageRegionType streamRegion;
+      ImageIORegionAdaptor< TInputImage::ImageDimension >::
+      Convert( streamIORegion, streamRegion, largestRegion.GetIndex() );
 
-    // check to see if we tried to stream but got the largest possible region
-    if ( piece == 0 && streamRegion != largestRegion )
-      {
-      InputImageRegionType bufferedRegion = input->GetBufferedRegion();
-      if ( bufferedRegion == largestRegion )
+      // execute the the upstream pipeline with the requested
+      // region for streaming
+      nonConstInput->SetRequestedRegion(streamRegion);
+      nonConstInput->PropagateRequestedRegion();
+      nonConstInput->UpdateOutputData();
+
+      // check to see if we tried to stream but got the largest possible region
+      if ( piece == 0 && streamRegion != largestRegion )
         {
-        // if so, then just write the entire image
-        itkDebugMacro("Requested stream region  matches largest region input filter may not support streaming well.");
-        itkDebugMacro("Writer is not streaming now!");
-        numDivisions = 1;
-        streamRegion = largestRegion;
-        ImageIORegionAdaptor< TInputImage::ImageDimension >::
-        Convert( streamRegion, streamIORegion, largestRegion.GetIndex() );
+        InputImageRegionType bufferedRegion = input->GetBufferedRegion();
+        if ( bufferedRegion == largestRegion )
+          {
+          // if so, then just write the entire image
+          itkDebugMacro("Requested stream region  matches largest region input filter may not support streaming well.");
+          itkDebugMacro("Writer is not streaming now!");
+          numDivisions = 1;
+          streamRegion = largestRegion;
+          ImageIORegionAdaptor< TInputImage::ImageDimension >::
+          Convert( streamRegion, streamIORegion, largestRegion.GetIndex() );
+          }
         }
-      }
 
-    m_ImageIO->SetIORegion(streamIORegion);
+      if ( writingThread >= 0 )
+        {
+        this->QueuePiece(pending, streamIORegion);
+        }
+      else
+        {
+        m_ImageIO->SetIORegion(streamIORegion);
 
-    // write the data
-    this->GenerateData();
+        // write the data
+        this->GenerateData();
+        }
 
-    this->UpdateProgress( (float)( piece + 1 ) / numDivisions );
+      this->UpdateProgress( (float)( piece + 1 ) / numDivisions );
+      }
+    }
+  catch ( ... )
+    {
+    if ( writingThread >= 0 )
+      {
+      // Drop the pieces not written yet.
+      pending.Mutex.Lock();
+      pending.Pieces.clear();
+      pending.Done = true;
+      pending.Condition->Broadcast();
+      pending.Mutex.Unlock();
+      threader->TerminateThread(writingThread);
+      }
+    throw;
+    }
+
+  if ( writingThread >= 0 )
+    {
+    pending.Mutex.Lock();
+    pending.Done = true;
+    pending.Condition->Broadcast();
+    pending.Mutex.Unlock();
+    threader->TerminateThread(writingThread);
+    if ( pending.Failed )
+      {
+      throw pending.Error;
+      }
     }
 
   // Notify end event observers
@@ -416,6 +474,121 @@ ImageFileWriter< TInputImage >
   m_ImageIO->Write(dataPtr);
 }
 
+//---------------------------------------------------------
+template< class TInputImage >
+void
+ImageFileWriter< TInputImage >
+::QueuePiece(PendingPieces & pending, const ImageIORegion & ioRegion)
+{
+  const InputImageType *input = this->GetInput();
+  InputImageRegionType  largestRegion = input->GetLargestPossibleRegion();
+
+  InputImageRegionType region;
+  ImageIORegionAdaptor< TInputImage::ImageDimension >::
+  Convert( ioRegion, region, largestRegion.GetIndex() );
+  if ( !input->GetBufferedRegion().IsInside(region) )
+    {
+    ImageFileWriterException e(__FILE__, __LINE__);
+    std::ostringstream       msg;
+    msg << "Did not get requested region!" << std::endl;
+    msg << "Requested:" << std::endl;
+    msg << region;
+    msg << "Actual:" << std::endl;
+    msg << input->GetBufferedRegion();
+    e.SetDescription( msg.str().c_str() );
+    e.SetLocation(ITK_LOCATION);
+    throw e;
+    }
+
+  pending.Mutex.Lock();
+  while ( !pending.Failed
+          && pending.Pieces.size() + pending.NumberOfPiecesBeingWritten >= pending.MaximumNumberOfPieces )
+    {
+    pending.Condition->Wait(&pending.Mutex);
+    }
+  const bool failed = pending.Failed;
+  pending.Mutex.Unlock();
+  if ( failed )
+    {
+    throw pending.Error;
+    }
+
+  // The upstream pipeline may reuse its output buffer for the next piece.
+  InputImagePointer pieceImage = InputImageType::New();
+  pieceImage->CopyInformation(input);
+  pieceImage->SetBufferedRegion(region);
+  pieceImage->Allocate();
+  ImageAlgorithm::Copy( input, pieceImage.GetPointer(), region, region );
+
+  pending.Mutex.Lock();
+  pending.Pieces.push_back( typename PendingPieces::PieceType(ioRegion, pieceImage) );
+  pending.Condition->Broadcast();
+  pending.Mutex.Unlock();
+}
+
+//---------------------------------------------------------
+template< class TInputImage >
+ITK_THREAD_RETURN_TYPE
+ImageFileWriter< TInputImage >
+::WritePendingPiecesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  PendingPieces *                  pending = static_cast< PendingPieces * >( info->UserData );
+
+  pending->Mutex.Lock();
+  while ( true )
+    {
+    while ( pending->Pieces.empty() && !pending->Done )
+      {
+      pending->Condition->Wait(&pending->Mutex);
+      }
+    if ( pending->Pieces.empty() )
+      {
+      break;
+      }
+    typename PendingPieces::PieceType piece = pending->Pieces.front();
+    pending->Pieces.pop_front();
+    ++pending->NumberOfPiecesBeingWritten;
+    pending->Mutex.Unlock();
+
+    bool                     failed = false;
+    ImageFileWriterException error(__FILE__, __LINE__);
+    try
+      {
+      pending->ImageIO->SetIORegion(piece.first);
+      pending->ImageIO->Write( piece.second->GetBufferPointer() );
+      }
+    catch ( ExceptionObject & e )
+      {
+      failed = true;
+      error = ImageFileWriterException( e.GetFile(), e.GetLine(), e.GetDescription(), e.GetLocation() );
+      }
+    catch ( std::exception & e )
+      {
+      failed = true;
+      error = ImageFileWriterException( __FILE__, __LINE__, e.what(), ITK_LOCATION );
+      }
+    // Release the piece before letting the pipeline copy another one.
+    piece.second = 0;
+
+    pending->Mutex.Lock();
+    --pending->NumberOfPiecesBeingWritten;
+    if ( failed )
+      {
+      pending->Failed = true;
+      pending->Error = error;
+      pending->Pieces.clear();
+      }
+    pending->Condition->Broadcast();
+    if ( failed )
+      {
+      break;
+      }
+    }
+  pending->Mutex.Unlock();
+  return ITK_THREAD_RETURN_VALUE;
+}
+
 //---------------------------------------------------------
 template< class TInputImage >
 void
@@ -439,6 +612,8 @@ ImageFileWriter< TInputImage >
 
   os << indent << "IO Region: " << m_PasteIORegion << "\n";
   os << indent << "Number of Stream Divisions: " << m_NumberOfStreamDivisions << "\n";
+  os << indent << "UseAsynchronousWriting: " << ( m_UseAsynchronousWriting ? "On" : "Off" ) << "\n";
+  os << indent << "MaximumNumberOfPendingPieces: " << m_MaximumNumberOfPendingPieces << "\n";
 
   if ( m_UseCompression )
     {
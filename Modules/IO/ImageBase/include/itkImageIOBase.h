@@ -21,6 +21,7 @@
 #include "itkIOConfigure.h"
 
 #include "itkLightProcessObject.h"
+#include "itkThreadSupport.h"
 #include "itkIndent.h"
 #include "itkImageIORegion.h"
 #include "itkRGBPixel.h"
@@ -192,6 +193,41 @@ public:
   itkGetConstMacro(UseCompression, bool);
   itkBooleanMacro(UseCompression);
 
+  /** Set/Get the zlib compression level, from 1 (fastest) to 9 (best
+   * compression), used by the ImageIOs writing gzip compressed data.
+   * The default is 6. */
+  itkSetClampMacro(CompressionLevel, int, 1, 9);
+  itkGetConstMacro(CompressionLevel, int);
+
+  /** Set/Get the number of threads the ImageIOs may use to compress or
+   * decompress the data, see BlockGzip. Defaults to the global default
+   * number of threads of the MultiThreader. */
+  itkSetClampMacro(NumberOfThreads, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfThreads, ThreadIdType);
+
+  /** Set/Get the factors by which the axes of the image are shrunk when
+   * it is read, 1 being the full resolution. The axes beyond the size of
+   * the vector are not shrunk. An ImageIO which can produce a decimated
+   * image cheaply, e.g. by decoding it at a reduced scale or from a
+   * reduced resolution level, may apply a divisor of the factor of an
+   * axis: ReadImageInformation() then reports the dimensions, spacing and
+   * origin of the decimated image, and GetAppliedShrinkFactor() returns
+   * that divisor. The rest of the shrinking is left to the caller, see
+   * ImageFileReader::SetShrinkFactors(). */
+  void SetShrinkFactors(const std::vector< unsigned int > & factors);
+
+  const std::vector< unsigned int > & GetShrinkFactors() const
+  {
+    return m_ShrinkFactors;
+  }
+
+  unsigned int GetShrinkFactor(unsigned int i) const;
+
+  /** The part of the shrink factor of axis i that the last call to
+   * ReadImageInformation() applied, 1 if the ImageIO reads the axis at
+   * full resolution. */
+  unsigned int GetAppliedShrinkFactor(unsigned int i) const;
+
   /** Set/Get a boolean to use streaming while reading or not. */
   itkSetMacro(UseStreamedReading, bool);
   itkGetConstMacro(UseStreamedReading, bool);
@@ -322,6 +358,19 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer) = 0;
 
+  /** Determine where the data of the whole image is stored, so that it
+   * can be mapped into memory instead of being read. Returns true, with
+   * the name of the file holding the data and the position of its first
+   * byte, only if Read() of the whole image would merely copy that many
+   * contiguous bytes of the file, i.e. the data is neither compressed,
+   * nor swapped, nor reordered, nor rescaled. Assumes
+   * ReadImageInformation() has been called. Default is false. */
+  virtual bool GetRawDataLocation(std::string & itkNotUsed(fileName),
+                                  SizeType & itkNotUsed(offset))
+  {
+    return false;
+  }
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -550,12 +599,24 @@ protected:
   /** Should we compress the data? */
   bool m_UseCompression;
 
+  /** zlib compression level. */
+  int m_CompressionLevel;
+
+  /** Number of threads used to compress or decompress the data. */
+  ThreadIdType m_NumberOfThreads;
+
   /** Should we use streaming for reading */
   bool m_UseStreamedReading;
 
   /** Should we use streaming for writing */
   bool m_UseStreamedWriting;
 
+  /** The shrink factors requested for reading, and those which the
+   * ImageIO applied. An ImageIO which shrinks the image sets the latter in
+   * ReadImageInformation(). */
+  std::vector< unsigned int > m_ShrinkFactors;
+  std::vector< unsigned int > m_AppliedShrinkFactors;
+
   /** The region to read or write. The region contains information about the
    * data within the region to read or write. */
   ImageIORegion m_IORegion;
@@ -23,6 +23,7 @@
 #include <string>
 #include "itkMetaDataDictionary.h"
 #include "itkImageFileReader.h"
+#include "itkSimpleFastMutexLock.h"
 
 namespace itk
 {
@@ -34,6 +35,13 @@ namespace itk
  * the files, but the image data must have the same Size for all
  * dimensions.
  *
+ * The files are read by up to NumberOfThreads threads. When an ImageIO
+ * is set, the files are read one after another with it instead, because
+ * ImageIO objects are not thread safe and hold settings and meta data
+ * that the caller may rely on. When files cannot be read, the first of
+ * them in the series is read again by the calling thread, which throws
+ * the exception the sequential reader would.
+ *
  * \sa GDCMSeriesFileNames
  * \sa NumericSeriesFileNames
  * \ingroup IOFilters
@@ -117,7 +125,9 @@ public:
   /** Set/Get the ImageIO helper class. By default, the
    * ImageSeriesReader uses the factory mechanism of the
    * ImageFileReader to determine the file type. This method can be
-   * used to specify which IO to use. */
+   * used to specify which IO to use. The files are then read one after
+   * another with this ImageIO, which holds the information of the last
+   * file read once the reader is updated. */
   itkSetObjectMacro(ImageIO, ImageIOBase);
   itkGetObjectMacro(ImageIO, ImageIOBase);
 
@@ -191,6 +201,32 @@ private:
 
   int ComputeMovingDimensionIndex(ReaderType *reader);
 
+  /** State shared by the threads reading the files. */
+  struct SliceReaderThreadStruct {
+    Self *                              Filter;
+    ImageRegionType                     SliceRegionToRequest;
+    SizeType                            ValidSize;
+    bool                                UpdateMetaDataDictionaryArray;
+    std::vector< int >                  Slices;
+    std::vector< DictionaryRawPointer > Dictionaries;
+    SizeValueType                       NextSlice;
+    SimpleFastMutexLock                 Mutex;
+    /** The first file that could not be read, and a copy of its
+     * exception. */
+    bool                                ErrorOccurred;
+    SizeValueType                       ErrorSlice;
+    ExceptionObject                     Error;
+
+    SliceReaderThreadStruct():
+      ErrorOccurred(false), ErrorSlice(0) {}
+  };
+
+  static ITK_THREAD_RETURN_TYPE SliceReaderThreaderCallback(void *arg);
+
+  /** Read the file of slice i, or only its information if the slice is
+   * not in the requested region, with imageIO if it is not null. */
+  void ReadSlice(int i, ImageIOBase *imageIO, SliceReaderThreadStruct & str);
+
   /** Modified time of the MetaDataDictionaryArray */
   TimeStamp m_MetaDataDictionaryArrayMTime;
 
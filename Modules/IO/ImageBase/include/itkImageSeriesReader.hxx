@@ -26,6 +26,8 @@
 #include "vnl/vnl_math.h"
 #include "itkProgressReporter.h"
 #include "itkMetaDataObject.h"
+#include "itkMultiThreader.h"
+#include <algorithm>
 
 namespace itk
 {
@@ -284,10 +286,13 @@ void ImageSeriesReader< TOutputImage >
 
   ImageRegionType requestedRegion = output->GetRequestedRegion();
   ImageRegionType largestRegion = output->GetLargestPossibleRegion();
-  ImageRegionType sliceRegionToRequest = output->GetRequestedRegion();
+
+  SliceReaderThreadStruct str;
+  str.Filter = this;
+  str.SliceRegionToRequest = output->GetRequestedRegion();
 
   // Each file must have the same size.
-  SizeType validSize = largestRegion.GetSize();
+  str.ValidSize = largestRegion.GetSize();
 
   // If more than one file is being read, then the input dimension
   // will be less than the output dimension.  In this case, set
@@ -296,169 +301,299 @@ void ImageSeriesReader< TOutputImage >
   // not be done because it will lower the dimension of the output image.
   if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
     {
-    validSize[this->m_NumberOfDimensionsInImage] = 1;
-    sliceRegionToRequest.SetSize(this->m_NumberOfDimensionsInImage, 1);
-    sliceRegionToRequest.SetIndex(this->m_NumberOfDimensionsInImage, 0);
+    str.ValidSize[this->m_NumberOfDimensionsInImage] = 1;
+    str.SliceRegionToRequest.SetSize(this->m_NumberOfDimensionsInImage, 1);
+    str.SliceRegionToRequest.SetIndex(this->m_NumberOfDimensionsInImage, 0);
     }
 
   // Allocate the output buffer
   output->SetBufferedRegion(requestedRegion);
   output->Allocate();
 
-  // progress reported on a per slice basis
-  ProgressReporter progress(this, 0,
-                            requestedRegion.GetSize(TOutputImage::ImageDimension-1),
-                            100);
-
   // We utilize the modified time of the output information to
   // know when the meta array needs to be updated, when the output
   // information is updated so should the meta array.
   // Each file can not be read in the UpdateOutputInformation methods
   // due to the poor performance of reading each file a second time there.
-  bool needToUpdateMetaDataDictionaryArray =
+  str.UpdateMetaDataDictionaryArray =
     this->m_OutputInformationMTime > this->m_MetaDataDictionaryArrayMTime
     && m_MetaDataDictionaryArrayUpdate;
 
-  typename  TOutputImage::InternalPixelType *outputBuffer = output->GetBufferPointer();
-  IndexType                           sliceStartIndex = requestedRegion.GetIndex();
-  const int                           numberOfFiles = static_cast< int >( m_FileNames.size() );
-
+  // Select the files to read.
+  IndexType sliceStartIndex = requestedRegion.GetIndex();
+  const int numberOfFiles = static_cast< int >( m_FileNames.size() );
   for ( int i = 0; i != numberOfFiles; ++i )
     {
     if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
       {
       sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
       }
+    if ( requestedRegion.IsInside(sliceStartIndex) || str.UpdateMetaDataDictionaryArray )
+      {
+      str.Slices.push_back(i);
+      }
+    }
+  str.Dictionaries.resize(numberOfFiles, 0);
+  str.NextSlice = 0;
 
-    const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
-    const int  iFileName = ( m_ReverseOrder ? numberOfFiles - i - 1 : i );
+  // The ImageIO objects are not thread safe: a user supplied ImageIO reads
+  // the files one after another.
+  const ThreadIdType numberOfThreads = m_ImageIO ? 1 : static_cast< ThreadIdType >(
+    std::min( static_cast< size_t >( this->GetNumberOfThreads() ), str.Slices.size() ) );
 
-    // check if we need this slice
-    if ( !insideRequestedRegion && !needToUpdateMetaDataDictionaryArray )
+  try
+    {
+    if ( numberOfThreads <= 1 )
       {
-      continue;
+      // progress reported on a per slice basis
+      ProgressReporter progress(this, 0, str.Slices.size(), 100);
+      for ( size_t s = 0; s < str.Slices.size(); ++s )
+        {
+        this->ReadSlice(str.Slices[s], m_ImageIO, str);
+        progress.CompletedPixel();
+        }
       }
+    else
+      {
+      MultiThreader *threader = this->GetMultiThreader();
+      threader->SetNumberOfThreads(numberOfThreads);
+      threader->SetSingleMethod(Self::SliceReaderThreaderCallback, &str);
+      threader->SingleMethodExecute();
 
-    // configure reader
-    typename ReaderType::Pointer reader = ReaderType::New();
-    reader->SetFileName( m_FileNames[iFileName].c_str() );
-
-    TOutputImage * readerOutput = reader->GetOutput();
+      if ( str.ErrorOccurred )
+        {
+        // Read the file again in this thread, so that its exception leaves
+        // the filter as it was thrown, whatever its type. The copy kept by
+        // the thread is only thrown if the file can be read this time.
+        this->ReadSlice(str.Slices[str.ErrorSlice], NULL, str);
+        throw str.Error;
+        }
+      if ( this->GetAbortGenerateData() )
+        {
+        ProcessAborted e(__FILE__, __LINE__);
+        e.SetDescription("Process aborted.");
+        e.SetLocation(ITK_LOCATION);
+        throw e;
+        }
+      this->UpdateProgress(1.0f);
+      }
+    }
+  catch ( ... )
+    {
+    for ( size_t i = 0; i < str.Dictionaries.size(); ++i )
+      {
+      delete str.Dictionaries[i];
+      }
+    throw;
+    }
 
-    if ( m_ImageIO )
+  // Store the dictionaries in the order of the files.
+  if ( str.UpdateMetaDataDictionaryArray )
+    {
+    for ( size_t i = 0; i < str.Dictionaries.size(); ++i )
       {
-      reader->SetImageIO(m_ImageIO);
+      if ( str.Dictionaries[i] )
+        {
+        m_MetaDataDictionaryArray.push_back(str.Dictionaries[i]);
+        }
       }
-    reader->SetUseStreaming(m_UseStreaming);
-    readerOutput->SetRequestedRegion(sliceRegionToRequest);
 
-    // update the data or info
-    if ( !insideRequestedRegion )
+    // update the time if we modified the meta array
+    m_MetaDataDictionaryArrayMTime.Modified();
+    }
+}
+
+template< class TOutputImage >
+ITK_THREAD_RETURN_TYPE
+ImageSeriesReader< TOutputImage >
+::SliceReaderThreaderCallback(void *arg)
+{
+  const MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  SliceReaderThreadStruct *              str = static_cast< SliceReaderThreadStruct * >( info->UserData );
+  const ThreadIdType                     threadId = info->ThreadID;
+  const SizeValueType                    numberOfSlices = static_cast< SizeValueType >( str->Slices.size() );
+
+  for (;; )
+    {
+    // Take the next file to read, unless a file could not be read.
+    str->Mutex.Lock();
+    const SizeValueType s = str->NextSlice;
+    const bool          stop = s >= numberOfSlices || str->ErrorOccurred
+                               || str->Filter->GetAbortGenerateData();
+    if ( !stop )
       {
-      reader->UpdateOutputInformation();
+      ++str->NextSlice;
       }
-    else
+    str->Mutex.Unlock();
+    if ( stop )
       {
-      // read the meta data information
-      readerOutput->UpdateOutputInformation();
-
-      // propagate the requested region to determin what the region
-      // will actually be read
-      readerOutput->PropagateRequestedRegion();
+      break;
+      }
 
-      // check that the size of each slice is the same
-      if ( readerOutput->GetLargestPossibleRegion().GetSize() != validSize )
+    // Exceptions cannot leave the thread with their details: keep the
+    // first file in the series that could not be read.
+    try
+      {
+      str->Filter->ReadSlice(str->Slices[s], NULL, *str);
+      }
+    catch ( ExceptionObject & e )
+      {
+      str->Mutex.Lock();
+      if ( !str->ErrorOccurred || s < str->ErrorSlice )
         {
-        itkExceptionMacro( << "Size mismatch! The size of  "
-                           << m_FileNames[iFileName].c_str()
-                           << " is "
-                           << readerOutput->GetLargestPossibleRegion().GetSize()
-                           << " and does not match the required size "
-                           << validSize
-                           << " from file "
-                           << m_FileNames[m_ReverseOrder ? m_FileNames.size() - 1 : 0].c_str() );
+        str->ErrorOccurred = true;
+        str->ErrorSlice = s;
+        str->Error = e;
         }
+      str->Mutex.Unlock();
+      }
+    catch ( std::exception & e )
+      {
+      str->Mutex.Lock();
+      if ( !str->ErrorOccurred || s < str->ErrorSlice )
+        {
+        str->ErrorOccurred = true;
+        str->ErrorSlice = s;
+        str->Error = ExceptionObject( __FILE__, __LINE__, e.what(), ITK_LOCATION );
+        }
+      str->Mutex.Unlock();
+      }
 
-      // get the size of the region to be read
-      SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
+    // Only the first thread invokes the progress events.
+    if ( threadId == 0 )
+      {
+      str->Filter->UpdateProgress( static_cast< float >( s ) / static_cast< float >( numberOfSlices ) );
+      }
+    }
 
-      if( readSize == sliceRegionToRequest.GetSize() )
-        {
-        // if the buffer of the ImageReader is going to match that of
-        // ourselves, then set the ImageReader's buffer to a section
-        // of ours
+  return ITK_THREAD_RETURN_VALUE;
+}
 
-        const size_t  numberOfPixelsInSlice = sliceRegionToRequest.GetNumberOfPixels();
+template< class TOutputImage >
+void ImageSeriesReader< TOutputImage >
+::ReadSlice(int i, ImageIOBase *imageIO, SliceReaderThreadStruct & str)
+{
+  TOutputImage *         output = this->GetOutput();
+  const ImageRegionType &requestedRegion = output->GetRequestedRegion();
+  const int              numberOfFiles = static_cast< int >( m_FileNames.size() );
 
-        typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
-        const size_t      numberOfInternalComponentsPerPixel =  AccessorFunctorType::GetVectorLength( output );
+  IndexType sliceStartIndex = requestedRegion.GetIndex();
+  if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
+    {
+    sliceStartIndex[this->m_NumberOfDimensionsInImage] = i;
+    }
 
+  const bool insideRequestedRegion = requestedRegion.IsInside(sliceStartIndex);
+  const int  iFileName = ( m_ReverseOrder ? numberOfFiles - i - 1 : i );
 
-        const ptrdiff_t   sliceOffset = ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage ) ?
-          ( i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage)) : 0;
+  // configure reader
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName( m_FileNames[iFileName].c_str() );
 
-        const ptrdiff_t  numberOfPixelComponentsUpToSlice =  numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
-        const bool       bufferDelete = false;
+  TOutputImage * readerOutput = reader->GetOutput();
 
-        typename  TOutputImage::InternalPixelType * outputSliceBuffer = outputBuffer + numberOfPixelComponentsUpToSlice;
+  if ( imageIO )
+    {
+    reader->SetImageIO(imageIO);
+    }
+  reader->SetUseStreaming(m_UseStreaming);
+  readerOutput->SetRequestedRegion(str.SliceRegionToRequest);
 
-        if ( strcmp(output->GetNameOfClass(), "VectorImage") == 0 )
-          {
-          // if the input image type is a vector image then the number
-          // of components needs to be set for the size
-          readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
-                                                               numberOfPixelsInSlice*numberOfInternalComponentsPerPixel,
-                                                               bufferDelete );
-          }
-        else
-          {
-          // otherwise the actual number of pixels needs to be passed
-          readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
-                                                               numberOfPixelsInSlice,
-                                                               bufferDelete );
-          }
-        readerOutput->UpdateOutputData();
-        }
-      else
-        {
-        // the read region isn't going to match exactly what we need
-        // to update to buffer created by the reader, then copy
+  // update the data or info
+  if ( !insideRequestedRegion )
+    {
+    reader->UpdateOutputInformation();
+    }
+  else
+    {
+    // read the meta data information
+    readerOutput->UpdateOutputInformation();
 
-        reader->Update();
+    // propagate the requested region to determin what the region
+    // will actually be read
+    readerOutput->PropagateRequestedRegion();
 
-        // output of buffer copy
-        ImageRegionType outRegion = requestedRegion;
-        outRegion.SetIndex( sliceStartIndex );
+    // check that the size of each slice is the same
+    if ( readerOutput->GetLargestPossibleRegion().GetSize() != str.ValidSize )
+      {
+      itkExceptionMacro( << "Size mismatch! The size of  "
+                         << m_FileNames[iFileName].c_str()
+                         << " is "
+                         << readerOutput->GetLargestPossibleRegion().GetSize()
+                         << " and does not match the required size "
+                         << str.ValidSize
+                         << " from file "
+                         << m_FileNames[m_ReverseOrder ? m_FileNames.size() - 1 : 0].c_str() );
+      }
 
-        // set the moving dimension to a size of 1
-        if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
-          {
-          outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
-          }
+    // get the size of the region to be read
+    SizeType readSize = readerOutput->GetRequestedRegion().GetSize();
 
-        ImageAlgorithm::Copy( readerOutput, output, sliceRegionToRequest, outRegion );
+    if( readSize == str.SliceRegionToRequest.GetSize() )
+      {
+      // if the buffer of the ImageReader is going to match that of
+      // ourselves, then set the ImageReader's buffer to a section
+      // of ours
 
-        }
+      const size_t  numberOfPixelsInSlice = str.SliceRegionToRequest.GetNumberOfPixels();
 
-      // report progress for read slices
-      progress.CompletedPixel();
+      typedef typename TOutputImage::AccessorFunctorType AccessorFunctorType;
+      const size_t      numberOfInternalComponentsPerPixel =  AccessorFunctorType::GetVectorLength( output );
 
-     } // end !insidedRequestedRegion
 
-    // Deep copy the MetaDataDictionary into the array
-    if ( reader->GetImageIO() &&  needToUpdateMetaDataDictionaryArray )
-      {
-      DictionaryRawPointer newDictionary = new DictionaryType;
-      *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
-      m_MetaDataDictionaryArray.push_back(newDictionary);
+      const ptrdiff_t   sliceOffset = ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage ) ?
+        ( i - requestedRegion.GetIndex(this->m_NumberOfDimensionsInImage)) : 0;
+
+      const ptrdiff_t  numberOfPixelComponentsUpToSlice =  numberOfPixelsInSlice * numberOfInternalComponentsPerPixel * sliceOffset;
+      const bool       bufferDelete = false;
+
+      typename  TOutputImage::InternalPixelType * outputSliceBuffer = output->GetBufferPointer() + numberOfPixelComponentsUpToSlice;
+
+      if ( strcmp(output->GetNameOfClass(), "VectorImage") == 0 )
+        {
+        // if the input image type is a vector image then the number
+        // of components needs to be set for the size
+        readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
+                                                             numberOfPixelsInSlice*numberOfInternalComponentsPerPixel,
+                                                             bufferDelete );
+        }
+      else
+        {
+        // otherwise the actual number of pixels needs to be passed
+        readerOutput->GetPixelContainer()->SetImportPointer( outputSliceBuffer,
+                                                             numberOfPixelsInSlice,
+                                                             bufferDelete );
+        }
+      readerOutput->UpdateOutputData();
       }
+    else
+      {
+      // the read region isn't going to match exactly what we need
+      // to update to buffer created by the reader, then copy
+
+      reader->Update();
+
+      // output of buffer copy
+      ImageRegionType outRegion = requestedRegion;
+      outRegion.SetIndex( sliceStartIndex );
 
-    } // end per slice loop
+      // set the moving dimension to a size of 1
+      if ( TOutputImage::ImageDimension != this->m_NumberOfDimensionsInImage )
+        {
+        outRegion.SetSize(this->m_NumberOfDimensionsInImage, 1);
+        }
+
+      ImageAlgorithm::Copy( readerOutput, output, str.SliceRegionToRequest, outRegion );
 
-  // update the time if we modified the meta array
-  if ( needToUpdateMetaDataDictionaryArray )
+      }
+    } // end !insidedRequestedRegion
+
+  // Deep copy the MetaDataDictionary into the array
+  if ( reader->GetImageIO() &&  str.UpdateMetaDataDictionaryArray )
     {
-    m_MetaDataDictionaryArrayMTime.Modified();
+    DictionaryRawPointer newDictionary = new DictionaryType;
+    *newDictionary = reader->GetImageIO()->GetMetaDataDictionary();
+    str.Dictionaries[i] = newDictionary;
     }
 }
 
@@ -0,0 +1,100 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMemoryMappedFile_h
+#define __itkMemoryMappedFile_h
+
+#include "itkLightObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFile
+ * \brief Maps a range of bytes of a file into memory.
+ *
+ * Map() maps length bytes of a file, starting at any offset, and
+ * GetPointer() then returns the address of the first of them. The pages
+ * are loaded from the file when they are first accessed, so that mapping
+ * even a very large file is immediate.
+ *
+ * The file is opened read-only, and is never modified through the
+ * mapping: the mapping is private, and a page that is written to is first
+ * copied, so that the change is only visible in this process. The mapping
+ * is removed by Unmap() or when the object is destroyed.
+ *
+ * \sa MemoryMappedImageContainer ImageFileReader::SetUseMemoryMapping
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITK_EXPORT MemoryMappedFile:public LightObject
+{
+public:
+  /** Standard class typedefs. */
+  typedef MemoryMappedFile           Self;
+  typedef LightObject                Superclass;
+  typedef SmartPointer< Self >       Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedFile, LightObject);
+
+  /** Type of the position of the first mapped byte in the file. */
+  typedef ::itk::intmax_t OffsetType;
+
+  /** Map length bytes of the file, starting offset bytes after its
+   * beginning, replacing any previous mapping. Returns false, and leaves
+   * nothing mapped, if the file cannot be opened or mapped, or holds less
+   * than offset + length bytes. */
+  bool Map(const std::string & fileName, OffsetType offset, size_t length);
+
+  /** Remove the mapping, if any. */
+  void Unmap();
+
+  /** Address of the first mapped byte, or NULL if nothing is mapped. */
+  void * GetPointer() const
+  {
+    return m_Pointer;
+  }
+
+  /** Number of mapped bytes. */
+  size_t GetLength() const
+  {
+    return m_Length;
+  }
+
+protected:
+  MemoryMappedFile();
+  ~MemoryMappedFile();
+
+private:
+  MemoryMappedFile(const Self &); //purposely not implemented
+  void operator=(const Self &);   //purposely not implemented
+
+  // The system maps whole pages: the mapping starts m_PageOffset bytes
+  // before m_Pointer.
+  void * m_Pointer;
+  size_t m_Length;
+  size_t m_PageOffset;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,93 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMemoryMappedImageContainer_h
+#define __itkMemoryMappedImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFile.h"
+
+namespace itk
+{
+/** \class MemoryMappedImageContainer
+ * \brief An image container whose elements are mapped from a file.
+ *
+ * The container holds a reference to a MemoryMappedFile, and uses the
+ * mapped bytes as its elements without copying them. The mapping is
+ * removed when the container is destroyed, or when its memory is
+ * replaced, e.g. by Reserve() with a larger size.
+ *
+ * Since the mapping is copied on write, the elements may be modified,
+ * e.g. by an in-place filter, without modifying the file.
+ *
+ * \sa ImageFileReader::SetUseMemoryMapping
+ * \ingroup ImageObjects
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+template< typename TElementIdentifier, typename TElement >
+class MemoryMappedImageContainer:
+  public ImportImageContainer< TElementIdentifier, TElement >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MemoryMappedImageContainer                           Self;
+  typedef ImportImageContainer< TElementIdentifier, TElement > Superclass;
+  typedef SmartPointer< Self >                                 Pointer;
+  typedef SmartPointer< const Self >                           ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Standard part of every itk Object. */
+  itkTypeMacro(MemoryMappedImageContainer, ImportImageContainer);
+
+  /** Use the bytes mapped by file as the elements of the container. */
+  void SetMappedFile(MemoryMappedFile *file)
+  {
+    // Setting the import pointer releases the previous mapping.
+    this->SetImportPointer(static_cast< TElement * >( file->GetPointer() ),
+                           static_cast< TElementIdentifier >( file->GetLength() / sizeof( TElement ) ),
+                           false);
+    m_MappedFile = file;
+  }
+
+  /** Get the file mapped by the container, if any. */
+  const MemoryMappedFile * GetMappedFile() const
+  {
+    return m_MappedFile.GetPointer();
+  }
+
+protected:
+  MemoryMappedImageContainer() {}
+  ~MemoryMappedImageContainer() {}
+
+  virtual void DeallocateManagedMemory()
+  {
+    Superclass::DeallocateManagedMemory();
+    m_MappedFile = 0;
+  }
+
+private:
+  MemoryMappedImageContainer(const Self &); //purposely not implemented
+  void operator=(const Self &);             //purposely not implemented
+
+  MemoryMappedFile::Pointer m_MappedFile;
+};
+} // end namespace itk
+
+#endif
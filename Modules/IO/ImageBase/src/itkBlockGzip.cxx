@@ -0,0 +1,576 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBlockGzip.h"
+#include "itkMultiThreader.h"
+#include "itk_zlib.h"
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+namespace itk
+{
+namespace
+{
+// The members written by Compress() start with the gzip magic number,
+// the deflate method, the FEXTRA flag, no time stamp, an unknown OS, and
+// a 6 bytes extra field holding the "BC" subfield.
+const unsigned int  GzipHeaderSize = 10;
+const unsigned int  BlockHeaderSize = 18;
+const unsigned int  TrailerSize = 8;
+const SizeValueType MaximumMemberSize = 65536;
+const unsigned int  FlagHeaderCRC = 2;
+const unsigned int  FlagExtra = 4;
+const unsigned int  FlagName = 8;
+const unsigned int  FlagComment = 16;
+
+// Number of blocks given to each thread at a time.
+const SizeValueType BlocksPerThread = 8;
+
+void
+PutUInt16(unsigned char *p, SizeValueType value)
+{
+  p[0] = static_cast< unsigned char >( value & 0xff );
+  p[1] = static_cast< unsigned char >( ( value >> 8 ) & 0xff );
+}
+
+void
+PutUInt32(unsigned char *p, SizeValueType value)
+{
+  PutUInt16(p, value & 0xffff);
+  PutUInt16(p + 2, ( value >> 16 ) & 0xffff);
+}
+
+SizeValueType
+GetUInt16(const unsigned char *p)
+{
+  return static_cast< SizeValueType >( p[0] ) | ( static_cast< SizeValueType >( p[1] ) << 8 );
+}
+
+SizeValueType
+GetUInt32(const unsigned char *p)
+{
+  return GetUInt16(p) | ( GetUInt16(p + 2) << 16 );
+}
+
+unsigned long
+ComputeCRC(const unsigned char *data, SizeValueType length)
+{
+  return crc32( crc32( 0L, Z_NULL, 0 ), data, static_cast< uInt >( length ) );
+}
+
+/** Deflate length bytes of data into a complete gzip member. */
+void
+CompressBlock(const unsigned char *data, SizeValueType length, int level,
+              std::vector< unsigned char > & member)
+{
+  z_stream stream;
+  memset( &stream, 0, sizeof( stream ) );
+  if ( deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK )
+    {
+    itkGenericExceptionMacro(<< "Cannot initialize zlib deflate");
+    }
+
+  const SizeValueType bound = deflateBound( &stream, static_cast< uLong >( length ) );
+  member.resize(BlockHeaderSize + bound + TrailerSize);
+
+  stream.next_in = const_cast< Bytef * >( data );
+  stream.avail_in = static_cast< uInt >( length );
+  stream.next_out = &member[BlockHeaderSize];
+  stream.avail_out = static_cast< uInt >( bound );
+  const int result = deflate(&stream, Z_FINISH);
+  const SizeValueType compressedLength = stream.total_out;
+  deflateEnd(&stream);
+
+  const SizeValueType memberSize = BlockHeaderSize + compressedLength + TrailerSize;
+  if ( result != Z_STREAM_END || memberSize > MaximumMemberSize )
+    {
+    itkGenericExceptionMacro(<< "zlib deflate failed");
+    }
+
+  unsigned char *header = &member[0];
+  header[0] = 0x1f;
+  header[1] = 0x8b;
+  header[2] = Z_DEFLATED;
+  header[3] = FlagExtra;
+  PutUInt32(header + 4, 0);
+  header[8] = 0;
+  header[9] = 0xff;
+  PutUInt16(header + 10, 6);
+  header[12] = 'B';
+  header[13] = 'C';
+  PutUInt16(header + 14, 2);
+  PutUInt16(header + 16, memberSize - 1);
+
+  unsigned char *trailer = &member[BlockHeaderSize + compressedLength];
+  PutUInt32( trailer, ComputeCRC(data, length) );
+  PutUInt32(trailer + 4, length & 0xffffffff);
+  member.resize(memberSize);
+}
+
+struct CompressThreadStruct {
+  const unsigned char *                         Data;
+  SizeValueType                                 Length;
+  SizeValueType                                 NumberOfBlocks;
+  int                                           Level;
+  std::vector< std::vector< unsigned char > > * Members;
+};
+
+ITK_THREAD_RETURN_TYPE
+CompressThreaderCallback(void *arg)
+{
+  const MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const CompressThreadStruct *           str = static_cast< CompressThreadStruct * >( info->UserData );
+  const SizeValueType                    blockSize = BlockGzip::BlockSize;
+
+  for ( SizeValueType b = info->ThreadID; b < str->NumberOfBlocks; b += info->NumberOfThreads )
+    {
+    const SizeValueType start = b * blockSize;
+    CompressBlock( str->Data + start, std::min(blockSize, str->Length - start), str->Level,
+                   ( *str->Members )[b] );
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/** A member whose compressed size is known, read in memory. */
+struct PendingMember {
+  SizeValueType DataOffset;       // of the deflated data in the batch buffer
+  SizeValueType CompressedLength;
+  SizeValueType Position;         // in the decompressed stream
+  SizeValueType Size;
+  SizeValueType CRC;
+};
+
+/** The requested runs of the decompressed stream, each RunLength bytes
+ * long, stored one after the other in Data. */
+struct DecompressThreadStruct {
+  const unsigned char *                Buffer;
+  const std::vector< PendingMember > * Members;
+  unsigned char *                      Data;
+  const SizeValueType *                RunOffsets;
+  SizeValueType                        NumberOfRuns;
+  SizeValueType                        RunLength;
+};
+
+/** Index of the first run ending after position. */
+SizeValueType
+FirstRunEndingAfter(const DecompressThreadStruct & str, SizeValueType position)
+{
+  SizeValueType low = 0;
+  SizeValueType high = str.NumberOfRuns;
+  while ( low < high )
+    {
+    const SizeValueType middle = ( low + high ) / 2;
+    if ( str.RunOffsets[middle] + str.RunLength <= position )
+      {
+      low = middle + 1;
+      }
+    else
+      {
+      high = middle;
+      }
+    }
+  return low;
+}
+
+/** Whether [first, last) of the decompressed stream overlaps a run. */
+bool
+OverlapsRuns(const DecompressThreadStruct & str, SizeValueType first, SizeValueType last)
+{
+  const SizeValueType r = FirstRunEndingAfter(str, first);
+  return first < last && r < str.NumberOfRuns && str.RunOffsets[r] < last;
+}
+
+/** Copy the bytes at [position, position + count) of the decompressed
+ * stream to the runs they overlap. */
+void
+CopyToRuns(const DecompressThreadStruct & str, SizeValueType position,
+           const unsigned char *bytes, SizeValueType count)
+{
+  const SizeValueType end = position + count;
+  for ( SizeValueType r = FirstRunEndingAfter(str, position);
+        r < str.NumberOfRuns && str.RunOffsets[r] < end; ++r )
+    {
+    const SizeValueType first = std::max(position, str.RunOffsets[r]);
+    const SizeValueType last = std::min(end, str.RunOffsets[r] + str.RunLength);
+    memcpy(str.Data + r * str.RunLength + ( first - str.RunOffsets[r] ), bytes + ( first - position ),
+           last - first);
+    }
+}
+
+/** Inflate the parts of a member within the runs into Data. */
+void
+DecompressMember(const PendingMember & member, const DecompressThreadStruct & str)
+{
+  if ( !OverlapsRuns(str, member.Position, member.Position + member.Size) )
+    {
+    return;
+    }
+
+  // Inflate in place when the member lies within a run.
+  std::vector< unsigned char > partial;
+  unsigned char *              output;
+  const SizeValueType          r = FirstRunEndingAfter(str, member.Position);
+  if ( str.RunOffsets[r] <= member.Position
+       && member.Position + member.Size <= str.RunOffsets[r] + str.RunLength )
+    {
+    output = str.Data + r * str.RunLength + ( member.Position - str.RunOffsets[r] );
+    }
+  else
+    {
+    partial.resize(member.Size);
+    output = &partial[0];
+    }
+
+  z_stream stream;
+  memset( &stream, 0, sizeof( stream ) );
+  if ( inflateInit2(&stream, -MAX_WBITS) != Z_OK )
+    {
+    itkGenericExceptionMacro(<< "Cannot initialize zlib inflate");
+    }
+  stream.next_in = const_cast< Bytef * >( str.Buffer + member.DataOffset );
+  stream.avail_in = static_cast< uInt >( member.CompressedLength );
+  stream.next_out = output;
+  stream.avail_out = static_cast< uInt >( member.Size );
+  const int result = inflate(&stream, Z_FINISH);
+  inflateEnd(&stream);
+
+  if ( result != Z_STREAM_END || stream.avail_out != 0
+       || ComputeCRC(output, member.Size) != member.CRC )
+    {
+    itkGenericExceptionMacro(<< "Corrupted gzip member at position " << member.Position);
+    }
+
+  if ( !partial.empty() )
+    {
+    CopyToRuns(str, member.Position, output, member.Size);
+    }
+}
+
+ITK_THREAD_RETURN_TYPE
+DecompressThreaderCallback(void *arg)
+{
+  const MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const DecompressThreadStruct *         str = static_cast< DecompressThreadStruct * >( info->UserData );
+
+  for ( SizeValueType m = info->ThreadID; m < str->Members->size(); m += info->NumberOfThreads )
+    {
+    DecompressMember( ( *str->Members )[m], *str );
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/** Inflate the members read so far, then forget them. */
+void
+DecompressPendingMembers(MultiThreader *threader, ThreadIdType numberOfThreads,
+                         std::vector< unsigned char > & buffer, std::vector< PendingMember > & members,
+                         DecompressThreadStruct & str)
+{
+  if ( members.empty() )
+    {
+    return;
+    }
+  str.Buffer = &buffer[0];
+  str.Members = &members;
+  threader->SetNumberOfThreads( std::min( numberOfThreads,
+                                          static_cast< ThreadIdType >( members.size() ) ) );
+  threader->SetSingleMethod(DecompressThreaderCallback, &str);
+  threader->SingleMethodExecute();
+  buffer.clear();
+  members.clear();
+}
+
+/** Skip a zero terminated string of a gzip header. */
+SizeValueType
+SkipString(std::istream & is)
+{
+  SizeValueType length = 0;
+  char          c;
+  while ( is.get(c) )
+    {
+    ++length;
+    if ( c == 0 )
+      {
+      break;
+      }
+    }
+  return length;
+}
+
+/** Inflate a member of unknown compressed size, whose header was read,
+ * with the calling thread. Returns its decompressed size. */
+SizeValueType
+DecompressStreamedMember(std::istream & is, SizeValueType position, DecompressThreadStruct & str)
+{
+  const SizeValueType        chunkSize = 65536;
+  std::vector< unsigned char > input(chunkSize);
+  std::vector< unsigned char > output(chunkSize);
+
+  z_stream stream;
+  memset( &stream, 0, sizeof( stream ) );
+  if ( inflateInit2(&stream, -MAX_WBITS) != Z_OK )
+    {
+    itkGenericExceptionMacro(<< "Cannot initialize zlib inflate");
+    }
+
+  SizeValueType size = 0;
+  unsigned long crc = crc32( 0L, Z_NULL, 0 );
+  int           result = Z_OK;
+  while ( result != Z_STREAM_END )
+    {
+    if ( stream.avail_in == 0 )
+      {
+      is.read( reinterpret_cast< char * >( &input[0] ), chunkSize );
+      stream.next_in = &input[0];
+      stream.avail_in = static_cast< uInt >( is.gcount() );
+      if ( stream.avail_in == 0 )
+        {
+        break;
+        }
+      }
+    stream.next_out = &output[0];
+    stream.avail_out = static_cast< uInt >( chunkSize );
+    result = inflate(&stream, Z_NO_FLUSH);
+    if ( result != Z_OK && result != Z_STREAM_END )
+      {
+      break;
+      }
+
+    const SizeValueType produced = chunkSize - stream.avail_out;
+    crc = crc32( crc, &output[0], static_cast< uInt >( produced ) );
+    CopyToRuns(str, position + size, &output[0], produced);
+    size += produced;
+    }
+  const SizeValueType unused = stream.avail_in;
+  inflateEnd(&stream);
+
+  if ( result != Z_STREAM_END )
+    {
+    itkGenericExceptionMacro(<< "Corrupted gzip member at position " << position);
+    }
+
+  // Give back what was read past the end of the deflated data.
+  is.clear();
+  is.seekg(-static_cast< std::streamoff >( unused ), std::ios::cur);
+
+  unsigned char trailer[TrailerSize];
+  is.read(reinterpret_cast< char * >( trailer ), TrailerSize);
+  if ( is.gcount() != TrailerSize || GetUInt32(trailer) != crc
+       || GetUInt32(trailer + 4) != ( size & 0xffffffff ) )
+    {
+    itkGenericExceptionMacro(<< "Corrupted gzip member at position " << position);
+    }
+  return size;
+}
+} // end anonymous namespace
+
+void
+BlockGzip
+::Compress(std::ostream & os, const void *data, SizeValueType length,
+           int level, ThreadIdType numberOfThreads)
+{
+  const SizeValueType blockSize = BlockSize;
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads(numberOfThreads);
+  const SizeValueType blocksPerBatch = BlocksPerThread * threader->GetNumberOfThreads();
+
+  std::vector< std::vector< unsigned char > > members(blocksPerBatch);
+
+  CompressThreadStruct str;
+  str.Level = level;
+  str.Members = &members;
+
+  const unsigned char *bytes = static_cast< const unsigned char * >( data );
+  for ( SizeValueType start = 0; start < length; start += blocksPerBatch * blockSize )
+    {
+    str.Data = bytes + start;
+    str.Length = std::min(length - start, blocksPerBatch * blockSize);
+    str.NumberOfBlocks = ( str.Length + blockSize - 1 ) / blockSize;
+
+    threader->SetNumberOfThreads( std::min( numberOfThreads,
+                                            static_cast< ThreadIdType >( str.NumberOfBlocks ) ) );
+    threader->SetSingleMethod(CompressThreaderCallback, &str);
+    threader->SingleMethodExecute();
+
+    for ( SizeValueType b = 0; b < str.NumberOfBlocks; ++b )
+      {
+      os.write( reinterpret_cast< const char * >( &members[b][0] ), members[b].size() );
+      }
+    if ( !os )
+      {
+      itkGenericExceptionMacro(<< "Cannot write the compressed data");
+      }
+    }
+
+  // An empty member marks the end of the data, as in the BGZF format.
+  CompressBlock(bytes, 0, level, members[0]);
+  os.write( reinterpret_cast< const char * >( &members[0][0] ), members[0].size() );
+  if ( !os )
+    {
+    itkGenericExceptionMacro(<< "Cannot write the compressed data");
+    }
+}
+
+void
+BlockGzip
+::Decompress(std::istream & is, void *data, SizeValueType offset,
+             SizeValueType length, ThreadIdType numberOfThreads)
+{
+  const std::vector< SizeValueType > runOffsets(1, offset);
+  Decompress(is, data, runOffsets, length, numberOfThreads);
+}
+
+void
+BlockGzip
+::Decompress(std::istream & is, void *data, const std::vector< SizeValueType > & runOffsets,
+             SizeValueType runLength, ThreadIdType numberOfThreads)
+{
+  if ( runOffsets.empty() )
+    {
+    return;
+    }
+  for ( size_t r = 1; r < runOffsets.size(); ++r )
+    {
+    if ( runOffsets[r] < runOffsets[r - 1] + runLength )
+      {
+      itkGenericExceptionMacro(<< "The runs to decompress must be sorted and must not overlap");
+      }
+    }
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads(numberOfThreads);
+  const SizeValueType membersPerBatch = BlocksPerThread * threader->GetNumberOfThreads();
+
+  DecompressThreadStruct str;
+  str.Data = static_cast< unsigned char * >( data );
+  str.RunOffsets = &runOffsets[0];
+  str.NumberOfRuns = runOffsets.size();
+  str.RunLength = runLength;
+  const SizeValueType end = runOffsets.back() + runLength;
+
+  std::vector< unsigned char > buffer;
+  std::vector< PendingMember > members;
+
+  SizeValueType position = 0;
+  while ( position < end )
+    {
+    unsigned char header[GzipHeaderSize];
+    is.read(reinterpret_cast< char * >( header ), GzipHeaderSize);
+    if ( is.gcount() == 0 )
+      {
+      break;
+      }
+    if ( is.gcount() != GzipHeaderSize || header[0] != 0x1f || header[1] != 0x8b
+         || header[2] != Z_DEFLATED )
+      {
+      itkGenericExceptionMacro(<< "Not a gzip stream");
+      }
+
+    const unsigned int flags = header[3];
+    SizeValueType      headerSize = GzipHeaderSize;
+    SizeValueType      memberSize = 0;
+    if ( flags & FlagExtra )
+      {
+      unsigned char extraLength[2];
+      is.read(reinterpret_cast< char * >( extraLength ), 2);
+      std::vector< unsigned char > extra( GetUInt16(extraLength) + 4 );
+      is.read( reinterpret_cast< char * >( &extra[0] ), GetUInt16(extraLength) );
+      headerSize += 2 + GetUInt16(extraLength);
+      for ( SizeValueType i = 0; i + 4 <= GetUInt16(extraLength); i += 4 + GetUInt16(&extra[i + 2]) )
+        {
+        if ( extra[i] == 'B' && extra[i + 1] == 'C' && GetUInt16(&extra[i + 2]) == 2 )
+          {
+          memberSize = GetUInt16(&extra[i + 4]) + 1;
+          }
+        }
+      }
+    if ( flags & FlagName )
+      {
+      headerSize += SkipString(is);
+      }
+    if ( flags & FlagComment )
+      {
+      headerSize += SkipString(is);
+      }
+    if ( flags & FlagHeaderCRC )
+      {
+      is.ignore(2);
+      headerSize += 2;
+      }
+    if ( !is )
+      {
+      itkGenericExceptionMacro(<< "Truncated gzip header at position " << position);
+      }
+
+    if ( memberSize == 0 )
+      {
+      DecompressPendingMembers(threader, numberOfThreads, buffer, members, str);
+      position += DecompressStreamedMember(is, position, str);
+      continue;
+      }
+
+    if ( memberSize < headerSize + TrailerSize )
+      {
+      itkGenericExceptionMacro(<< "Corrupted gzip member at position " << position);
+      }
+    PendingMember member;
+    member.CompressedLength = memberSize - headerSize - TrailerSize;
+
+    // The trailer gives the decompressed size, so that members before the
+    // requested data are skipped without being read.
+    unsigned char trailer[TrailerSize];
+    is.seekg(static_cast< std::streamoff >( member.CompressedLength ), std::ios::cur);
+    is.read(reinterpret_cast< char * >( trailer ), TrailerSize);
+    if ( is.gcount() != TrailerSize )
+      {
+      itkGenericExceptionMacro(<< "Truncated gzip member at position " << position);
+      }
+    member.CRC = GetUInt32(trailer);
+    member.Size = GetUInt32(trailer + 4);
+    member.Position = position;
+    position += member.Size;
+    if ( !OverlapsRuns(str, member.Position, position) )
+      {
+      continue;
+      }
+
+    is.seekg(-static_cast< std::streamoff >( member.CompressedLength + TrailerSize ), std::ios::cur);
+    member.DataOffset = buffer.size();
+    buffer.resize(buffer.size() + member.CompressedLength);
+    is.read( reinterpret_cast< char * >( &buffer[member.DataOffset] ), member.CompressedLength );
+    is.ignore(TrailerSize);
+    if ( static_cast< SizeValueType >( is.gcount() ) != TrailerSize )
+      {
+      itkGenericExceptionMacro(<< "Truncated gzip member at position " << member.Position);
+      }
+    members.push_back(member);
+    if ( members.size() >= membersPerBatch )
+      {
+      DecompressPendingMembers(threader, numberOfThreads, buffer, members, str);
+      }
+    }
+  DecompressPendingMembers(threader, numberOfThreads, buffer, members, str);
+
+  if ( position < end )
+    {
+    itkGenericExceptionMacro(<< "Unexpected end of gzip stream: " << position
+                             << " bytes decompressed instead of " << end);
+    }
+}
+} // end namespace itk
@@ -17,6 +17,7 @@
  *=========================================================================*/
 
 #include "itkImageIOBase.h"
+#include "itkMultiThreader.h"
 
 namespace itk
 {
@@ -25,7 +26,9 @@ ImageIOBase::ImageIOBase():
   m_ComponentType(UNKNOWNCOMPONENTTYPE),
   m_ByteOrder(OrderNotApplicable),
   m_FileType(TypeNotApplicable),
-  m_NumberOfDimensions(0)
+  m_NumberOfDimensions(0),
+  m_CompressionLevel(6),
+  m_NumberOfThreads( MultiThreader::GetGlobalDefaultNumberOfThreads() )
 {
   Reset(false);
 }
@@ -267,6 +270,34 @@ ImageIOBase
   return m_Strides[3];
 }
 
+void ImageIOBase::SetShrinkFactors(const std::vector< unsigned int > & factors)
+{
+  if ( factors != m_ShrinkFactors )
+    {
+    m_ShrinkFactors = factors;
+    this->Modified();
+    }
+  m_AppliedShrinkFactors.clear();
+}
+
+unsigned int ImageIOBase::GetShrinkFactor(unsigned int i) const
+{
+  if ( i >= m_ShrinkFactors.size() || m_ShrinkFactors[i] < 1 )
+    {
+    return 1;
+    }
+  return m_ShrinkFactors[i];
+}
+
+unsigned int ImageIOBase::GetAppliedShrinkFactor(unsigned int i) const
+{
+  if ( i >= m_AppliedShrinkFactors.size() || m_AppliedShrinkFactors[i] < 1 )
+    {
+    return 1;
+    }
+  return m_AppliedShrinkFactors[i];
+}
+
 void ImageIOBase::SetNumberOfDimensions(unsigned int dim)
 {
   if ( dim != m_NumberOfDimensions )
@@ -990,6 +1021,14 @@ void ImageIOBase::PrintSelf(std::ostream & os, Indent indent) const
     {
     os << indent << "UseCompression: Off" << std::endl;
     }
+  os << indent << "CompressionLevel: " << m_CompressionLevel << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  os << indent << "ShrinkFactors: ( ";
+  for ( unsigned int i = 0; i < m_ShrinkFactors.size(); i++ )
+    {
+    os << m_ShrinkFactors[i] << " ";
+    }
+  os << ")" << std::endl;
   if ( m_UseStreamedReading )
     {
     os << indent << "UseStreamedReading: On" << std::endl;
@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMemoryMappedFile.h"
+
+#if defined( _WIN32 )
+#include "itkWindows.h"
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace itk
+{
+MemoryMappedFile::MemoryMappedFile():
+  m_Pointer(0),
+  m_Length(0),
+  m_PageOffset(0)
+{}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  this->Unmap();
+}
+
+bool
+MemoryMappedFile::Map(const std::string & fileName, OffsetType offset, size_t length)
+{
+  this->Unmap();
+  if ( length == 0 || offset < 0 )
+    {
+    return false;
+    }
+
+#if defined( _WIN32 )
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const OffsetType pageOffset = offset % systemInfo.dwAllocationGranularity;
+  const OffsetType mapOffset = offset - pageOffset;
+
+  HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if ( file == INVALID_HANDLE_VALUE )
+    {
+    return false;
+    }
+  LARGE_INTEGER fileSize;
+  if ( !GetFileSizeEx(file, &fileSize)
+       || fileSize.QuadPart < offset + static_cast< OffsetType >( length ) )
+    {
+    CloseHandle(file);
+    return false;
+    }
+  // A copy-on-write view of a read-only mapping.
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+  CloseHandle(file);
+  if ( mapping == NULL )
+    {
+    return false;
+    }
+  void *view = MapViewOfFile(mapping, FILE_MAP_COPY,
+                             static_cast< DWORD >( static_cast< ::itk::uintmax_t >( mapOffset ) >> 32 ),
+                             static_cast< DWORD >( mapOffset & 0xffffffff ),
+                             static_cast< SIZE_T >( pageOffset + length ) );
+  // The view keeps the mapping alive.
+  CloseHandle(mapping);
+  if ( view == NULL )
+    {
+    return false;
+    }
+#else
+  const OffsetType pageOffset = offset % sysconf(_SC_PAGESIZE);
+  const OffsetType mapOffset = offset - pageOffset;
+
+  const int file = open(fileName.c_str(), O_RDONLY);
+  if ( file == -1 )
+    {
+    return false;
+    }
+  struct stat fileStatus;
+  if ( fstat(file, &fileStatus) != 0
+       || fileStatus.st_size < offset + static_cast< OffsetType >( length ) )
+    {
+    close(file);
+    return false;
+    }
+  // A private mapping is copied on write, even though the file is only
+  // open for reading.
+  void *view = mmap(NULL, pageOffset + length, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                    file, static_cast< off_t >( mapOffset ) );
+  // The mapping keeps a reference to the file.
+  close(file);
+  if ( view == MAP_FAILED )
+    {
+    return false;
+    }
+#endif
+
+  m_PageOffset = static_cast< size_t >( pageOffset );
+  m_Pointer = static_cast< char * >( view ) + m_PageOffset;
+  m_Length = length;
+  return true;
+}
+
+void
+MemoryMappedFile::Unmap()
+{
+  if ( m_Pointer == 0 )
+    {
+    return;
+    }
+  void *view = static_cast< char * >( m_Pointer ) - m_PageOffset;
+#if defined( _WIN32 )
+  UnmapViewOfFile(view);
+#else
+  munmap(view, m_PageOffset + m_Length);
+#endif
+  m_Pointer = 0;
+  m_Length = 0;
+  m_PageOffset = 0;
+}
+} // end namespace itk
@@ -0,0 +1,220 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBlockGzip.h"
+#include "itk_zlib.h"
+#include <sstream>
+#include <vector>
+#include <cstring>
+
+namespace
+{
+/** Decompress all the members of a gzip stream with zlib alone. */
+std::string
+ZlibDecompress(const std::string & compressed)
+{
+  std::string   result;
+  z_stream      stream;
+  unsigned char output[4096];
+
+  memset( &stream, 0, sizeof( stream ) );
+  inflateInit2(&stream, 16 + MAX_WBITS);
+  stream.next_in = reinterpret_cast< Bytef * >( const_cast< char * >( compressed.data() ) );
+  stream.avail_in = static_cast< uInt >( compressed.size() );
+  while ( stream.avail_in > 0 )
+    {
+    stream.next_out = output;
+    stream.avail_out = sizeof( output );
+    const int status = inflate(&stream, Z_NO_FLUSH);
+    result.append( reinterpret_cast< char * >( output ), sizeof( output ) - stream.avail_out );
+    if ( status == Z_STREAM_END )
+      {
+      inflateReset(&stream);
+      }
+    else if ( status != Z_OK )
+      {
+      break;
+      }
+    }
+  inflateEnd(&stream);
+  return result;
+}
+
+/** A single gzip member, as written by gzip. */
+std::string
+ZlibCompress(const char *data, size_t length)
+{
+  std::vector< unsigned char > output(length + 1024);
+  z_stream                     stream;
+
+  memset( &stream, 0, sizeof( stream ) );
+  deflateInit2(&stream, 6, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+  stream.next_in = reinterpret_cast< Bytef * >( const_cast< char * >( data ) );
+  stream.avail_in = static_cast< uInt >( length );
+  stream.next_out = &output[0];
+  stream.avail_out = static_cast< uInt >( output.size() );
+  deflate(&stream, Z_FINISH);
+  deflateEnd(&stream);
+  return std::string( reinterpret_cast< char * >( &output[0] ), stream.total_out );
+}
+
+bool
+CheckDecompress(const char *name, const std::string & compressed, const std::string & expected,
+                itk::SizeValueType offset, itk::SizeValueType length, itk::ThreadIdType numberOfThreads)
+{
+  std::istringstream is(compressed);
+  std::vector< char > output(length + 1);
+
+  itk::BlockGzip::Decompress(is, &output[0], offset, length, numberOfThreads);
+  if ( expected.compare(offset, length, &output[0], length) != 0 )
+    {
+    std::cerr << name << ": wrong data for offset " << offset << ", length " << length
+              << " and " << numberOfThreads << " threads" << std::endl;
+    return false;
+    }
+  std::cout << name << ": offset " << offset << ", length " << length
+            << ", " << numberOfThreads << " threads passed." << std::endl;
+  return true;
+}
+
+bool
+CheckDecompressRuns(const char *name, const std::string & compressed, const std::string & expected,
+                    const std::vector< itk::SizeValueType > & runOffsets, itk::SizeValueType runLength,
+                    itk::ThreadIdType numberOfThreads)
+{
+  std::istringstream is(compressed);
+  std::vector< char > output(runOffsets.size() * runLength + 1);
+
+  itk::BlockGzip::Decompress(is, &output[0], runOffsets, runLength, numberOfThreads);
+  for ( size_t r = 0; r < runOffsets.size(); ++r )
+    {
+    if ( expected.compare(runOffsets[r], runLength, &output[r * runLength], runLength) != 0 )
+      {
+      std::cerr << name << ": wrong data for run " << r << " at offset " << runOffsets[r]
+                << " and " << numberOfThreads << " threads" << std::endl;
+      return false;
+      }
+    }
+  std::cout << name << ": " << runOffsets.size() << " runs of length " << runLength
+            << ", " << numberOfThreads << " threads passed." << std::endl;
+  return true;
+}
+}
+
+int itkBlockGzipTest(int, char *[])
+{
+  // About eight blocks of compressible data.
+  std::string  data(8 * 0xff00 + 1234, 0);
+  unsigned int seed = 5;
+  for ( size_t i = 0; i < data.size(); ++i )
+    {
+    seed = seed * 1103515245 + 12345;
+    data[i] = static_cast< char >( ( seed >> 16 ) % 16 + i % 7 );
+    }
+
+  bool result = true;
+  try
+    {
+    std::ostringstream os;
+    itk::BlockGzip::Compress(os, data.data(), data.size(), 6, 4);
+    const std::string compressed = os.str();
+    std::cout << data.size() << " bytes compressed to " << compressed.size() << std::endl;
+
+    // Any gzip reader decompresses the members.
+    if ( ZlibDecompress(compressed) != data )
+      {
+      std::cerr << "zlib failed to decompress the members" << std::endl;
+      result = false;
+      }
+
+    result &= CheckDecompress("Blocks", compressed, data, 0, data.size(), 1);
+    result &= CheckDecompress("Blocks", compressed, data, 0, data.size(), 4);
+    result &= CheckDecompress("Blocks", compressed, data, 70000, 100000, 3);
+    result &= CheckDecompress("Blocks", compressed, data, data.size() - 10, 10, 2);
+
+    // Runs scattered over the blocks, and within a block.
+    std::vector< itk::SizeValueType > runOffsets;
+    for ( itk::SizeValueType offset = 500; offset + 300 <= data.size(); offset += 37000 )
+      {
+      runOffsets.push_back(offset);
+      }
+    runOffsets.push_back(data.size() - 300);
+    result &= CheckDecompressRuns("Blocks", compressed, data, runOffsets, 300, 3);
+    runOffsets.assign(1, 1000);
+    runOffsets.push_back(1400);
+    result &= CheckDecompressRuns("Blocks", compressed, data, runOffsets, 200, 2);
+    std::vector< itk::SizeValueType > straddling(1, 0xff00 - 100);
+    straddling.push_back(2 * 0xff00 - 150);
+    result &= CheckDecompressRuns("Blocks", compressed, data, straddling, 300, 2);
+
+    // A member of unknown size, e.g. a header written by zlib, followed
+    // by blocks.
+    const size_t      headerSize = 352;
+    const std::string mixed = ZlibCompress( data.data(), headerSize ) + ZlibCompress("", 0);
+    std::ostringstream mixedStream;
+    mixedStream << mixed;
+    itk::BlockGzip::Compress(mixedStream, data.data() + headerSize, data.size() - headerSize, 1, 4);
+    result &= CheckDecompress("Mixed", mixedStream.str(), data, headerSize, data.size() - headerSize, 4);
+    result &= CheckDecompress("Mixed", mixedStream.str(), data, 100, 1000, 4);
+
+    // A single member written by zlib.
+    result &= CheckDecompress("Plain", ZlibCompress( data.data(), data.size() ), data, 1000, 200000, 4);
+    result &= CheckDecompressRuns("Plain", ZlibCompress( data.data(), data.size() ), data, runOffsets, 200, 4);
+
+    // Empty data.
+    std::ostringstream empty;
+    itk::BlockGzip::Compress(empty, data.data(), 0, 9, 4);
+    if ( !ZlibDecompress( empty.str() ).empty() )
+      {
+      std::cerr << "Empty data decompressed to something" << std::endl;
+      result = false;
+      }
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Truncated and corrupted streams.
+  std::ostringstream os;
+  itk::BlockGzip::Compress(os, data.data(), data.size(), 6, 4);
+  std::string corrupted = os.str();
+  corrupted[corrupted.size() / 2] ^= 0x55;
+  const std::string streams[] = { os.str().substr(0, os.str().size() / 2), corrupted, "not gzip data" };
+  for ( unsigned int s = 0; s < 3; ++s )
+    {
+    try
+      {
+      CheckDecompress("Invalid", streams[s], data, 0, data.size(), 4);
+      std::cerr << "Missing exception for invalid stream " << s << std::endl;
+      result = false;
+      }
+    catch ( itk::ExceptionObject & e )
+      {
+      std::cout << "Expected exception: " << e.GetDescription() << std::endl;
+      }
+    }
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
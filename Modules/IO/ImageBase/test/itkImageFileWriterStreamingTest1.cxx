@@ -25,7 +25,7 @@ int itkImageFileWriterStreamingTest1(int argc, char* argv[])
 {
   if( argc < 3 )
     {
-    std::cerr << "Usage: " << argv[0] << " input output [existingFile [ no-streaming 1|0] ]" << std::endl;
+    std::cerr << "Usage: " << argv[0] << " input output [existingFile [ no-streaming 1|0 [ asynchronous 1|0 ] ] ]" << std::endl;
     return EXIT_FAILURE;
     }
 
@@ -52,6 +52,14 @@ int itkImageFileWriterStreamingTest1(int argc, char* argv[])
     }
 
 
+  bool asynchronousWriting = false;
+  if ( argc > 5 )
+    {
+      if ( atoi( argv[5] ) == 1 )
+          asynchronousWriting = true;
+    }
+
+
   typedef unsigned char            PixelType;
   typedef itk::Image<PixelType,3>   ImageType;
 
@@ -77,6 +85,7 @@ int itkImageFileWriterStreamingTest1(int argc, char* argv[])
   writer->SetFileName( argv[2] );
   writer->SetInput(monitor->GetOutput());
   writer->SetNumberOfStreamDivisions(numberOfDataPieces);
+  writer->SetUseAsynchronousWriting(asynchronousWriting);
 
 
   try
@@ -0,0 +1,245 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageSeriesReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMetaImageIO.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+namespace
+{
+typedef itk::Image< short, 2 >               SliceType;
+typedef itk::Image< short, 3 >               VolumeType;
+typedef itk::ImageSeriesReader< VolumeType > ReaderType;
+
+short
+ExpectedValue(const VolumeType::IndexType & index)
+{
+  return static_cast< short >( 100 * index[2] + 10 * index[1] + index[0] );
+}
+
+bool
+CheckVolume(const char *name, const VolumeType *volume, const VolumeType::RegionType & region)
+{
+  if ( volume->GetBufferedRegion() != region )
+    {
+    std::cerr << name << ": buffered region " << volume->GetBufferedRegion()
+              << " instead of " << region << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIteratorWithIndex< VolumeType > it(volume, region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != ExpectedValue( it.GetIndex() ) )
+      {
+      std::cerr << name << ": wrong value at " << it.GetIndex() << ": " << it.Get()
+                << " instead of " << ExpectedValue( it.GetIndex() ) << std::endl;
+      return false;
+      }
+    }
+  std::cout << name << " passed." << std::endl;
+  return true;
+}
+}
+
+int itkImageSeriesReaderParallelTest(int ac, char *av[])
+{
+  if ( ac < 2 )
+    {
+    std::cerr << "usage: " << av[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  const unsigned int numberOfSlices = 23;
+
+  SliceType::SizeType size;
+  size[0] = 9;
+  size[1] = 7;
+
+  // Write a slice per file, each holding its own slice index.
+  ReaderType::FileNamesContainer fileNames;
+  for ( unsigned int s = 0; s < numberOfSlices; ++s )
+    {
+    SliceType::Pointer slice = SliceType::New();
+    slice->SetRegions(size);
+    slice->Allocate();
+    itk::ImageRegionIteratorWithIndex< SliceType > it( slice, slice->GetBufferedRegion() );
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      VolumeType::IndexType index;
+      index[0] = it.GetIndex()[0];
+      index[1] = it.GetIndex()[1];
+      index[2] = s;
+      it.Set( ExpectedValue(index) );
+      }
+
+    std::ostringstream fileName;
+    fileName << av[1] << "/itkImageSeriesReaderParallelTest" << s << ".mha";
+    fileNames.push_back( fileName.str() );
+
+    typedef itk::ImageFileWriter< SliceType > WriterType;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput(slice);
+    writer->SetFileName( fileNames.back() );
+    writer->Update();
+    }
+
+  bool result = true;
+  try
+    {
+    // Whole volume, read sequentially and by several threads.
+    const itk::ThreadIdType numberOfThreads[] = { 1, 4 };
+    for ( unsigned int t = 0; t < 2; ++t )
+      {
+      ReaderType::Pointer reader = ReaderType::New();
+      reader->SetFileNames(fileNames);
+      reader->SetNumberOfThreads(numberOfThreads[t]);
+      reader->Update();
+      std::cout << "NumberOfThreads: " << numberOfThreads[t] << std::endl;
+      result &= CheckVolume( "Whole volume", reader->GetOutput(),
+                             reader->GetOutput()->GetLargestPossibleRegion() );
+      if ( reader->GetMetaDataDictionaryArray()->size() != numberOfSlices )
+        {
+        std::cerr << "Got " << reader->GetMetaDataDictionaryArray()->size()
+                  << " dictionaries instead of " << numberOfSlices << std::endl;
+        result = false;
+        }
+      }
+
+    // Only the slices of the requested region are read; the dictionary
+    // array was not updated, so the other files are skipped.
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileNames(fileNames);
+    reader->SetNumberOfThreads(4);
+    reader->MetaDataDictionaryArrayUpdateOff();
+    reader->UpdateOutputInformation();
+    VolumeType::RegionType region = reader->GetOutput()->GetLargestPossibleRegion();
+    region.SetIndex(2, 5);
+    region.SetSize(2, 11);
+    reader->GetOutput()->SetRequestedRegion(region);
+    reader->Update();
+    result &= CheckVolume("Requested slices", reader->GetOutput(), region);
+
+    // A user supplied ImageIO reads the files one after another and holds
+    // the information of the last file read.
+    itk::MetaImageIO::Pointer imageIO = itk::MetaImageIO::New();
+    reader = ReaderType::New();
+    reader->SetFileNames(fileNames);
+    reader->SetNumberOfThreads(4);
+    reader->SetImageIO(imageIO);
+    reader->ReverseOrderOn();
+    reader->Update();
+    if ( fileNames.front() != imageIO->GetFileName() )
+      {
+      std::cerr << "The ImageIO read " << imageIO->GetFileName() << " last instead of "
+                << fileNames.front() << std::endl;
+      result = false;
+      }
+
+    // The slices are reversed: flip the volume back before checking it.
+    VolumeType::Pointer flipped = VolumeType::New();
+    flipped->SetRegions( reader->GetOutput()->GetLargestPossibleRegion() );
+    flipped->Allocate();
+    itk::ImageRegionConstIteratorWithIndex< VolumeType > it( reader->GetOutput(),
+                                                             reader->GetOutput()->GetLargestPossibleRegion() );
+    for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+      {
+      VolumeType::IndexType index = it.GetIndex();
+      index[2] = numberOfSlices - 1 - index[2];
+      flipped->SetPixel( index, it.Get() );
+      }
+    result &= CheckVolume( "ImageIO", flipped, flipped->GetLargestPossibleRegion() );
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A missing file is reported by the thread that reads it, and its
+  // exception is rethrown with its details.
+  fileNames[fileNames.size() / 2] = std::string(av[1]) + "/itkImageSeriesReaderParallelTestMissing.mha";
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileNames(fileNames);
+  reader->SetNumberOfThreads(4);
+  bool caught = false;
+  try
+    {
+    reader->Update();
+    }
+  catch ( itk::ImageFileReaderException & e )
+    {
+    std::cout << "Expected exception: " << e.GetDescription() << std::endl;
+    caught = std::string( e.GetDescription() ).find("itkImageSeriesReaderParallelTestMissing.mha")
+      != std::string::npos;
+    }
+  if ( !caught )
+    {
+    std::cerr << "Missing exception for the missing file" << std::endl;
+    result = false;
+    }
+
+  // A file of another size makes ReadSlice() throw: the threads rethrow
+  // the exception the sequential reader throws.
+  SliceType::SizeType otherSize;
+  otherSize[0] = 5;
+  otherSize[1] = 7;
+  SliceType::Pointer otherSlice = SliceType::New();
+  otherSlice->SetRegions(otherSize);
+  otherSlice->Allocate();
+  otherSlice->FillBuffer(0);
+  fileNames[fileNames.size() / 2] = std::string(av[1]) + "/itkImageSeriesReaderParallelTestOtherSize.mha";
+  typedef itk::ImageFileWriter< SliceType > WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput(otherSlice);
+  writer->SetFileName( fileNames[fileNames.size() / 2] );
+  writer->Update();
+
+  const itk::ThreadIdType numberOfThreads[] = { 1, 4 };
+  std::string             description[2];
+  std::string             exceptionType[2];
+  reader = ReaderType::New();
+  reader->SetFileNames(fileNames);
+  for ( unsigned int t = 0; t < 2; ++t )
+    {
+    reader->SetNumberOfThreads(numberOfThreads[t]);
+    try
+      {
+      reader->Update();
+      }
+    catch ( itk::ExceptionObject & e )
+      {
+      description[t] = e.what();
+      exceptionType[t] = e.GetNameOfClass();
+      }
+    }
+  std::cout << "Expected exception: " << description[1] << std::endl;
+  if ( description[0].empty() || description[0] != description[1] || exceptionType[0] != exceptionType[1] )
+    {
+    std::cerr << "The threads threw " << exceptionType[1] << ": " << description[1]
+              << " instead of " << exceptionType[0] << ": " << description[0] << std::endl;
+    result = false;
+    }
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -82,6 +82,21 @@ public:
   FILE *m_FilePointer;
 };
 
+// libjpeg decodes an image at 1/2, 1/4 or 1/8 of its size by scaling the
+// IDCT, which is much cheaper than decoding it at full size. The largest
+// of these which divides the shrink factors of both axes is used.
+static unsigned int JPEGScaleDenominator(const ImageIOBase *io)
+{
+  unsigned int denominator = 8;
+
+  while ( denominator > 1
+          && ( io->GetShrinkFactor(0) % denominator != 0 || io->GetShrinkFactor(1) % denominator != 0 ) )
+    {
+    denominator /= 2;
+    }
+  return denominator;
+}
+
 bool JPEGImageIO::CanReadFile(const char *file)
 {
   // First check the extension
@@ -232,6 +247,10 @@ void JPEGImageIO::Read(void *buffer)
   // read the header
   jpeg_read_header(&cinfo, TRUE);
 
+  // decode at the scale found by ReadImageInformation()
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = this->GetAppliedShrinkFactor(0);
+
   // prepare to read the bulk data
   jpeg_start_decompress(&cinfo);
 
@@ -346,6 +365,11 @@ void JPEGImageIO::ReadImageInformation()
   // read the header
   jpeg_read_header(&cinfo, TRUE);
 
+  // decode a shrunk image at a reduced scale, if possible
+  const unsigned int denominator = JPEGScaleDenominator(this);
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = denominator;
+
   // force the output image size to be calculated (we could have used
   // cinfo.image_height etc. but that would preclude using libjpeg's
   // ability to scale an image on input).
@@ -356,6 +380,15 @@ void JPEGImageIO::ReadImageInformation()
   m_Dimensions[0] = cinfo.output_width;
   m_Dimensions[1] = cinfo.output_height;
 
+  // a pixel of the scaled image is the average of a block of pixels, and
+  // is centered on it
+  m_AppliedShrinkFactors.assign(2, denominator);
+  for ( unsigned int i = 0; i < 2; i++ )
+    {
+    m_Origin[i] = 0.5 * ( denominator - 1.0 ) * m_Spacing[i];
+    m_Spacing[i] *= denominator;
+    }
+
   this->SetNumberOfComponents(cinfo.output_components);
 
   switch ( this->GetNumberOfComponents() )
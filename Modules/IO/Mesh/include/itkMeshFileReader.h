@@ -23,6 +23,7 @@
 #include "itkLineCell.h"
 #include "itkMeshIOBase.h"
 #include "itkMeshSource.h"
+#include "itkMultiThreader.h"
 #include "itkPolygonCell.h"
 #include "itkQuadrilateralCell.h"
 #include "itkQuadraticEdgeCell.h"
@@ -34,6 +35,8 @@
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkMeshConvertPixelTraits.h"
 
+#include <vector>
+
 namespace itk
 {
 /** \class MeshFileReaderException
@@ -85,6 +88,10 @@ public:
  * no accepted suffix, so you will have to
  * manually create the MeshIO instance of the write type.
  *
+ * Points and point/cell data are copied into preallocated containers, and
+ * the cells are built on the threads of the reader before they are handed
+ * to the mesh in order.
+ *
  * \sa MeshIOBase
  *
  * \ingroup IOFilters
@@ -195,6 +202,25 @@ private:
   void operator=(const Self &); // purposely not implemented
 
   std::string m_ExceptionMessage;
+
+  /** Internal structure used for passing the cells to build to the
+   * threads. */
+  template< typename T >
+  struct ReadCellsThreadStruct {
+    const T *                                  Buffer;
+    const std::vector< SizeValueType > *        CellOffsets;
+    const std::vector< OutputCellIdentifier > * CellIdentifiers;
+    std::vector< OutputCellType * > *           Cells;
+  };
+
+  /** Builds the cells of one part of the cell buffer. */
+  template< typename T >
+  static ITK_THREAD_RETURN_TYPE ReadCellsThreaderCallback(void *arg);
+
+  /** Creates the cell(s) stored at the start of buffer, a polyline gives
+   * one line cell per edge. */
+  template< typename T >
+  static void CreateCells(const T *buffer, OutputCellType **cells);
 };
 } // namespace ITK
 
@@ -120,17 +120,19 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
 ::ReadPoints(T *buffer)
 {
   typename TOutputMesh::Pointer output = this->GetOutput();
-  output->GetPoints()->Reserve( m_MeshIO->GetNumberOfPoints() );
-  OutputPointType point;
+  typename OutputMeshType::PointsContainer *points = output->GetPoints();
+  points->Reserve( m_MeshIO->GetNumberOfPoints() );
 
-  for ( OutputPointIdentifier id = 0; id < output->GetNumberOfPoints(); id++ )
+  // Fill the reserved points in place, SetPoint() would look up the
+  // identifier and modify the container once per point.
+  SizeValueType index = NumericTraits< SizeValueType >::Zero;
+  for ( typename OutputMeshType::PointsContainer::Iterator it = points->Begin(); it != points->End(); ++it )
     {
-    for ( OutputPointIdentifier ii = 0; ii < OutputPointDimension; ii++ )
+    OutputPointType & point = it.Value();
+    for ( unsigned int ii = 0; ii < OutputPointDimension; ii++ )
       {
-      point[ii] = static_cast< typename OutputPointType::ValueType >( buffer[id * OutputPointDimension + ii] );
+      point[ii] = static_cast< typename OutputPointType::ValueType >( buffer[index++] );
       }
-
-    output->SetPoint(id, point);
     }
 }
 
@@ -142,199 +144,248 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
 {
   typename TOutputMesh::Pointer output = this->GetOutput();
 
+  // Locate and check every cell of the buffer first, so that the cells can
+  // then be built on several threads with nothing left to report.
+  std::vector< SizeValueType >        cellOffsets;
+  std::vector< OutputCellIdentifier > cellIdentifiers;
+  cellOffsets.reserve( m_MeshIO->GetNumberOfCells() );
+  cellIdentifiers.reserve( m_MeshIO->GetNumberOfCells() );
+
+  const SizeValueType  cellBufferSize = m_MeshIO->GetCellBufferSize();
   SizeValueType        index = NumericTraits< SizeValueType >::Zero;
-  OutputCellIdentifier id = NumericTraits< OutputCellIdentifier >::Zero;
-  while ( index < m_MeshIO->GetCellBufferSize() )
+  OutputCellIdentifier numberOfOutputCells = NumericTraits< OutputCellIdentifier >::Zero;
+  while ( index < cellBufferSize )
     {
-    MeshIOBase::CellGeometryType type = static_cast< MeshIOBase::CellGeometryType >( static_cast< int >( buffer[index++] ) );
+    if ( index + 2 > cellBufferSize )
+      {
+      itkExceptionMacro(<< "Truncated cell buffer");
+      }
+    MeshIOBase::CellGeometryType type = static_cast< MeshIOBase::CellGeometryType >( static_cast< int >( buffer[index] ) );
+    unsigned int                 numberOfPoints = static_cast< unsigned int >( buffer[index + 1] );
+    if ( index + 2 + numberOfPoints > cellBufferSize )
+      {
+      itkExceptionMacro(<< "Truncated cell buffer");
+      }
+
+    const char * cellName = 0;
+    unsigned int cellNumberOfPoints = 0;
     switch ( type )
       {
       case MeshIOBase::VERTEX_CELL:
-        {
-        unsigned int numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputVertexCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Vertex Cell with number of points = " << numberOfPoints);
-          }
-        OutputCellAutoPointer cell;
-        OutputVertexCellType *vertexCell = new OutputVertexCellType;
-        for ( unsigned int jj = 0; jj < OutputVertexCellType::NumberOfPoints; jj++ )
-          {
-          vertexCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(vertexCell);
-        output->SetCell(id++, cell);
+        cellName = "Vertex";
+        cellNumberOfPoints = OutputVertexCellType::NumberOfPoints;
         break;
-        }
       case MeshIOBase::LINE_CELL:
-        {
         // for polylines will be loaded as individual edges.
-        unsigned int numberOfPoints = static_cast< unsigned int >( buffer[index++] );
         if ( numberOfPoints < 2 )
           {
           itkExceptionMacro(<< "Invalid Line Cell with number of points = " << numberOfPoints);
           }
-        OutputPointIdentifier pointIDBuffer = static_cast< OutputPointIdentifier >( buffer[index++] );
-        for ( unsigned int jj = 1; jj < numberOfPoints; ++jj )
-          {
-          OutputCellAutoPointer cell;
-          OutputLineCellType *  lineCell = new OutputLineCellType;
-          lineCell->SetPointId(0, pointIDBuffer);
-          pointIDBuffer = static_cast< OutputPointIdentifier >( buffer[index++] );
-          lineCell->SetPointId(1, pointIDBuffer);
-          cell.TakeOwnership(lineCell);
-          output->SetCell(id++, cell);
-          }
         break;
-        }
       case MeshIOBase::TRIANGLE_CELL:
-        {
-        unsigned int numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputTriangleCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Triangle Cell with number of points = " << numberOfPoints);
-          }
-
-        OutputCellAutoPointer   cell;
-        OutputTriangleCellType *triangleCell = new OutputTriangleCellType;
-        for ( unsigned int jj = 0; jj < OutputTriangleCellType::NumberOfPoints; jj++ )
-          {
-          triangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(triangleCell);
-        output->SetCell(id++, cell);
+        cellName = "Triangle";
+        cellNumberOfPoints = OutputTriangleCellType::NumberOfPoints;
         break;
-        }
       case MeshIOBase::QUADRILATERAL_CELL:
-        {
-        unsigned int numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputQuadrilateralCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Quadrilateral Cell with number of points = " << numberOfPoints);
-          }
-
-        OutputCellAutoPointer        cell;
-        OutputQuadrilateralCellType *quadrilateralCell = new OutputQuadrilateralCellType;
-        for ( unsigned int jj = 0; jj < OutputQuadrilateralCellType::NumberOfPoints; jj++ )
-          {
-          quadrilateralCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(quadrilateralCell);
-        output->SetCell(id++, cell);
+        cellName = "Quadrilateral";
+        cellNumberOfPoints = OutputQuadrilateralCellType::NumberOfPoints;
         break;
-        }
       case MeshIOBase::POLYGON_CELL:
-        {
-        // For polyhedron, if the number of points is 3, then we treat it as
-        // triangle cell
-        OutputCellAutoPointer cell;
-        unsigned int          numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints == OutputTriangleCellType::NumberOfPoints )
-          {
-          OutputTriangleCellType *triangleCell = new OutputTriangleCellType;
-          for ( unsigned int jj = 0; jj < OutputTriangleCellType::NumberOfPoints; jj++ )
-            {
-            triangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-            }
-          cell.TakeOwnership(triangleCell);
-          }
-        else
-          {
-          OutputPolygonCellType *polygonCell = new OutputPolygonCellType;
-          for ( unsigned int jj = 0; jj < numberOfPoints; jj++ )
-            {
-            polygonCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-            }
-          cell.TakeOwnership(polygonCell);
-          }
-
-        output->SetCell(id++, cell);
         break;
-        }
       case MeshIOBase::TETRAHEDRON_CELL:
-        {
-        unsigned int numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputTetrahedronCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Tetrahedron Cell with number of points = " << numberOfPoints);
-          }
-
-        OutputCellAutoPointer      cell;
-        OutputTetrahedronCellType *tetrahedronCell = new OutputTetrahedronCellType;
-        for ( unsigned int jj = 0; jj < OutputTetrahedronCellType::NumberOfPoints; jj++ )
-          {
-          tetrahedronCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(tetrahedronCell);
-        output->SetCell(id++, cell);
+        cellName = "Tetrahedron";
+        cellNumberOfPoints = OutputTetrahedronCellType::NumberOfPoints;
         break;
-        }
       case MeshIOBase::HEXAHEDRON_CELL:
-        {
-        unsigned int numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputHexahedronCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Hexahedron Cell with number of points = " << numberOfPoints);
-          }
-
-        OutputCellAutoPointer     cell;
-        OutputHexahedronCellType *hexahedronCell = new OutputHexahedronCellType;
-        for ( unsigned int jj = 0; jj < OutputHexahedronCellType::NumberOfPoints; jj++ )
-          {
-          hexahedronCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
-
-        cell.TakeOwnership(hexahedronCell);
-        output->SetCell(id++, cell);
+        cellName = "Hexahedron";
+        cellNumberOfPoints = OutputHexahedronCellType::NumberOfPoints;
         break;
-        }
       case MeshIOBase::QUADRATIC_EDGE_CELL:
-        {
-        unsigned int numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputQuadraticEdgeCellType::NumberOfPoints )
-          {
-          itkExceptionMacro(<< "Invalid Quadratic edge Cell with number of points = " << numberOfPoints);
-          }
+        cellName = "Quadratic edge";
+        cellNumberOfPoints = OutputQuadraticEdgeCellType::NumberOfPoints;
+        break;
+      case MeshIOBase::QUADRATIC_TRIANGLE_CELL:
+        cellName = "Quadratic triangle";
+        cellNumberOfPoints = OutputQuadraticTriangleCellType::NumberOfPoints;
+        break;
+      default:
+        itkExceptionMacro(<< "Unknown cell type");
+      }
 
-        OutputCellAutoPointer        cell;
-        OutputQuadraticEdgeCellType *quadraticEdgeCell = new OutputQuadraticEdgeCellType;
-        for ( unsigned int jj = 0; jj < OutputQuadraticEdgeCellType::NumberOfPoints; jj++ )
-          {
-          quadraticEdgeCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
-          }
+    if ( cellName && numberOfPoints != cellNumberOfPoints )
+      {
+      itkExceptionMacro(<< "Invalid " << cellName << " Cell with number of points = " << numberOfPoints);
+      }
 
-        cell.TakeOwnership(quadraticEdgeCell);
-        output->SetCell(id++, cell);
-        break;
+    cellOffsets.push_back(index);
+    cellIdentifiers.push_back(numberOfOutputCells);
+    numberOfOutputCells += ( type == MeshIOBase::LINE_CELL ) ? numberOfPoints - 1 : 1;
+    index += 2 + numberOfPoints;
+    }
+
+  // Build the cells on the threads of the reader
+  std::vector< OutputCellType * > cells(numberOfOutputCells, 0);
+
+  ReadCellsThreadStruct< T > str;
+  str.Buffer = buffer;
+  str.CellOffsets = &cellOffsets;
+  str.CellIdentifiers = &cellIdentifiers;
+  str.Cells = &cells;
+
+  this->GetMultiThreader()->SetNumberOfThreads( this->GetNumberOfThreads() );
+  this->GetMultiThreader()->SetSingleMethod(&Self::template ReadCellsThreaderCallback< T >, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  // and hand them over to the mesh in order
+  for ( OutputCellIdentifier id = 0; id < numberOfOutputCells; id++ )
+    {
+    OutputCellAutoPointer cell;
+    cell.TakeOwnership(cells[id]);
+    output->SetCell(id, cell);
+    }
+}
+
+template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
+template< class T >
+ITK_THREAD_RETURN_TYPE
+MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
+::ReadCellsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  ReadCellsThreadStruct< T > *     str = static_cast< ReadCellsThreadStruct< T > * >( info->UserData );
+
+  const SizeValueType numberOfCells = str->CellOffsets->size();
+  const SizeValueType first = numberOfCells * info->ThreadID / info->NumberOfThreads;
+  const SizeValueType last = numberOfCells * ( info->ThreadID + 1 ) / info->NumberOfThreads;
+
+  for ( SizeValueType ii = first; ii < last; ii++ )
+    {
+    CreateCells( str->Buffer + ( *str->CellOffsets )[ii], &( *str->Cells )[( *str->CellIdentifiers )[ii]] );
+    }
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template< class TOutputMesh, class ConvertPointPixelTraits, class ConvertCellPixelTraits >
+template< class T >
+void
+MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
+::CreateCells(const T *buffer, OutputCellType **cells)
+{
+  MeshIOBase::CellGeometryType type = static_cast< MeshIOBase::CellGeometryType >( static_cast< int >( buffer[0] ) );
+  unsigned int                 numberOfPoints = static_cast< unsigned int >( buffer[1] );
+  const T *                    pointIds = buffer + 2;
+
+  switch ( type )
+    {
+    case MeshIOBase::VERTEX_CELL:
+      {
+      OutputVertexCellType *vertexCell = new OutputVertexCellType;
+      for ( unsigned int jj = 0; jj < OutputVertexCellType::NumberOfPoints; jj++ )
+        {
+        vertexCell->SetPointId( jj, static_cast< OutputPointIdentifier >( pointIds[jj] ) );
         }
-      case MeshIOBase::QUADRATIC_TRIANGLE_CELL:
+      cells[0] = vertexCell;
+      break;
+      }
+    case MeshIOBase::LINE_CELL:
+      {
+      for ( unsigned int jj = 1; jj < numberOfPoints; ++jj )
         {
-        unsigned int numberOfPoints = static_cast< unsigned int >( buffer[index++] );
-        if ( numberOfPoints != OutputQuadraticTriangleCellType::NumberOfPoints )
+        OutputLineCellType *lineCell = new OutputLineCellType;
+        lineCell->SetPointId( 0, static_cast< OutputPointIdentifier >( pointIds[jj - 1] ) );
+        lineCell->SetPointId( 1, static_cast< OutputPointIdentifier >( pointIds[jj] ) );
+        cells[jj - 1] = lineCell;
+        }
+      break;
+      }
+    case MeshIOBase::TRIANGLE_CELL:
+      {
+      OutputTriangleCellType *triangleCell = new OutputTriangleCellType;
+      for ( unsigned int jj = 0; jj < OutputTriangleCellType::NumberOfPoints; jj++ )
+        {
+        triangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( pointIds[jj] ) );
+        }
+      cells[0] = triangleCell;
+      break;
+      }
+    case MeshIOBase::QUADRILATERAL_CELL:
+      {
+      OutputQuadrilateralCellType *quadrilateralCell = new OutputQuadrilateralCellType;
+      for ( unsigned int jj = 0; jj < OutputQuadrilateralCellType::NumberOfPoints; jj++ )
+        {
+        quadrilateralCell->SetPointId( jj, static_cast< OutputPointIdentifier >( pointIds[jj] ) );
+        }
+      cells[0] = quadrilateralCell;
+      break;
+      }
+    case MeshIOBase::POLYGON_CELL:
+      {
+      // For polyhedron, if the number of points is 3, then we treat it as
+      // triangle cell
+      if ( numberOfPoints == OutputTriangleCellType::NumberOfPoints )
+        {
+        OutputTriangleCellType *triangleCell = new OutputTriangleCellType;
+        for ( unsigned int jj = 0; jj < OutputTriangleCellType::NumberOfPoints; jj++ )
           {
-          itkExceptionMacro(<< "Invalid Quadratic triangle Cell with number of points = " << numberOfPoints);
+          triangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( pointIds[jj] ) );
           }
-
-        OutputCellAutoPointer            cell;
-        OutputQuadraticTriangleCellType *quadraticTriangleCell = new OutputQuadraticTriangleCellType;
-        for ( unsigned int jj = 0; jj < OutputQuadraticTriangleCellType::NumberOfPoints; jj++ )
+        cells[0] = triangleCell;
+        }
+      else
+        {
+        OutputPolygonCellType *polygonCell = new OutputPolygonCellType;
+        for ( unsigned int jj = 0; jj < numberOfPoints; jj++ )
           {
-          quadraticTriangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( buffer[index++] ) );
+          polygonCell->SetPointId( jj, static_cast< OutputPointIdentifier >( pointIds[jj] ) );
           }
-
-        cell.TakeOwnership(quadraticTriangleCell);
-        output->SetCell(id++, cell);
-        break;
+        cells[0] = polygonCell;
         }
-      default:
+      break;
+      }
+    case MeshIOBase::TETRAHEDRON_CELL:
+      {
+      OutputTetrahedronCellType *tetrahedronCell = new OutputTetrahedronCellType;
+      for ( unsigned int jj = 0; jj < OutputTetrahedronCellType::NumberOfPoints; jj++ )
         {
-        itkExceptionMacro(<< "Unknown cell type");
+        tetrahedronCell->SetPointId( jj, static_cast< OutputPointIdentifier >( pointIds[jj] ) );
         }
+      cells[0] = tetrahedronCell;
+      break;
       }
+    case MeshIOBase::HEXAHEDRON_CELL:
+      {
+      OutputHexahedronCellType *hexahedronCell = new OutputHexahedronCellType;
+      for ( unsigned int jj = 0; jj < OutputHexahedronCellType::NumberOfPoints; jj++ )
+        {
+        hexahedronCell->SetPointId( jj, static_cast< OutputPointIdentifier >( pointIds[jj] ) );
+        }
+      cells[0] = hexahedronCell;
+      break;
+      }
+    case MeshIOBase::QUADRATIC_EDGE_CELL:
+      {
+      OutputQuadraticEdgeCellType *quadraticEdgeCell = new OutputQuadraticEdgeCellType;
+      for ( unsigned int jj = 0; jj < OutputQuadraticEdgeCellType::NumberOfPoints; jj++ )
+        {
+        quadraticEdgeCell->SetPointId( jj, static_cast< OutputPointIdentifier >( pointIds[jj] ) );
+        }
+      cells[0] = quadraticEdgeCell;
+      break;
+      }
+    case MeshIOBase::QUADRATIC_TRIANGLE_CELL:
+      {
+      OutputQuadraticTriangleCellType *quadraticTriangleCell = new OutputQuadraticTriangleCellType;
+      for ( unsigned int jj = 0; jj < OutputQuadraticTriangleCellType::NumberOfPoints; jj++ )
+        {
+        quadraticTriangleCell->SetPointId( jj, static_cast< OutputPointIdentifier >( pointIds[jj] ) );
+        }
+      cells[0] = quadraticTriangleCell;
+      break;
+      }
+    default:
+      // checked by ReadCells()
+      break;
     }
 }
 
@@ -407,10 +458,14 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
     inputPointDataBuffer = 0;
     }
 
-  for ( OutputPointIdentifier id = 0; id < m_MeshIO->GetNumberOfPointPixels(); id++ )
+  typename OutputMeshType::PointDataContainer::Pointer pointData = OutputMeshType::PointDataContainer::New();
+  pointData->Reserve( m_MeshIO->GetNumberOfPointPixels() );
+  OutputPointIdentifier id = NumericTraits< OutputPointIdentifier >::Zero;
+  for ( typename OutputMeshType::PointDataContainer::Iterator it = pointData->Begin(); it != pointData->End(); ++it )
     {
-    output->SetPointData(id, outputPointDataBuffer[id]);
+    it.Value() = outputPointDataBuffer[id++];
     }
+  output->SetPointData(pointData);
 
   if ( outputPointDataBuffer )
     {
@@ -489,10 +544,14 @@ MeshFileReader< TOutputMesh, ConvertPointPixelTraits, ConvertCellPixelTraits >
     inputCellDataBuffer = 0;
     }
 
-  for ( OutputCellIdentifier id = 0; id < m_MeshIO->GetNumberOfCellPixels(); id++ )
+  typename OutputMeshType::CellDataContainer::Pointer cellData = OutputMeshType::CellDataContainer::New();
+  cellData->Reserve( m_MeshIO->GetNumberOfCellPixels() );
+  OutputCellIdentifier id = NumericTraits< OutputCellIdentifier >::Zero;
+  for ( typename OutputMeshType::CellDataContainer::Iterator it = cellData->Begin(); it != cellData->End(); ++it )
     {
-    output->SetCellData(id, outputCellDataBuffer[id]);
+    it.Value() = outputCellDataBuffer[id++];
     }
+  output->SetCellData(cellData);
 
   if ( outputCellDataBuffer )
     {
@@ -582,7 +582,7 @@ protected:
         itk::ByteSwapper< TInput >::SwapRangeFromSystemToLittleEndian(buffer, numberOfComponents);
         }
 
-      outputFile.write(reinterpret_cast< char * >( buffer ), numberOfComponents);
+      outputFile.write(reinterpret_cast< char * >( buffer ), numberOfComponents * sizeof( TInput ));
       }
     else
       {
@@ -601,7 +601,8 @@ protected:
         itk::ByteSwapper< TOutput >::SwapRangeFromSystemToLittleEndian(data, numberOfComponents);
         }
 
-      outputFile.write(reinterpret_cast< char * >( data ), numberOfComponents);
+      outputFile.write(reinterpret_cast< char * >( data ), numberOfComponents * sizeof( TOutput ));
+      delete[] data;
       }
   }
 
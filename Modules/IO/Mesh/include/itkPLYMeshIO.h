@@ -0,0 +1,381 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef __itkPLYMeshIO_h
+#define __itkPLYMeshIO_h
+
+#include "itkMeshIOBase.h"
+
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace itk
+{
+/** \class PLYMeshIO
+ * \brief This class defines how to read and write the Stanford polygon
+ * file format (PLY).
+ *
+ * ASCII, binary little endian and binary big endian files are read. The
+ * coordinates come from the x, y and z properties of the "vertex" element
+ * and the cells from the "vertex_indices" (or "vertex_index") list of the
+ * "face" element; other elements and properties are skipped. In binary
+ * files the coordinates are read in one block, straight into the points
+ * buffer when the vertices carry nothing but x, y and z.
+ *
+ * Triangles, quadrilaterals and polygons of up to 255 points are written,
+ * in binary with the byte order of the MeshIO (little endian by default).
+ * Point and cell data are neither read nor written.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOMesh
+ */
+
+class ITK_EXPORT PLYMeshIO:public MeshIOBase
+{
+public:
+  /** Standard class typedefs. */
+  typedef PLYMeshIO                    Self;
+  typedef MeshIOBase                   Superclass;
+  typedef SmartPointer< const Self >   ConstPointer;
+  typedef SmartPointer< Self >         Pointer;
+
+  typedef Superclass::SizeValueType    SizeValueType;
+  typedef Superclass::StreamOffsetType StreamOffsetType;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(PLYMeshIO, MeshIOBase);
+
+  /*-------- This part of the interfaces deals with reading data. ----- */
+
+  /** Determine if the file can be read with this MeshIO implementation.
+  * \param FileNameToRead The name of the file to test for reading.
+  * \post Sets classes MeshIOBase::m_FileName variable to be FileNameToWrite
+  * \return Returns true if this MeshIO can read the file specified.
+  */
+  virtual bool CanReadFile(const char *FileNameToRead);
+
+  /** Set the spacing and dimension information for the set filename. */
+  virtual void ReadMeshInformation();
+
+  /** Reads the data from disk into the memory buffer provided. */
+  virtual void ReadPoints(void *buffer);
+
+  virtual void ReadCells(void *buffer);
+
+  virtual void ReadPointData(void *buffer);
+
+  virtual void ReadCellData(void *buffer);
+
+  /*-------- This part of the interfaces deals with writing data. ----- */
+
+  /** Determine if the file can be written with this MeshIO implementation.
+   * \param FileNameToWrite The name of the file to test for writing.
+   * \post Sets classes MeshIOBase::m_FileName variable to be FileNameToWrite
+   * \return Returns true if this MeshIO can write the file specified.
+   */
+  virtual bool CanWriteFile(const char *FileNameToWrite);
+
+  /** Set the spacing and dimension information for the set filename. */
+  virtual void WriteMeshInformation();
+
+  /** Writes the data to disk from the memory buffer provided. Make sure
+   * that the IORegions has been set properly. */
+  virtual void WritePoints(void *buffer);
+
+  virtual void WriteCells(void *buffer);
+
+  virtual void WritePointData(void *buffer);
+
+  virtual void WriteCellData(void *buffer);
+
+  virtual void Write();
+
+protected:
+  /** A property of a PLY element, list properties also have the type of
+   * their count. */
+  struct PLYProperty {
+    std::string     Name;
+    IOComponentType ValueType;
+    IOComponentType CountType;
+    bool            IsList;
+  };
+
+  /** An element of a PLY file and its properties. */
+  struct PLYElement {
+    std::string                Name;
+    SizeValueType              Count;
+    std::vector< PLYProperty > Properties;
+  };
+
+  /** Read a value of a binary file, in the byte order of the file. */
+  template< typename T >
+  T ReadBinaryValue(const char *data) const
+    {
+    T value;
+    memcpy(&value, data, sizeof( T ) );
+    if ( this->m_ByteOrder == BigEndian )
+      {
+      itk::ByteSwapper< T >::SwapFromSystemToBigEndian(&value);
+      }
+    else
+      {
+      itk::ByteSwapper< T >::SwapFromSystemToLittleEndian(&value);
+      }
+    return value;
+    }
+
+  /** Read the coordinates of the binary vertex element. */
+  template< typename T >
+  void ReadPointsBufferAsBinary(std::ifstream & inputFile, T *buffer)
+    {
+    const PLYElement &  element = m_Elements[m_PointElement];
+    const SizeValueType componentSize = sizeof( T );
+    const SizeValueType numberOfComponents = this->m_NumberOfPoints * this->m_PointDimension;
+    const SizeValueType recordSize = this->GetRecordSize(element);
+
+    inputFile.seekg(m_PointsStartPosition, std::ios::beg);
+    if ( recordSize == this->m_PointDimension * componentSize
+         && m_CoordinateProperties[0] == 0 && m_CoordinateProperties[1] == 1 && m_CoordinateProperties[2] == 2 )
+      {
+      // The vertices are nothing but x, y and z, read them in place
+      inputFile.read( reinterpret_cast< char * >( buffer ), numberOfComponents * componentSize );
+      }
+    else
+      {
+      std::vector< char > data(this->m_NumberOfPoints * recordSize);
+      inputFile.read( &data[0], data.size() );
+
+      SizeValueType offsets[3];
+      for ( unsigned int ii = 0; ii < this->m_PointDimension; ii++ )
+        {
+        offsets[ii] = 0;
+        for ( unsigned int jj = 0; jj < m_CoordinateProperties[ii]; jj++ )
+          {
+          offsets[ii] += this->GetComponentSize(element.Properties[jj].ValueType);
+          }
+        }
+
+      const char *record = &data[0];
+      SizeValueType index = 0;
+      for ( SizeValueType id = 0; id < this->m_NumberOfPoints; id++ )
+        {
+        for ( unsigned int ii = 0; ii < this->m_PointDimension; ii++ )
+          {
+          memcpy(buffer + index++, record + offsets[ii], componentSize);
+          }
+        record += recordSize;
+        }
+      }
+
+    if ( inputFile.fail() )
+      {
+      itkExceptionMacro(<< "Failed to read the points from " << this->m_FileName);
+      }
+
+    if ( this->m_ByteOrder == BigEndian )
+      {
+      itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
+      }
+    else
+      {
+      itk::ByteSwapper< T >::SwapRangeFromSystemToLittleEndian(buffer, numberOfComponents);
+      }
+    }
+
+  /** Read the coordinates of the ascii vertex element, one vertex per
+   * line. */
+  template< typename T >
+  void ReadPointsBufferAsAscii(std::ifstream & inputFile, T *buffer)
+    {
+    const PLYElement & element = m_Elements[m_PointElement];
+    std::vector< double > values( element.Properties.size() );
+
+    inputFile.seekg(m_PointsStartPosition, std::ios::beg);
+    SizeValueType index = 0;
+    for ( SizeValueType id = 0; id < this->m_NumberOfPoints; id++ )
+      {
+      for ( unsigned int jj = 0; jj < values.size(); jj++ )
+        {
+        inputFile >> values[jj];
+        }
+      for ( unsigned int ii = 0; ii < this->m_PointDimension; ii++ )
+        {
+        buffer[index++] = static_cast< T >( values[m_CoordinateProperties[ii]] );
+        }
+      }
+
+    if ( inputFile.fail() )
+      {
+      itkExceptionMacro(<< "Failed to read the points from " << this->m_FileName);
+      }
+    }
+
+  /** Read the coordinates of the vertex element. */
+  template< typename T >
+  void ReadPointsBuffer(std::ifstream & inputFile, T *buffer)
+    {
+    if ( this->m_FileType == ASCII )
+      {
+      this->ReadPointsBufferAsAscii(inputFile, buffer);
+      }
+    else
+      {
+      this->ReadPointsBufferAsBinary(inputFile, buffer);
+      }
+    }
+
+  /** Write the point coordinates, TOutput is the type of the binary
+   * coordinates in the file. */
+  template< typename TOutput, typename TInput >
+  void WritePointsBuffer(TInput *buffer, std::ofstream & outputFile)
+    {
+    if ( this->m_FileType == ASCII )
+      {
+      this->WritePointsBufferAsAscii(buffer, outputFile);
+      }
+    else
+      {
+      this->WriteBufferAsBinary< TOutput >(buffer, outputFile, this->m_NumberOfPoints * this->m_PointDimension);
+      }
+    }
+
+  /** Write the point coordinates as ascii, one vertex per line, with enough
+   * digits to read back the same values. */
+  template< typename T >
+  void WritePointsBufferAsAscii(T *buffer, std::ofstream & outputFile)
+    {
+    outputFile.precision(std::numeric_limits< T >::digits10 + 3);
+
+    SizeValueType index = 0;
+    for ( SizeValueType id = 0; id < this->m_NumberOfPoints; id++ )
+      {
+      for ( unsigned int ii = 0; ii < this->m_PointDimension; ii++ )
+        {
+        if ( ii )
+          {
+          outputFile << ' ';
+          }
+        outputFile << static_cast< typename NumericTraits< T >::PrintType >( buffer[index++] );
+        }
+      outputFile << '\n';
+      }
+    }
+
+  /** Write the triangles, quadrilaterals and polygons of the cells buffer as
+   * the faces of the file. */
+  template< typename T >
+  void WriteFaces(T *buffer, std::ofstream & outputFile)
+    {
+    std::vector< char > data;
+    if ( this->m_FileType == BINARY )
+      {
+      data.reserve( ( this->m_CellBufferSize - this->m_NumberOfCells ) * sizeof( itk::int32_t ) );
+      }
+
+    SizeValueType index = 0;
+    for ( SizeValueType id = 0; id < this->m_NumberOfCells; id++ )
+      {
+      MeshIOBase::CellGeometryType cellType = static_cast< MeshIOBase::CellGeometryType >( static_cast< int >( buffer[index++] ) );
+      unsigned int                 numberOfPoints = static_cast< unsigned int >( buffer[index++] );
+      if ( cellType != TRIANGLE_CELL && cellType != QUADRILATERAL_CELL && cellType != POLYGON_CELL )
+        {
+        itkExceptionMacro(<< "PLY files only store triangles, quadrilaterals and polygons");
+        }
+      if ( numberOfPoints > NumericTraits< unsigned char >::max() )
+        {
+        itkExceptionMacro(<< "Polygon with " << numberOfPoints << " points, at most "
+                          << static_cast< int >( NumericTraits< unsigned char >::max() ) << " are supported");
+        }
+
+      if ( this->m_FileType == BINARY )
+        {
+        data.push_back( static_cast< char >( numberOfPoints ) );
+        for ( unsigned int jj = 0; jj < numberOfPoints; jj++ )
+          {
+          itk::int32_t pointId = static_cast< itk::int32_t >( buffer[index++] );
+          if ( this->m_ByteOrder == BigEndian )
+            {
+            itk::ByteSwapper< itk::int32_t >::SwapFromSystemToBigEndian(&pointId);
+            }
+          else
+            {
+            itk::ByteSwapper< itk::int32_t >::SwapFromSystemToLittleEndian(&pointId);
+            }
+          const char *bytes = reinterpret_cast< const char * >( &pointId );
+          data.insert(data.end(), bytes, bytes + sizeof( itk::int32_t ) );
+          }
+        }
+      else
+        {
+        outputFile << numberOfPoints;
+        for ( unsigned int jj = 0; jj < numberOfPoints; jj++ )
+          {
+          outputFile << ' ' << static_cast< SizeValueType >( buffer[index++] );
+          }
+        outputFile << '\n';
+        }
+      }
+
+    if ( !data.empty() )
+      {
+      outputFile.write( &data[0], data.size() );
+      }
+    }
+
+  /** Size of a record of an element without list properties, zero if the
+   * element has list properties. */
+  SizeValueType GetRecordSize(const PLYElement & element) const;
+
+  /** Read an integer of a binary file. */
+  SizeValueType ReadBinaryInteger(const char *data, IOComponentType type) const;
+
+  /** Skip a binary element, counting the cell point identifiers when it is
+   * the face element. */
+  void SkipBinaryElement(std::ifstream & inputFile, unsigned int element);
+
+  /** Skip an ascii element, counting the cell point identifiers when it is
+   * the face element. */
+  void SkipAsciiElement(std::ifstream & inputFile, unsigned int element);
+
+protected:
+  PLYMeshIO();
+  virtual ~PLYMeshIO(){}
+
+  void PrintSelf(std::ostream & os, Indent indent) const;
+
+private:
+  PLYMeshIO(const Self &);      // purposely not implemented
+  void operator=(const Self &); // purposely not implemented
+
+  std::vector< PLYElement > m_Elements;
+  unsigned int              m_PointElement;             // index of the vertex element
+  unsigned int              m_CellElement;              // index of the face element
+  unsigned int              m_CoordinateProperties[3];  // x, y and z properties of the vertices
+  unsigned int              m_CellPointIdsProperty;     // point identifiers property of the faces
+  StreamOffsetType          m_PointsStartPosition;      // file position of the vertex element
+  StreamOffsetType          m_CellsStartPosition;       // file position of the face element
+  StreamOffsetType          m_CellsSize;                // bytes of the binary face element
+};
+} // end namespace itk
+
+#endif
@@ -187,22 +187,13 @@ protected:
   template< typename T >
   void ReadPointsBufferAsBINARY(std::ifstream & inputFile, T *buffer)
   {
-    std::string line;
-
-    while ( !inputFile.eof() )
+    /**  Load the point coordinates into the itk::Mesh in one block */
+    SizeValueType numberOfComponents = this->m_NumberOfPoints * this->m_PointDimension;
+    inputFile.seekg(m_PointsStartPosition, std::ios::beg);
+    inputFile.read( reinterpret_cast< char * >( buffer ), numberOfComponents * sizeof( T ) );
+    if ( itk::ByteSwapper< T >::SystemIsLittleEndian() )
       {
-      std::getline(inputFile, line, '\n');
-
-      if ( line.find("POINTS") != std::string::npos )
-        {
-        /**  Load the point coordinates into the itk::Mesh */
-        SizeValueType numberOfComponents = this->m_NumberOfPoints * this->m_PointDimension;
-        inputFile.read( reinterpret_cast< char * >( buffer ), numberOfComponents * sizeof( T ) );
-        if ( itk::ByteSwapper< T >::SystemIsLittleEndian() )
-          {
-          itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
-          }
-        }
+      itk::ByteSwapper< T >::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
       }
   }
 
@@ -1138,6 +1129,13 @@ protected:
 private:
   VTKPolyDataMeshIO(const Self &); // purposely not implemented
   void operator=(const Self &);    // purposely not implemented
+
+  /** File positions of the binary points, vertices, lines and polygons,
+   * found by ReadMeshInformation(). Zero when the file has none. */
+  StreamOffsetType m_PointsStartPosition;
+  StreamOffsetType m_VerticesStartPosition;
+  StreamOffsetType m_LinesStartPosition;
+  StreamOffsetType m_PolygonsStartPosition;
 };
 } // end namespace itk
 
@@ -23,6 +23,7 @@
 #include "itkMeshIOFactory.h"
 #include "itkOBJMeshIOFactory.h"
 #include "itkOFFMeshIOFactory.h"
+#include "itkPLYMeshIOFactory.h"
 #include "itkMutexLock.h"
 #include "itkMutexLockHolder.h"
 #include "itkVTKPolyDataMeshIOFactory.h"
@@ -96,6 +97,7 @@ MeshIOFactory
       ObjectFactoryBase::RegisterFactory( GiftiMeshIOFactory::New() );
       ObjectFactoryBase::RegisterFactory( OBJMeshIOFactory::New() );
       ObjectFactoryBase::RegisterFactory( OFFMeshIOFactory::New() );
+      ObjectFactoryBase::RegisterFactory( PLYMeshIOFactory::New() );
       ObjectFactoryBase::RegisterFactory( VTKPolyDataMeshIOFactory::New() );
 
       firstTime = false;
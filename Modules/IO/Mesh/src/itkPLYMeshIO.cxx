@@ -0,0 +1,968 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkPLYMeshIO.h"
+
+#include <itksys/SystemTools.hxx>
+#include <sstream>
+
+namespace itk
+{
+namespace
+{
+/** Map the name of a PLY property type to a component type */
+bool
+GetPLYComponentType(const std::string & name, MeshIOBase::IOComponentType & type)
+{
+  if ( name == "char" || name == "int8" )
+    {
+    type = MeshIOBase::CHAR;
+    }
+  else if ( name == "uchar" || name == "uint8" )
+    {
+    type = MeshIOBase::UCHAR;
+    }
+  else if ( name == "short" || name == "int16" )
+    {
+    type = MeshIOBase::SHORT;
+    }
+  else if ( name == "ushort" || name == "uint16" )
+    {
+    type = MeshIOBase::USHORT;
+    }
+  else if ( name == "int" || name == "int32" )
+    {
+    type = MeshIOBase::INT;
+    }
+  else if ( name == "uint" || name == "uint32" )
+    {
+    type = MeshIOBase::UINT;
+    }
+  else if ( name == "float" || name == "float32" )
+    {
+    type = MeshIOBase::FLOAT;
+    }
+  else if ( name == "double" || name == "float64" )
+    {
+    type = MeshIOBase::DOUBLE;
+    }
+  else
+    {
+    return false;
+    }
+  return true;
+}
+
+/** Name of the PLY property type of a component type, 0 if PLY has none */
+const char *
+GetPLYTypeName(MeshIOBase::IOComponentType type)
+{
+  switch ( type )
+    {
+    case MeshIOBase::CHAR:
+      return "char";
+    case MeshIOBase::UCHAR:
+      return "uchar";
+    case MeshIOBase::SHORT:
+      return "short";
+    case MeshIOBase::USHORT:
+      return "ushort";
+    case MeshIOBase::INT:
+      return "int";
+    case MeshIOBase::UINT:
+      return "uint";
+    case MeshIOBase::FLOAT:
+      return "float";
+    case MeshIOBase::DOUBLE:
+      return "double";
+    default:
+      return 0;
+    }
+}
+
+/** Read the next line that is not blank, without the line ending */
+bool
+GetDataLine(std::istream & inputFile, std::string & line)
+{
+  while ( std::getline(inputFile, line, '\n') )
+    {
+    if ( line.find_first_not_of(" \t\r") != std::string::npos )
+      {
+      return true;
+      }
+    }
+  return false;
+}
+}
+
+PLYMeshIO
+::PLYMeshIO()
+{
+  this->AddSupportedWriteExtension(".ply");
+  this->SetByteOrderToLittleEndian();
+  m_PointElement = 0;
+  m_CellElement = 0;
+  m_CoordinateProperties[0] = 0;
+  m_CoordinateProperties[1] = 0;
+  m_CoordinateProperties[2] = 0;
+  m_CellPointIdsProperty = 0;
+  m_PointsStartPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  m_CellsStartPosition = itk::NumericTraits< StreamOffsetType >::Zero;
+  m_CellsSize = itk::NumericTraits< StreamOffsetType >::Zero;
+}
+
+bool
+PLYMeshIO
+::CanReadFile(const char *fileName)
+{
+  if ( !itksys::SystemTools::FileExists(fileName, true) )
+    {
+    return false;
+    }
+
+  if ( itksys::SystemTools::GetFilenameLastExtension(fileName) != ".ply" )
+    {
+    return false;
+    }
+
+  return true;
+}
+
+bool
+PLYMeshIO
+::CanWriteFile(const char *fileName)
+{
+  if ( itksys::SystemTools::GetFilenameLastExtension(fileName) != ".ply" )
+    {
+    return false;
+    }
+
+  return true;
+}
+
+PLYMeshIO::SizeValueType
+PLYMeshIO
+::GetRecordSize(const PLYElement & element) const
+{
+  SizeValueType recordSize = 0;
+
+  for ( unsigned int ii = 0; ii < element.Properties.size(); ii++ )
+    {
+    if ( element.Properties[ii].IsList )
+      {
+      return 0;
+      }
+    recordSize += this->GetComponentSize(element.Properties[ii].ValueType);
+    }
+
+  return recordSize;
+}
+
+PLYMeshIO::SizeValueType
+PLYMeshIO
+::ReadBinaryInteger(const char *data, IOComponentType type) const
+{
+  switch ( type )
+    {
+    case CHAR:
+      return static_cast< SizeValueType >( this->ReadBinaryValue< char >(data) );
+    case UCHAR:
+      return static_cast< SizeValueType >( this->ReadBinaryValue< unsigned char >(data) );
+    case SHORT:
+      return static_cast< SizeValueType >( this->ReadBinaryValue< short >(data) );
+    case USHORT:
+      return static_cast< SizeValueType >( this->ReadBinaryValue< unsigned short >(data) );
+    case INT:
+      return static_cast< SizeValueType >( this->ReadBinaryValue< int >(data) );
+    case UINT:
+      return static_cast< SizeValueType >( this->ReadBinaryValue< unsigned int >(data) );
+    case FLOAT:
+      return static_cast< SizeValueType >( this->ReadBinaryValue< float >(data) );
+    case DOUBLE:
+      return static_cast< SizeValueType >( this->ReadBinaryValue< double >(data) );
+    default:
+      itkExceptionMacro(<< "Unknown component type");
+    }
+}
+
+void
+PLYMeshIO
+::SkipBinaryElement(std::ifstream & inputFile, unsigned int elementIndex)
+{
+  const PLYElement &     element = m_Elements[elementIndex];
+  const SizeValueType    recordSize = this->GetRecordSize(element);
+  const StreamOffsetType startPosition = inputFile.tellg();
+
+  if ( recordSize )
+    {
+    inputFile.seekg(static_cast< StreamOffsetType >( element.Count * recordSize ), std::ios::cur);
+    return;
+    }
+
+  // The records vary in size, walk through them in memory
+  inputFile.seekg(0, std::ios::end);
+  std::vector< char > data( static_cast< SizeValueType >( inputFile.tellg() - startPosition ) );
+  inputFile.seekg(startPosition, std::ios::beg);
+  if ( !data.empty() )
+    {
+    inputFile.read( &data[0], data.size() );
+    }
+
+  SizeValueType position = 0;
+  for ( SizeValueType id = 0; id < element.Count; id++ )
+    {
+    for ( unsigned int ii = 0; ii < element.Properties.size(); ii++ )
+      {
+      const PLYProperty & property = element.Properties[ii];
+      SizeValueType       count = 1;
+      if ( property.IsList )
+        {
+        if ( position + this->GetComponentSize(property.CountType) > data.size() )
+          {
+          itkExceptionMacro(<< "Unexpected end of file in element " << element.Name << " of " << this->m_FileName);
+          }
+        count = this->ReadBinaryInteger(&data[position], property.CountType);
+        position += this->GetComponentSize(property.CountType);
+        if ( elementIndex == m_CellElement && ii == m_CellPointIdsProperty )
+          {
+          this->m_CellBufferSize += 2 + count;
+          }
+        }
+      position += count * this->GetComponentSize(property.ValueType);
+      if ( position > data.size() )
+        {
+        itkExceptionMacro(<< "Unexpected end of file in element " << element.Name << " of " << this->m_FileName);
+        }
+      }
+    }
+
+  inputFile.seekg(startPosition + static_cast< StreamOffsetType >( position ), std::ios::beg);
+}
+
+void
+PLYMeshIO
+::SkipAsciiElement(std::ifstream & inputFile, unsigned int elementIndex)
+{
+  const PLYElement & element = m_Elements[elementIndex];
+  std::string        line;
+
+  for ( SizeValueType id = 0; id < element.Count; id++ )
+    {
+    if ( !GetDataLine(inputFile, line) )
+      {
+      itkExceptionMacro(<< "Unexpected end of file in element " << element.Name << " of " << this->m_FileName);
+      }
+
+    if ( elementIndex == m_CellElement )
+      {
+      std::istringstream ss(line);
+      double             value = 0;
+      for ( unsigned int ii = 0; ii < element.Properties.size(); ii++ )
+        {
+        SizeValueType count = 1;
+        if ( element.Properties[ii].IsList )
+          {
+          ss >> value;
+          count = static_cast< SizeValueType >( value );
+          if ( ii == m_CellPointIdsProperty )
+            {
+            this->m_CellBufferSize += 2 + count;
+            }
+          }
+        for ( SizeValueType jj = 0; jj < count; jj++ )
+          {
+          ss >> value;
+          }
+        }
+      if ( ss.fail() )
+        {
+        itkExceptionMacro(<< "Invalid face " << id << " in " << this->m_FileName);
+        }
+      }
+    }
+}
+
+void
+PLYMeshIO
+::ReadMeshInformation()
+{
+  std::ifstream inputFile;
+
+  // Positions of the elements are used, so the file is always opened as
+  // binary
+  inputFile.open(this->m_FileName.c_str(), std::ios::in | std::ios::binary);
+  if ( !inputFile.is_open() )
+    {
+    itkExceptionMacro(<< "Unable to open file\n" "inputFilename= " << this->m_FileName);
+    }
+
+  std::string line;
+  std::getline(inputFile, line, '\n');
+  if ( line.compare(0, 3, "ply") != 0 )
+    {
+    itkExceptionMacro(<< "Error, the file doesn't begin with keyword \"ply\" ");
+    }
+
+  // Read the header
+  bool formatFound = false;
+  bool headerEnded = false;
+  m_Elements.clear();
+  while ( !headerEnded && std::getline(inputFile, line, '\n') )
+    {
+    std::istringstream ss(line);
+    std::string        keyword;
+    ss >> keyword;
+
+    if ( keyword == "format" )
+      {
+      std::string format;
+      ss >> format;
+      if ( format == "ascii" )
+        {
+        this->m_FileType = ASCII;
+        }
+      else if ( format == "binary_little_endian" )
+        {
+        this->m_FileType = BINARY;
+        this->m_ByteOrder = LittleEndian;
+        }
+      else if ( format == "binary_big_endian" )
+        {
+        this->m_FileType = BINARY;
+        this->m_ByteOrder = BigEndian;
+        }
+      else
+        {
+        itkExceptionMacro(<< "Unknown format " << format << " in " << this->m_FileName);
+        }
+      formatFound = true;
+      }
+    else if ( keyword == "element" )
+      {
+      PLYElement element;
+      ss >> element.Name >> element.Count;
+      if ( ss.fail() )
+        {
+        itkExceptionMacro(<< "Invalid element \"" << line << "\" in " << this->m_FileName);
+        }
+      m_Elements.push_back(element);
+      }
+    else if ( keyword == "property" )
+      {
+      if ( m_Elements.empty() )
+        {
+        itkExceptionMacro(<< "Property outside of an element in " << this->m_FileName);
+        }
+
+      PLYProperty property;
+      property.CountType = UNKNOWNCOMPONENTTYPE;
+      property.IsList = false;
+
+      std::string valueType;
+      ss >> valueType;
+      bool validType = true;
+      if ( valueType == "list" )
+        {
+        std::string countType;
+        ss >> countType >> valueType;
+        property.IsList = true;
+        validType = GetPLYComponentType(countType, property.CountType);
+        }
+      ss >> property.Name;
+      if ( ss.fail() || !validType || !GetPLYComponentType(valueType, property.ValueType) )
+        {
+        itkExceptionMacro(<< "Invalid property \"" << line << "\" in " << this->m_FileName);
+        }
+      m_Elements.back().Properties.push_back(property);
+      }
+    else if ( keyword == "end_header" )
+      {
+      headerEnded = true;
+      }
+    // comment and obj_info lines are ignored
+    }
+
+  if ( !formatFound || !headerEnded )
+    {
+    itkExceptionMacro(<< "Incomplete header in " << this->m_FileName);
+    }
+
+  // Find the vertices and faces
+  const unsigned int numberOfElements = static_cast< unsigned int >( m_Elements.size() );
+  m_PointElement = numberOfElements;
+  m_CellElement = numberOfElements;
+  for ( unsigned int ii = 0; ii < numberOfElements; ii++ )
+    {
+    if ( m_Elements[ii].Name == "vertex" )
+      {
+      m_PointElement = ii;
+      }
+    else if ( m_Elements[ii].Name == "face" )
+      {
+      m_CellElement = ii;
+      }
+    }
+
+  this->m_PointDimension = 3;
+  this->m_NumberOfPoints = itk::NumericTraits< SizeValueType >::Zero;
+  this->m_NumberOfCells = itk::NumericTraits< SizeValueType >::Zero;
+  this->m_CellBufferSize = itk::NumericTraits< SizeValueType >::Zero;
+  this->m_PointComponentType = FLOAT;
+
+  if ( m_PointElement < numberOfElements )
+    {
+    const PLYElement & element = m_Elements[m_PointElement];
+    const char *       coordinateNames[3] = { "x", "y", "z" };
+    for ( unsigned int ii = 0; ii < 3; ii++ )
+      {
+      m_CoordinateProperties[ii] = static_cast< unsigned int >( element.Properties.size() );
+      for ( unsigned int jj = 0; jj < element.Properties.size(); jj++ )
+        {
+        if ( element.Properties[jj].Name == coordinateNames[ii] )
+          {
+          m_CoordinateProperties[ii] = jj;
+          }
+        }
+      if ( m_CoordinateProperties[ii] == element.Properties.size() )
+        {
+        itkExceptionMacro(<< "The vertices have no " << coordinateNames[ii] << " coordinate in " << this->m_FileName);
+        }
+      }
+
+    for ( unsigned int ii = 0; ii < element.Properties.size(); ii++ )
+      {
+      if ( element.Properties[ii].IsList )
+        {
+        itkExceptionMacro(<< "List properties of the vertices are not supported");
+        }
+      }
+
+    this->m_PointComponentType = element.Properties[m_CoordinateProperties[0]].ValueType;
+    if ( element.Properties[m_CoordinateProperties[1]].ValueType != this->m_PointComponentType
+         || element.Properties[m_CoordinateProperties[2]].ValueType != this->m_PointComponentType )
+      {
+      itkExceptionMacro(<< "The x, y and z coordinates must have the same type");
+      }
+
+    this->m_NumberOfPoints = element.Count;
+    }
+
+  if ( m_CellElement < numberOfElements )
+    {
+    const PLYElement & element = m_Elements[m_CellElement];
+    m_CellPointIdsProperty = static_cast< unsigned int >( element.Properties.size() );
+    for ( unsigned int ii = 0; ii < element.Properties.size(); ii++ )
+      {
+      if ( element.Properties[ii].IsList
+           && ( element.Properties[ii].Name == "vertex_indices" || element.Properties[ii].Name == "vertex_index" ) )
+        {
+        m_CellPointIdsProperty = ii;
+        }
+      }
+    if ( m_CellPointIdsProperty == element.Properties.size() )
+      {
+      itkExceptionMacro(<< "The faces have no vertex_indices in " << this->m_FileName);
+      }
+
+    this->m_NumberOfCells = element.Count;
+    }
+
+  // Locate the vertices and faces in the file, the faces are walked through
+  // to size the cells buffer
+  for ( unsigned int ii = 0; ii < numberOfElements; ii++ )
+    {
+    if ( ii > m_PointElement && ( ii > m_CellElement || m_CellElement == numberOfElements ) )
+      {
+      break;
+      }
+    if ( ii == m_PointElement )
+      {
+      m_PointsStartPosition = inputFile.tellg();
+      }
+    else if ( ii == m_CellElement )
+      {
+      m_CellsStartPosition = inputFile.tellg();
+      }
+
+    if ( this->m_FileType == ASCII )
+      {
+      this->SkipAsciiElement(inputFile, ii);
+      }
+    else
+      {
+      this->SkipBinaryElement(inputFile, ii);
+      }
+
+    if ( ii == m_CellElement )
+      {
+      m_CellsSize = inputFile.tellg() - m_CellsStartPosition;
+      }
+    }
+
+  inputFile.close();
+
+  // Set default cell component type
+  this->m_CellComponentType = UINT;
+
+  this->m_UpdatePoints = ( this->m_NumberOfPoints > 0 );
+  this->m_UpdateCells = ( this->m_NumberOfCells > 0 );
+
+  // Set default point pixel component and point pixel type
+  this->m_PointPixelComponentType = FLOAT;
+  this->m_PointPixelType  = SCALAR;
+  this->m_UpdatePointData = false;
+  this->m_NumberOfPointPixelComponents = itk::NumericTraits< unsigned int >::One;
+
+  // Set default cell pixel component and point pixel type
+  this->m_CellPixelComponentType = FLOAT;
+  this->m_CellPixelType  = SCALAR;
+  this->m_UpdateCellData = false;
+  this->m_NumberOfCellPixelComponents = itk::NumericTraits< unsigned int >::One;
+}
+
+void
+PLYMeshIO
+::ReadPoints(void *buffer)
+{
+  std::ifstream inputFile;
+
+  inputFile.open(this->m_FileName.c_str(), std::ios::in | std::ios::binary);
+  if ( !inputFile.is_open() )
+    {
+    itkExceptionMacro(<< "Unable to open file\n" "inputFilename= " << this->m_FileName);
+    }
+
+  switch ( this->m_PointComponentType )
+    {
+    case CHAR:
+      {
+      this->ReadPointsBuffer( inputFile, static_cast< char * >( buffer ) );
+      break;
+      }
+    case UCHAR:
+      {
+      this->ReadPointsBuffer( inputFile, static_cast< unsigned char * >( buffer ) );
+      break;
+      }
+    case SHORT:
+      {
+      this->ReadPointsBuffer( inputFile, static_cast< short * >( buffer ) );
+      break;
+      }
+    case USHORT:
+      {
+      this->ReadPointsBuffer( inputFile, static_cast< unsigned short * >( buffer ) );
+      break;
+      }
+    case INT:
+      {
+      this->ReadPointsBuffer( inputFile, static_cast< int * >( buffer ) );
+      break;
+      }
+    case UINT:
+      {
+      this->ReadPointsBuffer( inputFile, static_cast< unsigned int * >( buffer ) );
+      break;
+      }
+    case FLOAT:
+      {
+      this->ReadPointsBuffer( inputFile, static_cast< float * >( buffer ) );
+      break;
+      }
+    case DOUBLE:
+      {
+      this->ReadPointsBuffer( inputFile, static_cast< double * >( buffer ) );
+      break;
+      }
+    default:
+      {
+      itkExceptionMacro(<< "Unknown point component type");
+      }
+    }
+
+  inputFile.close();
+}
+
+void
+PLYMeshIO
+::ReadCells(void *buffer)
+{
+  if ( !this->m_CellBufferSize )
+    {
+    return;
+    }
+
+  std::ifstream inputFile;
+
+  inputFile.open(this->m_FileName.c_str(), std::ios::in | std::ios::binary);
+  if ( !inputFile.is_open() )
+    {
+    itkExceptionMacro(<< "Unable to open file\n" "inputFilename= " << this->m_FileName);
+    }
+  inputFile.seekg(m_CellsStartPosition, std::ios::beg);
+
+  const PLYElement & element = m_Elements[m_CellElement];
+  unsigned int *     data = static_cast< unsigned int * >( buffer );
+  SizeValueType      index = 0;
+
+  if ( this->m_FileType == ASCII )
+    {
+    std::string line;
+    for ( SizeValueType id = 0; id < element.Count; id++ )
+      {
+      GetDataLine(inputFile, line);
+      std::istringstream ss(line);
+      double             value = 0;
+      for ( unsigned int ii = 0; ii < element.Properties.size(); ii++ )
+        {
+        SizeValueType count = 1;
+        if ( element.Properties[ii].IsList )
+          {
+          ss >> value;
+          count = static_cast< SizeValueType >( value );
+          if ( ii == m_CellPointIdsProperty )
+            {
+            data[index++] = POLYGON_CELL;
+            data[index++] = static_cast< unsigned int >( count );
+            for ( SizeValueType jj = 0; jj < count; jj++ )
+              {
+              ss >> value;
+              data[index++] = static_cast< unsigned int >( value );
+              }
+            continue;
+            }
+          }
+        for ( SizeValueType jj = 0; jj < count; jj++ )
+          {
+          ss >> value;
+          }
+        }
+      }
+    }
+  else
+    {
+    // Read the faces in one block and convert them in memory
+    std::vector< char > faces( static_cast< SizeValueType >( m_CellsSize ) );
+    inputFile.read( &faces[0], faces.size() );
+    if ( inputFile.fail() )
+      {
+      itkExceptionMacro(<< "Failed to read the cells from " << this->m_FileName);
+      }
+
+    const PLYProperty & pointIds = element.Properties[m_CellPointIdsProperty];
+    const SizeValueType countSize = this->GetComponentSize(pointIds.CountType);
+    const SizeValueType pointIdSize = this->GetComponentSize(pointIds.ValueType);
+
+    const char *position = &faces[0];
+    for ( SizeValueType id = 0; id < element.Count; id++ )
+      {
+      for ( unsigned int ii = 0; ii < element.Properties.size(); ii++ )
+        {
+        const PLYProperty & property = element.Properties[ii];
+        if ( ii == m_CellPointIdsProperty )
+          {
+          SizeValueType count = this->ReadBinaryInteger(position, pointIds.CountType);
+          position += countSize;
+          data[index++] = POLYGON_CELL;
+          data[index++] = static_cast< unsigned int >( count );
+          for ( SizeValueType jj = 0; jj < count; jj++ )
+            {
+            data[index++] = static_cast< unsigned int >( this->ReadBinaryInteger(position, pointIds.ValueType) );
+            position += pointIdSize;
+            }
+          }
+        else if ( property.IsList )
+          {
+          SizeValueType count = this->ReadBinaryInteger(position, property.CountType);
+          position += this->GetComponentSize(property.CountType) + count * this->GetComponentSize(property.ValueType);
+          }
+        else
+          {
+          position += this->GetComponentSize(property.ValueType);
+          }
+        }
+      }
+    }
+
+  inputFile.close();
+}
+
+void
+PLYMeshIO
+::ReadPointData(void * itkNotUsed( buffer) )
+{
+  return;
+}
+
+void
+PLYMeshIO
+::ReadCellData(void * itkNotUsed( buffer) )
+{
+  return;
+}
+
+void
+PLYMeshIO
+::WriteMeshInformation()
+{
+  // Check file name
+  if ( this->m_FileName == "" )
+    {
+    itkExceptionMacro("No Input FileName");
+    }
+
+  if ( this->m_PointDimension != 3 )
+    {
+    itkExceptionMacro(<< "PLY files only store 3D points");
+    }
+
+  // The header ends its lines with '\n' only, whatever the file type
+  std::ofstream outputFile(this->m_FileName.c_str(), std::ios::out | std::ios::binary);
+  if ( !outputFile.is_open() )
+    {
+    itkExceptionMacro("Unable to open file\n"
+                      "outputFilename= " << this->m_FileName);
+    }
+
+  outputFile << "ply\n";
+  if ( this->m_FileType == ASCII )
+    {
+    outputFile << "format ascii 1.0\n";
+    }
+  else if ( this->m_ByteOrder == BigEndian )
+    {
+    outputFile << "format binary_big_endian 1.0\n";
+    }
+  else
+    {
+    outputFile << "format binary_little_endian 1.0\n";
+    }
+
+  // Coordinates without a PLY type are written as double
+  const char *pointType = GetPLYTypeName(this->m_PointComponentType);
+  if ( !pointType )
+    {
+    pointType = "double";
+    }
+
+  outputFile << "element vertex " << this->m_NumberOfPoints << "\n";
+  outputFile << "property " << pointType << " x\n";
+  outputFile << "property " << pointType << " y\n";
+  outputFile << "property " << pointType << " z\n";
+  if ( this->m_NumberOfCells )
+    {
+    outputFile << "element face " << this->m_NumberOfCells << "\n";
+    outputFile << "property list uchar int vertex_indices\n";
+    }
+  outputFile << "end_header\n";
+
+  outputFile.close();
+}
+
+void
+PLYMeshIO
+::WritePoints(void *buffer)
+{
+  std::ofstream outputFile(this->m_FileName.c_str(), std::ios::app | std::ios::binary);
+  if ( !outputFile.is_open() )
+    {
+    itkExceptionMacro("Unable to open file\n"
+                      "outputFilename= " << this->m_FileName);
+    }
+
+  switch ( this->m_PointComponentType )
+    {
+    case UCHAR:
+      {
+      this->WritePointsBuffer< unsigned char >(static_cast< unsigned char * >( buffer ), outputFile);
+      break;
+      }
+    case CHAR:
+      {
+      this->WritePointsBuffer< char >(static_cast< char * >( buffer ), outputFile);
+      break;
+      }
+    case USHORT:
+      {
+      this->WritePointsBuffer< unsigned short >(static_cast< unsigned short * >( buffer ), outputFile);
+      break;
+      }
+    case SHORT:
+      {
+      this->WritePointsBuffer< short >(static_cast< short * >( buffer ), outputFile);
+      break;
+      }
+    case UINT:
+      {
+      this->WritePointsBuffer< unsigned int >(static_cast< unsigned int * >( buffer ), outputFile);
+      break;
+      }
+    case INT:
+      {
+      this->WritePointsBuffer< int >(static_cast< int * >( buffer ), outputFile);
+      break;
+      }
+    case ULONG:
+      {
+      this->WritePointsBuffer< double >(static_cast< unsigned long * >( buffer ), outputFile);
+      break;
+      }
+    case LONG:
+      {
+      this->WritePointsBuffer< double >(static_cast< long * >( buffer ), outputFile);
+      break;
+      }
+    case ULONGLONG:
+      {
+      this->WritePointsBuffer< double >(static_cast< unsigned long long * >( buffer ), outputFile);
+      break;
+      }
+    case LONGLONG:
+      {
+      this->WritePointsBuffer< double >(static_cast< long long * >( buffer ), outputFile);
+      break;
+      }
+    case FLOAT:
+      {
+      this->WritePointsBuffer< float >(static_cast< float * >( buffer ), outputFile);
+      break;
+      }
+    case DOUBLE:
+      {
+      this->WritePointsBuffer< double >(static_cast< double * >( buffer ), outputFile);
+      break;
+      }
+    case LDOUBLE:
+      {
+      this->WritePointsBuffer< double >(static_cast< long double * >( buffer ), outputFile);
+      break;
+      }
+    default:
+      {
+      itkExceptionMacro(<< "Unknown point component type" << std::endl);
+      }
+    }
+
+  outputFile.close();
+}
+
+void
+PLYMeshIO
+::WriteCells(void *buffer)
+{
+  std::ofstream outputFile(this->m_FileName.c_str(), std::ios::app | std::ios::binary);
+  if ( !outputFile.is_open() )
+    {
+    itkExceptionMacro("Unable to open file\n"
+                      "outputFilename= " << this->m_FileName);
+    }
+
+  switch ( this->m_CellComponentType )
+    {
+    case UCHAR:
+      {
+      this->WriteFaces(static_cast< unsigned char * >( buffer ), outputFile);
+      break;
+      }
+    case CHAR:
+      {
+      this->WriteFaces(static_cast< char * >( buffer ), outputFile);
+      break;
+      }
+    case USHORT:
+      {
+      this->WriteFaces(static_cast< unsigned short * >( buffer ), outputFile);
+      break;
+      }
+    case SHORT:
+      {
+      this->WriteFaces(static_cast< short * >( buffer ), outputFile);
+      break;
+      }
+    case UINT:
+      {
+      this->WriteFaces(static_cast< unsigned int * >( buffer ), outputFile);
+      break;
+      }
+    case INT:
+      {
+      this->WriteFaces(static_cast< int * >( buffer ), outputFile);
+      break;
+      }
+    case ULONG:
+      {
+      this->WriteFaces(static_cast< unsigned long * >( buffer ), outputFile);
+      break;
+      }
+    case LONG:
+      {
+      this->WriteFaces(static_cast< long * >( buffer ), outputFile);
+      break;
+      }
+    case ULONGLONG:
+      {
+      this->WriteFaces(static_cast< unsigned long long * >( buffer ), outputFile);
+      break;
+      }
+    case LONGLONG:
+      {
+      this->WriteFaces(static_cast< long long * >( buffer ), outputFile);
+      break;
+      }
+    default:
+      {
+      itkExceptionMacro(<< "Unknown cell component type" << std::endl);
+      }
+    }
+
+  outputFile.close();
+}
+
+void
+PLYMeshIO
+::WritePointData(void * itkNotUsed( buffer) )
+{
+  return;
+}
+
+void
+PLYMeshIO
+::WriteCellData(void * itkNotUsed( buffer) )
+{
+  return;
+}
+
+void
+PLYMeshIO
+::Write()
+{
+  return;
+}
+
+void
+PLYMeshIO
+::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  for ( unsigned int ii = 0; ii < m_Elements.size(); ii++ )
+    {
+    os << indent << "Element " << m_Elements[ii].Name << ": " << m_Elements[ii].Count << std::endl;
+    }
+}
+} // namespace itk end
@@ -29,6 +29,10 @@ VTKPolyDataMeshIO
 {
   this->AddSupportedWriteExtension(".vtk");
   this->m_ByteOrder = BigEndian;
+  this->m_PointsStartPosition = 0;
+  this->m_VerticesStartPosition = 0;
+  this->m_LinesStartPosition = 0;
+  this->m_PolygonsStartPosition = 0;
 
   MetaDataDictionary & metaDic = this->GetMetaDataDictionary();
   EncapsulateMetaData< StringType >(metaDic, "pointScalarDataName", "PointScalarData");
@@ -147,6 +151,10 @@ VTKPolyDataMeshIO
   // Initialize number of cells
   this->m_NumberOfCells  = itk::NumericTraits<SizeValueType>::Zero;
   this->m_CellBufferSize = itk::NumericTraits<SizeValueType>::Zero;
+  this->m_PointsStartPosition = 0;
+  this->m_VerticesStartPosition = 0;
+  this->m_LinesStartPosition = 0;
+  this->m_PolygonsStartPosition = 0;
   MetaDataDictionary & metaDic = this->GetMetaDataDictionary();
 
   // Searching the vtk file
@@ -234,6 +242,16 @@ VTKPolyDataMeshIO
         }
 
       this->m_UpdatePoints = true;
+
+      // Remember where the binary points are and skip them instead of
+      // scanning them for keywords
+      if ( this->m_FileType == BINARY )
+        {
+        this->m_PointsStartPosition = inputFile.tellg();
+        inputFile.seekg(static_cast< StreamOffsetType >( this->m_NumberOfPoints * this->m_PointDimension
+                                                         * this->GetComponentSize(this->m_PointComponentType) ),
+                        std::ios::cur);
+        }
       }
     else if ( line.find("VERTICES") != std::string::npos )
       {
@@ -273,6 +291,12 @@ VTKPolyDataMeshIO
       // Set cell component type
       this->m_CellComponentType = UINT;
       this->m_UpdateCells = true;
+
+      if ( this->m_FileType == BINARY )
+        {
+        this->m_VerticesStartPosition = inputFile.tellg();
+        inputFile.seekg(static_cast< StreamOffsetType >( numberOfVertexIndices ) * sizeof( unsigned int ), std::ios::cur);
+        }
       }
     else if ( line.find("LINES") != std::string::npos )
       {
@@ -312,6 +336,12 @@ VTKPolyDataMeshIO
       // Set cell component type
       this->m_CellComponentType = UINT;
       this->m_UpdateCells = true;
+
+      if ( this->m_FileType == BINARY )
+        {
+        this->m_LinesStartPosition = inputFile.tellg();
+        inputFile.seekg(static_cast< StreamOffsetType >( numberOfLineIndices ) * sizeof( unsigned int ), std::ios::cur);
+        }
       }
     else if ( line.find("POLYGONS") != std::string::npos )
       {
@@ -351,6 +381,12 @@ VTKPolyDataMeshIO
       // Set cell component type
       this->m_CellComponentType = UINT;
       this->m_UpdateCells = true;
+
+      if ( this->m_FileType == BINARY )
+        {
+        this->m_PolygonsStartPosition = inputFile.tellg();
+        inputFile.seekg(static_cast< StreamOffsetType >( numberOfPolygonIndices ) * sizeof( unsigned int ), std::ios::cur);
+        }
       }
     else if ( line.find("POINT_DATA") != std::string::npos )
       {
@@ -1272,77 +1308,46 @@ VTKPolyDataMeshIO
     return;
     }
 
-  unsigned int *inputBuffer = new unsigned int[this->m_CellBufferSize - this->m_NumberOfCells];
-  void *        pv = inputBuffer;
-  char *        startBuffer = static_cast< char * >( pv );
   unsigned int *outputBuffer = static_cast< unsigned int * >( buffer );
 
-  std::string          line;
   MetaDataDictionary & metaDic = this->GetMetaDataDictionary();
 
-  while ( !inputFile.eof() )
+  const StreamOffsetType startPositions[3] =
+    { this->m_VerticesStartPosition, this->m_LinesStartPosition, this->m_PolygonsStartPosition };
+  const char *numberOfCellsKeys[3] = { "numberOfVertices", "numberOfLines", "numberOfPolygons" };
+  const char *numberOfIndicesKeys[3] = { "numberOfVertexIndices", "numberOfLineIndices", "numberOfPolygonIndices" };
+  const CellGeometryType cellTypes[3] = { MeshIOBase::VERTEX_CELL, MeshIOBase::LINE_CELL, MeshIOBase::POLYGON_CELL };
+
+  for ( unsigned int ii = 0; ii < 3; ii++ )
     {
-    std::getline(inputFile, line, '\n');
-    if ( line.find("VERTICES") != std::string::npos )
+    if ( !startPositions[ii] )
       {
-      unsigned int numberOfVertices = 0;
-      unsigned int numberOfVertexIndices = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfVertices", numberOfVertices);
-      ExposeMetaData< unsigned int >(metaDic, "numberOfVertexIndices", numberOfVertexIndices);
-      inputFile.read( startBuffer, numberOfVertexIndices * sizeof( unsigned int ) );
-
-      pv = startBuffer;
-      unsigned int *data = static_cast< unsigned int * >( pv );
-      if ( itk::ByteSwapper< unsigned int >::SystemIsLittleEndian() )
-        {
-        itk::ByteSwapper< unsigned int >::SwapRangeFromSystemToBigEndian(data, numberOfVertexIndices);
-        }
-      this->WriteCellsBuffer(data, outputBuffer, MeshIOBase::VERTEX_CELL, numberOfVertices);
-      startBuffer += numberOfVertexIndices * sizeof( unsigned int );
-      outputBuffer += ( numberOfVertexIndices + numberOfVertices ) * sizeof( unsigned int );
+      continue;
       }
-    else if ( line.find("LINES") != std::string::npos )
-      {
-      unsigned int numberOfLines = 0;
-      unsigned int numberOfLineIndices = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfLines", numberOfLines);
-      ExposeMetaData< unsigned int >(metaDic, "numberOfLineIndices", numberOfLineIndices);
-      inputFile.read( startBuffer, numberOfLineIndices * sizeof( unsigned int ) );
 
-      pv = startBuffer;
-      unsigned int *data = static_cast< unsigned int * >( pv );
-      if ( itk::ByteSwapper< unsigned int >::SystemIsLittleEndian() )
-        {
-        itk::ByteSwapper< unsigned int >::SwapRangeFromSystemToBigEndian(data, numberOfLineIndices);
-        }
-      this->WriteCellsBuffer(data, outputBuffer, MeshIOBase::LINE_CELL, numberOfLines);
-      startBuffer += numberOfLineIndices * sizeof( unsigned int );
-      outputBuffer += ( numberOfLineIndices + numberOfLines ) * sizeof( unsigned int );
-      }
-    else if ( line.find("POLYGONS") != std::string::npos )
+    unsigned int numberOfCells = 0;
+    unsigned int numberOfIndices = 0;
+    ExposeMetaData< unsigned int >(metaDic, numberOfCellsKeys[ii], numberOfCells);
+    ExposeMetaData< unsigned int >(metaDic, numberOfIndicesKeys[ii], numberOfIndices);
+
+    // Read the indices straight into the end of this part of the output
+    // buffer. Adding the cell type in front of each cell then moves the
+    // indices forward in place without overwriting any that are still to be
+    // read.
+    unsigned int *data = outputBuffer + numberOfCells;
+    inputFile.seekg(startPositions[ii], std::ios::beg);
+    inputFile.read( reinterpret_cast< char * >( data ), static_cast< std::streamsize >( numberOfIndices ) * sizeof( unsigned int ) );
+    if ( inputFile.fail() )
       {
-      unsigned int numberOfPolygons = 0;
-      unsigned int numberOfPolygonIndices = 0;
-      ExposeMetaData< unsigned int >(metaDic, "numberOfPolygons", numberOfPolygons);
-      ExposeMetaData< unsigned int >(metaDic, "numberOfPolygonIndices", numberOfPolygonIndices);
-      inputFile.read( startBuffer, numberOfPolygonIndices * sizeof( unsigned int ) );
-
-      pv = startBuffer;
-      unsigned int *data = static_cast< unsigned int * >( pv );
-      if ( itk::ByteSwapper< unsigned int >::SystemIsLittleEndian() )
-        {
-        itk::ByteSwapper< unsigned int >::SwapRangeFromSystemToBigEndian(data, numberOfPolygonIndices);
-        }
-
-      this->WriteCellsBuffer(data, outputBuffer, MeshIOBase::POLYGON_CELL, numberOfPolygons);
-      startBuffer += numberOfPolygonIndices * sizeof( unsigned int );
-      outputBuffer += ( numberOfPolygonIndices + numberOfPolygons ) * sizeof( unsigned int );
+      itkExceptionMacro(<< "Failed to read the cells from " << this->m_FileName);
       }
-    }
 
-  if ( this->m_CellBufferSize )
-    {
-    delete[] inputBuffer;
+    if ( itk::ByteSwapper< unsigned int >::SystemIsLittleEndian() )
+      {
+      itk::ByteSwapper< unsigned int >::SwapRangeFromSystemToBigEndian(data, numberOfIndices);
+      }
+    this->WriteCellsBuffer(data, outputBuffer, cellTypes[ii], numberOfCells);
+    outputBuffer += numberOfIndices + numberOfCells;
     }
 }
 
@@ -69,6 +69,11 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** Locate the data of an uncompressed binary image stored in a single
+   * file, either the header file or a separate data file, in the byte
+   * order of this machine. */
+  virtual bool GetRawDataLocation(std::string & fileName, SizeType & offset);
+
   MetaImage * GetMetaImagePointer(void);
 
   /*-------- This part of the interfaces deals with writing data. ----- */
@@ -11,8 +11,10 @@ itk_module(ITKIOMeta
   TEST_DEPENDS
     ITKTestKernel
     ITKSmoothing
+    ITKImageGrid
   DESCRIPTION
     "${DOCUMENTATION}"
 )
 
 # Extra test dependency of ITKSmoothing is caused by itkMetaStreamingIOTest.
+# Extra test dependency of ITKImageGrid is caused by itkMetaImageIOShrinkReadTest.
@@ -487,6 +487,61 @@ void MetaImageIO::Read(void *buffer)
     }
 }
 
+bool MetaImageIO::GetRawDataLocation(std::string & fileName, SizeType & offset)
+{
+  if ( m_SubSamplingFactor != 1 )
+    {
+    return false;
+    }
+
+  // Parse the header again, to find where it ends
+  std::ifstream stream(m_FileName.c_str(), std::ios::in | std::ios::binary);
+  MetaImage     header;
+  if ( !stream || !header.ReadStream(0, &stream, false) )
+    {
+    return false;
+    }
+  if ( !header.BinaryData() || header.CompressedData()
+       || header.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB() )
+    {
+    return false;
+    }
+
+  const std::string dataFileName = header.ElementDataFileName();
+  if ( dataFileName == "LOCAL" || dataFileName == "Local" || dataFileName == "local" )
+    {
+    fileName = m_FileName;
+    offset = static_cast< SizeType >( stream.tellg() );
+    }
+  else if ( dataFileName.compare(0, 4, "LIST") == 0
+            || dataFileName.find('%') != std::string::npos )
+    {
+    // One file per slice
+    return false;
+    }
+  else
+    {
+    fileName = dataFileName;
+    const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+    if ( !path.empty() && !itksys::SystemTools::FileIsFullPath( dataFileName.c_str() ) )
+      {
+      fileName = path + "/" + dataFileName;
+      }
+    offset = 0;
+    }
+  if ( header.HeaderSize() > 0 )
+    {
+    offset = header.HeaderSize();
+    }
+  else if ( header.HeaderSize() == -1 )
+    {
+    // The data ends the file
+    offset = static_cast< SizeType >( itksys::SystemTools::FileLength( fileName.c_str() ) )
+             - this->GetImageSizeInBytes();
+    }
+  return offset >= 0;
+}
+
 MetaImage * MetaImageIO::GetMetaImagePointer(void)
 {
   return &m_MetaImage;
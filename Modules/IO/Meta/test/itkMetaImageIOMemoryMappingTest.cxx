@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <fstream>
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMetaImageIO.h"
+#include "itkMemoryMappedImageContainer.h"
+#include "itkByteSwapper.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+typedef itk::Image< short, 3 > ImageType;
+typedef itk::MemoryMappedImageContainer< ImageType::PixelContainer::ElementIdentifier,
+                                         ImageType::PixelContainer::Element > MappedContainerType;
+
+bool
+IsMapped(ImageType *image)
+{
+  return dynamic_cast< MappedContainerType * >( image->GetPixelContainer() ) != 0;
+}
+
+template< class TImage >
+typename TImage::Pointer
+ReadImage(const std::string & fileName, bool useMemoryMapping)
+{
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO( itk::MetaImageIO::New() );
+  reader->SetFileName(fileName);
+  reader->SetUseMemoryMapping(useMemoryMapping);
+  reader->Update();
+  return reader->GetOutput();
+}
+
+template< class TImage >
+bool
+SameValues(const char *name, const TImage *image, const ImageType *expected)
+{
+  const itk::SizeValueType numberOfPixels = expected->GetBufferedRegion().GetNumberOfPixels();
+  if ( image->GetBufferedRegion().GetNumberOfPixels() != numberOfPixels )
+    {
+    std::cerr << name << ": wrong number of pixels" << std::endl;
+    return false;
+    }
+  for ( itk::SizeValueType i = 0; i < numberOfPixels; ++i )
+    {
+    if ( image->GetBufferPointer()[i] != expected->GetBufferPointer()[i] )
+      {
+      std::cerr << name << ": wrong value at " << i << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+bool
+CheckMapped(const char *name, ImageType *image, bool expectedMapped)
+{
+  if ( IsMapped(image) != expectedMapped )
+    {
+    std::cerr << name << ": the image is " << ( expectedMapped ? "not " : "" )
+              << "mapped" << std::endl;
+    return false;
+    }
+  std::cout << name << ( expectedMapped ? ": mapped." : ": read." ) << std::endl;
+  return true;
+}
+}
+
+int itkMetaImageIOMemoryMappingTest(int ac, char *av[])
+{
+  if ( ac < 2 )
+    {
+    std::cerr << "Usage: " << av[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::ChangeDirectory(av[1]);
+
+  ImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 29;
+  size[2] = 7;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    image->GetBufferPointer()[i] = static_cast< short >( i % 1000 - 500 );
+    }
+
+  bool result = true;
+  try
+    {
+    typedef itk::ImageFileWriter< ImageType > WriterType;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput(image);
+
+    // Data attached to the header, and in a separate file.
+    const char *fileNames[] = { "MemoryMapping.mha", "MemoryMapping.mhd" };
+    for ( unsigned int f = 0; f < 2; ++f )
+      {
+      writer->SetFileName(fileNames[f]);
+      writer->Update();
+
+      ImageType::Pointer mapped = ReadImage< ImageType >(fileNames[f], true);
+      result &= CheckMapped(fileNames[f], mapped, true);
+      result &= SameValues(fileNames[f], mapped.GetPointer(), image.GetPointer());
+
+      // Writing to the image does not modify the file.
+      mapped->GetBufferPointer()[100] = 1;
+      result &= SameValues( fileNames[f], ReadImage< ImageType >(fileNames[f], false).GetPointer(),
+                            image.GetPointer() );
+      }
+
+    // Compressed data is read.
+    writer->SetFileName("MemoryMappingCompressed.mha");
+    writer->UseCompressionOn();
+    writer->Update();
+    ImageType::Pointer compressed = ReadImage< ImageType >("MemoryMappingCompressed.mha", true);
+    result &= CheckMapped("Compressed", compressed, false);
+    result &= SameValues("Compressed", compressed.GetPointer(), image.GetPointer());
+
+    // Data in the other byte order is read, and swapped.
+    const bool bigEndian = itk::ByteSwapper< short >::SystemIsBigEndian();
+    std::ofstream header("MemoryMappingSwapped.mhd");
+    header << "ObjectType = Image\n"
+           << "NDims = 3\n"
+           << "DimSize = 37 29 7\n"
+           << "BinaryData = True\n"
+           << "BinaryDataByteOrderMSB = " << ( bigEndian ? "False" : "True" ) << "\n"
+           << "ElementType = MET_SHORT\n"
+           << "ElementDataFile = MemoryMapping.raw\n";
+    header.close();
+    ImageType::Pointer swapped = ReadImage< ImageType >("MemoryMappingSwapped.mhd", true);
+    result &= CheckMapped("Swapped", swapped, false);
+    result &= SameValues( "Swapped", swapped.GetPointer(),
+                          ReadImage< ImageType >("MemoryMappingSwapped.mhd", false).GetPointer() );
+
+    // Another pixel type is converted.
+    typedef itk::Image< float, 3 > FloatImageType;
+    FloatImageType::Pointer converted = ReadImage< FloatImageType >("MemoryMapping.mha", true);
+    result &= SameValues("Converted", converted.GetPointer(), image.GetPointer());
+    std::cout << "Converted: read." << std::endl;
+
+    // A mapped output is replaced by an allocated buffer when the file is
+    // read again.
+    typedef itk::ImageFileReader< ImageType > ReaderType;
+    ReaderType::Pointer reader = ReaderType::New();
+    reader->SetFileName("MemoryMapping.mha");
+    reader->UseMemoryMappingOn();
+    reader->Update();
+    result &= CheckMapped("Reader", reader->GetOutput(), true);
+    reader->UseMemoryMappingOff();
+    reader->Modified();
+    reader->Update();
+    result &= CheckMapped("Reader", reader->GetOutput(), false);
+    result &= SameValues("Reader", reader->GetOutput(), image.GetPointer());
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
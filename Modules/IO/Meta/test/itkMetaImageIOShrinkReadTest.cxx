@@ -0,0 +1,189 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkShrinkImageFilter.h"
+#include "itkStreamingImageFilter.h"
+#include "itksys/SystemTools.hxx"
+#include <cmath>
+
+namespace
+{
+typedef itk::Image< short, 3 > ImageType;
+
+// The image shrunk in memory
+ImageType::Pointer
+ExpectedImage(const ImageType *image, const unsigned int factors[3])
+{
+  typedef itk::ShrinkImageFilter< ImageType, ImageType > ShrinkType;
+  ShrinkType::Pointer shrink = ShrinkType::New();
+  shrink->SetInput(image);
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    shrink->SetShrinkFactor(i, factors[i]);
+    }
+  shrink->Update();
+  return shrink->GetOutput();
+}
+
+template< class TImage >
+bool
+SameImages(const char *name, const TImage *image, const ImageType *expected)
+{
+  if ( image->GetLargestPossibleRegion() != expected->GetLargestPossibleRegion() )
+    {
+    std::cerr << name << ": wrong size " << image->GetLargestPossibleRegion().GetSize()
+              << ", expected " << expected->GetLargestPossibleRegion().GetSize() << std::endl;
+    return false;
+    }
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    if ( std::fabs(image->GetSpacing()[i] - expected->GetSpacing()[i]) > 1e-9
+         || std::fabs(image->GetOrigin()[i] - expected->GetOrigin()[i]) > 1e-9 )
+      {
+      std::cerr << name << ": wrong spacing " << image->GetSpacing() << " or origin "
+                << image->GetOrigin() << ", expected " << expected->GetSpacing()
+                << " and " << expected->GetOrigin() << std::endl;
+      return false;
+      }
+    }
+  const itk::SizeValueType numberOfPixels = expected->GetBufferedRegion().GetNumberOfPixels();
+  for ( itk::SizeValueType i = 0; i < numberOfPixels; ++i )
+    {
+    if ( image->GetBufferPointer()[i] != expected->GetBufferPointer()[i] )
+      {
+      std::cerr << name << ": wrong value at " << i << std::endl;
+      return false;
+      }
+    }
+  std::cout << name << ": passed." << std::endl;
+  return true;
+}
+
+template< class TImage >
+typename TImage::Pointer
+ReadShrunkImage(const char *fileName, const unsigned int factors[3], unsigned int numberOfStreamDivisions)
+{
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  for ( unsigned int i = 0; i < 3; ++i )
+    {
+    reader->SetShrinkFactor(i, factors[i]);
+    }
+
+  typedef itk::StreamingImageFilter< TImage, TImage > StreamerType;
+  typename StreamerType::Pointer streamer = StreamerType::New();
+  streamer->SetInput( reader->GetOutput() );
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+  return streamer->GetOutput();
+}
+}
+
+int itkMetaImageIOShrinkReadTest(int ac, char *av[])
+{
+  if ( ac < 2 )
+    {
+    std::cerr << "Usage: " << av[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::ChangeDirectory(av[1]);
+
+  ImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 29;
+  size[2] = 7;
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.5;
+  spacing[1] = 0.75;
+  spacing[2] = 2.0;
+  ImageType::PointType origin;
+  origin[0] = -10.0;
+  origin[1] = 3.0;
+  origin[2] = 1.5;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->SetSpacing(spacing);
+  image->SetOrigin(origin);
+  image->Allocate();
+  for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    image->GetBufferPointer()[i] = static_cast< short >( i % 1000 - 500 );
+    }
+
+  bool result = true;
+  try
+    {
+    typedef itk::ImageFileWriter< ImageType > WriterType;
+    WriterType::Pointer writer = WriterType::New();
+    writer->SetInput(image);
+    writer->SetFileName("ShrinkRead.mha");
+    writer->Update();
+    writer->SetFileName("ShrinkReadCompressed.mha");
+    writer->UseCompressionOn();
+    writer->Update();
+
+    // Shrinking 37 pixels by 3 or 7 pixels by 3 leaves an odd number of
+    // pixels around the kept ones, so the output is shifted by half a
+    // pixel of the file.
+    const unsigned int factors[][3] = { { 1, 1, 1 }, { 3, 2, 2 }, { 4, 5, 1 }, { 1, 1, 8 }, { 40, 3, 3 } };
+    for ( unsigned int f = 0; f < sizeof( factors ) / sizeof( factors[0] ); ++f )
+      {
+      std::cout << "Factors " << factors[f][0] << " " << factors[f][1] << " " << factors[f][2] << std::endl;
+      ImageType::Pointer expected = ExpectedImage(image, factors[f]);
+
+      // The pixels kept are read from the raw data, in one piece or
+      // streamed.
+      result &= SameImages("Raw", ReadShrunkImage< ImageType >("ShrinkRead.mha", factors[f], 1).GetPointer(),
+                           expected.GetPointer() );
+      result &= SameImages("Raw streamed",
+                           ReadShrunkImage< ImageType >("ShrinkRead.mha", factors[f], 3).GetPointer(),
+                           expected.GetPointer() );
+
+      // Compressed data is read, then shrunk.
+      result &= SameImages("Compressed",
+                           ReadShrunkImage< ImageType >("ShrinkReadCompressed.mha", factors[f], 3).GetPointer(),
+                           expected.GetPointer() );
+
+      // Another pixel type is converted.
+      typedef itk::Image< float, 3 > FloatImageType;
+      result &= SameImages("Converted",
+                           ReadShrunkImage< FloatImageType >("ShrinkRead.mha", factors[f], 2).GetPointer(),
+                           expected.GetPointer() );
+      result &= SameImages("Compressed converted",
+                           ReadShrunkImage< FloatImageType >("ShrinkReadCompressed.mha", factors[f], 1).GetPointer(),
+                           expected.GetPointer() );
+      }
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( !result )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -38,6 +38,11 @@ namespace itk
  * \brief Class that defines how to read Nifti file format.
  * Nifti IMAGE FILE FORMAT - As much information as I can determine from sourceforge.net/projects/Niftilib
  *
+ * The data of gzip compressed files (.nii.gz, .img.gz) is written as a
+ * series of gzip members compressed by NumberOfThreads threads at
+ * CompressionLevel, see BlockGzip. Such files are read back by several
+ * threads as well, and remain readable by any gzip reader.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIONIFTI
  */
@@ -71,6 +76,13 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** Locate the data of an uncompressed file in the byte order of this
+   * machine. Images of vectors or tensors, which NIfTI stores one
+   * component after the other, and rescaled images are not located.
+   * Neither are floating point images, since Read() replaces their
+   * values that are not finite with zeros. */
+  virtual bool GetRawDataLocation(std::string & fileName, SizeType & offset);
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine if the file can be written with this ImageIO implementation.
@@ -88,6 +100,15 @@ public:
    * that the IORegions has been set properly. */
   virtual void Write(const void *buffer);
 
+  /** Determine if the ImageIO can stream reading from this file. Any
+   * region is read without loading the rest of the image: the requested
+   * bytes are read from uncompressed files, and the gzip members holding
+   * them are inflated for compressed ones. */
+  virtual bool CanStreamRead()
+  {
+    return true;
+  }
+
   /** Calculate the region of the image that can be efficiently read
    *  in response to a given requested region. */
   virtual ImageIORegion
@@ -117,6 +138,19 @@ private:
 
   void  SetImageIOMetadataFromNIfTI();
 
+  /** Load the data of the whole image into m_NiftiImage, like
+   * nifti_image_load(). */
+  void  LoadNiftiImageData();
+
+  /** Read the region of the image data of size starting at origin
+   * into data, like nifti_read_subregion_image(). The dimensions are
+   * those of the nifti image, with the components of vector pixels in
+   * the fifth one. */
+  void  ReadNiftiImageRegion(const int *origin, const int *size, void *data);
+
+  /** Write m_NiftiImage and its data, like nifti_image_write(). */
+  void  WriteNiftiImage();
+
   nifti_image *m_NiftiImage;
 
   double m_RescaleSlope;
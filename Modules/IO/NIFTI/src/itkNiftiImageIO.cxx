@@ -19,6 +19,10 @@
 #include "itkIOCommon.h"
 #include "itkMetaDataObject.h"
 #include "itkSpatialOrientationAdapter.h"
+#include "itkBlockGzip.h"
+#include "vnl/vnl_math.h"
+#include <algorithm>
+#include <vector>
 
 namespace itk
 {
@@ -344,7 +348,22 @@ ImageIORegion
 NiftiImageIO
 ::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
 {
-  return requestedRegion;
+  ImageIORegion streamableRegion(this->m_NumberOfDimensions);
+
+  if ( !m_UseStreamedReading )
+    {
+    for ( unsigned int i = 0; i < this->m_NumberOfDimensions; i++ )
+      {
+      streamableRegion.SetSize(i, this->m_Dimensions[i]);
+      streamableRegion.SetIndex(i, 0);
+      }
+    }
+  else
+    {
+    streamableRegion = requestedRegion;
+    }
+
+  return streamableRegion;
 }
 
 NiftiImageIO::NiftiImageIO():
@@ -429,6 +448,234 @@ CastCopy(float *to, void *from, size_t pixelcount)
     }
 }
 
+// Internal function to zero the values that are not finite, as
+// nifti_image_load does
+template< typename TReal >
+void
+ZeroNonFinite(void *data, size_t count)
+{
+  TReal *values = static_cast< TReal * >( data );
+
+  for ( size_t i = 0; i < count; i++ )
+    {
+    if ( !vnl_math_isfinite(values[i]) )
+      {
+      values[i] = 0;
+      }
+    }
+}
+
+// Internal function to bring data read from the image file of nim to
+// the native byte order and zero its values that are not finite, as
+// nifti_read_buffer does
+void
+FixNiftiData(const nifti_image *nim, void *data, size_t size)
+{
+  if ( nim->swapsize > 1 && nim->byteorder != nifti_short_order() )
+    {
+    nifti_swap_Nbytes(static_cast< int >( size / nim->swapsize ), nim->swapsize, data);
+    }
+  switch ( nim->datatype )
+    {
+    case NIFTI_TYPE_FLOAT32:
+    case NIFTI_TYPE_COMPLEX64:
+      ZeroNonFinite< float >(data, size / sizeof( float ) );
+      break;
+    case NIFTI_TYPE_FLOAT64:
+    case NIFTI_TYPE_COMPLEX128:
+      ZeroNonFinite< double >(data, size / sizeof( double ) );
+      break;
+    }
+}
+
+void
+NiftiImageIO::LoadNiftiImageData()
+{
+  // nifti_image_read() has found the image file that nifti_image_load()
+  // reads
+  const char *imageFileName = this->m_NiftiImage->iname;
+
+  if ( this->GetNumberOfThreads() == 1 || imageFileName == NULL
+       || !nifti_is_gzfile(imageFileName) || this->m_NiftiImage->iname_offset < 0 )
+    {
+    if ( nifti_image_load(this->m_NiftiImage) == -1 )
+      {
+      itkExceptionMacro( << "nifti_image_load failed for file: "
+                         << this->GetFileName() );
+      }
+    return;
+    }
+
+  // Decompress the gzip members with several threads.
+  std::ifstream file(imageFileName, std::ios::in | std::ios::binary);
+  if ( !file )
+    {
+    itkExceptionMacro( << "Cannot open image file for: " << this->GetFileName() );
+    }
+  const size_t volumeSize = nifti_get_volsize(this->m_NiftiImage);
+  this->m_NiftiImage->data = malloc(volumeSize);
+  if ( this->m_NiftiImage->data == NULL )
+    {
+    itkExceptionMacro( << "Cannot allocate " << volumeSize << " bytes for file: "
+                       << this->GetFileName() );
+    }
+  BlockGzip::Decompress(file, this->m_NiftiImage->data, this->m_NiftiImage->iname_offset,
+                        volumeSize, this->GetNumberOfThreads());
+  FixNiftiData(this->m_NiftiImage, this->m_NiftiImage->data, volumeSize);
+}
+
+void
+NiftiImageIO::ReadNiftiImageRegion(const int *origin, const int *size, void *data)
+{
+  const nifti_image *nim = this->m_NiftiImage;
+
+  if ( nim->iname == NULL || nim->iname_offset < 0 )
+    {
+    itkExceptionMacro( << "Cannot locate the image data of file: " << this->GetFileName() );
+    }
+
+  // Byte strides of the dimensions in the image file.
+  SizeValueType stride[7];
+  SizeValueType volumeSize = nim->nbyper;
+  for ( unsigned int d = 0; d < 7; d++ )
+    {
+    stride[d] = volumeSize;
+    if ( static_cast< int >( d ) < nim->ndim )
+      {
+      volumeSize *= std::max(nim->dim[d + 1], 1);
+      }
+    }
+
+  // The leading dimensions which the region covers entirely, and the
+  // next one, are contiguous in the file: the region is made of runs of
+  // runLength bytes.
+  unsigned int runDimension = 0;
+  while ( runDimension < 6 && origin[runDimension] == 0
+          && static_cast< SizeValueType >( size[runDimension] ) * stride[runDimension]
+          == stride[runDimension + 1] )
+    {
+    ++runDimension;
+    }
+  const SizeValueType runLength = stride[runDimension] * size[runDimension];
+
+  // Offsets of the runs in the file, or in the decompressed stream.
+  std::vector< SizeValueType > runOffsets;
+  int                          index[7] = { 0, 0, 0, 0, 0, 0, 0 };
+  do
+    {
+    SizeValueType runOffset = nim->iname_offset;
+    for ( unsigned int d = 0; d < 7; d++ )
+      {
+      runOffset += ( origin[d] + index[d] ) * stride[d];
+      }
+    runOffsets.push_back(runOffset);
+
+    unsigned int d = runDimension + 1;
+    for (; d < 7; d++ )
+      {
+      if ( ++index[d] < size[d] )
+        {
+        break;
+        }
+      index[d] = 0;
+      }
+    if ( d == 7 )
+      {
+      break;
+      }
+    }
+  while ( true );
+
+  std::ifstream file(nim->iname, std::ios::in | std::ios::binary);
+  if ( !file )
+    {
+    itkExceptionMacro( << "Cannot open image file for: " << this->GetFileName() );
+    }
+
+  char *bytes = static_cast< char * >( data );
+  if ( !nifti_is_gzfile(nim->iname) )
+    {
+    for ( size_t r = 0; r < runOffsets.size(); r++ )
+      {
+      file.seekg(static_cast< std::streamoff >( runOffsets[r] ), std::ios::beg);
+      file.read(bytes + r * runLength, runLength);
+      if ( static_cast< SizeValueType >( file.gcount() ) != runLength )
+        {
+        itkExceptionMacro( << "Cannot read the image data of file: " << this->GetFileName() );
+        }
+      }
+    }
+  else
+    {
+    // Stream through the file once, inflating only the members holding
+    // data of the runs.
+    BlockGzip::Decompress(file, data, runOffsets, runLength, this->GetNumberOfThreads());
+    }
+
+  FixNiftiData(nim, data, runOffsets.size() * runLength);
+}
+
+void
+NiftiImageIO::WriteNiftiImage()
+{
+  if ( this->GetNumberOfThreads() == 1 || !nifti_is_gzfile(this->m_NiftiImage->fname) )
+    {
+    nifti_image_write(this->m_NiftiImage);
+    return;
+    }
+
+  // niftilib writes the header and the padding up to the data, then the
+  // data is appended as further gzip members.
+  znzFile fp = nifti_image_write_hdr_img(this->m_NiftiImage, 2, "wb");
+  if ( znz_isnull(fp) )
+    {
+    itkExceptionMacro( << "Cannot write header of file: " << this->GetFileName() );
+    }
+  znzclose(fp);
+
+  std::ofstream file(this->m_NiftiImage->iname,
+                     std::ios::out | std::ios::binary | std::ios::app);
+  if ( !file )
+    {
+    itkExceptionMacro( << "Cannot open image file for: " << this->GetFileName() );
+    }
+  BlockGzip::Compress(file, this->m_NiftiImage->data, nifti_get_volsize(this->m_NiftiImage),
+                      this->GetCompressionLevel(), this->GetNumberOfThreads());
+}
+
+bool NiftiImageIO::GetRawDataLocation(std::string & fileName, SizeType & offset)
+{
+  if ( this->MustRescale()
+       || this->GetComponentType() == FLOAT
+       || this->GetComponentType() == DOUBLE
+       || ( this->GetNumberOfComponents() > 1
+            && this->GetPixelType() != COMPLEX
+            && this->GetPixelType() != RGB
+            && this->GetPixelType() != RGBA ) )
+    {
+    return false;
+    }
+
+  nifti_image *nim = nifti_image_read(this->GetFileName(), false);
+  if ( nim == NULL )
+    {
+    return false;
+    }
+  const char *imageFileName = nim->iname;
+  const bool  raw = imageFileName != NULL
+                    && !nifti_is_gzfile(imageFileName)
+                    && nim->iname_offset >= 0
+                    && ( nim->swapsize <= 1 || nim->byteorder == nifti_short_order() )
+                    && static_cast< SizeType >( nifti_get_volsize(nim) ) == this->GetImageSizeInBytes();
+  if ( raw )
+    {
+    fileName = imageFileName;
+    offset = nim->iname_offset;
+    }
+  nifti_image_free(nim);
+  return raw;
+}
+
 void NiftiImageIO::Read(void *buffer)
 {
   void *data = 0;
@@ -457,7 +704,10 @@ void NiftiImageIO::Read(void *buffer)
   unsigned int numComponents = this->GetNumberOfComponents();
   //
   // special case for images of vector pixels
-  if ( numComponents > 1 && this->GetPixelType() != COMPLEX )
+  if ( numComponents > 1
+       && this->GetPixelType() != COMPLEX
+       && this->GetPixelType() != RGB
+       && this->GetPixelType() != RGBA )
     {
     // nifti always sticks vec size in dim 4, so have to shove
     // other dims out of the way
@@ -465,6 +715,9 @@ void NiftiImageIO::Read(void *buffer)
     _size[5] = _size[4];
     // sizes = x y z t vecsize
     _size[4] = numComponents;
+    _origin[6] = _origin[5];
+    _origin[5] = _origin[4];
+    _origin[4] = 0;
     }
   // Free memory if any was occupied already (incase of re-using the IO filter).
   if ( this->m_NiftiImage != NULL )
@@ -494,24 +747,32 @@ void NiftiImageIO::Read(void *buffer)
   // all data as a block
   if ( i == this->GetNumberOfDimensions() )
     {
-    if ( nifti_image_load(this->m_NiftiImage) == -1 )
-      {
-      itkExceptionMacro( << "nifti_image_load failed for file: "
-                         << this->GetFileName() );
-      }
+    this->LoadNiftiImageData();
     data = this->m_NiftiImage->data;
     }
   else
     {
     // read in a subregion
-    if ( nifti_read_subregion_image(this->m_NiftiImage,
-                                    _origin,
-                                    _size,
-                                    &data) == -1 || this->m_NiftiImage == NULL )
+    size_t regionSize = this->m_NiftiImage->nbyper;
+    for ( i = 0; i < 7; i++ )
       {
-      itkExceptionMacro( << "nifti_read_subregion_image failed for file: "
+      regionSize *= _size[i];
+      }
+    data = malloc(regionSize);
+    if ( data == NULL )
+      {
+      itkExceptionMacro( << "Cannot allocate " << regionSize << " bytes for file: "
                          << this->GetFileName() );
       }
+    try
+      {
+      this->ReadNiftiImageRegion(_origin, _size, data);
+      }
+    catch ( ... )
+      {
+      free(data);
+      throw;
+      }
     }
   unsigned int pixelSize = this->m_NiftiImage->nbyper;
   //
@@ -529,7 +790,7 @@ void NiftiImageIO::Read(void *buffer)
 
     // Deal with correct management of 64bits platforms
     const size_t imageSizeInComponents =
-      static_cast< size_t >( this->GetImageSizeInComponents() );
+      static_cast< size_t >( numElts ) * numComponents;
 
     //
     // allocate new buffer for floats. Malloc instead of new to
@@ -604,10 +865,10 @@ void NiftiImageIO::Read(void *buffer)
     // vec x y z t l m o
     const char *       niftibuf = (const char *)data;
     char *             itkbuf = (char *)buffer;
-    const unsigned int rowdist = this->m_NiftiImage->dim[1];
-    const unsigned int slicedist = rowdist * this->m_NiftiImage->dim[2];
-    const unsigned int volumedist = slicedist * this->m_NiftiImage->dim[3];
-    const unsigned int seriesdist = volumedist * this->m_NiftiImage->dim[4];
+    const unsigned int rowdist = _size[0];
+    const unsigned int slicedist = rowdist * _size[1];
+    const unsigned int volumedist = slicedist * _size[2];
+    const unsigned int seriesdist = volumedist * _size[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -626,13 +887,13 @@ void NiftiImageIO::Read(void *buffer)
         vecOrder[i] = i;
         }
       }
-    for ( int t = 0; t < this->m_NiftiImage->dim[4]; t++ )
+    for ( int t = 0; t < _size[3]; t++ )
       {
-      for ( int z = 0; z < this->m_NiftiImage->dim[3]; z++ )
+      for ( int z = 0; z < _size[2]; z++ )
         {
-        for ( int y = 0; y < this->m_NiftiImage->dim[2]; y++ )
+        for ( int y = 0; y < _size[1]; y++ )
           {
-          for ( int x = 0; x < this->m_NiftiImage->dim[1]; x++ )
+          for ( int x = 0; x < _size[0]; x++ )
             {
             for ( unsigned int c = 0; c < numComponents; c++ )
               {
@@ -1862,7 +2123,7 @@ NiftiImageIO
     // Need a const cast here so that we don't have to copy the memory
     // for writing.
     this->m_NiftiImage->data = const_cast< void * >( buffer );
-    nifti_image_write(this->m_NiftiImage);
+    this->WriteNiftiImage();
     this->m_NiftiImage->data = 0; // if left pointing to data buffer
     // nifti_image_free will try and free this memory
     }
@@ -1944,7 +2205,7 @@ NiftiImageIO
     //Need a const cast here so that we don't have to copy the memory for
     //writing.
     this->m_NiftiImage->data = (void *)nifti_buf;
-    nifti_image_write(this->m_NiftiImage);
+    this->WriteNiftiImage();
     this->m_NiftiImage->data = 0; // if left pointing to data buffer
     delete[] nifti_buf;
     }
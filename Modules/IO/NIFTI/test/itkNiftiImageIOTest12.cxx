@@ -0,0 +1,96 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNiftiImageIOTest.h"
+
+// Compressed files written and read by several threads.
+int itkNiftiImageIOTest12(int ac, char *av[])
+{
+  if ( ac < 2 )
+    {
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::ChangeDirectory(av[1]);
+
+  typedef itk::Image< float, 3 > ImageType;
+  ImageType::SizeType size;
+  size[0] = 97;
+  size[1] = 83;
+  size[2] = 11;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  float *      buffer = image->GetBufferPointer();
+  unsigned int seed = 3;
+  for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    seed = seed * 1103515245 + 12345;
+    // Compressible, but not trivially.
+    buffer[i] = static_cast< float >( ( seed >> 16 ) % 64 ) + static_cast< float >( i % 97 );
+    }
+
+  const char *fileNames[] = { "itkNiftiImageIOTest12.nii.gz", "itkNiftiImageIOTest12.img.gz" };
+  for ( unsigned int f = 0; f < 2; ++f )
+    {
+    try
+      {
+      itk::NiftiImageIO::Pointer writeIO = itk::NiftiImageIO::New();
+      writeIO->SetNumberOfThreads(4);
+      writeIO->SetCompressionLevel(1);
+      typedef itk::ImageFileWriter< ImageType > WriterType;
+      WriterType::Pointer writer = WriterType::New();
+      writer->SetImageIO(writeIO);
+      writer->SetInput(image);
+      writer->SetFileName(fileNames[f]);
+      writer->Update();
+
+      // With one thread, the file is read by niftilib and zlib.
+      const itk::ThreadIdType numberOfThreads[] = { 4, 1 };
+      for ( unsigned int t = 0; t < 2; ++t )
+        {
+        itk::NiftiImageIO::Pointer readIO = itk::NiftiImageIO::New();
+        readIO->SetNumberOfThreads(numberOfThreads[t]);
+        typedef itk::ImageFileReader< ImageType > ReaderType;
+        ReaderType::Pointer reader = ReaderType::New();
+        reader->SetImageIO(readIO);
+        reader->SetFileName(fileNames[f]);
+        reader->Update();
+
+        const float *readBuffer = reader->GetOutput()->GetBufferPointer();
+        for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+          {
+          if ( readBuffer[i] != buffer[i] )
+            {
+            std::cerr << fileNames[f] << " read with " << numberOfThreads[t]
+                      << " threads: wrong value at " << i << ": " << readBuffer[i]
+                      << " instead of " << buffer[i] << std::endl;
+            return EXIT_FAILURE;
+            }
+          }
+        std::cout << fileNames[f] << " read with " << numberOfThreads[t] << " threads." << std::endl;
+        }
+      }
+    catch ( itk::ExceptionObject & e )
+      {
+      std::cerr << e << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  return EXIT_SUCCESS;
+}
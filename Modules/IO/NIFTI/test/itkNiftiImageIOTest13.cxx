@@ -0,0 +1,117 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNiftiImageIOTest.h"
+#include "itkMemoryMappedImageContainer.h"
+
+namespace
+{
+// Write image to fileName, and compare it with the image read with memory
+// mapping.
+template< class TImage >
+bool
+WriteAndMap(TImage *image, const char *fileName, bool expectedMapped)
+{
+  typedef itk::ImageFileWriter< TImage > WriterType;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO( itk::NiftiImageIO::New() );
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->Update();
+
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO( itk::NiftiImageIO::New() );
+  reader->SetFileName(fileName);
+  reader->UseMemoryMappingOn();
+  reader->Update();
+
+  typedef typename TImage::PixelContainer PixelContainerType;
+  typedef itk::MemoryMappedImageContainer< typename PixelContainerType::ElementIdentifier,
+                                           typename PixelContainerType::Element > MappedContainerType;
+  const bool mapped =
+    dynamic_cast< MappedContainerType * >( reader->GetOutput()->GetPixelContainer() ) != 0;
+  if ( mapped != expectedMapped )
+    {
+    std::cerr << fileName << ": the image is " << ( expectedMapped ? "not " : "" )
+              << "mapped" << std::endl;
+    return false;
+    }
+
+  const itk::SizeValueType numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  for ( itk::SizeValueType i = 0; i < numberOfPixels; ++i )
+    {
+    if ( reader->GetOutput()->GetBufferPointer()[i] != image->GetBufferPointer()[i] )
+      {
+      std::cerr << fileName << ": wrong value at " << i << std::endl;
+      return false;
+      }
+    }
+  std::cout << fileName << ( mapped ? ": mapped." : ": read." ) << std::endl;
+  return true;
+}
+
+template< class TImage >
+typename TImage::Pointer
+MakeImage()
+{
+  typename TImage::SizeType size;
+  size[0] = 23;
+  size[1] = 19;
+  size[2] = 6;
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    image->GetBufferPointer()[i] = static_cast< typename TImage::PixelType >( i % 1000 );
+    }
+  return image;
+}
+}
+
+// Uncompressed files mapped into memory.
+int itkNiftiImageIOTest13(int ac, char *av[])
+{
+  if ( ac < 2 )
+    {
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::ChangeDirectory(av[1]);
+
+  typedef itk::Image< short, 3 > ImageType;
+  typedef itk::Image< float, 3 > FloatImageType;
+  ImageType::Pointer      image = MakeImage< ImageType >();
+  FloatImageType::Pointer floatImage = MakeImage< FloatImageType >();
+
+  bool result = true;
+  try
+    {
+    result &= WriteAndMap(image.GetPointer(), "itkNiftiImageIOTest13.nii", true);
+    result &= WriteAndMap(image.GetPointer(), "itkNiftiImageIOTest13.hdr", true);
+    // Compressed data, and floating point values, are read.
+    result &= WriteAndMap(image.GetPointer(), "itkNiftiImageIOTest13.nii.gz", false);
+    result &= WriteAndMap(floatImage.GetPointer(), "itkNiftiImageIOTest13Float.nii", false);
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,164 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkNiftiImageIOTest.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+namespace
+{
+// Read region of fileName, and compare it with the same region of image.
+template< class TImage >
+bool
+ReadRegion(TImage *image, const char *fileName, const typename TImage::RegionType & region)
+{
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO( itk::NiftiImageIO::New() );
+  reader->SetFileName(fileName);
+  reader->UpdateOutputInformation();
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+
+  TImage *output = reader->GetOutput();
+  if ( output->GetBufferedRegion() != region )
+    {
+    std::cerr << fileName << ": read region " << output->GetBufferedRegion()
+              << " instead of " << region << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIteratorWithIndex< TImage > it(output, region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != image->GetPixel( it.GetIndex() ) )
+      {
+      std::cerr << fileName << ": wrong value at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  std::cout << fileName << ": read " << region.GetIndex() << " " << region.GetSize() << std::endl;
+  return true;
+}
+
+template< class TImage >
+void
+Write(TImage *image, const char *fileName)
+{
+  itk::NiftiImageIO::Pointer io = itk::NiftiImageIO::New();
+  io->SetNumberOfThreads(4);
+  typedef itk::ImageFileWriter< TImage > WriterType;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO(io);
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->Update();
+}
+}
+
+// Regions of uncompressed and compressed files read without the rest of
+// the image.
+int itkNiftiImageIOTest14(int ac, char *av[])
+{
+  if ( ac < 2 )
+    {
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::ChangeDirectory(av[1]);
+
+  // A series of volumes spanning several gzip members.
+  typedef itk::Image< short, 4 > ImageType;
+  ImageType::SizeType size;
+  size[0] = 40;
+  size[1] = 30;
+  size[2] = 20;
+  size[3] = 6;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  unsigned int seed = 7;
+  for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    seed = seed * 1103515245 + 12345;
+    image->GetBufferPointer()[i] = static_cast< short >( ( seed >> 16 ) % 512 ) - 256;
+    }
+
+  // One volume is contiguous in the file, a box is not.
+  ImageType::IndexType volumeIndex;
+  volumeIndex.Fill(0);
+  volumeIndex[3] = 4;
+  ImageType::SizeType volumeSize = size;
+  volumeSize[3] = 1;
+  const ImageType::RegionType volume(volumeIndex, volumeSize);
+
+  ImageType::IndexType boxIndex;
+  boxIndex[0] = 5;
+  boxIndex[1] = 7;
+  boxIndex[2] = 2;
+  boxIndex[3] = 1;
+  ImageType::SizeType boxSize;
+  boxSize[0] = 10;
+  boxSize[1] = 9;
+  boxSize[2] = 4;
+  boxSize[3] = 3;
+  const ImageType::RegionType box(boxIndex, boxSize);
+
+  // Vector pixels, whose components are apart in the file.
+  typedef itk::VectorImage< float, 3 > VectorImageType;
+  VectorImageType::SizeType vectorSize;
+  vectorSize[0] = 12;
+  vectorSize[1] = 11;
+  vectorSize[2] = 10;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(vectorSize);
+  vectorImage->SetVectorLength(3);
+  vectorImage->Allocate();
+  for ( itk::SizeValueType i = 0; i < vectorImage->GetBufferedRegion().GetNumberOfPixels() * 3; ++i )
+    {
+    vectorImage->GetBufferPointer()[i] = static_cast< float >( i ) * 0.5f;
+    }
+  VectorImageType::IndexType vectorIndex;
+  vectorIndex[0] = 3;
+  vectorIndex[1] = 2;
+  vectorIndex[2] = 6;
+  VectorImageType::SizeType vectorBoxSize;
+  vectorBoxSize[0] = 5;
+  vectorBoxSize[1] = 8;
+  vectorBoxSize[2] = 2;
+  const VectorImageType::RegionType vectorBox(vectorIndex, vectorBoxSize);
+
+  const char *fileNames[] = { "itkNiftiImageIOTest14.nii", "itkNiftiImageIOTest14.nii.gz" };
+  const char *vectorFileNames[] = { "itkNiftiImageIOTest14Vector.nii", "itkNiftiImageIOTest14Vector.nii.gz" };
+  bool        result = true;
+  try
+    {
+    for ( unsigned int f = 0; f < 2; ++f )
+      {
+      Write(image.GetPointer(), fileNames[f]);
+      result &= ReadRegion(image.GetPointer(), fileNames[f], volume);
+      result &= ReadRegion(image.GetPointer(), fileNames[f], box);
+
+      Write(vectorImage.GetPointer(), vectorFileNames[f]);
+      result &= ReadRegion(vectorImage.GetPointer(), vectorFileNames[f], vectorBox);
+      }
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+  return result ? EXIT_SUCCESS : EXIT_FAILURE;
+}
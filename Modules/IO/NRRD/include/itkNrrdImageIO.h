@@ -65,6 +65,12 @@ public:
   /** Reads the data from disk into the memory buffer provided. */
   virtual void Read(void *buffer);
 
+  /** Locate the data of a file with raw encoding, in the byte order of
+   * this machine, either attached to the header or in a single detached
+   * data file. The data is not located if the pixel components are not
+   * stored on the fastest axis. */
+  virtual bool GetRawDataLocation(std::string & fileName, SizeType & offset);
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   virtual bool CanWriteFile(const char *);
@@ -20,6 +20,7 @@
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itksys/SystemTools.hxx"
 
 namespace itk
 {
@@ -811,6 +812,81 @@ void NrrdImageIO::Read(void *buffer)
     }
 }
 
+bool NrrdImageIO::GetRawDataLocation(std::string & fileName, SizeType & offset)
+{
+  if ( ImageIOBase::SYMMETRICSECONDRANKTENSOR == this->GetPixelType() )
+    {
+    // The data may hold a mask, cropped by Read()
+    return false;
+    }
+
+  Nrrd *       nrrd = nrrdNew();
+  NrrdIoState *nio = nrrdIoStateNew();
+
+  // nrrd causes exceptions on purpose, so mask them
+  bool saveFPEState(FloatingPointExceptions::GetExceptionAction());
+  FloatingPointExceptions::Disable();
+
+  // read just the header, and keep the data file open at the first byte
+  // of the data
+  nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+  nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
+  bool located = false;
+  if ( nrrdLoad(nrrd, this->GetFileName(), nio) == 0 )
+    {
+    unsigned int rangeAxisIdx[NRRD_DIM_MAX];
+    const unsigned int rangeAxisNum = nrrdRangeAxesGet(nrrd, rangeAxisIdx);
+    located = nrrdFormatNRRD == nio->format
+              && nrrdEncodingRaw == nio->encoding
+              && ( nio->endian == AIR_ENDIAN || 1 == nrrdElementSize(nrrd) )
+              && ( 0 == rangeAxisNum || ( 1 == rangeAxisNum && 0 == rangeAxisIdx[0] ) )
+              && static_cast< SizeType >( nrrdElementSize(nrrd) * nrrdElementNumber(nrrd) )
+              == this->GetImageSizeInBytes()
+              && nio->dataFile != NULL
+              && !nio->dataFNFormat
+              && nio->dataFNArr->len <= 1;
+    if ( located && nio->dataFNArr->len == 1 )
+      {
+      // a detached data file, named relative to the header
+      fileName = nio->dataFN[0];
+      if ( fileName == "-" )
+        {
+        located = false;
+        }
+      else if ( airStrlen(nio->path) && !itksys::SystemTools::FileIsFullPath( fileName.c_str() ) )
+        {
+        fileName = std::string(nio->path) + "/" + fileName;
+        }
+      }
+    else if ( located )
+      {
+      fileName = this->GetFileName();
+      }
+    if ( located )
+      {
+      const long position = ftell(nio->dataFile);
+      located = position >= 0;
+      offset = position;
+      }
+    }
+  else
+    {
+    char *err = biffGetDone(NRRD);
+    free(err);
+    }
+
+  // restore state
+  FloatingPointExceptions::SetEnabled(saveFPEState);
+
+  if ( nio->dataFile )
+    {
+    nio->dataFile = airFclose(nio->dataFile);
+    }
+  nrrd = nrrdNuke(nrrd);
+  nio = nrrdIoStateNix(nio);
+  return located;
+}
+
 bool NrrdImageIO::CanWriteFile(const char *name)
 {
   std::string filename = name;
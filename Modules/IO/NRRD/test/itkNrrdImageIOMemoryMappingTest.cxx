@@ -0,0 +1,135 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkNrrdImageIO.h"
+#include "itkMemoryMappedImageContainer.h"
+#include "itksys/SystemTools.hxx"
+
+namespace
+{
+// Write image to fileName, and compare it with the image read with memory
+// mapping.
+template< class TImage >
+bool
+WriteAndMap(TImage *image, const char *fileName, bool compress, bool expectedMapped)
+{
+  typedef itk::ImageFileWriter< TImage > WriterType;
+  typename WriterType::Pointer writer = WriterType::New();
+  writer->SetImageIO( itk::NrrdImageIO::New() );
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetUseCompression(compress);
+  writer->Update();
+
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO( itk::NrrdImageIO::New() );
+  reader->SetFileName(fileName);
+  reader->UseMemoryMappingOn();
+  reader->Update();
+
+  typedef typename TImage::PixelContainer PixelContainerType;
+  typedef itk::MemoryMappedImageContainer< typename PixelContainerType::ElementIdentifier,
+                                           typename PixelContainerType::Element > MappedContainerType;
+  const bool mapped =
+    dynamic_cast< MappedContainerType * >( reader->GetOutput()->GetPixelContainer() ) != 0;
+  if ( mapped != expectedMapped )
+    {
+    std::cerr << fileName << ": the image is " << ( expectedMapped ? "not " : "" )
+              << "mapped" << std::endl;
+    return false;
+    }
+
+  const itk::SizeValueType numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
+  for ( itk::SizeValueType i = 0; i < numberOfPixels; ++i )
+    {
+    if ( reader->GetOutput()->GetBufferPointer()[i] != image->GetBufferPointer()[i] )
+      {
+      std::cerr << fileName << ": wrong value at " << i << std::endl;
+      return false;
+      }
+    }
+  std::cout << fileName << ( mapped ? ": mapped." : ": read." ) << std::endl;
+  return true;
+}
+}
+
+int itkNrrdImageIOMemoryMappingTest(int ac, char *av[])
+{
+  if ( ac < 2 )
+    {
+    std::cerr << "Usage: " << av[0] << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+    }
+  itksys::SystemTools::ChangeDirectory(av[1]);
+
+  typedef itk::Image< unsigned short, 3 > ImageType;
+  ImageType::SizeType size;
+  size[0] = 31;
+  size[1] = 17;
+  size[2] = 5;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for ( itk::SizeValueType i = 0; i < image->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    image->GetBufferPointer()[i] = static_cast< unsigned short >( i * 13 );
+    }
+
+  typedef itk::Image< itk::Vector< float, 3 >, 2 > VectorImageType;
+  VectorImageType::SizeType vectorSize;
+  vectorSize[0] = 19;
+  vectorSize[1] = 11;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  vectorImage->SetRegions(vectorSize);
+  vectorImage->Allocate();
+  for ( itk::SizeValueType i = 0; i < vectorImage->GetBufferedRegion().GetNumberOfPixels(); ++i )
+    {
+    for ( unsigned int c = 0; c < 3; ++c )
+      {
+      vectorImage->GetBufferPointer()[i][c] = i * 0.5f + c;
+      }
+    }
+
+  bool result = true;
+  try
+    {
+    // Attached and detached data, and vector pixels. The floating point
+    // components are aligned in the detached data file.
+    result &= WriteAndMap(image.GetPointer(), "MemoryMapping.nrrd", false, true);
+    result &= WriteAndMap(image.GetPointer(), "MemoryMapping.nhdr", false, true);
+    result &= WriteAndMap(vectorImage.GetPointer(), "MemoryMappingVector.nhdr", false, true);
+
+    // Compressed data is read.
+    result &= WriteAndMap(image.GetPointer(), "MemoryMappingCompressed.nrrd", true, false);
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  if ( !result )
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
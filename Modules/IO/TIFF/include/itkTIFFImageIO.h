@@ -31,6 +31,16 @@ class TIFFReaderInternal;
  *
  * \brief ImageIO object for reading and writing TIFF images
  *
+ * A single plane can be streamed: only the strips, or the tiles, which
+ * intersect the requested IORegion are decoded. Reduced resolution
+ * versions of the plane, stored in its SubIFDs or in the reduced image
+ * subfiles which follow it, are exposed as resolution levels, see
+ * SetResolutionLevel().
+ *
+ * When a tile size is set the image is written in tiles, which are
+ * compressed by several threads, see SetTileWidth(). Images larger than
+ * 2GB are written as BigTIFF.
+ *
  * \ingroup IOFilters
  *
  * \ingroup ITKIOTIFF
@@ -68,9 +78,37 @@ public:
   /** Reads 3D data from multi-pages tiff. */
   virtual void ReadVolume(void *buffer);
 
-  /** Reads 3D data from tiled tiff. */
+  /** Reads the IORegion of a tiled plane, decoding only the tiles which
+   * intersect it. */
   virtual void ReadTiles(void *buffer);
 
+  /** A single plane which is read strip by strip, or tile by tile, can be
+   * streamed. Valid after ReadImageInformation(). */
+  virtual bool CanStreamRead()
+  {
+    return m_CanStreamRead;
+  }
+
+  /** Method for supporting streaming.  Given a requested region, calculate what
+   * could be the region that we can read from the file. This is called the
+   * streamable region, which will be smaller than the LargestPossibleRegion and
+   * greater or equal to the RequestedRegion */
+  virtual ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const;
+
+  /** Get the number of resolution levels of the file: the full
+   * resolution plane and its reduced resolution versions. Valid after
+   * ReadImageInformation(). A multi-page volume has a single level. */
+  itkGetConstMacro(NumberOfResolutionLevels, unsigned int);
+
+  /** Set/Get the resolution level read, 0 being the full resolution.
+   * The spacing and origin of a reduced level are scaled so that it
+   * covers the same physical extent as the full resolution plane. When
+   * the level is 0 and shrink factors are set, see SetShrinkFactors(),
+   * the coarsest reduced level whose scale divides them is read. */
+  itkSetMacro(ResolutionLevel, unsigned int);
+  itkGetConstMacro(ResolutionLevel, unsigned int);
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -106,6 +144,16 @@ public:
   void SetCompressionToDeflate()       { this->SetCompression(Deflate); }
   void SetCompressionToLZW()           { this->SetCompression(LZW); }
 
+  /** Set/Get the size of the tiles written. When both are non zero the
+   * image is written in tiles, rounded up to a multiple of 16 as TIFF
+   * requires, instead of strips. The tiles are compressed by
+   * NumberOfThreads threads, except with JPEG or LZW compression. The
+   * default, 0, writes strips. */
+  itkSetMacro(TileWidth, unsigned int);
+  itkGetConstMacro(TileWidth, unsigned int);
+  itkSetMacro(TileHeight, unsigned int);
+  itkGetConstMacro(TileHeight, unsigned int);
+
   void SetCompression(int compression)
   {
     m_Compression = compression;
@@ -131,6 +179,9 @@ protected:
 
   void InternalWrite(const void *buffer);
 
+  /** Reads the IORegion of a single plane from its strips, or tiles. */
+  void ReadRegion(void *buffer);
+
   void InitializeColors();
 
   void ReadGenericImage(void *out,
@@ -158,6 +209,17 @@ protected:
   TIFFReaderInternal *m_InternalImage;
 
   int m_Compression;
+
+  unsigned int m_TileWidth;
+  unsigned int m_TileHeight;
+
+  unsigned int m_ResolutionLevel;
+  unsigned int m_NumberOfResolutionLevels;
+
+  // The level read: the ResolutionLevel, or a reduced level chosen to
+  // shrink the plane
+  unsigned int m_ReadResolutionLevel;
+  bool         m_CanStreamRead;
 private:
   TIFFImageIO(const Self &);    //purposely not implemented
   void operator=(const Self &); //purposely not implemented
@@ -5,6 +5,7 @@ itk_module(ITKIOTIFF
   DEPENDS
     ITKTIFF
     ITKIOImageBase
+    ITKZLIB
   TEST_DEPENDS
     ITKTestKernel
   DESCRIPTION
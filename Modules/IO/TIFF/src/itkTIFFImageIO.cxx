@@ -19,7 +19,13 @@
 #include "itkTIFFImageIO.h"
 #include "itksys/SystemTools.hxx"
 
+#include "itkMultiThreader.h"
+#include "itk_zlib.h"
+
 #include <sys/stat.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
 #include "itk_tiff.h"
 
@@ -51,17 +57,27 @@ public:
   unsigned short m_PlanarConfig;
   unsigned short m_Orientation;
   uint32         m_TileDepth;
-  unsigned int   m_TileRows;
-  unsigned int   m_TileColumns;
   unsigned int   m_TileWidth;
   unsigned int   m_TileHeight;
-  uint32_t       m_NumberOfTiles;
+  uint32         m_RowsPerStrip;
   unsigned int   m_SubFiles;
   unsigned int   m_IgnoredSubFiles;
   unsigned int   m_ResolutionUnit;
   float          m_XResolution;
   float          m_YResolution;
   short          m_SampleFormat;
+
+  // Offsets of the directories of the full resolution plane and of its
+  // reduced resolution versions.
+  std::vector< uint64 > m_ResolutionLevels;
+  unsigned int          m_CurrentResolutionLevel;
+  uint32                m_FullWidth;
+  uint32                m_FullHeight;
+
+  // Reads the fields of the current directory.
+  int ReadDirectory();
+
+  int SetResolutionLevel(unsigned int level);
 };
 
 int TIFFReaderInternal::Open(const char *filename)
@@ -107,17 +123,19 @@ void TIFFReaderInternal::Clean()
   this->m_TileDepth = 0;
   this->m_CurrentPage = 0;
   this->m_NumberOfPages = 0;
-  this->m_NumberOfTiles = 0;
-  this->m_TileRows = 0;
-  this->m_TileColumns = 0;
   this->m_TileWidth = 0;
   this->m_TileHeight = 0;
+  this->m_RowsPerStrip = 0;
   this->m_XResolution = 1;
   this->m_YResolution = 1;
   this->m_SubFiles = 0;
   this->m_IgnoredSubFiles = 0;
   this->m_SampleFormat = 1;
   this->m_ResolutionUnit = 1; // none
+  this->m_ResolutionLevels.clear();
+  this->m_CurrentResolutionLevel = 0;
+  this->m_FullWidth = 0;
+  this->m_FullHeight = 0;
   this->m_IsOpen = false;
 }
 
@@ -131,19 +149,12 @@ int TIFFReaderInternal::Initialize()
 {
   if ( this->m_Image )
     {
-    if ( !TIFFGetField(this->m_Image, TIFFTAG_IMAGEWIDTH, &this->m_Width)
-         || !TIFFGetField(this->m_Image, TIFFTAG_IMAGELENGTH, &this->m_Height) )
+    if ( !this->ReadDirectory() )
       {
       return 0;
       }
-
-    // Get the resolution in each direction
-    TIFFGetField(this->m_Image,
-                 TIFFTAG_XRESOLUTION, &this->m_XResolution);
-    TIFFGetField(this->m_Image,
-                 TIFFTAG_YRESOLUTION, &this->m_YResolution);
-    TIFFGetField(this->m_Image,
-                 TIFFTAG_RESOLUTIONUNIT, &this->m_ResolutionUnit);
+    this->m_FullWidth = this->m_Width;
+    this->m_FullHeight = this->m_Height;
 
     // Check the number of pages. First by looking at the number of directories
     this->m_NumberOfPages = TIFFNumberOfDirectories(this->m_Image);
@@ -171,22 +182,18 @@ int TIFFReaderInternal::Initialize()
         }
       }
 
-    // If the number of pages is still zero we look if the image is tiled
-    if ( this->m_NumberOfPages == 0 && TIFFIsTiled(this->m_Image) )
-      {
-      this->m_NumberOfTiles = TIFFNumberOfTiles(this->m_Image);
+    // The reduced resolution versions of the first plane are either in
+    // its SubIFDs, or in the reduced image subfiles which follow it.
+    this->m_ResolutionLevels.clear();
+    this->m_ResolutionLevels.push_back( TIFFCurrentDirOffset(this->m_Image) );
+    this->m_CurrentResolutionLevel = 0;
 
-      if ( !TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth)
-           || !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight) )
-        {
-        itkGenericExceptionMacro(
-          << "Cannot read tile width and tile length from file");
-        }
-      else
-        {
-        this->m_TileRows = this->m_Height / this->m_TileHeight;
-        this->m_TileColumns = this->m_Width / this->m_TileWidth;
-        }
+    uint16  numberOfSubIFDs = 0;
+    uint64 *subIFDs = NULL;
+    if ( TIFFGetField(this->m_Image, TIFFTAG_SUBIFD, &numberOfSubIFDs, &subIFDs) )
+      {
+      this->m_ResolutionLevels.insert(this->m_ResolutionLevels.end(),
+                                      subIFDs, subIFDs + numberOfSubIFDs);
       }
 
     // Checking if the TIFF contains subfiles
@@ -195,6 +202,7 @@ int TIFFReaderInternal::Initialize()
       this->m_SubFiles = 0;
       this->m_IgnoredSubFiles = 0;
 
+      std::vector< uint64 > reducedImages;
       for ( unsigned int page = 0; page < this->m_NumberOfPages; page++ )
         {
         int32 subfiletype = 6;
@@ -209,44 +217,119 @@ int TIFFReaderInternal::Initialize()
                     || subfiletype & FILETYPE_MASK )
             {
             ++this->m_IgnoredSubFiles;
+            if ( !( subfiletype & FILETYPE_MASK ) )
+              {
+              reducedImages.push_back( TIFFCurrentDirOffset(this->m_Image) );
+              }
             }
 
           }
         TIFFReadDirectory(this->m_Image);
         }
 
+      if ( this->m_ResolutionLevels.size() == 1 )
+        {
+        this->m_ResolutionLevels.insert( this->m_ResolutionLevels.end(),
+                                         reducedImages.begin(), reducedImages.end() );
+        }
+
       // Set the directory to the first image, and reads it
       TIFFSetDirectory(this->m_Image, 0);
       }
 
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ORIENTATION,
-                          &this->m_Orientation);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLESPERPIXEL,
-                          &this->m_SamplesPerPixel);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_COMPRESSION, &this->m_Compression);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_BITSPERSAMPLE,
-                          &this->m_BitsPerSample);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_PLANARCONFIG, &this->m_PlanarConfig);
-    TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLEFORMAT, &this->m_SampleFormat);
-
-    // If TIFFGetField returns false, there's no Photometric Interpretation
-    // set for this image, but that's a required field so we set a warning flag.
-    // (Because the "Photometrics" field is an enum, we can't rely on setting
-    // this->m_Photometrics to some signal value.)
-    if ( TIFFGetField(this->m_Image, TIFFTAG_PHOTOMETRIC, &this->m_Photometrics) )
-      {
-      this->m_HasValidPhotometricInterpretation = true;
-      }
-    else
+    // The planes of a volume have a single resolution
+    if ( this->m_NumberOfPages - this->m_IgnoredSubFiles > 1 )
       {
-      this->m_HasValidPhotometricInterpretation = false;
+      this->m_ResolutionLevels.resize(1);
       }
-    if ( !TIFFGetField(this->m_Image, TIFFTAG_TILEDEPTH, &this->m_TileDepth) )
+    }
+
+  return 1;
+}
+
+int TIFFReaderInternal::ReadDirectory()
+{
+  if ( !TIFFGetField(this->m_Image, TIFFTAG_IMAGEWIDTH, &this->m_Width)
+       || !TIFFGetField(this->m_Image, TIFFTAG_IMAGELENGTH, &this->m_Height) )
+    {
+    return 0;
+    }
+
+  // Get the resolution in each direction
+  TIFFGetField(this->m_Image,
+               TIFFTAG_XRESOLUTION, &this->m_XResolution);
+  TIFFGetField(this->m_Image,
+               TIFFTAG_YRESOLUTION, &this->m_YResolution);
+  TIFFGetField(this->m_Image,
+               TIFFTAG_RESOLUTIONUNIT, &this->m_ResolutionUnit);
+
+  if ( TIFFIsTiled(this->m_Image) )
+    {
+    if ( !TIFFGetField(this->m_Image, TIFFTAG_TILEWIDTH, &this->m_TileWidth)
+         || !TIFFGetField(this->m_Image, TIFFTAG_TILELENGTH, &this->m_TileHeight) )
       {
-      this->m_TileDepth = 0;
+      itkGenericExceptionMacro(
+        << "Cannot read tile width and tile length from file");
       }
     }
+  else
+    {
+    this->m_TileWidth = 0;
+    this->m_TileHeight = 0;
+    }
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ROWSPERSTRIP, &this->m_RowsPerStrip);
+
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_ORIENTATION,
+                        &this->m_Orientation);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLESPERPIXEL,
+                        &this->m_SamplesPerPixel);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_COMPRESSION, &this->m_Compression);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_BITSPERSAMPLE,
+                        &this->m_BitsPerSample);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_PLANARCONFIG, &this->m_PlanarConfig);
+  TIFFGetFieldDefaulted(this->m_Image, TIFFTAG_SAMPLEFORMAT, &this->m_SampleFormat);
+
+  // If TIFFGetField returns false, there's no Photometric Interpretation
+  // set for this image, but that's a required field so we set a warning flag.
+  // (Because the "Photometrics" field is an enum, we can't rely on setting
+  // this->m_Photometrics to some signal value.)
+  if ( TIFFGetField(this->m_Image, TIFFTAG_PHOTOMETRIC, &this->m_Photometrics) )
+    {
+    this->m_HasValidPhotometricInterpretation = true;
+    }
+  else
+    {
+    this->m_HasValidPhotometricInterpretation = false;
+    }
+  if ( !TIFFGetField(this->m_Image, TIFFTAG_TILEDEPTH, &this->m_TileDepth) )
+    {
+    this->m_TileDepth = 0;
+    }
+
+  return 1;
+}
+
+int TIFFReaderInternal::SetResolutionLevel(unsigned int level)
+{
+  if ( level >= this->m_ResolutionLevels.size() )
+    {
+    return 0;
+    }
+  if ( level == this->m_CurrentResolutionLevel )
+    {
+    return 1;
+    }
 
+  // The first directory is set by index, so that the pages which follow
+  // it are read in order.
+  const int set = ( level == 0 )
+                  ? TIFFSetDirectory(this->m_Image, 0)
+                  : TIFFSetSubDirectory(this->m_Image, this->m_ResolutionLevels[level]);
+  if ( !set || !this->ReadDirectory() )
+    {
+    return 0;
+    }
+  this->m_CurrentResolutionLevel = level;
   return 1;
 }
 
@@ -257,6 +340,8 @@ int TIFFReaderInternal::CanRead()
            && ( this->m_Compression == COMPRESSION_NONE
                 || this->m_Compression == COMPRESSION_PACKBITS
                 || this->m_Compression == COMPRESSION_LZW
+                || this->m_Compression == COMPRESSION_DEFLATE
+                || this->m_Compression == COMPRESSION_ADOBE_DEFLATE
                 )
            && ( this->m_HasValidPhotometricInterpretation )
            && ( this->m_Photometrics == PHOTOMETRIC_RGB
@@ -996,41 +1081,90 @@ unsigned int TIFFImageIO::GetFormat()
   return m_ImageFormat;
 }
 
-/** Read a tiled tiff */
+/** Read the IORegion of a tiled tiff */
 void TIFFImageIO::ReadTiles(void *buffer)
 {
-  unsigned char *volume = reinterpret_cast< unsigned char * >( buffer );
+  this->ReadRegion(buffer);
+}
+
+void TIFFImageIO::ReadRegion(void *buffer)
+{
+  TIFF *             tif = m_InternalImage->m_Image;
+  const uint32       height = m_InternalImage->m_Height;
+  const bool         tiled = TIFFIsTiled(tif) != 0;
+  const ImageIORegion & region = this->GetIORegion();
+
+  const uint32 x0 = static_cast< uint32 >( region.GetIndex(0) );
+  const uint32 y0 = static_cast< uint32 >( region.GetIndex(1) );
+  const uint32 x1 = x0 + static_cast< uint32 >( region.GetSize(0) );
+  const uint32 regionWidth = x1 - x0;
+  const uint32 regionHeight = static_cast< uint32 >( region.GetSize(1) );
+
+  // The rows of a plane which is not stored from the top are flipped, as
+  // in ReadGenericImage(). The rows of the file are read in increasing
+  // order in both cases.
+  const bool   topLeft = ( m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT );
+  const uint32 firstRow = topLeft ? y0 : height - y0 - regionHeight;
+  const uint32 lastRow = firstRow + regionHeight;
+
+  // A strip is a block as wide as the plane
+  const uint32 blockWidth = tiled ? m_InternalImage->m_TileWidth : m_InternalImage->m_Width;
+  const uint32 blockHeight = tiled ? m_InternalImage->m_TileHeight
+                             : std::min(m_InternalImage->m_RowsPerStrip, height);
+  const tmsize_t blockSize = tiled ? TIFFTileSize(tif) : TIFFStripSize(tif);
+
+  const SizeType inPixelSize = m_InternalImage->m_SamplesPerPixel * ( m_InternalImage->m_BitsPerSample / 8 );
+  const SizeType outPixelSize = this->GetNumberOfComponents() * this->GetComponentSize();
+  const SizeType blockRowSize = blockWidth * inPixelSize;
 
-  for ( unsigned int col = 0; col < m_InternalImage->m_Width; col += m_InternalImage->m_TileWidth )
+  // It is necessary to re-initialize the colors for eachread so
+  // that the colormap remains valid.
+  this->InitializeColors();
+
+  // Samples which are copied as they are
+  const bool copy = ( this->GetFormat() == TIFFImageIO::GRAYSCALE
+                      && m_InternalImage->m_Photometrics == PHOTOMETRIC_MINISBLACK
+                      && m_InternalImage->m_SamplesPerPixel == 1 )
+                    || ( this->GetFormat() == TIFFImageIO::RGB_
+                         && m_InternalImage->m_SamplesPerPixel == 3 );
+
+  std::vector< unsigned char > block(blockSize);
+  char *                       out = static_cast< char * >( buffer );
+
+  for ( uint32 by = firstRow - firstRow % blockHeight; by < lastRow; by += blockHeight )
     {
-    for ( unsigned int row = 0; row < m_InternalImage->m_Height; row += m_InternalImage->m_TileHeight )
+    for ( uint32 bx = x0 - x0 % blockWidth; bx < x1; bx += blockWidth )
       {
-      unsigned char *tempImage;
-      tempImage =
-        new unsigned char[m_InternalImage->m_TileWidth * m_InternalImage->m_TileHeight
-                          * m_InternalImage->m_SamplesPerPixel];
-
-      if ( TIFFReadTile(m_InternalImage->m_Image, tempImage, col, row, 0, 0) < 0 )
+      const tmsize_t read = tiled
+                            ? TIFFReadEncodedTile(tif, TIFFComputeTile(tif, bx, by, 0, 0), &block[0], blockSize)
+                            : TIFFReadEncodedStrip(tif, TIFFComputeStrip(tif, by, 0), &block[0], blockSize);
+      if ( read < 0 )
         {
-        itkExceptionMacro(<< "Cannot read tile : " << row << "," << col << " from file");
-        if ( tempImage != buffer )
-          {
-          delete[] tempImage;
-          }
-
-        return;
+        itkExceptionMacro(<< "Cannot read " << ( tiled ? "tile" : "strip" )
+                          << " : " << by << "," << bx << " from file");
         }
 
-      unsigned int xx, yy;
-      for ( yy = 0; yy < m_InternalImage->m_TileHeight; yy++ )
+      const uint32 rowBegin = std::max(by, firstRow);
+      const uint32 rowEnd = std::min(by + blockHeight, lastRow);
+      const uint32 colBegin = std::max(bx, x0);
+      const uint32 colEnd = std::min(bx + blockWidth, x1);
+
+      for ( uint32 row = rowBegin; row < rowEnd; ++row )
         {
-        for ( xx = 0; xx <  m_InternalImage->m_TileWidth; xx++ )
+        const uint32         outRow = ( topLeft ? row : height - 1 - row ) - y0;
+        const unsigned char *in = &block[0] + ( row - by ) * blockRowSize + ( colBegin - bx ) * inPixelSize;
+        char *               image = out + ( static_cast< SizeType >( outRow ) * regionWidth + colBegin - x0 )
+                                     * outPixelSize;
+        if ( copy )
           {
-          for ( unsigned int i = 0; i < m_InternalImage->m_SamplesPerPixel; i++ )
-            {
-            *volume = *( tempImage++ );
-            volume++;
-            }
+          memcpy(image, in, ( colEnd - colBegin ) * inPixelSize);
+          continue;
+          }
+        for ( uint32 col = colBegin; col < colEnd; ++col )
+          {
+          this->EvaluateImageAt( image, const_cast< unsigned char * >( in ) );
+          in += inPixelSize;
+          image += outPixelSize;
           }
         }
       }
@@ -1300,18 +1434,25 @@ void TIFFImageIO::Read(void *buffer)
     return;
     }
 
-  // The IO region should be of dimensions 3 otherwise we read only the first
-  // page
-  if ( m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2 )
+  if ( !m_InternalImage->SetResolutionLevel(m_ReadResolutionLevel) )
     {
-    this->ReadVolume(buffer);
+    itkExceptionMacro(<< "Cannot read resolution level " << m_ReadResolutionLevel
+                      << " of file " << this->m_FileName);
+    }
+
+  // A single plane is read from the strips, or tiles, within the IORegion
+  if ( m_CanStreamRead )
+    {
+    this->ReadRegion(buffer);
     m_InternalImage->Clean();
     return;
     }
 
-  if ( m_InternalImage->m_NumberOfTiles > 0 && this->GetIORegion().GetImageDimension() > 2 )
+  // The IO region should be of dimensions 3 otherwise we read only the first
+  // page
+  if ( m_InternalImage->m_NumberOfPages > 0 && this->GetIORegion().GetImageDimension() > 2 )
     {
-    this->ReadTiles(buffer);
+    this->ReadVolume(buffer);
     m_InternalImage->Clean();
     return;
     }
@@ -1402,6 +1543,14 @@ TIFFImageIO::TIFFImageIO()
 
   m_Compression = TIFFImageIO::PackBits;
 
+  m_TileWidth = 0;
+  m_TileHeight = 0;
+
+  m_ResolutionLevel = 0;
+  m_NumberOfResolutionLevels = 1;
+  m_ReadResolutionLevel = 0;
+  m_CanStreamRead = false;
+
   this->AddSupportedWriteExtension(".tif");
   this->AddSupportedWriteExtension(".TIF");
   this->AddSupportedWriteExtension(".tiff");
@@ -1423,6 +1572,10 @@ void TIFFImageIO::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
   os << indent << "Compression: " << m_Compression << "\n";
+  os << indent << "TileWidth: " << m_TileWidth << "\n";
+  os << indent << "TileHeight: " << m_TileHeight << "\n";
+  os << indent << "ResolutionLevel: " << m_ResolutionLevel << "\n";
+  os << indent << "NumberOfResolutionLevels: " << m_NumberOfResolutionLevels << "\n";
 }
 
 void TIFFImageIO::InitializeColors()
@@ -1447,6 +1600,13 @@ void TIFFImageIO::ReadImageInformation()
       }
     }
 
+  // The spacing is the one of the full resolution plane
+  if ( !m_InternalImage->SetResolutionLevel(0) )
+    {
+    itkExceptionMacro(<< "Cannot read file " << this->m_FileName << "!");
+    }
+
+  this->SetNumberOfDimensions(2);
   m_Spacing[0] = 1.0;
   m_Spacing[1] = 1.0;
 
@@ -1471,6 +1631,74 @@ void TIFFImageIO::ReadImageInformation()
   m_Origin[0] = 0.0;
   m_Origin[1] = 0.0;
 
+  m_NumberOfResolutionLevels = static_cast< unsigned int >( m_InternalImage->m_ResolutionLevels.size() );
+  if ( m_ResolutionLevel >= m_NumberOfResolutionLevels )
+    {
+    itkExceptionMacro(<< "Resolution level " << m_ResolutionLevel << " is not in file "
+                      << this->m_FileName << ", which has " << m_NumberOfResolutionLevels
+                      << " resolution levels");
+    }
+
+  // A shrunk plane is read from the coarsest reduced level whose scale,
+  // rounded, divides the shrink factors
+  m_ReadResolutionLevel = m_ResolutionLevel;
+  if ( m_ResolutionLevel == 0 && ( this->GetShrinkFactor(0) > 1 || this->GetShrinkFactor(1) > 1 ) )
+    {
+    unsigned int levelFactors[2] = { 1, 1 };
+    for ( unsigned int level = 1; level < m_NumberOfResolutionLevels; level++ )
+      {
+      if ( !m_InternalImage->SetResolutionLevel(level) || !m_InternalImage->CanRead() )
+        {
+        continue;
+        }
+      const unsigned int factors[2] = {
+        static_cast< unsigned int >( 0.5 + static_cast< double >( m_InternalImage->m_FullWidth )
+                                     / m_InternalImage->m_Width ),
+        static_cast< unsigned int >( 0.5 + static_cast< double >( m_InternalImage->m_FullHeight )
+                                     / m_InternalImage->m_Height )
+      };
+      if ( factors[0] >= 1 && factors[1] >= 1
+           && this->GetShrinkFactor(0) % factors[0] == 0
+           && this->GetShrinkFactor(1) % factors[1] == 0
+           && factors[0] * factors[1] > levelFactors[0] * levelFactors[1] )
+        {
+        m_ReadResolutionLevel = level;
+        levelFactors[0] = factors[0];
+        levelFactors[1] = factors[1];
+        }
+      }
+    if ( !m_InternalImage->SetResolutionLevel(0) )
+      {
+      itkExceptionMacro(<< "Cannot read file " << this->m_FileName << "!");
+      }
+    if ( m_ReadResolutionLevel > 0 )
+      {
+      m_AppliedShrinkFactors.assign(levelFactors, levelFactors + 2);
+      }
+    }
+
+  if ( m_ReadResolutionLevel > 0 )
+    {
+    if ( !m_InternalImage->SetResolutionLevel(m_ReadResolutionLevel) )
+      {
+      itkExceptionMacro(<< "Cannot read resolution level " << m_ReadResolutionLevel
+                        << " of file " << this->m_FileName);
+      }
+    this->InitializeColors();
+
+    // A pixel of a reduced level covers several full resolution pixels,
+    // and is centered on them.
+    const double scale[2] = {
+      static_cast< double >( m_InternalImage->m_FullWidth ) / m_InternalImage->m_Width,
+      static_cast< double >( m_InternalImage->m_FullHeight ) / m_InternalImage->m_Height
+    };
+    for ( unsigned int i = 0; i < 2; i++ )
+      {
+      m_Origin[i] = 0.5 * ( scale[i] - 1.0 ) * m_Spacing[i];
+      m_Spacing[i] *= scale[i];
+      }
+    }
+
   int width  = m_InternalImage->m_Width;
   int height = m_InternalImage->m_Height;
 
@@ -1551,18 +1779,29 @@ void TIFFImageIO::ReadImageInformation()
     m_Origin[2] = 0.0;
     }
 
-  // if the tiff is tiled
-  if ( m_InternalImage->m_NumberOfTiles > 1 )
+  // A single plane whose samples ReadRegion() can convert is streamed
+  const unsigned int format = this->GetFormat();
+  m_CanStreamRead = m_NumberOfDimensions == 2
+                    && m_InternalImage->CanRead()
+                    && m_InternalImage->m_SamplesPerPixel != 2
+                    && ( format == TIFFImageIO::GRAYSCALE
+                         || format == TIFFImageIO::RGB_
+                         || format == TIFFImageIO::PALETTE_RGB
+                         || format == TIFFImageIO::PALETTE_GRAYSCALE );
+
+  return;
+}
+
+ImageIORegion
+TIFFImageIO
+::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
+{
+  if ( !m_UseStreamedReading || !m_CanStreamRead )
     {
-    this->SetNumberOfDimensions(3);
-    m_Dimensions[0] = m_InternalImage->m_TileWidth;
-    m_Dimensions[1] = m_InternalImage->m_TileHeight;
-    m_Dimensions[2] = m_InternalImage->m_NumberOfTiles;
-    m_Spacing[2] = 1.0;
-    m_Origin[2] = 0.0;
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requestedRegion);
     }
 
-  return;
+  return requestedRegion;
 }
 
 bool TIFFImageIO::CanWriteFile(const char *name)
@@ -1621,6 +1860,212 @@ void TIFFImageIO::Write(const void *buffer)
 }
 
 
+namespace
+{
+// Number of tiles given to each thread at a time.
+const uint32 TilesPerThread = 8;
+
+/** The layout of the tiles of a page and how they are compressed. */
+struct TileEncoderStruct {
+  const unsigned char *                         Page;
+  uint32                                        Width;
+  uint32                                        Height;
+  uint32                                        TileWidth;
+  uint32                                        TileHeight;
+  uint32                                        TilesAcross;
+  unsigned int                                  BytesPerSample;
+  unsigned int                                  SamplesPerPixel;
+  int                                           Compression;
+  int                                           Level;
+  uint32                                        FirstTile;
+  uint32                                        NumberOfTiles;
+  std::vector< std::vector< unsigned char > > * Tiles;
+};
+
+/** Copy a tile of the page, padding the tiles on the right and bottom
+ * edges with zeros. */
+void
+CopyTile(const TileEncoderStruct & str, uint32 tile, std::vector< unsigned char > & data)
+{
+  const SizeValueType pixelSize = str.BytesPerSample * str.SamplesPerPixel;
+  const SizeValueType tileRowSize = str.TileWidth * pixelSize;
+  const uint32        x0 = ( tile % str.TilesAcross ) * str.TileWidth;
+  const uint32        y0 = ( tile / str.TilesAcross ) * str.TileHeight;
+  const uint32        columns = std::min(str.TileWidth, str.Width - x0);
+  const uint32        rows = std::min(str.TileHeight, str.Height - y0);
+
+  data.assign(tileRowSize * str.TileHeight, 0);
+  for ( uint32 row = 0; row < rows; ++row )
+    {
+    memcpy(&data[row * tileRowSize],
+           str.Page + ( static_cast< SizeValueType >( y0 + row ) * str.Width + x0 ) * pixelSize,
+           columns * pixelSize);
+    }
+}
+
+/** Replace each sample by its difference with the same sample of the
+ * previous pixel, as the horizontal differencing predictor does. */
+template< class TSample >
+void
+ApplyHorizontalPredictor(TSample *data, const TileEncoderStruct & str)
+{
+  const SizeValueType rowLength = static_cast< SizeValueType >( str.TileWidth ) * str.SamplesPerPixel;
+  for ( uint32 row = 0; row < str.TileHeight; ++row )
+    {
+    TSample *samples = data + row * rowLength;
+    for ( SizeValueType i = rowLength - 1; i >= str.SamplesPerPixel; --i )
+      {
+      samples[i] = static_cast< TSample >( samples[i] - samples[i - str.SamplesPerPixel] );
+      }
+    }
+}
+
+/** Encode a row with the PackBits run length encoding. */
+void
+PackBitsRow(const unsigned char *row, SizeValueType length, std::vector< unsigned char > & encoded)
+{
+  SizeValueType i = 0;
+  while ( i < length )
+    {
+    SizeValueType run = 1;
+    while ( i + run < length && run < 128 && row[i + run] == row[i] )
+      {
+      ++run;
+      }
+    if ( run > 1 )
+      {
+      encoded.push_back( static_cast< unsigned char >( 257 - run ) );
+      encoded.push_back(row[i]);
+      i += run;
+      }
+    else
+      {
+      // A literal run stops before two equal bytes
+      const SizeValueType start = i++;
+      while ( i < length && i - start < 128 && !( i + 1 < length && row[i] == row[i + 1] ) )
+        {
+        ++i;
+        }
+      encoded.push_back( static_cast< unsigned char >( i - start - 1 ) );
+      encoded.insert(encoded.end(), row + start, row + i);
+      }
+    }
+}
+
+/** Compress a tile as libtiff would. An empty result reports an error. */
+void
+EncodeTile(const TileEncoderStruct & str, uint32 tile, std::vector< unsigned char > & encoded)
+{
+  std::vector< unsigned char > data;
+  CopyTile(str, tile, data);
+
+  switch ( str.Compression )
+    {
+    case COMPRESSION_PACKBITS:
+      {
+      const SizeValueType tileRowSize = static_cast< SizeValueType >( str.TileWidth )
+                                        * str.BytesPerSample * str.SamplesPerPixel;
+      encoded.clear();
+      encoded.reserve( data.size() + data.size() / 128 + str.TileHeight );
+      for ( uint32 row = 0; row < str.TileHeight; ++row )
+        {
+        PackBitsRow(&data[row * tileRowSize], tileRowSize, encoded);
+        }
+      break;
+      }
+    case COMPRESSION_DEFLATE:
+      {
+      if ( str.BytesPerSample == 2 )
+        {
+        ApplyHorizontalPredictor(reinterpret_cast< unsigned short * >( &data[0] ), str);
+        }
+      else
+        {
+        ApplyHorizontalPredictor(&data[0], str);
+        }
+      uLongf length = compressBound( static_cast< uLong >( data.size() ) );
+      encoded.resize(length);
+      if ( compress2(&encoded[0], &length, &data[0], static_cast< uLong >( data.size() ), str.Level) != Z_OK )
+        {
+        length = 0;
+        }
+      encoded.resize(length);
+      break;
+      }
+    default:
+      encoded.swap(data);
+    }
+}
+
+ITK_THREAD_RETURN_TYPE
+EncodeTilesThreaderCallback(void *arg)
+{
+  const MultiThreader::ThreadInfoStruct *info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  const TileEncoderStruct *              str = static_cast< TileEncoderStruct * >( info->UserData );
+
+  for ( uint32 t = info->ThreadID; t < str->NumberOfTiles; t += info->NumberOfThreads )
+    {
+    EncodeTile( *str, str->FirstTile + t, ( *str->Tiles )[t] );
+    }
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/** Write the tiles of a page. PackBits and Deflate tiles are compressed
+ * by several threads then written raw, the other compressions are left
+ * to libtiff. */
+void
+WriteTiles(TIFF *tif, TileEncoderStruct & str, ThreadIdType numberOfThreads)
+{
+  const uint32 numberOfTiles = TIFFNumberOfTiles(tif);
+
+  if ( str.Compression != COMPRESSION_NONE
+       && str.Compression != COMPRESSION_PACKBITS
+       && str.Compression != COMPRESSION_DEFLATE )
+    {
+    std::vector< unsigned char > data;
+    for ( uint32 tile = 0; tile < numberOfTiles; ++tile )
+      {
+      CopyTile(str, tile, data);
+      if ( TIFFWriteEncodedTile( tif, tile, &data[0], static_cast< tmsize_t >( data.size() ) ) < 0 )
+        {
+        itkGenericExceptionMacro(<< "TIFFImageIO: error out of disk space");
+        }
+      }
+    return;
+    }
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads(numberOfThreads);
+  const uint32 tilesPerBatch = TilesPerThread * threader->GetNumberOfThreads();
+
+  std::vector< std::vector< unsigned char > > tiles(tilesPerBatch);
+  str.Tiles = &tiles;
+
+  for ( str.FirstTile = 0; str.FirstTile < numberOfTiles; str.FirstTile += tilesPerBatch )
+    {
+    str.NumberOfTiles = std::min(tilesPerBatch, numberOfTiles - str.FirstTile);
+
+    threader->SetNumberOfThreads( std::min( numberOfThreads,
+                                            static_cast< ThreadIdType >( str.NumberOfTiles ) ) );
+    threader->SetSingleMethod(EncodeTilesThreaderCallback, &str);
+    threader->SingleMethodExecute();
+
+    for ( uint32 t = 0; t < str.NumberOfTiles; ++t )
+      {
+      if ( tiles[t].empty() )
+        {
+        itkGenericExceptionMacro(<< "TIFFImageIO: cannot compress tile " << str.FirstTile + t);
+        }
+      if ( TIFFWriteRawTile( tif, str.FirstTile + t, &tiles[t][0],
+                             static_cast< tmsize_t >( tiles[t].size() ) ) < 0 )
+        {
+        itkGenericExceptionMacro(<< "TIFFImageIO: error out of disk space");
+        }
+      }
+    }
+}
+} // end anonymous namespace
+
 void TIFFImageIO::InternalWrite(const void *buffer)
 {
   char *outPtr = (char *)buffer;
@@ -1640,6 +2085,11 @@ void TIFFImageIO::InternalWrite(const void *buffer)
   uint32 rowsperstrip = ( uint32 ) - 1;
   int    bps;
 
+  // TIFF tiles are a multiple of 16 pixels wide and high
+  const bool   tiled = m_TileWidth > 0 && m_TileHeight > 0;
+  const uint32 tileWidth = ( m_TileWidth + 15 ) / 16 * 16;
+  const uint32 tileHeight = ( m_TileHeight + 15 ) / 16 * 16;
+
   switch ( this->GetComponentType() )
     {
     case UCHAR:
@@ -1775,13 +2225,22 @@ void TIFFImageIO::InternalWrite(const void *buffer)
       {
       predictor = 2;
       TIFFSetField(tif, TIFFTAG_PREDICTOR, predictor);
+      TIFFSetField(tif, TIFFTAG_ZIPQUALITY, m_CompressionLevel);
       }
 
     TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, photometric); // Fix for scomponents
 
-    TIFFSetField( tif,
-                  TIFFTAG_ROWSPERSTRIP,
-                  TIFFDefaultStripSize(tif, rowsperstrip) );
+    if ( tiled )
+      {
+      TIFFSetField(tif, TIFFTAG_TILEWIDTH, tileWidth);
+      TIFFSetField(tif, TIFFTAG_TILELENGTH, tileHeight);
+      }
+    else
+      {
+      TIFFSetField( tif,
+                    TIFFTAG_ROWSPERSTRIP,
+                    TIFFDefaultStripSize(tif, rowsperstrip) );
+      }
 
     if ( resolution_x > 0 && resolution_y > 0 )
      {
@@ -1821,16 +2280,43 @@ void TIFFImageIO::InternalWrite(const void *buffer)
     rowLength *= this->GetNumberOfComponents();
     rowLength *= width;
 
-    int row = 0;
-    for ( unsigned int idx2 = 0; idx2 < height; idx2++ )
+    if ( tiled )
       {
-      if ( TIFFWriteScanline(tif, const_cast< char * >( outPtr ), row, 0) < 0 )
+      TileEncoderStruct str;
+      str.Page = reinterpret_cast< const unsigned char * >( outPtr );
+      str.Width = width;
+      str.Height = height;
+      str.TileWidth = tileWidth;
+      str.TileHeight = tileHeight;
+      str.TilesAcross = ( width + tileWidth - 1 ) / tileWidth;
+      str.BytesPerSample = this->GetComponentSize();
+      str.SamplesPerPixel = scomponents;
+      str.Compression = compression;
+      str.Level = m_CompressionLevel;
+      try
         {
-        itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
-        break;
+        WriteTiles(tif, str, m_NumberOfThreads);
+        }
+      catch ( ... )
+        {
+        TIFFClose(tif);
+        throw;
+        }
+      outPtr += static_cast< SizeValueType >( rowLength ) * height;
+      }
+    else
+      {
+      int row = 0;
+      for ( unsigned int idx2 = 0; idx2 < height; idx2++ )
+        {
+        if ( TIFFWriteScanline(tif, const_cast< char * >( outPtr ), row, 0) < 0 )
+          {
+          itkExceptionMacro(<< "TIFFImageIO: error out of disk space");
+          break;
+          }
+        outPtr += rowLength;
+        row++;
         }
-      outPtr += rowLength;
-      row++;
       }
 
     if ( m_NumberOfDimensions == 3 )
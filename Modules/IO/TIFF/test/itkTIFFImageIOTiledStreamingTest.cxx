@@ -0,0 +1,314 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkTIFFImageIO.h"
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkRGBPixel.h"
+#include "itksys/SystemTools.hxx"
+#include "itk_tiff.h"
+#include <vector>
+
+namespace
+{
+/** Check the tile size of the first directory of a file. */
+bool CheckTiles(const char *fileName, uint32 expectedWidth, uint32 expectedHeight, uint16 expectedCompression)
+{
+  TIFF *tif = TIFFOpen(fileName, "r");
+  if ( !tif )
+    {
+    std::cerr << "Cannot open " << fileName << std::endl;
+    return false;
+    }
+  uint32 tileWidth = 0;
+  uint32 tileHeight = 0;
+  uint16 compression = 0;
+  TIFFGetField(tif, TIFFTAG_TILEWIDTH, &tileWidth);
+  TIFFGetField(tif, TIFFTAG_TILELENGTH, &tileHeight);
+  TIFFGetFieldDefaulted(tif, TIFFTAG_COMPRESSION, &compression);
+  const bool tiled = TIFFIsTiled(tif) != 0;
+  TIFFClose(tif);
+
+  if ( !tiled || tileWidth != expectedWidth || tileHeight != expectedHeight || compression != expectedCompression )
+    {
+    std::cerr << fileName << ": tiles of " << tileWidth << "x" << tileHeight
+              << " compressed with " << compression << " instead of "
+              << expectedWidth << "x" << expectedHeight << " compressed with "
+              << expectedCompression << std::endl;
+    return false;
+    }
+  return true;
+}
+
+/** Write a 16x16 tiled plane whose pixel (x,y) is the pixel
+ * (x*scale,y*scale) of the full resolution plane. */
+void WritePlane(TIFF *tif, uint32 width, uint32 height, uint32 scale, uint32 subfileType)
+{
+  TIFFSetField(tif, TIFFTAG_SUBFILETYPE, subfileType);
+  TIFFSetField(tif, TIFFTAG_IMAGEWIDTH, width);
+  TIFFSetField(tif, TIFFTAG_IMAGELENGTH, height);
+  TIFFSetField(tif, TIFFTAG_BITSPERSAMPLE, 8);
+  TIFFSetField(tif, TIFFTAG_SAMPLESPERPIXEL, 1);
+  TIFFSetField(tif, TIFFTAG_PHOTOMETRIC, PHOTOMETRIC_MINISBLACK);
+  TIFFSetField(tif, TIFFTAG_PLANARCONFIG, PLANARCONFIG_CONTIG);
+  TIFFSetField(tif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
+  TIFFSetField(tif, TIFFTAG_COMPRESSION, COMPRESSION_LZW);
+  TIFFSetField(tif, TIFFTAG_TILEWIDTH, 16);
+  TIFFSetField(tif, TIFFTAG_TILELENGTH, 16);
+
+  std::vector< unsigned char > tile(16 * 16);
+  for ( uint32 ty = 0; ty < height; ty += 16 )
+    {
+    for ( uint32 tx = 0; tx < width; tx += 16 )
+      {
+      for ( uint32 y = 0; y < 16; ++y )
+        {
+        for ( uint32 x = 0; x < 16; ++x )
+          {
+          tile[y * 16 + x] = static_cast< unsigned char >( ( ( tx + x ) * scale + 3 * ( ty + y ) * scale ) & 0xff );
+          }
+        }
+      TIFFWriteTile(tif, &tile[0], tx, ty, 0, 0);
+      }
+    }
+  TIFFWriteDirectory(tif);
+}
+
+template< typename TImage >
+bool CompareRegion(const TImage *image, const TImage *expected, const typename TImage::RegionType & region)
+{
+  if ( image->GetBufferedRegion() != region )
+    {
+    std::cerr << "Read " << image->GetBufferedRegion() << " instead of " << region << std::endl;
+    return false;
+    }
+  itk::ImageRegionConstIteratorWithIndex< TImage > it(image, region);
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if ( it.Get() != expected->GetPixel( it.GetIndex() ) )
+      {
+      std::cerr << "Wrong pixel at " << it.GetIndex() << std::endl;
+      return false;
+      }
+    }
+  return true;
+}
+
+/** Read the region of a file, with streaming. */
+template< typename TImage >
+typename TImage::Pointer ReadRegion(const char *fileName, const typename TImage::RegionType & region,
+                                    unsigned int level = 0)
+{
+  itk::TIFFImageIO::Pointer io = itk::TIFFImageIO::New();
+  io->SetResolutionLevel(level);
+
+  typedef itk::ImageFileReader< TImage > ReaderType;
+  typename ReaderType::Pointer reader = ReaderType::New();
+  reader->SetImageIO(io);
+  reader->SetFileName(fileName);
+  reader->SetUseStreaming(true);
+  reader->UpdateOutputInformation();
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->GetOutput()->Update();
+
+  typename TImage::Pointer image = reader->GetOutput();
+  image->DisconnectPipeline();
+  return image;
+}
+}
+
+// Tiled and stripped TIFF files read a region at a time, and pyramids.
+int itkTIFFImageIOTiledStreamingTest(int ac, char *av[])
+{
+  if ( ac > 1 )
+    {
+    itksys::SystemTools::ChangeDirectory(av[1]);
+    }
+
+  typedef itk::Image< unsigned short, 2 >                ImageType;
+  typedef itk::Image< itk::RGBPixel< unsigned char >, 2 > RGBImageType;
+
+  ImageType::SizeType size;
+  size[0] = 300;
+  size[1] = 200;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  RGBImageType::Pointer rgbImage = RGBImageType::New();
+  rgbImage->SetRegions(size);
+  rgbImage->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, image->GetBufferedRegion() );
+  for ( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set( static_cast< unsigned short >( index[0] * 211 + index[1] * 307 ) );
+
+    // Long runs as well as literals for PackBits
+    RGBImageType::PixelType rgb;
+    rgb[0] = static_cast< unsigned char >( index[1] );
+    rgb[1] = static_cast< unsigned char >( index[0] / 7 );
+    rgb[2] = static_cast< unsigned char >( index[0] * index[1] );
+    rgbImage->SetPixel(index, rgb);
+    }
+
+  ImageType::IndexType start;
+  start[0] = 70;
+  start[1] = 90;
+  ImageType::SizeType regionSize;
+  regionSize[0] = 100;
+  regionSize[1] = 50;
+  const ImageType::RegionType region(start, regionSize);
+
+  try
+    {
+    // Deflate tiles, rounded up to 64x64, ragged at the border.
+    const char *tiledName = "itkTIFFImageIOTiledStreamingTest.tif";
+    itk::TIFFImageIO::Pointer writeIO = itk::TIFFImageIO::New();
+    writeIO->SetTileWidth(64);
+    writeIO->SetTileHeight(50);
+    writeIO->SetCompressionToDeflate();
+    writeIO->SetNumberOfThreads(4);
+    itk::ImageFileWriter< ImageType >::Pointer writer = itk::ImageFileWriter< ImageType >::New();
+    writer->SetImageIO(writeIO);
+    writer->SetInput(image);
+    writer->SetFileName(tiledName);
+    writer->SetUseCompression(true);
+    writer->Update();
+
+    if ( !CheckTiles(tiledName, 64, 64, COMPRESSION_DEFLATE)
+         || !CompareRegion( ReadRegion< ImageType >( tiledName, image->GetLargestPossibleRegion() ).GetPointer(),
+                            image.GetPointer(), image->GetLargestPossibleRegion() )
+         || !CompareRegion( ReadRegion< ImageType >(tiledName, region).GetPointer(), image.GetPointer(), region ) )
+      {
+      return EXIT_FAILURE;
+      }
+
+    // PackBits tiles of RGB pixels
+    const char *rgbName = "itkTIFFImageIOTiledStreamingTestRGB.tif";
+    itk::TIFFImageIO::Pointer rgbIO = itk::TIFFImageIO::New();
+    rgbIO->SetTileWidth(32);
+    rgbIO->SetTileHeight(48);
+    rgbIO->SetCompressionToPackBits();
+    itk::ImageFileWriter< RGBImageType >::Pointer rgbWriter = itk::ImageFileWriter< RGBImageType >::New();
+    rgbWriter->SetImageIO(rgbIO);
+    rgbWriter->SetInput(rgbImage);
+    rgbWriter->SetFileName(rgbName);
+    rgbWriter->SetUseCompression(true);
+    rgbWriter->Update();
+
+    if ( !CheckTiles(rgbName, 32, 48, COMPRESSION_PACKBITS)
+         || !CompareRegion( ReadRegion< RGBImageType >(rgbName, region).GetPointer(), rgbImage.GetPointer(), region ) )
+      {
+      return EXIT_FAILURE;
+      }
+
+    // Strips are streamed too
+    const char *stripName = "itkTIFFImageIOTiledStreamingTestStrips.tif";
+    writer->SetImageIO( itk::TIFFImageIO::New() );
+    writer->SetFileName(stripName);
+    writer->SetUseCompression(false);
+    writer->Update();
+
+    if ( !CompareRegion( ReadRegion< ImageType >(stripName, region).GetPointer(), image.GetPointer(), region ) )
+      {
+      return EXIT_FAILURE;
+      }
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // A 128x96 plane with a 64x48 version in its SubIFDs
+  const char *pyramidName = "itkTIFFImageIOTiledStreamingTestPyramid.tif";
+  TIFF *      tif = TIFFOpen(pyramidName, "w");
+  if ( !tif )
+    {
+    std::cerr << "Cannot write " << pyramidName << std::endl;
+    return EXIT_FAILURE;
+    }
+  uint64 subIFDs[1] = { 0 };
+  TIFFSetField(tif, TIFFTAG_SUBIFD, 1, subIFDs);
+  WritePlane(tif, 128, 96, 1, 0);
+  WritePlane(tif, 64, 48, 2, FILETYPE_REDUCEDIMAGE);
+  TIFFClose(tif);
+
+  typedef itk::Image< unsigned char, 2 > LevelImageType;
+  try
+    {
+    itk::TIFFImageIO::Pointer io = itk::TIFFImageIO::New();
+    io->SetFileName(pyramidName);
+    io->SetResolutionLevel(1);
+    io->ReadImageInformation();
+    if ( io->GetNumberOfResolutionLevels() != 2
+         || io->GetDimensions(0) != 64 || io->GetDimensions(1) != 48
+         || io->GetSpacing(0) != 2.0 || io->GetSpacing(1) != 2.0
+         || io->GetOrigin(0) != 0.5 || io->GetOrigin(1) != 0.5 )
+      {
+      std::cerr << "Wrong resolution level 1" << std::endl;
+      io->Print(std::cerr);
+      return EXIT_FAILURE;
+      }
+
+    LevelImageType::IndexType levelStart;
+    levelStart[0] = 20;
+    levelStart[1] = 10;
+    LevelImageType::SizeType levelSize;
+    levelSize[0] = 30;
+    levelSize[1] = 17;
+    const LevelImageType::RegionType levelRegion(levelStart, levelSize);
+    LevelImageType::Pointer          level = ReadRegion< LevelImageType >(pyramidName, levelRegion, 1);
+
+    itk::ImageRegionConstIteratorWithIndex< LevelImageType > lit(level, levelRegion);
+    for ( lit.GoToBegin(); !lit.IsAtEnd(); ++lit )
+      {
+      const LevelImageType::IndexType index = lit.GetIndex();
+      if ( lit.Get() != static_cast< unsigned char >( ( index[0] * 2 + 3 * index[1] * 2 ) & 0xff ) )
+        {
+        std::cerr << "Wrong pixel of level 1 at " << index << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    }
+  catch ( itk::ExceptionObject & e )
+    {
+    std::cerr << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // There is no third level
+  try
+    {
+    itk::TIFFImageIO::Pointer io = itk::TIFFImageIO::New();
+    io->SetFileName(pyramidName);
+    io->SetResolutionLevel(2);
+    io->ReadImageInformation();
+    std::cerr << "Resolution level 2 was not rejected" << std::endl;
+    return EXIT_FAILURE;
+    }
+  catch ( itk::ExceptionObject & )
+    {
+    }
+
+  return EXIT_SUCCESS;
+}
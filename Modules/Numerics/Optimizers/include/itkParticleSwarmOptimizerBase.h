@@ -21,6 +21,7 @@
 
 #include "itkSingleValuedNonLinearOptimizer.h"
 #include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkParticleSwarmOptimizerBaseEvaluateParticlesThreader.h"
 
 namespace itk
 {
@@ -47,6 +48,10 @@ namespace itk
  * The actual optimization procedure, updating the swarm, is performed in the
  * subclasses, required to implement the UpdateSwarm() method.
  *
+ * The particles of a generation are independent, and may be evaluated
+ * concurrently, each thread with its own cost function. See
+ * SetConcurrentCostFunctions.
+ *
  * NOTE: This implementation only performs minimization.
  *
  * \ingroup Numerics Optimizers
@@ -85,6 +90,8 @@ public:
   typedef ParametersType::ValueType         ValueType;
   typedef Statistics::MersenneTwisterRandomVariateGenerator
                                             RandomVariateGeneratorType;
+  typedef std::vector< CostFunctionType::Pointer >
+                                            CostFunctionListType;
 
   /** Specify whether to initialize the particles using a normal distribution
     * centered on the user supplied initial value or a uniform distribution.
@@ -181,6 +188,22 @@ public:
   itkGetMacro( UseSeed, bool )
   itkBooleanMacro( UseSeed)
 
+  /** Set/Get the cost functions used to evaluate the particles of a
+   * generation concurrently. The particles are evaluated in up to N + 1
+   * threads, N being the number of cost functions in the list: the first
+   * thread uses the cost function set with SetCostFunction, and thread i
+   * the i-th cost function of the list. Each must give the values of the
+   * cost function set with SetCostFunction, e.g. a metric set up with the
+   * same images and its own transform, so that the optimization gives the
+   * same result whatever the number of threads. A cost function whose
+   * GetValue may be called from several threads at once can appear more than
+   * once. The default, an empty list, evaluates the particles one after
+   * another. An exception thrown by a cost function is rethrown in the
+   * calling thread once the generation is evaluated; when several
+   * particles fail, the exception of the first of them is rethrown. */
+  void SetConcurrentCostFunctions( const CostFunctionListType & costFunctions );
+  const CostFunctionListType & GetConcurrentCostFunctions() const;
+
   /** Get the function value for the current position.
    *  NOTE: This value is only valid during and after the execution of the
    *        StartOptimization() method.*/
@@ -205,6 +228,24 @@ protected:
    * Implement your update rule in this function.*/
   virtual void UpdateSwarm() = 0;
 
+  friend class ParticleSwarmOptimizerBaseEvaluateParticlesThreader;
+  typedef ParticleSwarmOptimizerBaseEvaluateParticlesThreader::IndexRangeType
+                                                              IndexRangeType;
+
+  /**
+   * Evaluate the cost function at the current parameters of all the
+   * particles, concurrently when concurrent cost functions are set, and set
+   * their current values. Their best values and parameters are left to the
+   * caller. */
+  void EvaluateParticles();
+
+  /**
+   * Evaluate the particles in the inclusive range \c subrange with the cost
+   * function of thread \c threadId. When evaluating concurrently, an
+   * exception thrown by the cost function stops the thread and is kept. */
+  void EvaluateParticlesOverSubRange( const IndexRangeType & subrange,
+                                      const ThreadIdType threadId );
+
   ParticleSwarmOptimizerBase( const Self& ); //purposely not implemented
   void operator=( const Self& );//purposely not implemented
 
@@ -235,6 +276,14 @@ protected:
   NumberOfIterationsType                       m_IterationIndex;
   RandomVariateGeneratorType::IntegerType      m_Seed;
   bool                                         m_UseSeed;
+  CostFunctionListType                         m_ConcurrentCostFunctions;
+
+  ParticleSwarmOptimizerBaseEvaluateParticlesThreader::Pointer
+                                               m_EvaluateParticlesThreader;
+  /** The first particle each thread failed to evaluate, or -1, and the
+   * exception thrown for it. */
+  std::vector<IndexValueType>                  m_EvaluateParticlesFailedParticles;
+  std::vector<ExceptionObject>                 m_EvaluateParticlesExceptions;
 };
 } // end namespace itk
 
@@ -85,8 +85,13 @@ InitializationBiasedParticleSwarmOptimizer
         {
         p.m_CurrentParameters[k] = m_ParameterBounds[k].second;
         }
-      }       //evaluate function at new position
-    p.m_CurrentValue = m_CostFunction->GetValue( p.m_CurrentParameters );
+      }
+    }
+          //evaluate function at new positions
+  EvaluateParticles();
+  for( j=0; j<m_NumberOfParticles; j++ )
+    {
+    ParticleData & p = m_Particles[j];
     if( p.m_CurrentValue < p.m_BestValue )
       {
       p.m_BestValue = p.m_CurrentValue;
@@ -35,6 +35,7 @@ ParticleSwarmOptimizerBase
   this->m_FunctionConvergenceTolerance = 1e-4;
   this->m_Seed = 0;
   this->m_UseSeed = false;
+  this->m_EvaluateParticlesThreader = ParticleSwarmOptimizerBaseEvaluateParticlesThreader::New();
 }
 
 ParticleSwarmOptimizerBase
@@ -141,6 +142,23 @@ ParticleSwarmOptimizerBase
 }
 
 
+void
+ParticleSwarmOptimizerBase
+::SetConcurrentCostFunctions( const CostFunctionListType & costFunctions )
+{
+  this->m_ConcurrentCostFunctions = costFunctions;
+  Modified();
+}
+
+
+const ParticleSwarmOptimizerBase::CostFunctionListType &
+ParticleSwarmOptimizerBase
+::GetConcurrentCostFunctions() const
+{
+  return this->m_ConcurrentCostFunctions;
+}
+
+
 ParticleSwarmOptimizerBase::CostFunctionType::MeasureType
 ParticleSwarmOptimizerBase
 ::GetValue() const
@@ -181,6 +199,8 @@ ParticleSwarmOptimizerBase
   os<<indent<<"Function convergence tolerance: "<<this->m_FunctionConvergenceTolerance << std::endl;
   os<<indent<<"UseSeed: " << m_UseSeed << std::endl;
   os<<indent<<"Seed: " << m_Seed << std::endl;
+  os<<indent<<"Number of concurrent cost functions: ";
+  os<<this->m_ConcurrentCostFunctions.size() << std::endl;
 
   os<<"\n";
           //printing the swarm, usually should be avoided (too much information)
@@ -332,6 +352,18 @@ ParticleSwarmOptimizerBase
   n =
     static_cast<unsigned int>( ( GetCostFunction() )->GetNumberOfParameters() );
 
+  for( i=0; i<this->m_ConcurrentCostFunctions.size(); i++ )
+    {
+    if( this->m_ConcurrentCostFunctions[i].IsNull() )
+      {
+      itkExceptionMacro(<<"NULL concurrent cost function")
+      }
+    if( this->m_ConcurrentCostFunctions[i]->GetNumberOfParameters() != n )
+      {
+      itkExceptionMacro(<<"cost function and concurrent cost function dimensions mismatch")
+      }
+    }
+
         //check that the number of parameters match
   ParametersType initialPosition = GetInitialPosition();
   if( initialPosition.Size() != n )
@@ -528,12 +560,87 @@ ParticleSwarmOptimizerBase
       }
     }
             //initial function evaluations
+  EvaluateParticles();
   for( i=0; i<this->m_NumberOfParticles; i++ )
     {
-    this->m_Particles[i].m_CurrentValue =
-      this->m_CostFunction->GetValue( m_Particles[i].m_CurrentParameters );
     this->m_Particles[i].m_BestValue = m_Particles[i].m_CurrentValue;
     }
 }
 
+
+void
+ParticleSwarmOptimizerBase
+::EvaluateParticles()
+{
+  IndexRangeType fullrange;
+  fullrange[0] = 0;
+  fullrange[1] = this->m_Particles.size()-1; //range is inclusive
+  if( this->m_ConcurrentCostFunctions.empty() )
+    {
+    EvaluateParticlesOverSubRange( fullrange, 0 );
+    }
+  else
+    {
+            //each particle is evaluated independently, so the values do not
+            //depend on the number of threads
+    const ThreadIdType numberOfThreads =
+      static_cast<ThreadIdType>( this->m_ConcurrentCostFunctions.size() + 1 );
+    this->m_EvaluateParticlesFailedParticles.assign( numberOfThreads, -1 );
+    this->m_EvaluateParticlesExceptions.assign( numberOfThreads, ExceptionObject() );
+    this->m_EvaluateParticlesThreader->SetMaximumNumberOfThreads( numberOfThreads );
+    this->m_EvaluateParticlesThreader->Execute( this, fullrange );
+
+            //rethrow the exception of the first particle that could not be
+            //evaluated, whatever the number of threads
+    ThreadIdType failedThread = numberOfThreads;
+    for( ThreadIdType t=0; t<numberOfThreads; t++ )
+      {
+      if( this->m_EvaluateParticlesFailedParticles[t] >= 0 &&
+          ( failedThread == numberOfThreads ||
+            this->m_EvaluateParticlesFailedParticles[t] <
+            this->m_EvaluateParticlesFailedParticles[failedThread] ) )
+        {
+        failedThread = t;
+        }
+      }
+    if( failedThread < numberOfThreads )
+      {
+      throw this->m_EvaluateParticlesExceptions[failedThread];
+      }
+    }
+}
+
+
+void
+ParticleSwarmOptimizerBase
+::EvaluateParticlesOverSubRange( const IndexRangeType & subrange,
+                                 const ThreadIdType threadId )
+{
+  const CostFunctionType * costFunction = this->m_CostFunction;
+  if( threadId > 0 )
+    {
+    costFunction = this->m_ConcurrentCostFunctions[threadId-1];
+    }
+  IndexValueType j = subrange[0];
+  try
+    {
+    for( ; j<=subrange[1]; j++ )
+      {
+      this->m_Particles[j].m_CurrentValue =
+        costFunction->GetValue( this->m_Particles[j].m_CurrentParameters );
+      }
+    }
+  catch( ExceptionObject & e )
+    {
+            //the threader would only report that a thread failed, so the
+            //exception is kept for EvaluateParticles to rethrow
+    if( this->m_ConcurrentCostFunctions.empty() )
+      {
+      throw;
+      }
+    this->m_EvaluateParticlesFailedParticles[threadId] = j;
+    this->m_EvaluateParticlesExceptions[threadId] = e;
+    }
+}
+
 }
@@ -45,6 +45,13 @@ int PSOTest2();
  */
 int PSOTest3();
 
+
+/**
+ * Test that evaluating the particles concurrently gives the same result as
+ * evaluating them one after another.
+ */
+int PSOTest4();
+
 bool verboseFlag = false;
 
 /**
@@ -82,9 +89,12 @@ int itkParticleSwarmOptimizerTest(int argc, char* argv[] )
       }
     }
 
+  const int concurrentResult = PSOTest4();
+
   std::cout<< "All Tests Completed."<< std::endl;
 
-  if( static_cast<double>(success1)/ static_cast<double>(allIterations) <= threshold ||
+  if( concurrentResult != EXIT_SUCCESS ||
+       static_cast<double>(success1)/ static_cast<double>(allIterations) <= threshold ||
       static_cast<double>(success2)/ static_cast<double>(allIterations) <= threshold ||
       static_cast<double>(success3)/ static_cast<double>(allIterations) <= threshold )
     {
@@ -486,3 +496,117 @@ int PSOTest3()
   std::cout << "[Test 3 SUCCESS]" << std::endl;
   return EXIT_SUCCESS;
 }
+
+
+int PSOTest4()
+{
+  std::cout << "Particle Swarm Optimizer Test 4 [concurrent evaluation]\n";
+  std::cout << "----------------------------------\n";
+
+  OptimizerType::ParameterBoundsType bounds;
+  bounds.push_back( std::make_pair( -100, 100 ) );
+  bounds.push_back( std::make_pair( -100, 100 ) );
+  OptimizerType::ParametersType initialParameters( 2 );
+  initialParameters[0] = 50;
+  initialParameters[1] = 50;
+
+  OptimizerType::ParametersType finalParameters[2];
+  OptimizerType::MeasureType    finalValue[2];
+  std::string                   stopCondition[2];
+  try
+    {
+    for( unsigned int run=0; run<2; run++ )
+      {
+      ParticleSwarmTestF3::Pointer costFunction = ParticleSwarmTestF3::New();
+      OptimizerType::Pointer  itkOptimizer = OptimizerType::New();
+      itkOptimizer->UseSeedOn();
+      itkOptimizer->SetSeed( 8775070 );
+      itkOptimizer->SetParameterBounds( bounds );
+      itkOptimizer->SetNumberOfParticles( 50 );
+      itkOptimizer->SetMaximalNumberOfIterations( 200 );
+      itkOptimizer->SetParametersConvergenceTolerance( 0.1, 2 );
+      itkOptimizer->SetFunctionConvergenceTolerance( 0.01 );
+      itkOptimizer->SetCostFunction( costFunction.GetPointer() );
+      itkOptimizer->SetInitialPosition( initialParameters );
+      if( run == 1 )
+        {
+        //one cost function per additional thread
+        OptimizerType::CostFunctionListType costFunctions;
+        for( unsigned int i=0; i<3; i++ )
+          {
+          costFunctions.push_back( ParticleSwarmTestF3::New().GetPointer() );
+          }
+        itkOptimizer->SetConcurrentCostFunctions( costFunctions );
+        if( itkOptimizer->GetConcurrentCostFunctions().size() != 3 )
+          {
+          std::cerr << "Error in Set/Get methods for concurrent cost functions";
+          return EXIT_FAILURE;
+          }
+        }
+      itkOptimizer->StartOptimization();
+      finalParameters[run] = itkOptimizer->GetCurrentPosition();
+      finalValue[run] = itkOptimizer->GetValue();
+      stopCondition[run] = itkOptimizer->GetStopConditionDescription();
+      std::cout << stopCondition[run] << ": " << finalParameters[run]
+                << " value " << finalValue[run] << std::endl;
+      }
+    }
+  catch( itk::ExceptionObject & e )
+    {
+    std::cout << "[Test 4 FAILURE]" << std::endl;
+    std::cout << "Exception thrown ! " << std::endl;
+    std::cout << "Description = " << e.GetDescription() << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( finalParameters[0] != finalParameters[1] || finalValue[0] != finalValue[1] ||
+      stopCondition[0] != stopCondition[1] )
+    {
+    std::cout << "[Test 4 FAILURE]" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  //a cost function failing for some particles makes the optimization throw
+  //the exception of the first of them, concurrently or not
+  std::string description[2];
+  initialParameters[0] = -50;
+  for( unsigned int run=0; run<2; run++ )
+    {
+    OptimizerType::Pointer  itkOptimizer = OptimizerType::New();
+    itkOptimizer->UseSeedOn();
+    itkOptimizer->SetSeed( 8775070 );
+    itkOptimizer->SetParameterBounds( bounds );
+    itkOptimizer->SetNumberOfParticles( 50 );
+    itkOptimizer->SetMaximalNumberOfIterations( 200 );
+    itkOptimizer->SetParametersConvergenceTolerance( 0.1, 2 );
+    itkOptimizer->SetFunctionConvergenceTolerance( 0.01 );
+    itkOptimizer->SetCostFunction( ParticleSwarmTestF4::New().GetPointer() );
+    itkOptimizer->SetInitialPosition( initialParameters );
+    if( run == 1 )
+      {
+      OptimizerType::CostFunctionListType costFunctions;
+      for( unsigned int i=0; i<3; i++ )
+        {
+        costFunctions.push_back( ParticleSwarmTestF4::New().GetPointer() );
+        }
+      itkOptimizer->SetConcurrentCostFunctions( costFunctions );
+      }
+    try
+      {
+      itkOptimizer->StartOptimization();
+      }
+    catch( itk::ExceptionObject & e )
+      {
+      description[run] = e.GetDescription();
+      std::cout << "Caught expected exception: " << description[run] << std::endl;
+      }
+    }
+  if( description[0].empty() || description[0] != description[1] )
+    {
+    std::cout << "[Test 4 FAILURE]" << std::endl;
+    std::cout << "Expected the same exception, got \"" << description[0]
+              << "\" and \"" << description[1] << "\"" << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "[Test 4 SUCCESS]" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -190,6 +190,35 @@ public:
 
 };
 
+/**
+ * \class ParticleSwarmTestF4
+ * The Rosenbrock function of ParticleSwarmTestF3, which cannot be evaluated
+ * for x > 80: an exception giving the parameters is thrown instead.
+ */
+class ParticleSwarmTestF4 : public ParticleSwarmTestF3
+{
+public:
+
+  typedef ParticleSwarmTestF4           Self;
+  typedef ParticleSwarmTestF3           Superclass;
+  typedef itk::SmartPointer<Self>       Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+  itkNewMacro( Self );
+  itkTypeMacro( ParticleSwarmTestF4, ParticleSwarmTestF3 );
+
+  double GetValue( const ParametersType & parameters ) const
+  {
+    if( parameters[0] > 80 )
+      {
+      std::ostringstream message;
+      message << "cannot evaluate " << parameters;
+      throw itk::ExceptionObject( __FILE__, __LINE__, message.str().c_str() );
+      }
+    return Superclass::GetValue( parameters );
+  }
+
+};
+
 class CommandIterationUpdateParticleSwarm : public itk::Command
 {
 public:
@@ -159,6 +159,9 @@ protected:
   DerivativeType     m_Gradient;
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Create an optimizer of the same type, with the same settings. */
+  virtual LightObject::Pointer InternalClone() const;
+
 private:
   GradientDescentOptimizerBasev4( const Self & ); //purposely not implemented
   void operator=( const Self& ); //purposely not implemented
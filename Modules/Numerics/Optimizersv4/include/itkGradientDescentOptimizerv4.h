@@ -127,6 +127,7 @@ public:
    * \sa SetDoEstimateLearningOnce()
    */
   itkSetObjectMacro(ScalesEstimator, OptimizerParameterScalesEstimator);
+  itkGetConstObjectMacro(ScalesEstimator, OptimizerParameterScalesEstimator);
 
   /** Option to use ScalesEstimator for scales estimation.
    * The estimation is performed once at begin of
@@ -217,6 +218,10 @@ protected:
 
   virtual void PrintSelf( std::ostream & os, Indent indent ) const;
 
+  /** Create an optimizer of the same type, with the same settings. The
+   * clone shares the scales estimator of this optimizer. */
+  virtual LightObject::Pointer InternalClone() const;
+
   OptimizerParameterScalesEstimator::Pointer m_ScalesEstimator;
 
   /** Minimum convergence value for convergence checking.
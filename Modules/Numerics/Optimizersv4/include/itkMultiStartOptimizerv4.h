@@ -19,6 +19,7 @@
 #define __itkMultiStartOptimizerv4_h
 #include "itkObjectToObjectOptimizerBase.h"
 #include "itkGradientDescentOptimizerv4.h"
+#include "itkMultiStartOptimizerv4OptimizeStartsThreader.h"
 
 namespace itk
 {
@@ -33,6 +34,10 @@ namespace itk
  *   focus modifying the parameter sample space.  This is why we place the burden on the user to provide
  *   the parameter samples over which to optimize.
  *
+ *   The starts are independent, and may be optimized concurrently: see
+ *   SetNumberOfConcurrentStarts. Each thread then optimizes its share of the
+ *   starts with its own clone of the metric and of the local optimizer.
+ *
  * \ingroup ITKOptimizersv4
  */
 
@@ -137,6 +142,34 @@ public:
 
   inline ParameterListSizeType GetBestParametersIndex( ) { return this->m_BestParametersIndex; }
 
+  /** Set/Get the number of starts that are optimized concurrently, each in
+   * its own thread. The default, 1, optimizes the starts one after another
+   * with the metric and the local optimizer.
+   *
+   * Otherwise each thread uses a clone of the metric, which has its own copy
+   * of the moving transform and shares the images, interpolators and any
+   * fixed domain cache of the metric, and a clone of the local optimizer.
+   * The clones are initialized one after another before the starts are
+   * optimized. Since the starts are independent and each clone evaluates
+   * like the metric, the results do not depend on the number of threads.
+   * The metric must support Clone, as ImageToImageMetricv4 does. The local
+   * optimizer must not use a scales estimator, which is set up with the
+   * metric and not with its clones: estimate the scales and learning rate
+   * beforehand and set them on the local optimizer. Observers of the local
+   * optimizer are not called.
+   *
+   * The IterationEvent of each start is only invoked once all the starts are
+   * optimized, with the metric set to the optimized parameters of the start.
+   * Calling StopOptimization from an observer then ends the reporting of the
+   * starts, but saves no computation.
+   *
+   * The metric still uses its own threads to evaluate each start. Setting
+   * its maximum number of threads to 1 avoids running more threads than
+   * there are cores, but may change the metric values slightly, as the sums
+   * over the threads are accumulated differently. */
+  itkSetClampMacro( NumberOfConcurrentStarts, ThreadIdType, 1, NumericTraits< ThreadIdType >::max() );
+  itkGetConstMacro( NumberOfConcurrentStarts, ThreadIdType );
+
 protected:
 
   /** Default constructor */
@@ -145,6 +178,20 @@ protected:
 
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
+  friend class MultiStartOptimizerv4OptimizeStartsThreader;
+  typedef MultiStartOptimizerv4OptimizeStartsThreader::IndexRangeType IndexRangeType;
+
+  /** Optimize the starts from the current iteration on concurrently, and
+   * store their results. */
+  void OptimizeStartsConcurrently();
+
+  /** Clone the metric and the local optimizer for each thread. */
+  void InitializeConcurrentStarts( const ThreadIdType numberOfThreads );
+
+  /** Optimize the starts in the inclusive range \c subrange with the metric
+   * and local optimizer of thread \c threadId. */
+  void OptimizeStartsOverSubRange( const IndexRangeType & subrange, const ThreadIdType threadId );
+
   /* Common variables for optimization control and reporting */
   bool                          m_Stop;
   StopConditionType             m_StopCondition;
@@ -158,6 +205,15 @@ protected:
   ParameterListSizeType         m_BestParametersIndex;
   OptimizerPointer              m_LocalOptimizer;
 
+  /* Variables for concurrent starts */
+  ThreadIdType                     m_NumberOfConcurrentStarts;
+  std::vector< MetricTypePointer > m_ConcurrentMetrics;
+  std::vector< OptimizerPointer >  m_ConcurrentLocalOptimizers;
+  MetricValuesListType             m_ConcurrentMetricValues;
+  std::vector< unsigned char >     m_ConcurrentStartIsValid;
+
+  MultiStartOptimizerv4OptimizeStartsThreader::Pointer m_OptimizeStartsThreader;
+
 private:
   MultiStartOptimizerv4( const Self & ); //purposely not implemented
   void operator=( const Self& ); //purposely not implemented
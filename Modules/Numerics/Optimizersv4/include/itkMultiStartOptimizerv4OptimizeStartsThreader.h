@@ -0,0 +1,70 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMultiStartOptimizerv4OptimizeStartsThreader_h
+#define __itkMultiStartOptimizerv4OptimizeStartsThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+namespace itk
+{
+
+class MultiStartOptimizerv4;
+
+/** \class MultiStartOptimizerv4OptimizeStartsThreader
+ * \brief Optimize the starts of a MultiStartOptimizerv4 concurrently.
+ *
+ * Before the threads are started, the associate sets up one metric and
+ * local optimizer per thread.
+ * \ingroup ITKOptimizersv4
+ */
+class MultiStartOptimizerv4OptimizeStartsThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, MultiStartOptimizerv4 >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MultiStartOptimizerv4OptimizeStartsThreader                                  Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, MultiStartOptimizerv4 > Superclass;
+  typedef SmartPointer< Self >                                                         Pointer;
+  typedef SmartPointer< const Self >                                                   ConstPointer;
+
+  itkTypeMacro( MultiStartOptimizerv4OptimizeStartsThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef Superclass::DomainType    DomainType;
+  typedef Superclass::AssociateType AssociateType;
+  typedef DomainType                IndexRangeType;
+
+protected:
+  virtual void BeforeThreadedExecution();
+
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId );
+
+  MultiStartOptimizerv4OptimizeStartsThreader() {}
+  virtual ~MultiStartOptimizerv4OptimizeStartsThreader() {}
+
+private:
+  MultiStartOptimizerv4OptimizeStartsThreader( const Self & ); // purposely not implemented
+  void operator=( const Self & ); // purposely not implemented
+};
+
+} // end namespace itk
+
+#endif
@@ -64,6 +64,10 @@ public:
   /** Run-time type information (and related methods). */
   itkTypeMacro(ObjectToObjectMetric, SingleValuedCostFunctionv4);
 
+  /** Define the Clone method. Derived classes that can be cloned override
+   * InternalClone to set up the new metric like this one. */
+  itkCloneMacro(Self);
+
   /** Type used for representing object components  */
   typedef Superclass::ParametersValueType CoordinateRepresentationType;
 
@@ -150,6 +154,9 @@ protected:
 
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Create a metric of the same type, with the same gradient source. */
+  virtual LightObject::Pointer InternalClone() const;
+
   GradientSourceType       m_GradientSource;
 
 private:
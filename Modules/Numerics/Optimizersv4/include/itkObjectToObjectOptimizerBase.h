@@ -68,6 +68,10 @@ public:
   /** Run-time type information (and related methods). */
   itkTypeMacro(ObjectToObjectOptimizerBase, Object);
 
+  /** Define the Clone method. The clone has the settings of this optimizer,
+   * but no metric. */
+  itkCloneMacro(Self);
+
   /**  Scale type. */
   typedef OptimizerParameters< double >             ScalesType;
 
@@ -144,6 +148,10 @@ protected:
 
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Create an optimizer of the same type, with the same scales and number
+   * of threads. */
+  virtual LightObject::Pointer InternalClone() const;
+
 private:
 
   //purposely not implemented
@@ -184,6 +184,9 @@ protected:
 
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Create an optimizer of the same type, with the same settings. */
+  virtual LightObject::Pointer InternalClone() const;
+
   friend class QuasiNewtonOptimizerv4EstimateNewtonStepThreader;
 
 private:
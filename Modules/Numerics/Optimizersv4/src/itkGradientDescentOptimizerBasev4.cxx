@@ -42,6 +42,21 @@ GradientDescentOptimizerBasev4
 ::~GradientDescentOptimizerBasev4()
 {}
 
+//-------------------------------------------------------------------
+LightObject::Pointer
+GradientDescentOptimizerBasev4
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+  rval->m_NumberOfIterations = this->m_NumberOfIterations;
+  return loPtr;
+}
+
 //-------------------------------------------------------------------
 void
 GradientDescentOptimizerBasev4
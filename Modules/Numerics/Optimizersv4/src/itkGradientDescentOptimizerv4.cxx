@@ -52,6 +52,31 @@ GradientDescentOptimizerv4
 {}
 
 
+/**
+ *InternalClone
+ */
+LightObject::Pointer
+GradientDescentOptimizerv4
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+  rval->m_LearningRate = this->m_LearningRate;
+  rval->m_MaximumStepSizeInPhysicalUnits = this->m_MaximumStepSizeInPhysicalUnits;
+  rval->m_ScalesEstimator = this->m_ScalesEstimator;
+  rval->m_MinimumConvergenceValue = this->m_MinimumConvergenceValue;
+  rval->m_ConvergenceWindowSize = this->m_ConvergenceWindowSize;
+  rval->m_DoEstimateScales = this->m_DoEstimateScales;
+  rval->m_DoEstimateLearningRateAtEachIteration = this->m_DoEstimateLearningRateAtEachIteration;
+  rval->m_DoEstimateLearningRateOnce = this->m_DoEstimateLearningRateOnce;
+  return loPtr;
+}
+
+
 /**
  *PrintSelf
  */
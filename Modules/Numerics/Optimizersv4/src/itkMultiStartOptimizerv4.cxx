@@ -34,6 +34,8 @@ MultiStartOptimizerv4
   this->m_MaximumMetricValue=NumericTraits<MeasureType>::max();
   this->m_MinimumMetricValue = this->m_MaximumMetricValue;
   m_LocalOptimizer = NULL;
+  this->m_NumberOfConcurrentStarts = 1;
+  this->m_OptimizeStartsThreader = MultiStartOptimizerv4OptimizeStartsThreader::New();
 }
 
 //-------------------------------------------------------------------
@@ -51,6 +53,7 @@ MultiStartOptimizerv4
   os << indent << "Current iteration: " << this->m_CurrentIteration << std::endl;
   os << indent << "Stop condition:"<< this->m_StopCondition << std::endl;
   os << indent << "Stop condition description: " << this->m_StopConditionDescription.str()  << std::endl;
+  os << indent << "Number of concurrent starts: " << this->m_NumberOfConcurrentStarts << std::endl;
 }
 
 //-------------------------------------------------------------------
@@ -165,22 +168,47 @@ MultiStartOptimizerv4
   this->InvokeEvent( StartEvent() );
 
   this->m_Stop = false;
+  const bool concurrent = this->m_NumberOfConcurrentStarts > 1;
+  if( concurrent )
+    {
+    this->OptimizeStartsConcurrently();
+    }
   while( ! this->m_Stop )
     {
     /* Compute metric value */
-    try
+    bool startIsValid = true;
+    if( concurrent )
       {
+      /* The start has been optimized already, report its result. Observers
+       * find the metric at the optimized parameters, as in serial runs. */
       this->m_Metric->SetParameters( this->m_ParametersList[ this->m_CurrentIteration ] );
-      if (  this->m_LocalOptimizer )
+      startIsValid = this->m_ConcurrentStartIsValid[ this->m_CurrentIteration ];
+      if( startIsValid )
         {
-        this->m_LocalOptimizer->SetMetric( this->m_Metric );
-        this->m_LocalOptimizer->StartOptimization();
-        this->m_ParametersList[this->m_CurrentIteration] = this->m_Metric->GetParameters();
+        this->m_Value = this->m_ConcurrentMetricValues[ this->m_CurrentIteration ];
+        this->m_MetricValuesList.push_back(this->m_Value);
         }
-      this->m_Value = this->m_Metric->GetValue();
-      this->m_MetricValuesList.push_back(this->m_Value);
       }
-    catch ( ExceptionObject & )
+    else
+      {
+      try
+        {
+        this->m_Metric->SetParameters( this->m_ParametersList[ this->m_CurrentIteration ] );
+        if (  this->m_LocalOptimizer )
+          {
+          this->m_LocalOptimizer->SetMetric( this->m_Metric );
+          this->m_LocalOptimizer->StartOptimization();
+          this->m_ParametersList[this->m_CurrentIteration] = this->m_Metric->GetParameters();
+          }
+        this->m_Value = this->m_Metric->GetValue();
+        this->m_MetricValuesList.push_back(this->m_Value);
+        }
+      catch ( ExceptionObject & )
+        {
+        startIsValid = false;
+        }
+      }
+    if( ! startIsValid )
       {
       /** We simply ignore this exception because it may just be a bad starting point.
        *  We hope that other start points are better.
@@ -217,4 +245,100 @@ MultiStartOptimizerv4
     } //while (!m_Stop)
 }
 
+/**
+ * Optimize the remaining starts concurrently.
+ */
+void
+MultiStartOptimizerv4
+::OptimizeStartsConcurrently()
+{
+  const LocalOptimizerType * localOptimizer =
+    dynamic_cast< const LocalOptimizerType * >( this->m_LocalOptimizer.GetPointer() );
+  if( localOptimizer && localOptimizer->GetScalesEstimator() )
+    {
+    itkExceptionMacro("The local optimizer must not use a scales estimator when "
+                      "starts are optimized concurrently. Set its scales and "
+                      "learning rate instead.");
+    }
+
+  const SizeValueType numberOfStarts = this->m_ParametersList.size();
+  this->m_ConcurrentMetricValues.assign( numberOfStarts, this->m_MaximumMetricValue );
+  this->m_ConcurrentStartIsValid.assign( numberOfStarts, 0 );
+  if( this->m_CurrentIteration >= numberOfStarts )
+    {
+    return;
+    }
+
+  IndexRangeType fullrange;
+  fullrange[0] = this->m_CurrentIteration;
+  fullrange[1] = numberOfStarts - 1; //range is inclusive
+  this->m_OptimizeStartsThreader->SetMaximumNumberOfThreads( this->m_NumberOfConcurrentStarts );
+  this->m_OptimizeStartsThreader->Execute( this, fullrange );
+
+  /* Release the clones and what they computed during initialization. */
+  this->m_ConcurrentMetrics.clear();
+  this->m_ConcurrentLocalOptimizers.clear();
+}
+
+/**
+ * Set up the metric and local optimizer of each thread.
+ */
+void
+MultiStartOptimizerv4
+::InitializeConcurrentStarts( const ThreadIdType numberOfThreads )
+{
+  this->m_ConcurrentMetrics.resize( numberOfThreads );
+  this->m_ConcurrentLocalOptimizers.resize( numberOfThreads );
+  for( ThreadIdType i = 0; i < numberOfThreads; i++ )
+    {
+    MetricTypePointer metric = this->m_Metric->Clone();
+    /* A metric that does not support Clone gives a metric that is not set
+     * up, which usually has another number of parameters. */
+    if( metric.IsNull() ||
+        metric->GetNumberOfParameters() != this->m_Metric->GetNumberOfParameters() )
+      {
+      itkExceptionMacro("The metric " << this->m_Metric->GetNameOfClass()
+                        << " does not support Clone, which is needed to optimize starts concurrently.");
+      }
+    metric->Initialize();
+    this->m_ConcurrentMetrics[i] = metric;
+    if( this->m_LocalOptimizer )
+      {
+      OptimizerPointer localOptimizer = this->m_LocalOptimizer->Clone();
+      localOptimizer->SetMetric( metric );
+      this->m_ConcurrentLocalOptimizers[i] = localOptimizer;
+      }
+    }
+}
+
+/**
+ * Optimize a range of starts, in a thread.
+ */
+void
+MultiStartOptimizerv4
+::OptimizeStartsOverSubRange( const IndexRangeType & subrange, const ThreadIdType threadId )
+{
+  MetricType * metric = this->m_ConcurrentMetrics[threadId];
+  OptimizerType * localOptimizer = this->m_ConcurrentLocalOptimizers[threadId];
+  for( IndexValueType i = subrange[0]; i <= subrange[1]; i++ )
+    {
+    /* Exceptions are reported once all the starts are optimized, in order. */
+    try
+      {
+      metric->SetParameters( this->m_ParametersList[i] );
+      if( localOptimizer )
+        {
+        localOptimizer->StartOptimization();
+        this->m_ParametersList[i] = metric->GetParameters();
+        }
+      this->m_ConcurrentMetricValues[i] = metric->GetValue();
+      this->m_ConcurrentStartIsValid[i] = 1;
+      }
+    catch ( ExceptionObject & )
+      {
+      this->m_ConcurrentStartIsValid[i] = 0;
+      }
+    }
+}
+
 } //namespace itk
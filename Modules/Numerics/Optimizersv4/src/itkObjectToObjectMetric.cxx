@@ -51,6 +51,21 @@ ObjectToObjectMetric
          m_GradientSource == GRADIENT_SOURCE_BOTH;
 }
 
+//-------------------------------------------------------------------
+LightObject::Pointer
+ObjectToObjectMetric
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+  rval->m_GradientSource = this->m_GradientSource;
+  return loPtr;
+}
+
 //-------------------------------------------------------------------
 void
 ObjectToObjectMetric
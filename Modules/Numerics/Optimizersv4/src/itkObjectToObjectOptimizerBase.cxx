@@ -55,6 +55,22 @@ ObjectToObjectOptimizerBase
   m_Metric->Print( os, indent.GetNextIndent() );
 }
 
+//-------------------------------------------------------------------
+LightObject::Pointer
+ObjectToObjectOptimizerBase
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+  rval->m_Scales = this->m_Scales;
+  rval->m_NumberOfThreads = this->m_NumberOfThreads;
+  return loPtr;
+}
+
 //-------------------------------------------------------------------
 void
 ObjectToObjectOptimizerBase
@@ -48,6 +48,21 @@ QuasiNewtonOptimizerv4
   Superclass::PrintSelf(os, indent);
 }
 
+LightObject::Pointer
+QuasiNewtonOptimizerv4
+::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+  rval->m_MaximumIterationsWithoutProgress = this->m_MaximumIterationsWithoutProgress;
+  rval->m_MaximumNewtonStepSizeInPhysicalUnits = this->m_MaximumNewtonStepSizeInPhysicalUnits;
+  return loPtr;
+}
+
 void
 QuasiNewtonOptimizerv4
 ::StartOptimization()
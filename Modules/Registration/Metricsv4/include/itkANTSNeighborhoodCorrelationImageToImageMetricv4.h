@@ -223,6 +223,9 @@ protected:
 
   virtual void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Create a metric with the settings of this one. */
+  virtual typename LightObject::Pointer InternalClone() const;
+
 private:
   ANTSNeighborhoodCorrelationImageToImageMetricv4( const Self & ); //purposely not implemented
   void operator=(const Self &); //purposely not implemented
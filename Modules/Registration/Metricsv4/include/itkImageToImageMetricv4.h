@@ -28,6 +28,7 @@
 #include "itkThreadedImageRegionPartitioner.h"
 #include "itkImageToImageFilter.h"
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include "itkImageToImageMetricv4FixedDomainCache.h"
 #include "itkGradientRecursiveGaussianImageFilter.h"
 #include "itkPointSet.h"
 
@@ -120,12 +121,36 @@ namespace itk
  * \note If the point set is sparse, the option SetUse[Fixed|Moving]ImageGradientFilter
  * typically should be disabled to avoid excessive computation. However,
  * the gradient values of the fixed image are not cached
- * when using a point set (there are plans for this in the future), so
+ * when using a point set unless a fixed domain cache is set (see below), so
  * depending on the number of iterations (when used during optimization)
  * and the level of sparsity, it may be more efficient to
  * use a gradient image filter for it because it will only be
  * calculated once.
  *
+ * Fixed Domain Cache
+ *
+ * An ImageToImageMetricv4FixedDomainCache may be set with
+ * SetFixedDomainCache. \c Initialize then stores in it the fixed side of
+ * every domain point, i.e. the mapped fixed point, the fixed pixel value and
+ * the fixed image gradient, along with the fixed image gradient image and the
+ * virtual sampled point set. The threaders that process points in blocks
+ * read these from the cache instead of computing them at every evaluation,
+ * and later calls to \c Initialize, of this metric or of other metrics
+ * sharing the cache, reuse them as long as the fixed image, fixed
+ * transform, fixed image mask, fixed interpolator, fixed image gradient
+ * settings, sampled point set and virtual domain are unchanged. The results are the same as without the cache.
+ *
+ * Cloning
+ *
+ * \c Clone creates a metric that evaluates like this one, e.g. to optimize
+ * several starts concurrently (see MultiStartOptimizerv4). The clone has its
+ * own copy of the moving transform, and shares the images, the fixed
+ * transform, the interpolators, the masks, the sampled point set, the
+ * gradient calculators, the gradient filters set by the user and the fixed
+ * domain cache of this metric. Settings are copied. The clone must be
+ * initialized. Metrics sharing objects must be initialized one after
+ * another, but may then be evaluated concurrently.
+ *
  * Threading
  *
  * This class is threaded. Threading is handled by friend classes
@@ -163,6 +188,9 @@ namespace itk
  *  The ProcessPoint method of the derived threader must be overriden to
  *  provide the metric-specific evaluation.
  *
+ *  Derived classes with settings of their own must override InternalClone
+ *  to copy them to the clone.
+ *
  *  To access methods and members within the derived metric class from the
  *  derived threader class, the user must cast m_Associate to the type of the
  *  derived metric class.
@@ -385,6 +413,14 @@ public:
    * any given iteration of the optimizer. */
   typedef typename Superclass::NumberOfParametersType   NumberOfParametersType;
 
+  /** Type of the cache of fixed domain data. */
+  typedef ImageToImageMetricv4FixedDomainCache< FixedImageType,
+                                                VirtualImageType,
+                                                CoordinateRepresentationType >
+                                                      FixedDomainCacheType;
+  typedef typename FixedDomainCacheType::Pointer      FixedDomainCachePointer;
+  typedef typename FixedDomainCacheType::KeyType      FixedDomainCacheKeyType;
+
   /* Set/get images */
   /** Connect the Fixed Image.  */
   itkSetConstObjectMacro(FixedImage, FixedImageType);
@@ -509,6 +545,13 @@ public:
   itkGetConstReferenceMacro(UseMovingImageGradientFilter, bool);
   itkBooleanMacro(UseMovingImageGradientFilter);
 
+  /** Set/Get the cache of fixed domain data. The cache may be shared
+   * between metrics. It is filled or reused during \c Initialize. The
+   * default is NULL, for no caching. See ImageToImageMetricv4FixedDomainCache
+   * for details. */
+  itkSetObjectMacro( FixedDomainCache, FixedDomainCacheType );
+  itkGetObjectMacro( FixedDomainCache, FixedDomainCacheType );
+
   /** Get number of threads to used in the the \c GetValueAndDerivative
    * calculation.  Only valid after \c GetValueAndDerivative has been called. */
   ThreadIdType GetNumberOfThreadsUsed() const;
@@ -712,6 +755,20 @@ protected:
    * more than once.*/
   virtual void GetValueAndDerivativeExecute() const;
 
+  /** Compute the key that identifies the fixed domain data of the current
+   * settings in a FixedDomainCache. */
+  virtual FixedDomainCacheKeyType ComputeFixedDomainCacheKey() const;
+
+  /** Compute the fixed side of every domain point and store it, with the
+   * fixed image gradient image and virtual sampled point set, in
+   * \c m_FixedDomainCache. Called by \c Initialize when the cache does not
+   * hold the data of the current settings. */
+  virtual void FillFixedDomainCache();
+
+  /** Get the fixed domain cache if it holds the data of the settings of the
+   * last call to \c Initialize, and NULL otherwise. Used by the threaders. */
+  const FixedDomainCacheType * GetValidFixedDomainCache() const;
+
   /** Initialize the default image gradient filters. This must only
    * be called once the fixed and moving images have been set. */
   virtual void InitializeDefaultFixedImageGradientFilter(void);
@@ -753,6 +810,11 @@ protected:
   FixedImageGradientCalculatorPointer   m_FixedImageGradientCalculator;
   MovingImageGradientCalculatorPointer  m_MovingImageGradientCalculator;
 
+  /** Cache of fixed domain data, and the key of the settings of the last
+   * call to \c Initialize. */
+  FixedDomainCachePointer               m_FixedDomainCache;
+  FixedDomainCacheKeyType               m_FixedDomainCacheKey;
+
   /** Derivative results holder. User a raw pointer so we can point it
    * to a user-provided object. This enables
    * safely sharing a derivative object between metrics during multi-variate
@@ -786,6 +848,10 @@ protected:
 
   void PrintSelf(std::ostream& os, Indent indent) const;
 
+  /** Create a metric that evaluates like this one. See the main
+   * documentation. */
+  virtual typename LightObject::Pointer InternalClone() const;
+
   /** Verify that virtual domain and displacement field are the same size
    * and in the same physical space. */
   virtual void VerifyDisplacementFieldSizeAndPhysicalSpace();
@@ -25,6 +25,9 @@
 #include "itkLinearInterpolateImageFunction.h"
 #include "itkIdentityTransform.h"
 #include "itkCentralDifferenceImageFunction.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageAlgorithm.h"
+#include <typeinfo>
 
 namespace itk
 {
@@ -156,14 +159,6 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
       this->m_FixedImage->GetRequestedRegion() );
     }
 
-  /* Map the fixed samples into the virtual domain and store in
-   * a searpate point set. */
-  this->m_NumberOfSkippedFixedSampledPoints = 0;
-  if( this->m_UseFixedSampledPointSet )
-    {
-    this->MapFixedSampledPointSetToVirtual();
-    }
-
   /* Special checks for when the moving transform is dense/high-dimensional */
   if( this->m_MovingTransform->HasLocalSupport() )
     {
@@ -205,6 +200,39 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     this->m_MovingImageGradientCalculator->SetInputImage(this->m_MovingImage);
     }
 
+  /* Check whether the fixed domain cache holds the data of the current
+   * settings. This is done once the interpolators and gradient calculators
+   * have their input, and the gradient filter input is set first, since
+   * setting their input modifies them. */
+  bool fixedDomainIsCached = false;
+  if( this->m_FixedDomainCache.IsNotNull() )
+    {
+    if( this->m_UseFixedImageGradientFilter )
+      {
+      this->m_FixedImageGradientFilter->SetInput( this->m_FixedImage );
+      }
+    this->m_FixedDomainCacheKey = this->ComputeFixedDomainCacheKey();
+    fixedDomainIsCached = this->m_FixedDomainCache->IsValidFor( this->m_FixedDomainCacheKey );
+    itkDebugMacro("Initialize: fixed domain cache is valid: " << fixedDomainIsCached);
+    }
+
+  /* Map the fixed samples into the virtual domain and store in
+   * a searpate point set. */
+  this->m_NumberOfSkippedFixedSampledPoints = 0;
+  if( this->m_UseFixedSampledPointSet )
+    {
+    if( fixedDomainIsCached )
+      {
+      this->m_VirtualSampledPointSet = this->m_FixedDomainCache->GetVirtualSampledPointSet();
+      this->m_NumberOfSkippedFixedSampledPoints =
+        this->m_FixedDomainCache->GetNumberOfSkippedFixedSampledPoints();
+      }
+    else
+      {
+      this->MapFixedSampledPointSetToVirtual();
+      }
+    }
+
   /* Initialize default gradient image filters. */
   itkDebugMacro("InitializeDefaultFixedImageGradientFilter");
   this->InitializeDefaultFixedImageGradientFilter();
@@ -217,8 +245,16 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
    * optimized. */
   if ( this->m_UseFixedImageGradientFilter )
     {
-    itkDebugMacro("Initialize: ComputeFixedImageGradientFilterImage");
-    this->ComputeFixedImageGradientFilterImage();
+    if( fixedDomainIsCached )
+      {
+      this->m_FixedImageGradientImage = this->m_FixedDomainCache->GetFixedImageGradientImage();
+      this->m_FixedImageGradientInterpolator->SetInputImage( this->m_FixedImageGradientImage );
+      }
+    else
+      {
+      itkDebugMacro("Initialize: ComputeFixedImageGradientFilterImage");
+      this->ComputeFixedImageGradientFilterImage();
+      }
     }
 
   /* Compute gradient image for moving image. Needed now for
@@ -229,6 +265,195 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     itkDebugMacro("Initialize: ComputeMovingImageGradientFilterImage");
     this->ComputeMovingImageGradientFilterImage();
     }
+
+  /* Fill the fixed domain cache, once everything it is computed from is
+   * set up. */
+  if( this->m_FixedDomainCache.IsNotNull() && ! fixedDomainIsCached )
+    {
+    itkDebugMacro("Initialize: FillFixedDomainCache");
+    this->FillFixedDomainCache();
+    }
+}
+
+template<class TFixedImage,class TMovingImage,class TVirtualImage>
+typename ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >::FixedDomainCacheKeyType
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+::ComputeFixedDomainCacheKey() const
+{
+  FixedDomainCacheKeyType key;
+
+  key.FixedImage = this->m_FixedImage.GetPointer();
+  key.FixedImageMTime = this->m_FixedImage->GetMTime();
+
+  /* The default identity transform and linear interpolator give the same
+   * results whatever the instance. */
+  typedef IdentityTransform< CoordinateRepresentationType,
+                             itkGetStaticConstMacro( FixedImageDimension ) >
+                                                    FixedIdentityTransformType;
+  if( typeid( *this->m_FixedTransform ) != typeid( FixedIdentityTransformType ) )
+    {
+    key.FixedTransform = this->m_FixedTransform.GetPointer();
+    key.FixedTransformMTime = this->m_FixedTransform->GetMTime();
+    }
+  typedef LinearInterpolateImageFunction< FixedImageType,
+                                          CoordinateRepresentationType >
+                                                    FixedLinearInterpolatorType;
+  if( typeid( *this->m_FixedInterpolator ) != typeid( FixedLinearInterpolatorType ) )
+    {
+    key.FixedInterpolator = this->m_FixedInterpolator.GetPointer();
+    key.FixedInterpolatorMTime = this->m_FixedInterpolator->GetMTime();
+    }
+
+  if( this->m_FixedImageMask.IsNotNull() )
+    {
+    key.FixedImageMask = this->m_FixedImageMask.GetPointer();
+    key.FixedImageMaskMTime = this->m_FixedImageMask->GetMTime();
+    }
+
+  key.UseFixedSampledPointSet = this->m_UseFixedSampledPointSet;
+  if( this->m_UseFixedSampledPointSet )
+    {
+    key.FixedSampledPointSet = this->m_FixedSampledPointSet.GetPointer();
+    key.FixedSampledPointSetMTime = this->m_FixedSampledPointSet->GetMTime();
+    }
+
+  /* The default gradient filter is set up from the fixed image alone. The
+   * gradient calculator only matters when fixed gradients are used. */
+  key.UseFixedImageGradientFilter = this->m_UseFixedImageGradientFilter;
+  key.HasFixedImageGradients = this->GetGradientSourceIncludesFixed();
+  if( this->m_UseFixedImageGradientFilter )
+    {
+    if( this->m_FixedImageGradientFilter != this->m_DefaultFixedImageGradientFilter )
+      {
+      key.FixedImageGradientSource = this->m_FixedImageGradientFilter.GetPointer();
+      key.FixedImageGradientSourceMTime = this->m_FixedImageGradientFilter->GetMTime();
+      }
+    }
+  else if( key.HasFixedImageGradients )
+    {
+    key.FixedImageGradientSource = this->m_FixedImageGradientCalculator.GetPointer();
+    key.FixedImageGradientSourceMTime = this->m_FixedImageGradientCalculator->GetMTime();
+    }
+
+  key.VirtualDomainRegion = this->GetVirtualDomainRegion();
+  key.VirtualDomainOrigin = this->GetVirtualDomainOrigin();
+  key.VirtualDomainSpacing = this->GetVirtualDomainSpacing();
+  key.VirtualDomainDirection = this->GetVirtualDomainDirection();
+
+  return key;
+}
+
+template<class TFixedImage,class TMovingImage,class TVirtualImage>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+::FillFixedDomainCache()
+{
+  FixedDomainCacheType * cache = this->m_FixedDomainCache;
+  const FixedDomainCacheKeyType & key = this->m_FixedDomainCacheKey;
+  const SizeValueType numberOfPoints = this->GetNumberOfDomainPoints();
+  cache->Allocate( key, numberOfPoints );
+
+  if( this->m_UseFixedImageGradientFilter )
+    {
+    /* Share a copy of the gradient image, so that later updates of the
+     * filter do not overwrite it. Disconnecting the filter output instead
+     * would modify a user filter, and so invalidate the key of the cache. */
+    typename FixedImageGradientImageType::Pointer gradientImage = FixedImageGradientImageType::New();
+    gradientImage->CopyInformation( this->m_FixedImageGradientImage );
+    gradientImage->SetRegions( this->m_FixedImageGradientImage->GetBufferedRegion() );
+    gradientImage->Allocate();
+    ImageAlgorithm::Copy( this->m_FixedImageGradientImage.GetPointer(), gradientImage.GetPointer(),
+                          gradientImage->GetBufferedRegion(), gradientImage->GetBufferedRegion() );
+    this->m_FixedImageGradientImage = gradientImage;
+    this->m_FixedImageGradientInterpolator->SetInputImage( this->m_FixedImageGradientImage );
+    cache->SetFixedImageGradientImage( this->m_FixedImageGradientImage );
+    }
+  if( this->m_UseFixedSampledPointSet )
+    {
+    cache->SetVirtualSampledPointSet( this->m_VirtualSampledPointSet );
+    cache->SetNumberOfSkippedFixedSampledPoints( this->m_NumberOfSkippedFixedSampledPoints );
+    }
+
+  /* Compute the points in blocks, the way the threaders do, so that the
+   * cached data are the same as the data they compute. */
+  typedef typename FixedInterpolatorType::OutputType FixedInterpolatorOutputType;
+  const SizeValueType blockSize = 256;
+  std::vector< VirtualPointType >                     virtualPoints( blockSize );
+  std::vector< SizeValueType >                        offsets( blockSize );
+  std::vector< FixedOutputPointType >                 mappedFixedPoints( blockSize );
+  std::vector< FixedInterpolatorOutputType >          fixedPixelValues( blockSize );
+  FixedImageGradientType                              fixedImageGradient;
+
+  typedef ImageRegionConstIteratorWithIndex< VirtualImageType > IteratorType;
+  IteratorType it( this->m_VirtualDomainImage, this->GetVirtualDomainRegion() );
+  it.GoToBegin();
+
+  SizeValueType offset = 0;
+  while( offset < numberOfPoints )
+    {
+    const SizeValueType numberOfBlockPoints = std::min( blockSize, numberOfPoints - offset );
+    for( SizeValueType i = 0; i < numberOfBlockPoints; i++ )
+      {
+      if( this->m_UseFixedSampledPointSet )
+        {
+        virtualPoints[i] = this->m_VirtualSampledPointSet->GetPoint( offset + i );
+        this->m_VirtualDomainImage->TransformPhysicalPointToIndex( virtualPoints[i], cache->GetVirtualIndices()[offset + i] );
+        }
+      else
+        {
+        this->m_VirtualDomainImage->TransformIndexToPhysicalPoint( it.GetIndex(), virtualPoints[i] );
+        ++it;
+        }
+      }
+
+    this->m_FixedTransform->TransformPoints( &virtualPoints[0], &mappedFixedPoints[0], numberOfBlockPoints );
+
+    SizeValueType numberOfValidPoints = 0;
+    for( SizeValueType i = 0; i < numberOfBlockPoints; i++ )
+      {
+      if( ( this->m_FixedImageMask && ! this->m_FixedImageMask->IsInside( mappedFixedPoints[i] ) )
+          || ! this->m_FixedInterpolator->IsInsideBuffer( mappedFixedPoints[i] ) )
+        {
+        continue;
+        }
+      offsets[numberOfValidPoints] = offset + i;
+      mappedFixedPoints[numberOfValidPoints] = mappedFixedPoints[i];
+      numberOfValidPoints++;
+      }
+
+    if( numberOfValidPoints > 0 )
+      {
+      this->m_FixedInterpolator->EvaluatePoints( &mappedFixedPoints[0], &fixedPixelValues[0], numberOfValidPoints );
+      for( SizeValueType j = 0; j < numberOfValidPoints; j++ )
+        {
+        const SizeValueType pointOffset = offsets[j];
+        cache->GetValidPoints()[pointOffset] = 1;
+        cache->GetMappedFixedPoints()[pointOffset] = mappedFixedPoints[j];
+        cache->GetFixedPixelValues()[pointOffset] = fixedPixelValues[j];
+        if( key.HasFixedImageGradients )
+          {
+          this->ComputeFixedImageGradientAtPoint( mappedFixedPoints[j], fixedImageGradient );
+          cache->GetFixedImageGradients()[pointOffset] = fixedImageGradient;
+          }
+        }
+      }
+    offset += numberOfBlockPoints;
+    }
+
+  cache->SetFilled();
+}
+
+template<class TFixedImage,class TMovingImage,class TVirtualImage>
+const typename ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >::FixedDomainCacheType *
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+::GetValidFixedDomainCache() const
+{
+  if( this->m_FixedDomainCache.IsNotNull()
+      && this->m_FixedDomainCache->IsValidFor( this->m_FixedDomainCacheKey ) )
+    {
+    return this->m_FixedDomainCache.GetPointer();
+    }
+  return NULL;
 }
 
 template<class TFixedImage,class TMovingImage,class TVirtualImage>
@@ -949,6 +1174,60 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
   return true;
 }
 
+template<class TFixedImage,class TMovingImage,class TVirtualImage>
+typename LightObject::Pointer
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
+::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+
+  /* Objects that are only read while evaluating are shared. */
+  rval->m_FixedImage = this->m_FixedImage;
+  rval->m_MovingImage = this->m_MovingImage;
+  if( this->m_UserHasProvidedVirtualDomainImage )
+    {
+    rval->SetVirtualDomainImage( this->m_VirtualDomainImage );
+    }
+  rval->m_FixedTransform = this->m_FixedTransform;
+  rval->m_FixedInterpolator = this->m_FixedInterpolator;
+  rval->m_MovingInterpolator = this->m_MovingInterpolator;
+  rval->m_FixedImageGradientCalculator = this->m_FixedImageGradientCalculator;
+  rval->m_MovingImageGradientCalculator = this->m_MovingImageGradientCalculator;
+  rval->m_FixedImageMask = this->m_FixedImageMask;
+  rval->m_MovingImageMask = this->m_MovingImageMask;
+  rval->m_FixedSampledPointSet = this->m_FixedSampledPointSet;
+  rval->m_FixedDomainCache = this->m_FixedDomainCache;
+
+  /* The default gradient filters are set up by Initialize, so the clone
+   * uses its own. The gradient interpolators are set to the gradient images
+   * of each metric. */
+  if( this->m_FixedImageGradientFilter != this->m_DefaultFixedImageGradientFilter )
+    {
+    rval->m_FixedImageGradientFilter = this->m_FixedImageGradientFilter;
+    }
+  if( this->m_MovingImageGradientFilter != this->m_DefaultMovingImageGradientFilter )
+    {
+    rval->m_MovingImageGradientFilter = this->m_MovingImageGradientFilter;
+    }
+
+  /* The moving transform is optimized, so the clone has its own. */
+  rval->m_MovingTransform = this->m_MovingTransform->Clone();
+
+  rval->m_UseFixedImageGradientFilter = this->m_UseFixedImageGradientFilter;
+  rval->m_UseMovingImageGradientFilter = this->m_UseMovingImageGradientFilter;
+  rval->m_UseFixedSampledPointSet = this->m_UseFixedSampledPointSet;
+  rval->m_FloatingPointCorrectionResolution = this->m_FloatingPointCorrectionResolution;
+  rval->m_HaveMadeGetValueWarning = this->m_HaveMadeGetValueWarning;
+  rval->SetMaximumNumberOfThreads( this->GetMaximumNumberOfThreads() );
+
+  return loPtr;
+}
+
 template<class TFixedImage,class TMovingImage,class TVirtualImage>
 void
 ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
@@ -1023,6 +1302,14 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage >
     {
     os << indent << "MovingImageMask is NULL." << std::endl;
     }
+  if( this->m_FixedDomainCache.IsNotNull() )
+    {
+    os << indent << "FixedDomainCache: " << this->m_FixedDomainCache.GetPointer() << std::endl;
+    }
+  else
+    {
+    os << indent << "FixedDomainCache is NULL." << std::endl;
+    }
 }
 
 }//namespace itk
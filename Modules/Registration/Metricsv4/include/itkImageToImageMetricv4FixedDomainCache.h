@@ -0,0 +1,273 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageToImageMetricv4FixedDomainCache_h
+#define __itkImageToImageMetricv4FixedDomainCache_h
+
+#include "itkImage.h"
+#include "itkPointSet.h"
+#include "itkCovariantVector.h"
+#include <vector>
+
+namespace itk
+{
+
+/** \class ImageToImageMetricv4FixedDomainCache
+ * \brief Holds the fixed image data that ImageToImageMetricv4 computes over
+ * its virtual domain, so that it can be reused by later calls to
+ * \c Initialize and shared between metrics.
+ *
+ * Nothing on the fixed side of an ImageToImageMetricv4 changes while the
+ * moving transform is optimized: each point of the virtual domain always maps
+ * to the same fixed point, with the same fixed pixel value and fixed image
+ * gradient. The metric fills this cache during \c Initialize, and its
+ * threaders then read the fixed side of each point from the cache instead of
+ * transforming and interpolating it at every evaluation. The cache holds, in
+ * the order of the domain points (the buffer order of the virtual domain for
+ * dense sampling, the point identifiers of the virtual sampled point set for
+ * sparse sampling):
+ *  - whether the point maps inside the fixed image mask and buffer,
+ *  - the mapped fixed point and the fixed pixel value,
+ *  - the fixed image gradient, when the metric uses fixed image gradients,
+ *  - the virtual index, for sparse sampling,
+ * and, for the whole domain, the fixed image gradient image and the fixed
+ * sampled point set mapped to the virtual domain.
+ *
+ * The data are stored with a key that identifies the fixed image, fixed
+ * transform, fixed image mask, fixed interpolator, fixed image gradient
+ * filter or calculator, sampled point set and virtual domain they were
+ * computed from, by pointer and modification time. A metric reuses the
+ * cache only when the key of its current settings is equal to the stored
+ * one, and otherwise fills it again. Metrics of any moving image type may
+ * share a cache, e.g. the metrics of the starts of a multi-start
+ * optimization, or of successive registrations of the same fixed image.
+ * The default identity fixed transform, linear fixed interpolator and fixed
+ * image gradient filter of a metric are identified by their type, so that
+ * metrics with the default settings share the cache too.
+ *
+ * \warning The cache holds one entry: metrics with different fixed images or
+ * virtual domains, e.g. at different levels of a multi-resolution
+ * registration, each need their own cache to avoid filling it in turn.
+ * \warning For dense sampling the cache stores about
+ * 16 * FixedImageDimension + 9 bytes per virtual domain point, e.g. 57 bytes
+ * per point for 3D images.
+ * \warning The cache is filled during \c Initialize. Metrics sharing a cache
+ * must not be initialized at the same time from different threads, but they
+ * may be evaluated concurrently.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template< class TFixedImage, class TVirtualImage, class TCoordRep = double >
+class ITK_EXPORT ImageToImageMetricv4FixedDomainCache : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef ImageToImageMetricv4FixedDomainCache Self;
+  typedef Object                               Superclass;
+  typedef SmartPointer< Self >                 Pointer;
+  typedef SmartPointer< const Self >           ConstPointer;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro( ImageToImageMetricv4FixedDomainCache, Object );
+
+  itkStaticConstMacro( FixedImageDimension, unsigned int, TFixedImage::ImageDimension );
+  itkStaticConstMacro( VirtualImageDimension, unsigned int, TVirtualImage::ImageDimension );
+
+  typedef TFixedImage                                                        FixedImageType;
+  typedef TVirtualImage                                                      VirtualImageType;
+  typedef TCoordRep                                                          CoordinateRepresentationType;
+  typedef typename NumericTraits< typename FixedImageType::PixelType >::RealType
+                                                                             FixedRealType;
+  typedef Point< CoordinateRepresentationType, FixedImageDimension >         FixedPointType;
+  typedef CovariantVector< CoordinateRepresentationType, FixedImageDimension >
+                                                                             FixedImageGradientType;
+  typedef Image< CovariantVector< FixedRealType, FixedImageDimension >, FixedImageDimension >
+                                                                             FixedImageGradientImageType;
+  typedef typename VirtualImageType::IndexType                               VirtualIndexType;
+  typedef typename VirtualImageType::RegionType                              VirtualRegionType;
+  typedef typename VirtualImageType::PointType                               VirtualOriginType;
+  typedef typename VirtualImageType::SpacingType                             VirtualSpacingType;
+  typedef typename VirtualImageType::DirectionType                           VirtualDirectionType;
+  typedef PointSet< typename VirtualImageType::PixelType, VirtualImageDimension >
+                                                                             VirtualSampledPointSetType;
+
+  /** Per-point containers, indexed by the position of the point in the
+   * domain. */
+  typedef std::vector< unsigned char >          ValidContainerType;
+  typedef std::vector< FixedPointType >         FixedPointContainerType;
+  typedef std::vector< FixedRealType >          FixedPixelValueContainerType;
+  typedef std::vector< FixedImageGradientType > FixedImageGradientContainerType;
+  typedef std::vector< VirtualIndexType >       VirtualIndexContainerType;
+
+  /** Identifies what the cached data were computed from. Objects that a
+   * metric uses with their default settings are identified by a NULL
+   * pointer. */
+  struct KeyType
+    {
+    KeyType();
+    bool operator==( const KeyType & other ) const;
+    bool operator!=( const KeyType & other ) const
+      {
+      return !( *this == other );
+      }
+
+    const Object *       FixedImage;
+    unsigned long        FixedImageMTime;
+    const Object *       FixedTransform;
+    unsigned long        FixedTransformMTime;
+    const Object *       FixedImageMask;
+    unsigned long        FixedImageMaskMTime;
+    const Object *       FixedInterpolator;
+    unsigned long        FixedInterpolatorMTime;
+    const Object *       FixedImageGradientSource;
+    unsigned long        FixedImageGradientSourceMTime;
+    const Object *       FixedSampledPointSet;
+    unsigned long        FixedSampledPointSetMTime;
+    bool                 UseFixedSampledPointSet;
+    bool                 UseFixedImageGradientFilter;
+    bool                 HasFixedImageGradients;
+    VirtualRegionType    VirtualDomainRegion;
+    VirtualOriginType    VirtualDomainOrigin;
+    VirtualSpacingType   VirtualDomainSpacing;
+    VirtualDirectionType VirtualDomainDirection;
+    };
+
+  /** Whether the cache holds data computed for \c key. */
+  bool IsValidFor( const KeyType & key ) const
+    {
+    return this->m_IsFilled && this->m_Key == key;
+    }
+
+  /** Discard the cached data and allocate the per-point containers for
+   * \c numberOfPoints points computed for \c key. The cache is only valid
+   * for \c key once \c SetFilled has been called. */
+  void Allocate( const KeyType & key, const SizeValueType numberOfPoints );
+
+  /** Mark the cache as filled, once every point has been computed. */
+  void SetFilled();
+
+  /** Discard the cached data and release its memory. */
+  void Clear();
+
+  /** Get the key of the cached data. */
+  const KeyType & GetKey() const
+    {
+    return this->m_Key;
+    }
+
+  /** Get the number of domain points. */
+  SizeValueType GetNumberOfPoints() const
+    {
+    return this->m_NumberOfPoints;
+    }
+
+  /** Per-point data. */
+  ValidContainerType & GetValidPoints()
+    {
+    return this->m_ValidPoints;
+    }
+  const ValidContainerType & GetValidPoints() const
+    {
+    return this->m_ValidPoints;
+    }
+  FixedPointContainerType & GetMappedFixedPoints()
+    {
+    return this->m_MappedFixedPoints;
+    }
+  const FixedPointContainerType & GetMappedFixedPoints() const
+    {
+    return this->m_MappedFixedPoints;
+    }
+  FixedPixelValueContainerType & GetFixedPixelValues()
+    {
+    return this->m_FixedPixelValues;
+    }
+  const FixedPixelValueContainerType & GetFixedPixelValues() const
+    {
+    return this->m_FixedPixelValues;
+    }
+  FixedImageGradientContainerType & GetFixedImageGradients()
+    {
+    return this->m_FixedImageGradients;
+    }
+  const FixedImageGradientContainerType & GetFixedImageGradients() const
+    {
+    return this->m_FixedImageGradients;
+    }
+  VirtualIndexContainerType & GetVirtualIndices()
+    {
+    return this->m_VirtualIndices;
+    }
+  const VirtualIndexContainerType & GetVirtualIndices() const
+    {
+    return this->m_VirtualIndices;
+    }
+
+  /** Set/Get the fixed image gradient image, when computed by a filter. */
+  itkSetObjectMacro( FixedImageGradientImage, FixedImageGradientImageType );
+  itkGetObjectMacro( FixedImageGradientImage, FixedImageGradientImageType );
+
+  /** Set/Get the fixed sampled point set mapped to the virtual domain, for
+   * sparse sampling. */
+  itkSetObjectMacro( VirtualSampledPointSet, VirtualSampledPointSetType );
+  itkGetObjectMacro( VirtualSampledPointSet, VirtualSampledPointSetType );
+
+  /** Set/Get the number of fixed sampled points that were not mapped inside
+   * the virtual domain. */
+  itkSetMacro( NumberOfSkippedFixedSampledPoints, SizeValueType );
+  itkGetConstMacro( NumberOfSkippedFixedSampledPoints, SizeValueType );
+
+  /** Get the number of times the cache has been filled. For informational
+   * purposes. */
+  itkGetConstMacro( NumberOfFills, SizeValueType );
+
+protected:
+  ImageToImageMetricv4FixedDomainCache();
+  virtual ~ImageToImageMetricv4FixedDomainCache() {}
+
+  void PrintSelf( std::ostream & os, Indent indent ) const;
+
+private:
+  ImageToImageMetricv4FixedDomainCache( const Self & ); //purposely not implemented
+  void operator=( const Self & ); //purposely not implemented
+
+  KeyType       m_Key;
+  bool          m_IsFilled;
+  SizeValueType m_NumberOfPoints;
+  SizeValueType m_NumberOfFills;
+
+  ValidContainerType              m_ValidPoints;
+  FixedPointContainerType         m_MappedFixedPoints;
+  FixedPixelValueContainerType    m_FixedPixelValues;
+  FixedImageGradientContainerType m_FixedImageGradients;
+  VirtualIndexContainerType       m_VirtualIndices;
+
+  typename FixedImageGradientImageType::Pointer m_FixedImageGradientImage;
+  typename VirtualSampledPointSetType::Pointer  m_VirtualSampledPointSet;
+  SizeValueType                                 m_NumberOfSkippedFixedSampledPoints;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkImageToImageMetricv4FixedDomainCache.hxx"
+#endif
+
+#endif
@@ -0,0 +1,166 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkImageToImageMetricv4FixedDomainCache_hxx
+#define __itkImageToImageMetricv4FixedDomainCache_hxx
+
+#include "itkImageToImageMetricv4FixedDomainCache.h"
+
+namespace itk
+{
+
+template< class TFixedImage, class TVirtualImage, class TCoordRep >
+ImageToImageMetricv4FixedDomainCache< TFixedImage, TVirtualImage, TCoordRep >
+::KeyType::KeyType() :
+  FixedImage( NULL ),
+  FixedImageMTime( 0 ),
+  FixedTransform( NULL ),
+  FixedTransformMTime( 0 ),
+  FixedImageMask( NULL ),
+  FixedImageMaskMTime( 0 ),
+  FixedInterpolator( NULL ),
+  FixedInterpolatorMTime( 0 ),
+  FixedImageGradientSource( NULL ),
+  FixedImageGradientSourceMTime( 0 ),
+  FixedSampledPointSet( NULL ),
+  FixedSampledPointSetMTime( 0 ),
+  UseFixedSampledPointSet( false ),
+  UseFixedImageGradientFilter( false ),
+  HasFixedImageGradients( false )
+{
+  this->VirtualDomainOrigin.Fill( 0.0 );
+  this->VirtualDomainSpacing.Fill( 1.0 );
+  this->VirtualDomainDirection.SetIdentity();
+}
+
+template< class TFixedImage, class TVirtualImage, class TCoordRep >
+bool
+ImageToImageMetricv4FixedDomainCache< TFixedImage, TVirtualImage, TCoordRep >
+::KeyType::operator==( const KeyType & other ) const
+{
+  return this->FixedImage == other.FixedImage
+    && this->FixedImageMTime == other.FixedImageMTime
+    && this->FixedTransform == other.FixedTransform
+    && this->FixedTransformMTime == other.FixedTransformMTime
+    && this->FixedImageMask == other.FixedImageMask
+    && this->FixedImageMaskMTime == other.FixedImageMaskMTime
+    && this->FixedInterpolator == other.FixedInterpolator
+    && this->FixedInterpolatorMTime == other.FixedInterpolatorMTime
+    && this->FixedImageGradientSource == other.FixedImageGradientSource
+    && this->FixedImageGradientSourceMTime == other.FixedImageGradientSourceMTime
+    && this->FixedSampledPointSet == other.FixedSampledPointSet
+    && this->FixedSampledPointSetMTime == other.FixedSampledPointSetMTime
+    && this->UseFixedSampledPointSet == other.UseFixedSampledPointSet
+    && this->UseFixedImageGradientFilter == other.UseFixedImageGradientFilter
+    && this->HasFixedImageGradients == other.HasFixedImageGradients
+    && this->VirtualDomainRegion == other.VirtualDomainRegion
+    && this->VirtualDomainOrigin == other.VirtualDomainOrigin
+    && this->VirtualDomainSpacing == other.VirtualDomainSpacing
+    && this->VirtualDomainDirection == other.VirtualDomainDirection;
+}
+
+template< class TFixedImage, class TVirtualImage, class TCoordRep >
+ImageToImageMetricv4FixedDomainCache< TFixedImage, TVirtualImage, TCoordRep >
+::ImageToImageMetricv4FixedDomainCache() :
+  m_IsFilled( false ),
+  m_NumberOfPoints( 0 ),
+  m_NumberOfFills( 0 ),
+  m_NumberOfSkippedFixedSampledPoints( 0 )
+{
+}
+
+template< class TFixedImage, class TVirtualImage, class TCoordRep >
+void
+ImageToImageMetricv4FixedDomainCache< TFixedImage, TVirtualImage, TCoordRep >
+::Allocate( const KeyType & key, const SizeValueType numberOfPoints )
+{
+  this->m_IsFilled = false;
+  this->m_Key = key;
+  this->m_NumberOfPoints = numberOfPoints;
+  this->m_ValidPoints.assign( numberOfPoints, 0 );
+  this->m_MappedFixedPoints.resize( numberOfPoints );
+  this->m_FixedPixelValues.resize( numberOfPoints );
+  if( key.HasFixedImageGradients )
+    {
+    this->m_FixedImageGradients.resize( numberOfPoints );
+    }
+  else
+    {
+    FixedImageGradientContainerType().swap( this->m_FixedImageGradients );
+    }
+  if( key.UseFixedSampledPointSet )
+    {
+    this->m_VirtualIndices.resize( numberOfPoints );
+    }
+  else
+    {
+    VirtualIndexContainerType().swap( this->m_VirtualIndices );
+    }
+  this->m_FixedImageGradientImage = NULL;
+  this->m_VirtualSampledPointSet = NULL;
+  this->m_NumberOfSkippedFixedSampledPoints = 0;
+  this->Modified();
+}
+
+template< class TFixedImage, class TVirtualImage, class TCoordRep >
+void
+ImageToImageMetricv4FixedDomainCache< TFixedImage, TVirtualImage, TCoordRep >
+::SetFilled()
+{
+  this->m_IsFilled = true;
+  this->m_NumberOfFills++;
+  this->Modified();
+}
+
+template< class TFixedImage, class TVirtualImage, class TCoordRep >
+void
+ImageToImageMetricv4FixedDomainCache< TFixedImage, TVirtualImage, TCoordRep >
+::Clear()
+{
+  this->m_IsFilled = false;
+  this->m_Key = KeyType();
+  this->m_NumberOfPoints = 0;
+  ValidContainerType().swap( this->m_ValidPoints );
+  FixedPointContainerType().swap( this->m_MappedFixedPoints );
+  FixedPixelValueContainerType().swap( this->m_FixedPixelValues );
+  FixedImageGradientContainerType().swap( this->m_FixedImageGradients );
+  VirtualIndexContainerType().swap( this->m_VirtualIndices );
+  this->m_FixedImageGradientImage = NULL;
+  this->m_VirtualSampledPointSet = NULL;
+  this->m_NumberOfSkippedFixedSampledPoints = 0;
+  this->Modified();
+}
+
+template< class TFixedImage, class TVirtualImage, class TCoordRep >
+void
+ImageToImageMetricv4FixedDomainCache< TFixedImage, TVirtualImage, TCoordRep >
+::PrintSelf( std::ostream & os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "IsFilled: " << this->m_IsFilled << std::endl;
+  os << indent << "NumberOfPoints: " << this->m_NumberOfPoints << std::endl;
+  os << indent << "NumberOfFills: " << this->m_NumberOfFills << std::endl;
+  os << indent << "HasFixedImageGradients: " << this->m_Key.HasFixedImageGradients << std::endl;
+  os << indent << "UseFixedSampledPointSet: " << this->m_Key.UseFixedSampledPointSet << std::endl;
+  os << indent << "NumberOfSkippedFixedSampledPoints: "
+     << this->m_NumberOfSkippedFixedSampledPoints << std::endl;
+  os << indent << "VirtualDomainRegion: " << this->m_Key.VirtualDomainRegion << std::endl;
+}
+
+} // end namespace itk
+
+#endif
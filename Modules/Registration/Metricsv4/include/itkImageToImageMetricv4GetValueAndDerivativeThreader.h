@@ -95,8 +95,8 @@ protected:
   /** Constructor. */
   ImageToImageMetricv4GetValueAndDerivativeThreader() {}
 
-  /** Walk through the given virtual image domain, and call \c ProcessVirtualPoint on every
-   * point. */
+  /** Walk through the given virtual image domain, and call \c ProcessVirtualPoints on
+   * every block of \c PointBlockSize points. */
   virtual void ThreadedExecution( const DomainType & subdomain,
                                   const ThreadIdType threadId );
 
@@ -156,8 +156,8 @@ protected:
   /** Constructor. */
   ImageToImageMetricv4GetValueAndDerivativeThreader() {}
 
-  /** Walk through the given virtual image domain, and call \c ProcessVirtualPoint on every
-   * point. */
+  /** Walk through the given virtual image domain, and call \c ProcessVirtualPoints on
+   * every block of \c PointBlockSize points. */
   virtual void ThreadedExecution( const DomainType & subdomain,
                                   const ThreadIdType threadId );
 
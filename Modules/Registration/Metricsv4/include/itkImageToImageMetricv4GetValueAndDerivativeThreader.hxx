@@ -30,16 +30,32 @@ ImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedImageRegionPartitione
 ::ThreadedExecution ( const DomainType & imageSubRegion,
                       const ThreadIdType threadId )
 {
-  VirtualPointType virtualPoint;
-  VirtualIndexType virtualIndex;
+  /* Gather the points into blocks, processed together by
+   * ProcessVirtualPoints. */
+  std::vector< VirtualPointType > virtualPoints( Superclass::PointBlockSize );
+  std::vector< VirtualIndexType > virtualIndices( Superclass::PointBlockSize );
+  SizeValueType                   numberOfPoints = 0;
+  std::vector< SizeValueType > &  domainOffsets = this->m_PointBlockPerThread[threadId].DomainOffsets;
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualDomainImage();
   typedef ImageRegionConstIteratorWithIndex< VirtualImageType > IteratorType;
   IteratorType it( virtualImage, imageSubRegion );
   for( it.GoToBegin(); !it.IsAtEnd(); ++it )
     {
-    virtualIndex = it.GetIndex();
-    virtualImage->TransformIndexToPhysicalPoint( virtualIndex, virtualPoint );
-    this->ProcessVirtualPoint( virtualIndex, virtualPoint, threadId );
+    virtualIndices[numberOfPoints] = it.GetIndex();
+    virtualImage->TransformIndexToPhysicalPoint( virtualIndices[numberOfPoints], virtualPoints[numberOfPoints] );
+    if( this->m_FixedDomainCache )
+      {
+      domainOffsets[numberOfPoints] = virtualImage->ComputeOffset( virtualIndices[numberOfPoints] );
+      }
+    if( ++numberOfPoints == Superclass::PointBlockSize )
+      {
+      this->ProcessVirtualPoints( &virtualIndices[0], &virtualPoints[0], numberOfPoints, threadId );
+      numberOfPoints = 0;
+      }
+    }
+  if( numberOfPoints > 0 )
+    {
+    this->ProcessVirtualPoints( &virtualIndices[0], &virtualPoints[0], numberOfPoints, threadId );
     }
 }
 
@@ -49,18 +65,38 @@ ImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerParti
 ::ThreadedExecution ( const DomainType & indexSubRange,
                       const ThreadIdType threadId )
 {
-  VirtualPointType virtualPoint;
-  VirtualIndexType virtualIndex;
+  /* Gather the points into blocks, processed together by
+   * ProcessVirtualPoints. */
+  std::vector< VirtualPointType > virtualPoints( Superclass::PointBlockSize );
+  std::vector< VirtualIndexType > virtualIndices( Superclass::PointBlockSize );
+  SizeValueType                   numberOfPoints = 0;
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualDomainImage();
   typename TImageToImageMetricv4::VirtualSampledPointSetType::ConstPointer virtualSampledPointSet = this->m_Associate->GetVirtualSampledPointSet();
   typedef typename TImageToImageMetricv4::VirtualSampledPointSetType::MeshTraits::PointIdentifier ElementIdentifierType;
   const ElementIdentifierType begin = indexSubRange[0];
   const ElementIdentifierType end   = indexSubRange[1];
+  std::vector< SizeValueType > & domainOffsets = this->m_PointBlockPerThread[threadId].DomainOffsets;
   for( ElementIdentifierType i = begin; i <= end; ++i )
     {
-    virtualPoint = virtualSampledPointSet->GetPoint( i );
-    virtualImage->TransformPhysicalPointToIndex( virtualPoint, virtualIndex );
-    this->ProcessVirtualPoint( virtualIndex, virtualPoint, threadId );
+    virtualPoints[numberOfPoints] = virtualSampledPointSet->GetPoint( i );
+    if( this->m_FixedDomainCache )
+      {
+      virtualIndices[numberOfPoints] = this->m_FixedDomainCache->GetVirtualIndices()[i];
+      domainOffsets[numberOfPoints] = i;
+      }
+    else
+      {
+      virtualImage->TransformPhysicalPointToIndex( virtualPoints[numberOfPoints], virtualIndices[numberOfPoints] );
+      }
+    if( ++numberOfPoints == Superclass::PointBlockSize )
+      {
+      this->ProcessVirtualPoints( &virtualIndices[0], &virtualPoints[0], numberOfPoints, threadId );
+      numberOfPoints = 0;
+      }
+    }
+  if( numberOfPoints > 0 )
+    {
+    this->ProcessVirtualPoints( &virtualIndices[0], &virtualPoints[0], numberOfPoints, threadId );
     }
 }
 
@@ -34,9 +34,13 @@ namespace itk
  *  AfterThreadedExecution.
  *
  *  The \c ThreadedExecution in
- *  ImageToImageMetricv4GetValueAndDerivativeThreader calls \c
- *  ProcessVirtualPoint on every point in the virtual image domain.  \c
- *  ProcessVirtualPoint calls \c ProcessPoint on each point.
+ *  ImageToImageMetricv4GetValueAndDerivativeThreader gathers the points of
+ *  the virtual image domain into blocks and calls \c ProcessVirtualPoints on
+ *  each block.  By default \c ProcessVirtualPoints calls
+ *  \c ProcessVirtualPoint on each point of the block.  Threaders that set
+ *  \c m_ProcessVirtualPointsInBlocks instead have each block mapped and
+ *  interpolated at once, before \c ProcessPoint is called on each point
+ *  that maps inside both images.
  *
  * \ingroup ITKMetricsv4 */
 template < class TDomainPartitioner, class TImageToImageMetricv4 >
@@ -148,6 +152,29 @@ protected:
         const ThreadIdType                threadID ) const = 0;
 
 
+  /** Method called by the threaders to process a block of at most
+   * \c PointBlockSize virtual points.  Unless
+   * \c m_ProcessVirtualPointsInBlocks is set, \c ProcessVirtualPoint is
+   * called on each point.  Otherwise the fixed and moving transforms map
+   * the whole block with \c TransformPoints, and the interpolators evaluate
+   * the points that lie inside both images and masks with \c EvaluatePoints.
+   * Their image gradients are computed with the
+   * \c ComputeFixedImageGradientAtPoint and
+   * \c ComputeMovingImageGradientAtPoint methods of the associate.
+   * \c ProcessPoint is then called on each of these points in order, and
+   * the results are accumulated exactly as in \c ProcessVirtualPoint.
+   * When \c m_FixedDomainCache is set, the fixed side of the points is
+   * instead read from the cache, at the domain offsets the threader stores
+   * in the \c DomainOffsets of the block. */
+  virtual void ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                                     const VirtualPointType * virtualPoints,
+                                     const SizeValueType numberOfPoints,
+                                     const ThreadIdType threadId );
+
+  /** Number of virtual points the threaders gather before calling
+   * \c ProcessVirtualPoints. */
+  itkStaticConstMacro(PointBlockSize, SizeValueType, 256);
+
   /** Store derivative result from a single point calculation.
    * \warning If this method is overridden or otherwise not used
    * in a derived class, be sure to *accumulate* results. */
@@ -163,6 +190,34 @@ protected:
    * classes for efficiency. */
   mutable std::vector< JacobianType >                 m_MovingTransformJacobianPerThread;
 
+  /** Per-thread working space of \c ProcessVirtualPoints. */
+  typedef typename ImageToImageMetricv4Type::FixedInterpolatorType::OutputType  FixedInterpolatorOutputType;
+  typedef typename ImageToImageMetricv4Type::MovingInterpolatorType::OutputType MovingInterpolatorOutputType;
+  struct PointBlockType
+    {
+    std::vector< SizeValueType >                        DomainOffsets;
+    std::vector< SizeValueType >                        ValidPoints;
+    std::vector< FixedOutputPointType >                 MappedFixedPoints;
+    std::vector< MovingOutputPointType >                MappedMovingPoints;
+    std::vector< FixedInterpolatorOutputType >          FixedPixelValues;
+    std::vector< MovingInterpolatorOutputType >         MovingPixelValues;
+    std::vector< FixedImageGradientType >               FixedImageGradients;
+    std::vector< MovingImageGradientType >              MovingImageGradients;
+    };
+  mutable std::vector< PointBlockType >               m_PointBlockPerThread;
+
+  /** The fixed domain cache of the associate, when it holds the data of its
+   * current settings, and NULL otherwise. Set in \c BeforeThreadedExecution. */
+  typedef typename ImageToImageMetricv4Type::FixedDomainCacheType FixedDomainCacheType;
+  const FixedDomainCacheType *                        m_FixedDomainCache;
+
+  /** Whether \c ProcessVirtualPoints processes the points as a block rather
+   * than calling \c ProcessVirtualPoint on each of them. False by default.
+   * Threaders that set it in their constructor do not have
+   * \c ProcessVirtualPoint called, so threaders derived from them that
+   * override \c ProcessVirtualPoint must reset it. */
+  bool                                                m_ProcessVirtualPointsInBlocks;
+
 private:
   ImageToImageMetricv4GetValueAndDerivativeThreaderBase( const Self & ); // purposely not implemented
   void operator=( const Self & ); // purposely not implemented
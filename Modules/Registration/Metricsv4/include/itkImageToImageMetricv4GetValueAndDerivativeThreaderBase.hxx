@@ -26,7 +26,9 @@ namespace itk
 
 template< class TDomainPartitioner, class TImageToImageMetricv4 >
 ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
-::ImageToImageMetricv4GetValueAndDerivativeThreaderBase()
+::ImageToImageMetricv4GetValueAndDerivativeThreaderBase() :
+  m_FixedDomainCache( NULL ),
+  m_ProcessVirtualPointsInBlocks( false )
 {
 }
 
@@ -46,6 +48,9 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
   this->m_LocalDerivativesPerThread.resize( this->GetNumberOfThreadsUsed() );
   /* Per-thread pre-allocated Jacobian objects for efficiency */
   this->m_MovingTransformJacobianPerThread.resize( this->GetNumberOfThreadsUsed() );
+  /* Per-thread working space for blocks of points */
+  this->m_PointBlockPerThread.resize( this->GetNumberOfThreadsUsed() );
+  this->m_FixedDomainCache = this->m_Associate->GetValidFixedDomainCache();
 
   /* This size always comes from the moving image */
   const NumberOfParametersType globalDerivativeSize =
@@ -60,6 +65,15 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
     this->m_MovingTransformJacobianPerThread[i].SetSize(
                                           this->m_Associate->VirtualImageDimension,
                                           this->m_Associate->GetNumberOfLocalParameters() );
+    PointBlockType & block = this->m_PointBlockPerThread[i];
+    block.DomainOffsets.resize( PointBlockSize );
+    block.ValidPoints.resize( PointBlockSize );
+    block.MappedFixedPoints.resize( PointBlockSize );
+    block.MappedMovingPoints.resize( PointBlockSize );
+    block.FixedPixelValues.resize( PointBlockSize );
+    block.MovingPixelValues.resize( PointBlockSize );
+    block.FixedImageGradients.resize( PointBlockSize );
+    block.MovingImageGradients.resize( PointBlockSize );
     if ( this->m_Associate->m_MovingTransform->HasLocalSupport() )
       {
       /* For transforms with local support, e.g. displacement field,
@@ -239,6 +253,157 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImag
   return pointIsValid;
 }
 
+template< class TDomainPartitioner, class TImageToImageMetricv4 >
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
+::ProcessVirtualPoints( const VirtualIndexType * virtualIndices,
+                        const VirtualPointType * virtualPoints,
+                        const SizeValueType numberOfPoints,
+                        const ThreadIdType threadId )
+{
+  if( ! this->m_ProcessVirtualPointsInBlocks )
+    {
+    for( SizeValueType i = 0; i < numberOfPoints; i++ )
+      {
+      this->ProcessVirtualPoint( virtualIndices[i], virtualPoints[i], threadId );
+      }
+    return;
+    }
+
+  ImageToImageMetricv4Type * associate = this->m_Associate;
+  PointBlockType &           block = this->m_PointBlockPerThread[threadId];
+  const bool                 computeFixedGradient = associate->GetGradientSourceIncludesFixed();
+  const bool                 computeMovingGradient = associate->GetGradientSourceIncludesMoving();
+  SizeValueType              numberOfValidPoints = 0;
+
+  /* Transform the block into fixed and moving spaces, and evaluate.
+   * Do this in a try block to catch exceptions and print more useful info
+   * then we otherwise get when exceptions are caught in MultiThreader. */
+  try
+    {
+    if( this->m_FixedDomainCache )
+      {
+      /* The fixed side of each point comes from the cache. */
+      const FixedDomainCacheType & cache = *this->m_FixedDomainCache;
+      associate->m_MovingTransform->TransformPoints( virtualPoints, &block.MappedMovingPoints[0], numberOfPoints );
+
+      for( SizeValueType i = 0; i < numberOfPoints; i++ )
+        {
+        const SizeValueType offset = block.DomainOffsets[i];
+        if( ! cache.GetValidPoints()[offset]
+            || ( associate->m_MovingImageMask && ! associate->m_MovingImageMask->IsInside( block.MappedMovingPoints[i] ) )
+            || ! associate->m_MovingInterpolator->IsInsideBuffer( block.MappedMovingPoints[i] ) )
+          {
+          continue;
+          }
+        block.ValidPoints[numberOfValidPoints] = i;
+        block.MappedFixedPoints[numberOfValidPoints] = cache.GetMappedFixedPoints()[offset];
+        block.FixedPixelValues[numberOfValidPoints] = cache.GetFixedPixelValues()[offset];
+        if( computeFixedGradient )
+          {
+          block.FixedImageGradients[numberOfValidPoints] = cache.GetFixedImageGradients()[offset];
+          }
+        block.MappedMovingPoints[numberOfValidPoints] = block.MappedMovingPoints[i];
+        numberOfValidPoints++;
+        }
+      if( numberOfValidPoints == 0 )
+        {
+        return;
+        }
+      }
+    else
+      {
+      associate->m_FixedTransform->TransformPoints( virtualPoints, &block.MappedFixedPoints[0], numberOfPoints );
+      associate->m_MovingTransform->TransformPoints( virtualPoints, &block.MappedMovingPoints[0], numberOfPoints );
+
+      /* Keep the points that are inside both masks and both image buffers,
+       * packed at the front of the block. */
+      for( SizeValueType i = 0; i < numberOfPoints; i++ )
+        {
+        if( ( associate->m_FixedImageMask && ! associate->m_FixedImageMask->IsInside( block.MappedFixedPoints[i] ) )
+            || ! associate->m_FixedInterpolator->IsInsideBuffer( block.MappedFixedPoints[i] )
+            || ( associate->m_MovingImageMask && ! associate->m_MovingImageMask->IsInside( block.MappedMovingPoints[i] ) )
+            || ! associate->m_MovingInterpolator->IsInsideBuffer( block.MappedMovingPoints[i] ) )
+          {
+          continue;
+          }
+        block.ValidPoints[numberOfValidPoints] = i;
+        block.MappedFixedPoints[numberOfValidPoints] = block.MappedFixedPoints[i];
+        block.MappedMovingPoints[numberOfValidPoints] = block.MappedMovingPoints[i];
+        numberOfValidPoints++;
+        }
+      if( numberOfValidPoints == 0 )
+        {
+        return;
+        }
+
+      associate->m_FixedInterpolator->EvaluatePoints( &block.MappedFixedPoints[0], &block.FixedPixelValues[0], numberOfValidPoints );
+
+      if( computeFixedGradient )
+        {
+        for( SizeValueType j = 0; j < numberOfValidPoints; j++ )
+          {
+          associate->ComputeFixedImageGradientAtPoint( block.MappedFixedPoints[j], block.FixedImageGradients[j] );
+          }
+        }
+      }
+
+    associate->m_MovingInterpolator->EvaluatePoints( &block.MappedMovingPoints[0], &block.MovingPixelValues[0], numberOfValidPoints );
+
+    if( computeMovingGradient )
+      {
+      for( SizeValueType j = 0; j < numberOfValidPoints; j++ )
+        {
+        associate->ComputeMovingImageGradientAtPoint( block.MappedMovingPoints[j], block.MovingImageGradients[j] );
+        }
+      }
+    }
+  catch( ExceptionObject & exc )
+    {
+    std::string msg("Caught exception: \n");
+    msg += exc.what();
+    ExceptionObject err(__FILE__, __LINE__, msg);
+    throw err;
+    }
+
+  /* Call the user method in derived classes on each valid point, in the
+   * order of the block. */
+  MeasureType metricValueResult;
+  for( SizeValueType j = 0; j < numberOfValidPoints; j++ )
+    {
+    const SizeValueType       i = block.ValidPoints[j];
+    const FixedImagePixelType  mappedFixedPixelValue = block.FixedPixelValues[j];
+    const MovingImagePixelType mappedMovingPixelValue = block.MovingPixelValues[j];
+    bool                      pointIsValid = false;
+    try
+      {
+      pointIsValid = this->ProcessPoint(
+                                     virtualIndices[i],
+                                     virtualPoints[i],
+                                     block.MappedFixedPoints[j], mappedFixedPixelValue,
+                                     block.FixedImageGradients[j],
+                                     block.MappedMovingPoints[j], mappedMovingPixelValue,
+                                     block.MovingImageGradients[j],
+                                     metricValueResult, this->m_LocalDerivativesPerThread[threadId],
+                                     threadId );
+      }
+    catch( ExceptionObject & exc )
+      {
+      //NOTE: there must be a cleaner way to do this:
+      std::string msg("Exception in GetValueAndDerivativeProcessPoint:\n");
+      msg += exc.what();
+      ExceptionObject err(__FILE__, __LINE__, msg);
+      throw err;
+      }
+    if( pointIsValid )
+      {
+      this->m_NumberOfValidPointsPerThread[threadId]++;
+      this->m_MeasurePerThread[threadId] += metricValueResult;
+      this->StorePointDerivativeResult( virtualIndices[i], threadId );
+      }
+    }
+}
+
 template< class TDomainPartitioner, class TImageToImageMetricv4 >
 void
 ImageToImageMetricv4GetValueAndDerivativeThreaderBase< TDomainPartitioner, TImageToImageMetricv4 >
@@ -76,7 +76,12 @@ public:
   typedef typename JointHistogramMetricType::JointPDFValueType              JointPDFValueType;
 
 protected:
-  JointHistogramMutualInformationGetValueAndDerivativeThreader() {}
+  JointHistogramMutualInformationGetValueAndDerivativeThreader()
+    {
+    /* ProcessPoint only depends on the mapped points, so the points are
+     * processed in blocks. */
+    this->m_ProcessVirtualPointsInBlocks = true;
+    }
 
   typedef Image< SizeValueType, 2 > JointHistogramType;
   std::vector< typename JointHistogramType::Pointer > m_JointHistogramPerThread;
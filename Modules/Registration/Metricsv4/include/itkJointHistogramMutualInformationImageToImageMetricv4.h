@@ -200,6 +200,9 @@ protected:
   /** Standard PrintSelf method. */
   void PrintSelf(std::ostream & os, Indent indent) const;
 
+  /** Create a metric with the settings of this one. */
+  virtual typename LightObject::Pointer InternalClone() const;
+
   /** Count of the number of valid histogram points. */
   SizeValueType   m_JointHistogramTotalCount;
 
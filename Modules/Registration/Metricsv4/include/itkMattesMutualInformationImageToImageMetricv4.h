@@ -20,6 +20,9 @@
 
 #include "itkImageToImageMetricv4.h"
 #include "itkMattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include "itkMattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader.h"
+#include "itkBSplineBaseTransform.h"
+#include "itkCompositeTransform.h"
 #include "itkPoint.h"
 #include "itkIndex.h"
 #include "itkBSplineDerivativeKernelFunction.h"
@@ -62,10 +65,15 @@ namespace itk
  * \warning Local-support transforms are not yet supported. If used,
  * an exception is thrown during Initialize().
  *
- * \note The per-iteration post-processing code is not multi-threaded, but could be
- * readily be made so for a small performance gain.
- * See GetValueCommonAfterThreadedExecution(), GetValueAndDerivative()
- * and threader::AfterThreadedExecution().
+ * The per-thread joint PDFs, and joint PDF derivatives or derivatives, are
+ * summed in parallel after each pass over the domain, each thread summing a
+ * range of histogram rows or parameters.
+ * See GetValueCommonAfterThreadedExecution() and
+ * MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader.
+ *
+ * When the moving transform is a cubic BSplineBaseTransform, only the
+ * parameters in the support region of each point are visited when the
+ * derivatives are accumulated.
  *
  * The algorithm and much of the code was copied from the previous
  * Mattes MI metric, i.e. itkMattesMutualInformationImageToImageMetric.
@@ -153,6 +161,44 @@ public:
                     5, NumericTraits<SizeValueType>::max() );
   itkGetConstReferenceMacro(NumberOfHistogramBins, SizeValueType);
 
+  /**
+   *  This variable selects the method to be used for computing the Metric
+   * derivatives with respect to the Transform parameters. Two modes of
+   * computation are available. The choice between one and the other is a
+   * trade-off between computation speed and memory allocations. The two modes
+   * are described in detail below:
+   *
+   * UseExplicitPDFDerivatives = True
+   * will compute the Metric derivative by first calculating the derivatives of
+   * each one of the Joint PDF bins with respect to each one of the Transform
+   * parameters and then accumulating these contributions in the final metric
+   * derivative array by using a bin-specific weight.  The memory required for
+   * storing the intermediate derivatives is a 3D array of floating point values
+   * with size equals to the product of (number of histogram bins)^2 times
+   * number of transform parameters, for each thread. This method is well suited
+   * for Transform with a small number of parameters.
+   *
+   * UseExplicitPDFDerivatives = False will compute the Metric derivative by
+   * first computing the weights for each one of the Joint PDF bins and caching
+   * them into an array. Then it will revisit each one of the PDF bins for
+   * computing its weighted contribution to the full derivative array. In this
+   * method an extra 2D array is used for storing the weights of each one of
+   * the PDF bins, and a single derivative array is kept per thread, at the
+   * cost of a second pass over the domain.  This method is well suited for
+   * Transforms with a large number of parameters, such as BSplineTransforms.
+   *
+   * Transforms with local support, e.g. displacement fields, always use
+   * the second method.
+   *
+   * Unless UseExplicitPDFDerivatives is set, Initialize chooses the second
+   * method for moving transforms derived from a cubic BSplineBaseTransform,
+   * whose explicit PDF derivatives take too much memory, and for
+   * CompositeTransforms optimizing such a transform. It chooses the first
+   * method otherwise.  */
+  virtual void SetUseExplicitPDFDerivatives( const bool flag );
+  itkGetConstReferenceMacro(UseExplicitPDFDerivatives, bool);
+  itkBooleanMacro(UseExplicitPDFDerivatives);
+
   virtual void Initialize(void) throw ( itk::ExceptionObject );
 
   /** Calculate and return both the value for the metric and its derivative.
@@ -186,8 +232,8 @@ public:
   /**
    * Get the internal JointPDFDeriviative image that was used in
    * creating the metric derivative value.
-   * This is only created when a global support transform is used, and
-   * derivatives are requested.
+   * This is only created when a global support transform is used,
+   * derivatives are requested and UseExplicitPDFDerivatives is on.
    */
   const typename JointPDFDerivativesType::Pointer GetJointPDFDerivatives () const
     {
@@ -205,13 +251,19 @@ protected:
 
   friend class MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedImageRegionPartitioner< Superclass::VirtualImageDimension >, Superclass, Self >;
   friend class MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerPartitioner, Superclass, Self >;
+  friend class MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader< Self >;
   typedef MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedImageRegionPartitioner< Superclass::VirtualImageDimension >, Superclass, Self >
     MattesMutualInformationDenseGetValueAndDerivativeThreaderType;
   typedef MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< ThreadedIndexedContainerPartitioner, Superclass, Self >
     MattesMutualInformationSparseGetValueAndDerivativeThreaderType;
+  typedef MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader< Self >
+    MattesMutualInformationSumPerThreadResultsThreaderType;
 
   void PrintSelf(std::ostream& os, Indent indent) const;
 
+  /** Create a metric with the settings of this one. */
+  virtual typename LightObject::Pointer InternalClone() const;
+
 
   typedef JointPDFType::IndexType             JointPDFIndexType;
   typedef JointPDFType::PixelType             JointPDFValueType;
@@ -226,10 +278,21 @@ protected:
   typedef BSplineKernelFunction<3,PDFValueType>           CubicBSplineFunctionType;
   typedef BSplineDerivativeKernelFunction<3,PDFValueType> CubicBSplineDerivativeFunctionType;
 
+  /** Moving transform type whose Jacobian is computed sparsely. */
+  typedef BSplineBaseTransform< typename Superclass::CoordinateRepresentationType,
+                                itkGetStaticConstMacro(MovingImageDimension), 3 > BSplineTransformType;
+  typedef typename BSplineTransformType::WeightsType             BSplineTransformWeightsType;
+  typedef typename BSplineTransformType::ParameterIndexArrayType BSplineTransformIndexArrayType;
+
   /** Post-processing code common to both GetValue
-   * and GetValueAndDerivative. */
+   * and GetValueAndDerivative. Sums the per-thread joint PDFs and fixed
+   * image marginal PDFs, and the joint PDF derivatives if present. */
   virtual void GetValueCommonAfterThreadedExecution();
 
+  /** Sum the per-thread derivatives of the second pass of the implicit
+   * PDF derivative computation into the derivative result. */
+  virtual void SumThreaderDerivatives();
+
   OffsetValueType ComputeSingleFixedImageParzenWindowIndex( const FixedImagePixelType & value ) const;
 
   /** Variables to define the marginal and joint histograms. */
@@ -265,11 +328,21 @@ protected:
   typename std::vector<JointPDFType::Pointer>            m_ThreaderJointPDF;
   typename std::vector<JointPDFDerivativesType::Pointer> m_ThreaderJointPDFDerivatives;
 
-  std::vector<int> m_ThreaderJointPDFStartBin;
-  std::vector<int> m_ThreaderJointPDFEndBin;
-
+  /** Sum of the joint PDF per summing thread. */
   mutable std::vector<PDFValueType> m_ThreaderJointPDFSum;
 
+  /** Sums the per-thread results in parallel. */
+  typename MattesMutualInformationSumPerThreadResultsThreaderType::Pointer m_SumPerThreadResultsThreader;
+
+  bool m_UseExplicitPDFDerivatives;
+  bool m_UserHasSetUseExplicitPDFDerivatives;
+
+  /** True during the second pass over the domain of the implicit PDF
+   * derivative computation for global transforms, which accumulates the
+   * derivatives weighted by m_PRatioArray into m_ThreaderDerivatives. */
+  mutable bool m_ImplicitDerivativesSecondPass;
+  mutable std::vector<DerivativeType> m_ThreaderDerivatives;
+
   /** Store the per-point local derivative result by parzen window bin.
    * For local-support transforms only. */
   mutable std::vector<DerivativeType>              m_LocalDerivativeByParzenBin;
@@ -46,15 +46,18 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualIma
   // For multi-threading the metric
   m_ThreaderJointPDF(0),
   m_ThreaderJointPDFDerivatives(0),
-  m_ThreaderJointPDFStartBin(0),
-  m_ThreaderJointPDFEndBin(0),
-  m_ThreaderJointPDFSum(0)
+  m_ThreaderJointPDFSum(0),
+
+  m_UseExplicitPDFDerivatives(true),
+  m_UserHasSetUseExplicitPDFDerivatives(false),
+  m_ImplicitDerivativesSecondPass(false)
 {
   // We have our own GetValueAndDerivativeThreader's that we want
   // ImageToImageMetricv4 to use.
   this->m_DenseGetValueAndDerivativeThreader  = MattesMutualInformationDenseGetValueAndDerivativeThreaderType::New();
   this->m_SparseGetValueAndDerivativeThreader = MattesMutualInformationSparseGetValueAndDerivativeThreaderType::New();
 
+  this->m_SumPerThreadResultsThreader = MattesMutualInformationSumPerThreadResultsThreaderType::New();
 }
 
 template < class TFixedImage, class TMovingImage, class TVirtualImage >
@@ -75,6 +78,34 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
   /* Superclass initialization */
   this->Superclass::Initialize();
 
+  /* Without a choice of the user, bound the memory used for the PDF
+   * derivatives of B-spline transforms, alone or optimized within a
+   * composite transform. */
+  if( ! this->m_UserHasSetUseExplicitPDFDerivatives )
+    {
+    typedef CompositeTransform< typename Superclass::CoordinateRepresentationType,
+                                itkGetStaticConstMacro( MovingImageDimension ) > MovingCompositeTransformType;
+    const MovingCompositeTransformType * composite =
+      dynamic_cast< const MovingCompositeTransformType * >( this->m_MovingTransform.GetPointer() );
+    if( composite != NULL )
+      {
+      this->m_UseExplicitPDFDerivatives = true;
+      for( size_t n = 0; n < composite->GetNumberOfTransforms(); n++ )
+        {
+        if( composite->GetNthTransformToOptimize( n )
+            && dynamic_cast< const BSplineTransformType * >( composite->GetNthTransform( n ).GetPointer() ) != NULL )
+          {
+          this->m_UseExplicitPDFDerivatives = false;
+          }
+        }
+      }
+    else
+      {
+      this->m_UseExplicitPDFDerivatives =
+        dynamic_cast< const BSplineTransformType * >( this->m_MovingTransform.GetPointer() ) == NULL;
+      }
+    }
+
   /* Expects moving image gradient source */
   if( this->GetGradientSourceIncludesFixed() || !this->GetGradientSourceIncludesMoving() )
     {
@@ -172,6 +203,19 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
    * is now performed in the threader BeforeThreadedExecution method */
   }
 
+template <class TFixedImage, class TMovingImage, class TVirtualImage>
+void
+MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+::SetUseExplicitPDFDerivatives( const bool flag )
+{
+  this->m_UserHasSetUseExplicitPDFDerivatives = true;
+  if( this->m_UseExplicitPDFDerivatives != flag )
+    {
+    this->m_UseExplicitPDFDerivatives = flag;
+    this->Modified();
+    }
+}
+
 template <class TFixedImage, class TMovingImage, class TVirtualImage>
 void
 MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
@@ -198,9 +242,9 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
 //////////////////
 
   // Collect some results
-  for( ThreadIdType threadID = 1; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
+  for( SizeValueType i = 1; i < this->m_ThreaderJointPDFSum.size(); i++ )
     {
-    this->m_ThreaderJointPDFSum[0] += this->m_ThreaderJointPDFSum[threadID];
+    this->m_ThreaderJointPDFSum[0] += this->m_ThreaderJointPDFSum[i];
     }
   if( this->m_ThreaderJointPDFSum[0] < itk::NumericTraits< PDFValueType >::epsilon() )
     {
@@ -261,6 +305,8 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
 
   const PDFValueType nFactor = 1.0 / ( this->m_MovingImageBinSize * this->GetNumberOfValidPoints() );
 
+  const bool explicitDerivatives = ! this->HasLocalSupport() && this->m_UseExplicitPDFDerivatives;
+
   for( unsigned int fixedIndex = 0; fixedIndex < this->m_NumberOfHistogramBins; ++fixedIndex )
     {
     const PDFValueType fixedImagePDFValue = this->m_ThreaderFixedImageMarginalPDF[0][fixedIndex];
@@ -282,7 +328,7 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
         sum += jointPDFValue * ( pRatio - vcl_log(fixedImagePDFValue) );
         }
 
-      if( ! this->HasLocalSupport() )
+      if( explicitDerivatives )
         {
         // Collect global derivative contributions
 
@@ -300,7 +346,8 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
       else
         {
         // Collect the pRatio per pdf indecies.
-        // Will be applied subsequently to local-support derivative
+        // Will be applied subsequently to local-support derivative,
+        // or during the second pass over the domain for global transforms.
         OffsetValueType index = movingIndex + (fixedIndex * this->m_NumberOfHistogramBins);
         this->m_PRatioArray[index] = pRatio * nFactor;
         }
@@ -322,6 +369,22 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
         }
       }
     }
+  else if( ! explicitDerivatives )
+    {
+    // Second pass over the domain, accumulating the derivative contribution
+    // of each point weighted by the pRatio of its joint PDF bins.
+    this->m_ImplicitDerivativesSecondPass = true;
+    try
+      {
+      this->GetValueAndDerivativeExecute();
+      }
+    catch( ... )
+      {
+      this->m_ImplicitDerivativesSecondPass = false;
+      throw;
+      }
+    this->m_ImplicitDerivativesSecondPass = false;
+    }
 
   // in ITKv4, metrics always minimize
   // Note: in old metric ComputeDerivatives, derivativeContribution is subtracted in global case, but added in "local" (implicit) case.
@@ -340,41 +403,49 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualI
 {
   // This method is from MattesMutualImageToImageMetric::GetValueThreadPostProcess. Common
   // code used by GetValue and GetValueAndDerivative.
-  // Should be threaded. But if modified to do so, should probably not be threaded
-  // separately, but rather as a part of all post-processing.
-  for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
-    {
-    const int maxI = this->m_NumberOfHistogramBins
-      * ( this->m_ThreaderJointPDFEndBin[threadID] - this->m_ThreaderJointPDFStartBin[threadID] + 1 );
+  // The PDF domain is chunked by rows of fixed image bins.  Each thread
+  // consolidates independent parts of the PDF.
+  typename MattesMutualInformationSumPerThreadResultsThreaderType::DomainType binRange;
+  binRange[0] = 0;
+  binRange[1] = this->m_NumberOfHistogramBins - 1;
+  this->m_SumPerThreadResultsThreader->SetMaximumNumberOfThreads( this->GetMaximumNumberOfThreads() );
+  this->m_SumPerThreadResultsThreader->Execute( this, binRange );
+}
 
-    const unsigned int tPdfPtrOffset = ( this->m_ThreaderJointPDFStartBin[threadID] * this->m_ThreaderJointPDF[0]->GetOffsetTable()[1] );
-    JointPDFValueType * const pdfPtrStart = this->m_ThreaderJointPDF[0]->GetBufferPointer() + tPdfPtrOffset;
+/**
+ * Sum the per-thread derivatives of the implicit PDF derivative computation.
+ */
+template <class TFixedImage, class TMovingImage, class TVirtualImage>
+void
+MattesMutualInformationImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage>
+::SumThreaderDerivatives()
+{
+  typename MattesMutualInformationSumPerThreadResultsThreaderType::DomainType parameterRange;
+  parameterRange[0] = 0;
+  parameterRange[1] = this->m_DerivativeResult->Size() - 1;
+  this->m_SumPerThreadResultsThreader->SetMaximumNumberOfThreads( this->GetMaximumNumberOfThreads() );
+  this->m_SumPerThreadResultsThreader->Execute( this, parameterRange );
+}
 
-    // The PDF domain is chunked based on thread.  Each thread consolodates independant parts of the PDF.
-    for( unsigned int t = 1; t < this->GetNumberOfThreadsUsed(); t++ )
-      {
-      JointPDFValueType *                 pdfPtr = pdfPtrStart;
-      JointPDFValueType const *          tPdfPtr = this->m_ThreaderJointPDF[t]->GetBufferPointer() + tPdfPtrOffset;
-      JointPDFValueType const * const tPdfPtrEnd = tPdfPtr + maxI;
-      // for(i=0; i < maxI; i++)
-      while( tPdfPtr < tPdfPtrEnd )
-        {
-        *( pdfPtr++ ) += *( tPdfPtr++ );
-        }
-      for( int i = this->m_ThreaderJointPDFStartBin[threadID]; i <= this->m_ThreaderJointPDFEndBin[threadID]; i++ )
-        {
-        this->m_ThreaderFixedImageMarginalPDF[0][i] += this->m_ThreaderFixedImageMarginalPDF[t][i];
-        }
-      }
-    // Sum of this threads domain into the this->m_ThreaderJointPDFSum that covers that part of the domain.
-    PDFValueType                    jointPDFSum = 0.0;
-    JointPDFValueType const * pdfPtr = pdfPtrStart;
-    for( int i = 0; i < maxI; i++ )
-      {
-      jointPDFSum += *( pdfPtr++ );
-      }
-    this->m_ThreaderJointPDFSum[threadID] = jointPDFSum;
-  }
+/**
+ * InternalClone
+ */
+template < class TFixedImage, class TMovingImage, class TVirtualImage  >
+typename LightObject::Pointer
+MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualImage>
+::InternalClone() const
+{
+  typename LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>( loPtr.GetPointer() );
+  if( rval.IsNull() )
+    {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+    }
+  rval->m_NumberOfHistogramBins = this->m_NumberOfHistogramBins;
+  rval->m_UseExplicitPDFDerivatives = this->m_UseExplicitPDFDerivatives;
+  rval->m_UserHasSetUseExplicitPDFDerivatives = this->m_UserHasSetUseExplicitPDFDerivatives;
+
+  return loPtr;
 }
 
 /**
@@ -386,6 +457,9 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,TMovingImage,TVirtualIma
 ::PrintSelf(std::ostream& os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "NumberOfHistogramBins: " << this->m_NumberOfHistogramBins << std::endl;
+  os << indent << "UseExplicitPDFDerivatives: " << this->m_UseExplicitPDFDerivatives << std::endl;
+  os << indent << "UserHasSetUseExplicitPDFDerivatives: " << this->m_UserHasSetUseExplicitPDFDerivatives << std::endl;
 }
 
 /**
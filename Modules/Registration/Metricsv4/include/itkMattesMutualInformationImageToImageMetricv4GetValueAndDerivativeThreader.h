@@ -79,8 +79,17 @@ public:
 
   typedef typename TMattesMutualInformationMetric::JacobianType             JacobianType;
 
+  typedef typename TMattesMutualInformationMetric::BSplineTransformType           BSplineTransformType;
+  typedef typename TMattesMutualInformationMetric::BSplineTransformWeightsType    BSplineTransformWeightsType;
+  typedef typename TMattesMutualInformationMetric::BSplineTransformIndexArrayType BSplineTransformIndexArrayType;
+
 protected:
-  MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader() {}
+  MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader()
+    {
+    /* ProcessPoint only depends on the mapped points, so the points are
+     * processed in blocks. */
+    this->m_ProcessVirtualPointsInBlocks = true;
+    }
 
   virtual void BeforeThreadedExecution();
 
@@ -102,7 +111,14 @@ protected:
         DerivativeType &                  localDerivativeReturn,
         const ThreadIdType                threadID ) const;
 
-  /** Compute PDF derivative contribution for each parameter. */
+  /** Compute the Jacobian of the moving transform at the point, or only
+   * the weights and indices of the support region for a B-spline transform. */
+  void ComputeTransformJacobian( const VirtualPointType & virtualPoint, const ThreadIdType threadID ) const;
+
+  /** Compute PDF derivative contribution for each parameter.
+   * During the second pass of the implicit PDF derivative computation,
+   * \c cubicBSplineDerivativeValue is the sum over the Parzen window of the
+   * kernel derivatives weighted by the pRatio of each bin. */
   virtual void ComputePDFDerivatives(const ThreadIdType &    threadID,
                              const OffsetValueType &         fixedImageParzenWindowIndex,
                              const JacobianType &            jacobian,
@@ -114,6 +130,14 @@ protected:
 private:
   MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader( const Self & ); // purposely not implemented
   void operator=( const Self & ); // purposely not implemented
+
+  /** Set when the moving transform is a cubic B-spline transform, whose
+   * Jacobian is computed from the weights of the support region only. */
+  typename BSplineTransformType::ConstPointer m_MovingBSplineTransform;
+
+  /** Per-thread B-spline weights and parameter indices of the support region. */
+  mutable std::vector< BSplineTransformWeightsType >    m_BSplineTransformWeightsPerThread;
+  mutable std::vector< BSplineTransformIndexArrayType > m_BSplineTransformIndicesPerThread;
 };
 
 } // end namespace itk
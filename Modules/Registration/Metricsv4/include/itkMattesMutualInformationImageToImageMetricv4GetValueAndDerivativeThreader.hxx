@@ -39,6 +39,38 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   /* Convenience assignment */
   TMattesMutualInformationMetric * associate = dynamic_cast<TMattesMutualInformationMetric*>(this->m_Associate);
 
+  /* The Jacobian of a B-spline transform is only non-zero for the
+   * parameters of the support region of a point. */
+  this->m_MovingBSplineTransform = NULL;
+  if( ! associate->HasLocalSupport() )
+    {
+    this->m_MovingBSplineTransform = dynamic_cast< const BSplineTransformType * >( associate->GetMovingTransform() );
+    }
+  if( this->m_MovingBSplineTransform.IsNotNull() )
+    {
+    this->m_BSplineTransformWeightsPerThread.resize( this->GetNumberOfThreadsUsed() );
+    this->m_BSplineTransformIndicesPerThread.resize( this->GetNumberOfThreadsUsed() );
+    for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
+      {
+      this->m_BSplineTransformWeightsPerThread[threadID].SetSize( this->m_MovingBSplineTransform->GetNumberOfWeights() );
+      this->m_BSplineTransformIndicesPerThread[threadID].SetSize( this->m_MovingBSplineTransform->GetNumberOfWeights() );
+      }
+    }
+
+  if( associate->m_ImplicitDerivativesSecondPass )
+    {
+    /* The joint PDF and the pRatio of the first pass are kept. The derivatives
+     * are accumulated in the per-thread containers of the superclass, which
+     * are zeroed above. */
+    associate->m_ThreaderDerivatives.resize( this->GetNumberOfThreadsUsed() );
+    for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
+      {
+      associate->m_ThreaderDerivatives[threadID].SetData( this->m_DerivativesPerThread[threadID].data_block(),
+                                                          this->m_DerivativesPerThread[threadID].Size(), false );
+      }
+    return;
+    }
+
   /* Porting: these next blocks of code are from MattesMutualImageToImageMetric::Initialize */
 
   /**
@@ -49,20 +81,6 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   associate->m_ThreaderFixedImageMarginalPDF.resize(associate->GetNumberOfThreadsUsed(),
                                          std::vector<PDFValueType>(associate->m_NumberOfHistogramBins, 0.0F) );
 
-  associate->m_ThreaderJointPDFStartBin.resize( this->GetNumberOfThreadsUsed() );
-  associate->m_ThreaderJointPDFEndBin.resize(this->GetNumberOfThreadsUsed() );
-  const OffsetValueType binRange = associate->m_NumberOfHistogramBins / this->GetNumberOfThreadsUsed();
-  for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
-    {
-    associate->m_ThreaderJointPDFStartBin[threadID] = threadID * binRange;
-    associate->m_ThreaderJointPDFEndBin[threadID] = ( threadID + 1 ) * binRange - 1;
-    }
-  // Ensure that the last EndBin range contains the last histogram bin
-  associate->m_ThreaderJointPDFStartBin[this->GetNumberOfThreadsUsed() - 1] = ( this->GetNumberOfThreadsUsed() - 1 ) * binRange;
-  associate->m_ThreaderJointPDFEndBin[this->GetNumberOfThreadsUsed() - 1] = associate->m_NumberOfHistogramBins - 1;
-
-  associate->m_ThreaderJointPDFSum.resize(this->GetNumberOfThreadsUsed());
-
   JointPDFRegionType jointPDFRegion;
   // For the joint PDF define a region starting from {0,0}
   // with size {m_NumberOfHistogramBins, this->m_NumberOfHistogramBins}.
@@ -87,15 +105,21 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   /**
    * Allocate memory for the joint PDF and joint PDF derivatives.
    * The joint PDF and joint PDF derivatives are store as itk::Image.
+   * The images of the previous iteration are reused when their size
+   * has not changed.
    */
   associate->m_ThreaderJointPDF.resize(this->GetNumberOfThreadsUsed());
   for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); ++threadID )
     {
-    associate->m_ThreaderJointPDF[threadID] = JointPDFType::New();
-    associate->m_ThreaderJointPDF[threadID]->SetRegions(jointPDFRegion);
+    if( associate->m_ThreaderJointPDF[threadID].IsNull()
+        || associate->m_ThreaderJointPDF[threadID]->GetBufferedRegion() != jointPDFRegion )
+      {
+      associate->m_ThreaderJointPDF[threadID] = JointPDFType::New();
+      associate->m_ThreaderJointPDF[threadID]->SetRegions(jointPDFRegion);
+      associate->m_ThreaderJointPDF[threadID]->Allocate();
+      }
     associate->m_ThreaderJointPDF[threadID]->SetOrigin(origin);
     associate->m_ThreaderJointPDF[threadID]->SetSpacing(spacing);
-    associate->m_ThreaderJointPDF[threadID]->Allocate();
     }
 
   //
@@ -103,6 +127,7 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   //
   if( associate->HasLocalSupport() )
     {
+    associate->m_ThreaderDerivatives.resize(0);
     associate->m_PRatioArray.assign(associate->m_NumberOfHistogramBins * associate->m_NumberOfHistogramBins, 0.0);
     associate->m_JointPdfIndex1DArray.assign( associate->GetNumberOfParameters(), 0 );
     // Don't need this with local-support
@@ -118,9 +143,18 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       associate->m_LocalDerivativeByParzenBin[n].Fill( NumericTraits< DerivativeValueType >::Zero );
       }
     }
+  else if( ! associate->m_UseExplicitPDFDerivatives )
+    {
+    // The pRatio is applied during a second pass over the domain.
+    associate->m_PRatioArray.assign(associate->m_NumberOfHistogramBins * associate->m_NumberOfHistogramBins, 0.0);
+    associate->m_JointPdfIndex1DArray.resize(0);
+    associate->m_ThreaderJointPDFDerivatives.resize(0);
+    associate->m_LocalDerivativeByParzenBin.resize(0);
+    }
   else
     {
     // Don't need this with global transforms
+    associate->m_ThreaderDerivatives.resize(0);
     associate->m_PRatioArray.resize(0);
     associate->m_JointPdfIndex1DArray.resize(0);
     associate->m_LocalDerivativeByParzenBin.resize(0);
@@ -147,9 +181,13 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     // Set the regions and allocate
     for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
       {
-      associate->m_ThreaderJointPDFDerivatives[threadID] = JointPDFDerivativesType::New();
-      associate->m_ThreaderJointPDFDerivatives[threadID]->SetRegions( jointPDFDerivativesRegion);
-      associate->m_ThreaderJointPDFDerivatives[threadID]->Allocate();
+      if( associate->m_ThreaderJointPDFDerivatives[threadID].IsNull()
+          || associate->m_ThreaderJointPDFDerivatives[threadID]->GetBufferedRegion() != jointPDFDerivativesRegion )
+        {
+        associate->m_ThreaderJointPDFDerivatives[threadID] = JointPDFDerivativesType::New();
+        associate->m_ThreaderJointPDFDerivatives[threadID]->SetRegions( jointPDFDerivativesRegion);
+        associate->m_ThreaderJointPDFDerivatives[threadID]->Allocate();
+        }
       }
     }
 
@@ -167,7 +205,7 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       associate->m_ThreaderFixedImageMarginalPDF[threadID].begin(),
       associate->m_ThreaderFixedImageMarginalPDF[threadID].end(), 0.0F);
     associate->m_ThreaderJointPDF[threadID]->FillBuffer(0.0F);
-    if( ! associate->HasLocalSupport() )
+    if( ! associate->m_ThreaderJointPDFDerivatives.empty() )
       {
       associate->m_ThreaderJointPDFDerivatives[threadID]->FillBuffer(0.0F);
       }
@@ -231,6 +269,36 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
 
   const OffsetValueType fixedImageParzenWindowIndex = associate->ComputeSingleFixedImageParzenWindowIndex( fixedImageValue );
 
+  PDFValueType movingImageParzenWindowArg = static_cast<PDFValueType>( pdfMovingIndex ) - static_cast<PDFValueType>( movingImageParzenWindowTerm );
+
+  if( associate->m_ImplicitDerivativesSecondPass )
+    {
+    // The PDFs are complete. Weight the kernel derivative of each affected
+    // bin by its pRatio and accumulate the derivative once for the point.
+    const PDFValueType * pRatioPtr = &( associate->m_PRatioArray[0] )
+      + ( fixedImageParzenWindowIndex * associate->m_NumberOfHistogramBins )
+      + pdfMovingIndex;
+    PDFValueType weightedDerivativeValue = 0.0;
+    for( OffsetValueType bin = pdfMovingIndex; bin <= pdfMovingIndexMax; ++bin )
+      {
+      weightedDerivativeValue += *( pRatioPtr++ )
+        * associate->m_CubicBSplineDerivativeKernel->Evaluate(movingImageParzenWindowArg);
+      movingImageParzenWindowArg += 1.0;
+      }
+
+    this->ComputeTransformJacobian( virtualPoint, threadID );
+    this->ComputePDFDerivatives(threadID,
+                                fixedImageParzenWindowIndex,
+                                this->m_MovingTransformJacobianPerThread[threadID],
+                                pdfMovingIndex,
+                                movingImageGradient,
+                                weightedDerivativeValue,
+                                NULL);
+
+    this->m_NumberOfValidPointsPerThread[threadID]++;
+    return false;
+    }
+
   // Since a zero-order BSpline (box car) kernel is used for
   // the fixed image marginal pdf, we need only increment the
   // fixedImageParzenWindowIndex by value of 1.0.
@@ -247,7 +315,6 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     * zero-th (column) dimension and the fixed image bins corresponds
     * to the first (row) dimension.
     */
-  PDFValueType movingImageParzenWindowArg = static_cast<PDFValueType>( pdfMovingIndex ) - static_cast<PDFValueType>( movingImageParzenWindowTerm );
 
   // Pointer to affected bin to be updated
   JointPDFValueType *pdfPtr = associate->m_ThreaderJointPDF[threadID]->GetBufferPointer()
@@ -268,10 +335,17 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       }
     }
 
+  // With implicit PDF derivatives and a global transform, only the PDFs
+  // are computed during the first pass.
+  const bool computeDerivatives = associate->HasLocalSupport() || associate->m_UseExplicitPDFDerivatives;
+
   // Compute the transform Jacobian.
   typedef JacobianType & JacobianReferenceType;
   JacobianReferenceType jacobian = this->m_MovingTransformJacobianPerThread[threadID];
-  associate->GetMovingTransform()->ComputeJacobianWithRespectToParameters( virtualPoint, jacobian);
+  if( computeDerivatives )
+    {
+    this->ComputeTransformJacobian( virtualPoint, threadID );
+    }
 
   SizeValueType movingParzenBin = 0;
 
@@ -280,6 +354,13 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     PDFValueType val = static_cast<PDFValueType>( associate->m_CubicBSplineKernel ->Evaluate( movingImageParzenWindowArg) );
     *( pdfPtr++ ) += val;
 
+    if( ! computeDerivatives )
+      {
+      movingImageParzenWindowArg += 1.0;
+      ++pdfMovingIndex;
+      continue;
+      }
+
     // Compute the cubicBSplineDerivative for later repeated use.
     const PDFValueType cubicBSplineDerivativeValue = associate->m_CubicBSplineDerivativeKernel->Evaluate(movingImageParzenWindowArg);
 
@@ -336,13 +417,45 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
   const OffsetValueType pdfFixedIndex = fixedImageParzenWindowIndex;
 
   JointPDFDerivativesValueType *derivPtr=0;
-  if( ! associate->HasLocalSupport() )
+  if( associate->m_ImplicitDerivativesSecondPass )
+    {
+    // Accumulate directly into the per-thread derivative.
+    localSupportDerivativeResultPtr = associate->m_ThreaderDerivatives[threadID].data_block();
+    }
+  else if( ! associate->HasLocalSupport() )
     {
     derivPtr = associate->m_ThreaderJointPDFDerivatives[threadID]->GetBufferPointer()
       + ( pdfFixedIndex  * associate->m_ThreaderJointPDFDerivatives[threadID]->GetOffsetTable()[2] )
       + ( pdfMovingIndex * associate->m_ThreaderJointPDFDerivatives[threadID]->GetOffsetTable()[1] );
     }
 
+  if( this->m_MovingBSplineTransform.IsNotNull() )
+    {
+    // Only visit the parameters of the support region, in which the
+    // Jacobian of dimension dim is the weight of the coefficient.
+    const BSplineTransformWeightsType &    weights = this->m_BSplineTransformWeightsPerThread[threadID];
+    const BSplineTransformIndexArrayType & indices = this->m_BSplineTransformIndicesPerThread[threadID];
+    const NumberOfParametersType parametersPerDimension = this->m_MovingBSplineTransform->GetNumberOfParametersPerDimension();
+    for( SizeValueType dim = 0; dim < associate->MovingImageDimension; dim++ )
+      {
+      for( SizeValueType mu = 0; mu < weights.Size(); mu++ )
+        {
+        const PDFValueType innerProduct = weights[mu] * movingImageGradient[dim];
+        const PDFValueType derivativeContribution = innerProduct * cubicBSplineDerivativeValue;
+        const NumberOfParametersType parameterIndex = indices[mu] + dim * parametersPerDimension;
+        if( associate->m_ImplicitDerivativesSecondPass )
+          {
+          localSupportDerivativeResultPtr[parameterIndex] += derivativeContribution;
+          }
+        else
+          {
+          derivPtr[parameterIndex] -= derivativeContribution;
+          }
+        }
+      }
+    return;
+    }
+
   for( NumberOfParametersType mu = 0; mu < associate->GetNumberOfLocalParameters(); mu++ )
     {
     PDFValueType innerProduct = 0.0;
@@ -352,7 +465,7 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
       }
 
     const PDFValueType derivativeContribution = innerProduct * cubicBSplineDerivativeValue;
-    if( associate->HasLocalSupport() )
+    if( localSupportDerivativeResultPtr != NULL )
       {
       *( localSupportDerivativeResultPtr ) += derivativeContribution;
       localSupportDerivativeResultPtr++;
@@ -372,14 +485,6 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
 {
   TMattesMutualInformationMetric * associate = dynamic_cast<TMattesMutualInformationMetric*>(this->m_Associate);
 
-  /* Store the number of valid points.
-   * This is the only code we need from Superclass::AfterThreadedExecution */
-  associate->m_NumberOfValidPoints = NumericTraits< SizeValueType >::Zero;
-  for (ThreadIdType i=0; i<this->GetNumberOfThreadsUsed(); i++)
-    {
-    associate->m_NumberOfValidPoints += this->m_NumberOfValidPointsPerThread[i];
-    }
-
   /* Porting: This code is from
    * MattesMutualInformationImageToImageMetric::GetValueAndDerivativeThreadPostProcess */
 
@@ -392,47 +497,33 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomai
     associate->m_NumberOfValidPoints += this->m_NumberOfValidPointsPerThread[i];
     }
 
-  /* Post-processing that is common the GetValue and GetValueAndDerivative */
-  associate->GetValueCommonAfterThreadedExecution();
-
-  /* This should be done via its own threader class. Previously it was threaded using
-   * old ImageToImageMetric threaded post-processing. */
-  if( ! associate->HasLocalSupport() )
+  if( associate->m_ImplicitDerivativesSecondPass )
     {
-    for( ThreadIdType threadID = 0; threadID < this->GetNumberOfThreadsUsed(); threadID++ )
-      {
-      const NumberOfParametersType rowSize = associate->GetNumberOfLocalParameters() * associate->m_NumberOfHistogramBins;
-
-      const SizeValueType maxI =
-        rowSize * ( associate->m_ThreaderJointPDFEndBin[threadID]
-                    - associate->m_ThreaderJointPDFStartBin[threadID] + 1 );
-
-      JointPDFDerivativesValueType *const pdfDPtrStart = associate->m_ThreaderJointPDFDerivatives[0]->GetBufferPointer()
-        + ( associate->m_ThreaderJointPDFStartBin[threadID] * rowSize );
-      const SizeValueType tPdfDPtrOffset = associate->m_ThreaderJointPDFStartBin[threadID] *  rowSize;
-      for( SizeValueType t = 1; t < this->GetNumberOfThreadsUsed(); t++ )
-        {
-        JointPDFDerivativesValueType *      pdfDPtr = pdfDPtrStart;
-        JointPDFDerivativesValueType const *tPdfDPtr = associate->m_ThreaderJointPDFDerivatives[t]->GetBufferPointer()
-          + tPdfDPtrOffset;
-        JointPDFDerivativesValueType const * const tPdfDPtrEnd = tPdfDPtr + maxI;
-        // for(i = 0; i < maxI; i++)
-        while( tPdfDPtr < tPdfDPtrEnd )
-          {
-          *( pdfDPtr++ ) += *( tPdfDPtr++ );
-          }
-        }
-
-      const PDFValueType nFactor = 1.0 / ( associate->m_MovingImageBinSize
-                                     * associate->GetNumberOfValidPoints() );
+    associate->SumThreaderDerivatives();
+    }
+  else
+    {
+    /* Post-processing that is common the GetValue and GetValueAndDerivative.
+     * This also sums the joint PDF derivatives, when they are computed. */
+    associate->GetValueCommonAfterThreadedExecution();
+    }
+}
 
-      JointPDFDerivativesValueType *             pdfDPtr = pdfDPtrStart;
-      JointPDFDerivativesValueType const * const tPdfDPtrEnd = pdfDPtrStart + maxI;
-      while( pdfDPtr < tPdfDPtrEnd )
-        {
-        *( pdfDPtr++ ) *= nFactor;
-        }
-      }
+template< class TDomainPartitioner, class TImageToImageMetric, class TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader< TDomainPartitioner, TImageToImageMetric, TMattesMutualInformationMetric >
+::ComputeTransformJacobian( const VirtualPointType & virtualPoint, const ThreadIdType threadID ) const
+{
+  if( this->m_MovingBSplineTransform.IsNotNull() )
+    {
+    this->m_MovingBSplineTransform->ComputeJacobianFromBSplineWeightsWithRespectToPosition( virtualPoint,
+      this->m_BSplineTransformWeightsPerThread[threadID], this->m_BSplineTransformIndicesPerThread[threadID] );
+    }
+  else
+    {
+    TMattesMutualInformationMetric * associate = dynamic_cast<TMattesMutualInformationMetric*>(this->m_Associate);
+    associate->GetMovingTransform()->ComputeJacobianWithRespectToParameters( virtualPoint,
+      this->m_MovingTransformJacobianPerThread[threadID] );
     }
 }
 
@@ -0,0 +1,88 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader_h
+#define __itkMattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader_h
+
+#include "itkDomainThreader.h"
+#include "itkThreadedIndexedContainerPartitioner.h"
+
+namespace itk
+{
+
+/** \class MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader
+ * \brief Sums the per-thread results of
+ * MattesMutualInformationImageToImageMetricv4 \c GetValueAndDerivative.
+ *
+ * The domain is a range of fixed image histogram bins.  Each thread sums
+ * its rows of the per-thread joint PDFs, fixed image marginal PDFs and, with
+ * explicit PDF derivatives, joint PDF derivatives into the entries for the
+ * first thread, so that the post-processing cost does not grow with the
+ * number of threads.
+ *
+ * During the second pass of the implicit PDF derivative computation the
+ * domain is instead a range of transform parameters, and the per-thread
+ * derivatives are summed into the derivative result.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template < class TMattesMutualInformationMetric >
+class MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader
+  : public DomainThreader< ThreadedIndexedContainerPartitioner, TMattesMutualInformationMetric >
+{
+public:
+  /** Standard class typedefs. */
+  typedef MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader Self;
+  typedef DomainThreader< ThreadedIndexedContainerPartitioner, TMattesMutualInformationMetric >
+                                                                                 Superclass;
+  typedef SmartPointer< Self >                                                   Pointer;
+  typedef SmartPointer< const Self >                                             ConstPointer;
+
+  itkTypeMacro( MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader, DomainThreader );
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::DomainType    DomainType;
+  typedef typename Superclass::AssociateType AssociateType;
+  typedef DomainType                         IndexRangeType;
+
+  typedef typename TMattesMutualInformationMetric::PDFValueType                 PDFValueType;
+  typedef typename TMattesMutualInformationMetric::JointPDFValueType            JointPDFValueType;
+  typedef typename TMattesMutualInformationMetric::JointPDFDerivativesValueType JointPDFDerivativesValueType;
+  typedef typename TMattesMutualInformationMetric::DerivativeValueType          DerivativeValueType;
+
+protected:
+  MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader() {}
+
+  /** Size the per-thread joint PDF sums. */
+  virtual void BeforeThreadedExecution();
+
+  virtual void ThreadedExecution( const IndexRangeType & subrange,
+                                  const ThreadIdType threadId );
+
+private:
+  MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader( const Self & ); // purposely not implemented
+  void operator=( const Self & ); // purposely not implemented
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader.hxx"
+#endif
+
+#endif
@@ -0,0 +1,128 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef __itkMattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader_hxx
+#define __itkMattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader_hxx
+
+#include "itkMattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader.h"
+
+namespace itk
+{
+
+template< class TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader< TMattesMutualInformationMetric >
+::BeforeThreadedExecution()
+{
+  if( ! this->m_Associate->m_ImplicitDerivativesSecondPass )
+    {
+    this->m_Associate->m_ThreaderJointPDFSum.assign( this->GetNumberOfThreadsUsed(), 0.0 );
+    }
+}
+
+template< class TMattesMutualInformationMetric >
+void
+MattesMutualInformationImageToImageMetricv4SumPerThreadResultsThreader< TMattesMutualInformationMetric >
+::ThreadedExecution( const IndexRangeType & subrange,
+                     const ThreadIdType threadId )
+{
+  AssociateType * associate = this->m_Associate;
+
+  if( associate->m_ImplicitDerivativesSecondPass )
+    {
+    // The subrange is a range of transform parameters.
+    const SizeValueType numberOfSources = associate->m_ThreaderDerivatives.size();
+    for( IndexValueType p = subrange[0]; p <= subrange[1]; p++ )
+      {
+      DerivativeValueType sum = ( *associate->m_DerivativeResult )[p];
+      for( SizeValueType t = 0; t < numberOfSources; t++ )
+        {
+        sum += associate->m_ThreaderDerivatives[t][p];
+        }
+      ( *associate->m_DerivativeResult )[p] = sum;
+      }
+    return;
+    }
+
+  // The subrange is a range of fixed image bins, i.e. rows of the joint PDF.
+  const SizeValueType numberOfSources = associate->m_ThreaderJointPDF.size();
+  const SizeValueType numberOfBins = associate->m_NumberOfHistogramBins;
+  const SizeValueType numberOfRows = subrange[1] - subrange[0] + 1;
+
+  const SizeValueType pdfOffset = subrange[0] * numberOfBins;
+  const SizeValueType pdfLength = numberOfRows * numberOfBins;
+  JointPDFValueType * const pdfPtrStart = associate->m_ThreaderJointPDF[0]->GetBufferPointer() + pdfOffset;
+  for( SizeValueType t = 1; t < numberOfSources; t++ )
+    {
+    JointPDFValueType *                 pdfPtr = pdfPtrStart;
+    JointPDFValueType const *          tPdfPtr = associate->m_ThreaderJointPDF[t]->GetBufferPointer() + pdfOffset;
+    JointPDFValueType const * const tPdfPtrEnd = tPdfPtr + pdfLength;
+    while( tPdfPtr < tPdfPtrEnd )
+      {
+      *( pdfPtr++ ) += *( tPdfPtr++ );
+      }
+    for( IndexValueType i = subrange[0]; i <= subrange[1]; i++ )
+      {
+      associate->m_ThreaderFixedImageMarginalPDF[0][i] += associate->m_ThreaderFixedImageMarginalPDF[t][i];
+      }
+    }
+
+  PDFValueType jointPDFSum = 0.0;
+  JointPDFValueType const * pdfPtr = pdfPtrStart;
+  for( SizeValueType i = 0; i < pdfLength; i++ )
+    {
+    jointPDFSum += *( pdfPtr++ );
+    }
+  associate->m_ThreaderJointPDFSum[threadId] = jointPDFSum;
+
+  // The explicit PDF derivatives are only stored for global transforms.
+  if( associate->m_ThreaderJointPDFDerivatives.empty() )
+    {
+    return;
+    }
+
+  const SizeValueType rowSize = associate->GetNumberOfLocalParameters() * numberOfBins;
+  const SizeValueType derivOffset = subrange[0] * rowSize;
+  const SizeValueType derivLength = numberOfRows * rowSize;
+  JointPDFDerivativesValueType * const pdfDPtrStart =
+    associate->m_ThreaderJointPDFDerivatives[0]->GetBufferPointer() + derivOffset;
+  for( SizeValueType t = 1; t < numberOfSources; t++ )
+    {
+    JointPDFDerivativesValueType *              pdfDPtr = pdfDPtrStart;
+    JointPDFDerivativesValueType const *       tPdfDPtr = associate->m_ThreaderJointPDFDerivatives[t]->GetBufferPointer()
+      + derivOffset;
+    JointPDFDerivativesValueType const * const tPdfDPtrEnd = tPdfDPtr + derivLength;
+    while( tPdfDPtr < tPdfDPtrEnd )
+      {
+      *( pdfDPtr++ ) += *( tPdfDPtr++ );
+      }
+    }
+
+  const PDFValueType nFactor = 1.0 / ( associate->m_MovingImageBinSize
+                                       * associate->GetNumberOfValidPoints() );
+
+  JointPDFDerivativesValueType *             pdfDPtr = pdfDPtrStart;
+  JointPDFDerivativesValueType const * const pdfDPtrEnd = pdfDPtrStart + derivLength;
+  while( pdfDPtr < pdfDPtrEnd )
+    {
+    *( pdfDPtr++ ) *= nFactor;
+    }
+}
+
+} // end namespace itk
+
+#endif
@@ -61,7 +61,12 @@ public:
   typedef typename Superclass::DerivativeValueType      DerivativeValueType;
 
 protected:
-  MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader() {}
+  MeanSquaresImageToImageMetricv4GetValueAndDerivativeThreader()
+    {
+    /* ProcessPoint only depends on the mapped points, so the points are
+     * processed in blocks. */
+    this->m_ProcessVirtualPointsInBlocks = true;
+    }
 
   /** This function computes the local voxel-wise contribution of
    *  the metric to the global integral of the metric/derivative.
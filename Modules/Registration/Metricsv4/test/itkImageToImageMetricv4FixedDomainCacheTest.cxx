@@ -0,0 +1,331 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkImageToImageMetricv4FixedDomainCache.h"
+#include "itkAffineTransform.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+/* Verify that metrics using a fixed domain cache give exactly the results
+ * of metrics without one, that the cache is reused across Initialize calls
+ * and metrics, and that it is filled again when the fixed side changes. */
+
+namespace
+{
+const unsigned int Dimension = 2;
+typedef itk::Image< double, Dimension >                     ImageType;
+typedef itk::AffineTransform< double, Dimension >           MovingTransformType;
+typedef itk::TranslationTransform< double, Dimension >      FixedTransformType;
+typedef itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType >
+                                                            MeanSquaresMetricType;
+typedef itk::MattesMutualInformationImageToImageMetricv4< ImageType, ImageType >
+                                                            MattesMetricType;
+typedef MeanSquaresMetricType::FixedDomainCacheType         CacheType;
+
+/* A metric that halves the fixed image gradients, to check that the cache
+ * holds the gradients of the overridden method. */
+class HalfFixedGradientMetric : public MeanSquaresMetricType
+{
+public:
+  typedef HalfFixedGradientMetric   Self;
+  typedef MeanSquaresMetricType     Superclass;
+  typedef itk::SmartPointer< Self > Pointer;
+
+  itkNewMacro( Self );
+
+protected:
+  HalfFixedGradientMetric() {}
+
+  virtual void ComputeFixedImageGradientAtPoint( const FixedImagePointType & mappedPoint,
+                                                 FixedImageGradientType & gradient ) const
+    {
+    Superclass::ComputeFixedImageGradientAtPoint( mappedPoint, gradient );
+    gradient *= 0.5;
+    }
+};
+
+ImageType::Pointer CreateImage( const double shift )
+{
+  ImageType::SizeType size;
+  size.Fill( 32 );
+  ImageType::RegionType region;
+  region.SetSize( size );
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.0;
+  spacing[1] = 1.5;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->SetSpacing( spacing );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const ImageType::IndexType index = it.GetIndex();
+    it.Set( 100.0 * vcl_sin( 0.2 * ( index[0] - shift ) ) * vcl_cos( 0.15 * index[1] ) + index[0] );
+    }
+  return image;
+}
+
+MovingTransformType::Pointer CreateMovingTransform( const double angle )
+{
+  MovingTransformType::Pointer transform = MovingTransformType::New();
+  MovingTransformType::OutputVectorType translation;
+  translation[0] = 1.3;
+  translation[1] = -0.7;
+  MovingTransformType::InputPointType center;
+  center[0] = 16.0;
+  center[1] = 24.0;
+  transform->SetCenter( center );
+  transform->Rotate2D( angle );
+  transform->Translate( translation );
+  return transform;
+}
+
+template< class TMetric >
+void SetUpMetric( TMetric * metric, const ImageType * fixedImage, const ImageType * movingImage,
+                  const double angle )
+{
+  metric->SetFixedImage( fixedImage );
+  metric->SetMovingImage( movingImage );
+  metric->SetMovingTransform( CreateMovingTransform( angle ) );
+  metric->SetMaximumNumberOfThreads( 2 );
+}
+
+/* Evaluate both metrics and check that they agree exactly. */
+template< class TMetric >
+bool CompareMetrics( const char * name, TMetric * cachedMetric, TMetric * referenceMetric )
+{
+  typename TMetric::MeasureType    cachedValue, referenceValue;
+  typename TMetric::DerivativeType cachedDerivative, referenceDerivative;
+  cachedMetric->GetValueAndDerivative( cachedValue, cachedDerivative );
+  referenceMetric->GetValueAndDerivative( referenceValue, referenceDerivative );
+
+  bool same = cachedValue == referenceValue
+    && cachedMetric->GetNumberOfValidPoints() == referenceMetric->GetNumberOfValidPoints()
+    && cachedMetric->GetNumberOfSkippedFixedSampledPoints() == referenceMetric->GetNumberOfSkippedFixedSampledPoints()
+    && cachedDerivative.Size() == referenceDerivative.Size();
+  for( unsigned int i = 0; same && i < cachedDerivative.Size(); i++ )
+    {
+    same = cachedDerivative[i] == referenceDerivative[i];
+    }
+  if( !same )
+    {
+    std::cerr << name << ": with the cache, value " << cachedValue << " derivative " << cachedDerivative
+              << " valid points " << cachedMetric->GetNumberOfValidPoints()
+              << "; without, value " << referenceValue << " derivative " << referenceDerivative
+              << " valid points " << referenceMetric->GetNumberOfValidPoints() << std::endl;
+    return false;
+    }
+  std::cout << name << ": value " << cachedValue << ", " << cachedMetric->GetNumberOfValidPoints()
+            << " valid points." << std::endl;
+  return true;
+}
+
+bool CheckNumberOfFills( const char * name, const CacheType * cache, const itk::SizeValueType expected )
+{
+  if( cache->GetNumberOfFills() != expected )
+    {
+    std::cerr << name << ": the cache was filled " << cache->GetNumberOfFills()
+              << " times, expected " << expected << std::endl;
+    return false;
+    }
+  return true;
+}
+}
+
+int itkImageToImageMetricv4FixedDomainCacheTest( int, char *[] )
+{
+  ImageType::Pointer fixedImage = CreateImage( 0.0 );
+  ImageType::Pointer movingImage = CreateImage( 1.5 );
+  bool pass = true;
+
+  // Dense sampling, fixed and moving gradients from the gradient filters
+  CacheType::Pointer cache = CacheType::New();
+  MeanSquaresMetricType::Pointer reference = MeanSquaresMetricType::New();
+  MeanSquaresMetricType::Pointer cached = MeanSquaresMetricType::New();
+  MeanSquaresMetricType::Pointer shared = MeanSquaresMetricType::New();
+  SetUpMetric( reference.GetPointer(), fixedImage, movingImage, 0.1 );
+  SetUpMetric( cached.GetPointer(), fixedImage, movingImage, 0.1 );
+  SetUpMetric( shared.GetPointer(), fixedImage, movingImage, 0.1 );
+  reference->SetGradientSource( MeanSquaresMetricType::GRADIENT_SOURCE_BOTH );
+  cached->SetGradientSource( MeanSquaresMetricType::GRADIENT_SOURCE_BOTH );
+  shared->SetGradientSource( MeanSquaresMetricType::GRADIENT_SOURCE_BOTH );
+  cached->SetFixedDomainCache( cache );
+  shared->SetFixedDomainCache( cache );
+  reference->Initialize();
+  cached->Initialize();
+  pass &= CheckNumberOfFills( "Dense", cache, 1 );
+  pass &= CompareMetrics( "Dense", cached.GetPointer(), reference.GetPointer() );
+
+  // Another metric with the same fixed side reuses the cache
+  shared->Initialize();
+  pass &= CheckNumberOfFills( "Dense shared", cache, 1 );
+  pass &= CompareMetrics( "Dense shared", shared.GetPointer(), reference.GetPointer() );
+
+  // So do restarts from another moving transform
+  reference->SetMovingTransform( CreateMovingTransform( -0.2 ) );
+  cached->SetMovingTransform( CreateMovingTransform( -0.2 ) );
+  reference->Initialize();
+  cached->Initialize();
+  pass &= CheckNumberOfFills( "Dense restart", cache, 1 );
+  pass &= CompareMetrics( "Dense restart", cached.GetPointer(), reference.GetPointer() );
+
+  // A new fixed transform fills the cache again. The metric initialized
+  // before then does not use the cache any more.
+  FixedTransformType::Pointer fixedTransform = FixedTransformType::New();
+  FixedTransformType::OutputVectorType fixedTranslation;
+  fixedTranslation[0] = 0.6;
+  fixedTranslation[1] = -1.1;
+  fixedTransform->Translate( fixedTranslation );
+  reference->SetFixedTransform( fixedTransform );
+  cached->SetFixedTransform( fixedTransform );
+  reference->Initialize();
+  cached->Initialize();
+  pass &= CheckNumberOfFills( "Dense fixed transform", cache, 2 );
+  pass &= CompareMetrics( "Dense fixed transform", cached.GetPointer(), reference.GetPointer() );
+  MeanSquaresMetricType::Pointer unshared = MeanSquaresMetricType::New();
+  SetUpMetric( unshared.GetPointer(), fixedImage, movingImage, 0.1 );
+  unshared->SetGradientSource( MeanSquaresMetricType::GRADIENT_SOURCE_BOTH );
+  unshared->Initialize();
+  pass &= CompareMetrics( "Dense stale", shared.GetPointer(), unshared.GetPointer() );
+
+  // So does a modified fixed image
+  fixedImage->Modified();
+  reference->Initialize();
+  cached->Initialize();
+  pass &= CheckNumberOfFills( "Dense modified image", cache, 3 );
+  pass &= CompareMetrics( "Dense modified image", cached.GetPointer(), reference.GetPointer() );
+
+  // A gradient filter set by the user is not modified by filling the cache,
+  // so the cache is reused
+  typedef MeanSquaresMetricType::DefaultFixedImageGradientFilter GradientFilterType;
+  GradientFilterType::Pointer gradientFilter = GradientFilterType::New();
+  gradientFilter->SetSigma( 1.5 );
+  CacheType::Pointer filterCache = CacheType::New();
+  MeanSquaresMetricType::Pointer filterReference = MeanSquaresMetricType::New();
+  MeanSquaresMetricType::Pointer filterCached = MeanSquaresMetricType::New();
+  SetUpMetric( filterReference.GetPointer(), fixedImage, movingImage, 0.1 );
+  SetUpMetric( filterCached.GetPointer(), fixedImage, movingImage, 0.1 );
+  filterReference->SetGradientSource( MeanSquaresMetricType::GRADIENT_SOURCE_BOTH );
+  filterCached->SetGradientSource( MeanSquaresMetricType::GRADIENT_SOURCE_BOTH );
+  filterReference->SetFixedImageGradientFilter( gradientFilter );
+  filterCached->SetFixedImageGradientFilter( gradientFilter );
+  filterCached->SetFixedDomainCache( filterCache );
+  filterReference->Initialize();
+  filterCached->Initialize();
+  filterCached->Initialize();
+  pass &= CheckNumberOfFills( "User gradient filter", filterCache, 1 );
+  pass &= CompareMetrics( "User gradient filter", filterCached.GetPointer(), filterReference.GetPointer() );
+
+  // The cache holds the fixed gradients of a metric overriding their
+  // computation
+  CacheType::Pointer plainCache = CacheType::New();
+  CacheType::Pointer overrideCache = CacheType::New();
+  MeanSquaresMetricType::Pointer plain = MeanSquaresMetricType::New();
+  HalfFixedGradientMetric::Pointer overridden = HalfFixedGradientMetric::New();
+  SetUpMetric( plain.GetPointer(), fixedImage, movingImage, 0.1 );
+  SetUpMetric( overridden.GetPointer(), fixedImage, movingImage, 0.1 );
+  plain->SetGradientSource( MeanSquaresMetricType::GRADIENT_SOURCE_BOTH );
+  overridden->SetGradientSource( MeanSquaresMetricType::GRADIENT_SOURCE_BOTH );
+  plain->SetFixedDomainCache( plainCache );
+  overridden->SetFixedDomainCache( overrideCache );
+  plain->Initialize();
+  overridden->Initialize();
+  bool halved = overrideCache->GetNumberOfPoints() == plainCache->GetNumberOfPoints();
+  for( itk::SizeValueType i = 0; halved && i < plainCache->GetNumberOfPoints(); i++ )
+    {
+    if( plainCache->GetValidPoints()[i] )
+      {
+      halved = overrideCache->GetFixedImageGradients()[i] == plainCache->GetFixedImageGradients()[i] * 0.5;
+      }
+    }
+  if( !halved )
+    {
+    std::cerr << "Overridden gradients: the cache does not hold the gradients of the metric." << std::endl;
+    pass = false;
+    }
+
+  // Sparse sampling, fixed gradients from the gradient calculator
+  typedef MeanSquaresMetricType::FixedSampledPointSetType PointSetType;
+  PointSetType::Pointer pointSet = PointSetType::New();
+  itk::SizeValueType numberOfSamples = 0;
+  itk::ImageRegionIteratorWithIndex< ImageType > it( fixedImage, fixedImage->GetBufferedRegion() );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    if( ( it.GetIndex()[0] + 2 * it.GetIndex()[1] ) % 5 == 0 )
+      {
+      PointSetType::PointType point;
+      fixedImage->TransformIndexToPhysicalPoint( it.GetIndex(), point );
+      pointSet->SetPoint( numberOfSamples++, point );
+      }
+    }
+  CacheType::Pointer sparseCache = CacheType::New();
+  reference->SetFixedSampledPointSet( pointSet );
+  reference->UseFixedSampledPointSetOn();
+  reference->UseFixedImageGradientFilterOff();
+  cached->SetFixedSampledPointSet( pointSet );
+  cached->UseFixedSampledPointSetOn();
+  cached->UseFixedImageGradientFilterOff();
+  cached->SetFixedDomainCache( sparseCache );
+  reference->Initialize();
+  cached->Initialize();
+  cached->Initialize();
+  pass &= CheckNumberOfFills( "Sparse", sparseCache, 1 );
+  pass &= CompareMetrics( "Sparse", cached.GetPointer(), reference.GetPointer() );
+  if( reference->GetNumberOfSkippedFixedSampledPoints() == 0 )
+    {
+    std::cerr << "Sparse: expected sampled points outside the virtual domain." << std::endl;
+    pass = false;
+    }
+
+  // Mattes mutual information, which only uses moving gradients
+  MattesMetricType::Pointer mattesReference = MattesMetricType::New();
+  MattesMetricType::Pointer mattesCached = MattesMetricType::New();
+  SetUpMetric( mattesReference.GetPointer(), fixedImage, movingImage, 0.05 );
+  SetUpMetric( mattesCached.GetPointer(), fixedImage, movingImage, 0.05 );
+  mattesCached->SetFixedDomainCache( cache );
+  mattesReference->Initialize();
+  mattesCached->Initialize();
+  pass &= CheckNumberOfFills( "Mattes", cache, 4 );
+  pass &= CompareMetrics( "Mattes", mattesCached.GetPointer(), mattesReference.GetPointer() );
+  mattesReference->SetFixedSampledPointSet( pointSet );
+  mattesReference->UseFixedSampledPointSetOn();
+  mattesCached->SetFixedSampledPointSet( pointSet );
+  mattesCached->UseFixedSampledPointSetOn();
+  mattesReference->Initialize();
+  mattesCached->Initialize();
+  pass &= CheckNumberOfFills( "Mattes sparse", cache, 5 );
+  pass &= CompareMetrics( "Mattes sparse", mattesCached.GetPointer(), mattesReference.GetPointer() );
+
+  cache->Print( std::cout );
+  cache->Clear();
+  mattesCached->Initialize();
+  pass &= CheckNumberOfFills( "Cleared", cache, 6 );
+  pass &= CompareMetrics( "Cleared", mattesCached.GetPointer(), mattesReference.GetPointer() );
+
+  if( !pass )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -22,6 +22,8 @@
 #include "itkBSplineInterpolateImageFunction.h"
 #include "itkTextOutput.h"
 #include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkAffineTransform.h"
 #include "itkImageMaskSpatialObject.h"
 
 #include <iostream>
@@ -30,6 +32,51 @@
  * This test was copied for v4 metric from itkMattesMutualInformationImageToMetricTest
  */
 
+/**
+ *  Check that the metric value and derivative computed with implicit PDF
+ *  derivatives match those computed with explicit PDF derivatives.
+ */
+template< class TMetric >
+bool TestMattesMetricExplicitAndImplicitPDFDerivatives( TMetric * metric )
+{
+  typename TMetric::MeasureType    explicitMeasure;
+  typename TMetric::MeasureType    implicitMeasure;
+  typename TMetric::DerivativeType explicitDerivative;
+  typename TMetric::DerivativeType implicitDerivative;
+
+  metric->UseExplicitPDFDerivativesOn();
+  metric->GetValueAndDerivative( explicitMeasure, explicitDerivative );
+  metric->UseExplicitPDFDerivativesOff();
+  metric->GetValueAndDerivative( implicitMeasure, implicitDerivative );
+  const bool jointPDFDerivativesReleased = metric->GetJointPDFDerivatives().IsNull();
+  metric->UseExplicitPDFDerivativesOn();
+
+  bool pass = true;
+  if( vnl_math_abs( explicitMeasure - implicitMeasure ) > 1e-10 * vnl_math_abs( explicitMeasure ) )
+    {
+    std::cout << "Implicit PDF derivatives measure " << implicitMeasure
+              << " differs from explicit measure " << explicitMeasure << std::endl;
+    pass = false;
+    }
+  const double derivativeMagnitude = explicitDerivative.magnitude();
+  for( unsigned int i = 0; i < explicitDerivative.Size(); i++ )
+    {
+    if( vnl_math_abs( explicitDerivative[i] - implicitDerivative[i] ) > 1e-8 * derivativeMagnitude )
+      {
+      std::cout << "Implicit PDF derivative [" << i << "] " << implicitDerivative[i]
+                << " differs from explicit derivative " << explicitDerivative[i] << std::endl;
+      pass = false;
+      }
+    }
+  if( ! jointPDFDerivativesReleased )
+    {
+    std::cout << "Joint PDF derivatives are stored with implicit PDF derivatives." << std::endl;
+    pass = false;
+    }
+  std::cout << "Explicit and implicit PDF derivatives: " << ( pass ? "match" : "differ" ) << std::endl;
+  return pass;
+}
+
 /**
  * TODO: check this text:
  *
@@ -394,6 +441,12 @@ int TestMattesMetricWithAffineTransform(
 
   std::cout << "GetNumberOfThreadsUsed: " << metric->GetNumberOfThreadsUsed() << std::endl;
 
+  transformer->SetParameters( parameters );
+  if( ! TestMattesMetricExplicitAndImplicitPDFDerivatives( metric.GetPointer() ) )
+    {
+    testFailed = true;
+    }
+
   if( testFailed )
     {
     return EXIT_FAILURE;
@@ -598,6 +651,38 @@ int TestMattesMetricWithBSplineTransform(
   // initialize the metric before use
   metric->Initialize();
 
+  // Unless set, the PDF derivatives are implicit for B-spline transforms
+  if( metric->GetUseExplicitPDFDerivatives() )
+    {
+    std::cerr << "Expected implicit PDF derivatives with a B-spline transform." << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Likewise for a composite transform optimizing a B-spline transform
+  typedef itk::AffineTransform< double, ImageDimension >    AffineTransformType;
+  typedef itk::CompositeTransform< double, ImageDimension > CompositeTransformType;
+  typename CompositeTransformType::Pointer composite = CompositeTransformType::New();
+  composite->AddTransform( AffineTransformType::New() );
+  composite->AddTransform( transformer );
+  composite->SetOnlyMostRecentTransformToOptimizeOn();
+  metric->SetMovingTransform( composite );
+  metric->Initialize();
+  if( metric->GetUseExplicitPDFDerivatives() )
+    {
+    std::cerr << "Expected implicit PDF derivatives with a composite B-spline transform." << std::endl;
+    return EXIT_FAILURE;
+    }
+  composite->SetNthTransformToOptimizeOn( 0 );
+  composite->SetNthTransformToOptimizeOff( 1 );
+  metric->Initialize();
+  if( ! metric->GetUseExplicitPDFDerivatives() )
+    {
+    std::cerr << "Expected explicit PDF derivatives with a fixed composite B-spline transform." << std::endl;
+    return EXIT_FAILURE;
+    }
+  metric->SetMovingTransform( transformer );
+  metric->Initialize();
+
 //------------------------------------------------------------
 // Set up a B-spline deformable transform parameters
 //------------------------------------------------------------
@@ -696,6 +781,12 @@ int TestMattesMetricWithBSplineTransform(
 
     }
 
+  transformer->SetParameters( parameters );
+  if( ! TestMattesMetricExplicitAndImplicitPDFDerivatives( metric.GetPointer() ) )
+    {
+    testFailed = true;
+    }
+
   if( testFailed )
     {
     return EXIT_FAILURE;
@@ -746,6 +837,18 @@ int itkMattesMutualInformationImageToImageMetricv4Test(int, char *[] )
     return EXIT_FAILURE;
     }
 
+  // Test metric with BSpline transform
+  useSampling = false;
+  std::cout << "Test metric with BSpline transform and a linear interpolator." << std::endl;
+  failed = TestMattesMetricWithBSplineTransform<ImageType,LinearInterpolatorType>(
+    linearInterpolator, useSampling );
+
+  if ( failed )
+    {
+    std::cout << "Test failed" << std::endl;
+    return EXIT_FAILURE;
+    }
+
 //FIXME:
 std::cout << "Returning early." << std::endl;
 return EXIT_SUCCESS;
@@ -25,6 +25,35 @@
  * TODO Numerical verification.
  */
 
+namespace
+{
+/* A metric whose moving image gradients are all zero, to check that the
+ * threaders use the overridden gradient method. */
+template< class TImage >
+class MeanSquaresZeroGradientMetricv4
+  : public itk::MeanSquaresImageToImageMetricv4< TImage, TImage, TImage >
+{
+public:
+  typedef MeanSquaresZeroGradientMetricv4                                  Self;
+  typedef itk::MeanSquaresImageToImageMetricv4< TImage, TImage, TImage >  Superclass;
+  typedef itk::SmartPointer< Self >                                       Pointer;
+
+  itkNewMacro( Self );
+
+  typedef typename Superclass::MovingImagePointType    MovingImagePointType;
+  typedef typename Superclass::MovingImageGradientType MovingImageGradientType;
+
+protected:
+  MeanSquaresZeroGradientMetricv4() {}
+
+  virtual void ComputeMovingImageGradientAtPoint( const MovingImagePointType &,
+                                                  MovingImageGradientType & gradient ) const
+    {
+    gradient.Fill( 0.0 );
+    }
+};
+}
+
 int itkMeanSquaresImageToImageMetricv4Test(int, char ** const)
 {
 
@@ -167,6 +196,31 @@ int itkMeanSquaresImageToImageMetricv4Test(int, char ** const)
               << ", " << valueReturn2 << std::endl;
     }
 
+  // A metric overriding the moving image gradient computation, with the
+  // gradient filter, has zero derivatives
+  typedef MeanSquaresZeroGradientMetricv4< ImageType > ZeroGradientMetricType;
+  ZeroGradientMetricType::Pointer zeroGradientMetric = ZeroGradientMetricType::New();
+  zeroGradientMetric->SetFixedImage( fixedImage );
+  zeroGradientMetric->SetMovingImage( movingImage );
+  zeroGradientMetric->SetFixedTransform( fixedTransform );
+  zeroGradientMetric->SetMovingTransform( movingTransform );
+  try
+    {
+    zeroGradientMetric->Initialize();
+    zeroGradientMetric->GetValueAndDerivative( valueReturn2, derivativeReturn );
+    }
+  catch( itk::ExceptionObject & exc )
+    {
+    std::cerr << "Caught unexpected exception with the overridden gradients: " << exc << std::endl;
+    return EXIT_FAILURE;
+    }
+  if( valueReturn2 != valueReturn1 || derivativeReturn.inf_norm() != 0.0 )
+    {
+    std::cerr << "The overridden moving image gradients were not used: value " << valueReturn2
+              << ", derivative " << derivativeReturn << std::endl;
+    return EXIT_FAILURE;
+    }
+
   std::cout << "Test passed." << std::endl;
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,269 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkImageToImageMetricv4FixedDomainCache.h"
+#include "itkRegistrationParameterScalesFromShift.h"
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkMultiStartOptimizerv4.h"
+#include "itkAffineTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+
+/* Verify that a multi-start optimization with concurrent starts gives
+ * exactly the results of the serial one, and that metrics clone their
+ * settings. */
+
+namespace
+{
+const unsigned int Dimension = 2;
+typedef itk::Image< double, Dimension >                     ImageType;
+typedef itk::AffineTransform< double, Dimension >           TransformType;
+typedef itk::MeanSquaresImageToImageMetricv4< ImageType, ImageType >
+                                                            MeanSquaresMetricType;
+typedef itk::MattesMutualInformationImageToImageMetricv4< ImageType, ImageType >
+                                                            MattesMetricType;
+typedef MeanSquaresMetricType::FixedDomainCacheType         CacheType;
+typedef itk::GradientDescentOptimizerv4                     LocalOptimizerType;
+typedef itk::MultiStartOptimizerv4                          MultiStartOptimizerType;
+
+/* Two Gaussian blobs, moved by offset. */
+ImageType::Pointer CreateBlobsImage( const double offsetX, const double offsetY )
+{
+  ImageType::SizeType size;
+  size[0] = 40;
+  size[1] = 36;
+  ImageType::RegionType region;
+  region.SetSize( size );
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions( region );
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex< ImageType > it( image, region );
+  for( it.GoToBegin(); !it.IsAtEnd(); ++it )
+    {
+    const double x1 = it.GetIndex()[0] - 14.0 - offsetX;
+    const double y1 = it.GetIndex()[1] - 12.0 - offsetY;
+    const double x2 = it.GetIndex()[0] - 26.0 - offsetX;
+    const double y2 = it.GetIndex()[1] - 22.0 - offsetY;
+    it.Set( 200.0 * vcl_exp( - ( x1 * x1 + y1 * y1 ) / 50.0 )
+            + 120.0 * vcl_exp( - ( x2 * x2 + y2 * y2 ) / 98.0 ) );
+    }
+  return image;
+}
+
+/* A rotation about the center of image. */
+TransformType::Pointer CreateRotation( const ImageType * image, const double angle )
+{
+  itk::ContinuousIndex< double, Dimension > centerIndex;
+  for( unsigned int d = 0; d < Dimension; d++ )
+    {
+    centerIndex[d] = ( image->GetLargestPossibleRegion().GetSize()[d] - 1 ) / 2.0;
+    }
+  TransformType::InputPointType center;
+  image->TransformContinuousIndexToPhysicalPoint( centerIndex, center );
+
+  TransformType::Pointer transform = TransformType::New();
+  transform->SetCenter( center );
+  transform->Rotate2D( angle );
+  return transform;
+}
+
+/* Count the starts reported while the metric is not at their optimized
+ * parameters. */
+class StartObserver: public itk::Command
+{
+public:
+  typedef StartObserver             Self;
+  typedef itk::Command              Superclass;
+  typedef itk::SmartPointer< Self > Pointer;
+
+  itkNewMacro( Self );
+
+  unsigned int GetNumberOfMismatches() const
+    {
+    return this->m_NumberOfMismatches;
+    }
+
+  void Execute(itk::Object *caller, const itk::EventObject & event)
+    {
+    MultiStartOptimizerType * optimizer = dynamic_cast< MultiStartOptimizerType * >( caller );
+    if( !(itk::IterationEvent().CheckEvent( &event )) )
+      {
+      return;
+      }
+    if( !( optimizer->GetMetric()->GetParameters()
+           == optimizer->GetParametersList()[ optimizer->GetCurrentIteration() ] ) )
+      {
+      this->m_NumberOfMismatches++;
+      }
+    }
+
+  void Execute(const itk::Object *, const itk::EventObject &)
+    {
+    }
+
+protected:
+  StartObserver(): m_NumberOfMismatches(0) {}
+
+private:
+  unsigned int m_NumberOfMismatches;
+};
+
+/* Run a multi-start optimization from rotated starts. */
+MultiStartOptimizerType::Pointer Optimize( MeanSquaresMetricType * metric,
+                                           const itk::ThreadIdType numberOfConcurrentStarts,
+                                           StartObserver * observer )
+{
+  metric->SetMovingTransform( CreateRotation( metric->GetFixedImage(), 0.0 ) );
+  metric->Initialize();
+
+  LocalOptimizerType::Pointer localOptimizer = LocalOptimizerType::New();
+  LocalOptimizerType::ScalesType scales( metric->GetNumberOfParameters() );
+  scales.Fill( 1000.0 );
+  scales[4] = 1.0;
+  scales[5] = 1.0;
+  localOptimizer->SetScales( scales );
+  localOptimizer->SetLearningRate( 0.001 );
+  localOptimizer->SetNumberOfIterations( 10 );
+
+  MultiStartOptimizerType::Pointer optimizer = MultiStartOptimizerType::New();
+  MultiStartOptimizerType::ParametersListType parametersList;
+  for( int i = -4; i <= 4; i++ )
+    {
+    parametersList.push_back( CreateRotation( metric->GetFixedImage(), 0.1 * i )->GetParameters() );
+    }
+  optimizer->SetMetric( metric );
+  optimizer->SetParametersList( parametersList );
+  optimizer->SetLocalOptimizer( localOptimizer );
+  optimizer->SetNumberOfConcurrentStarts( numberOfConcurrentStarts );
+  optimizer->AddObserver( itk::IterationEvent(), observer );
+  optimizer->StartOptimization();
+  return optimizer;
+}
+}
+
+int itkMultiStartOptimizerv4ConcurrentStartsTest( int, char *[] )
+{
+  ImageType::Pointer fixedImage = CreateBlobsImage( 0.0, 0.0 );
+  ImageType::Pointer movingImage = CreateBlobsImage( 2.0, -1.0 );
+  bool pass = true;
+
+  MeanSquaresMetricType::Pointer serialMetric = MeanSquaresMetricType::New();
+  serialMetric->SetFixedImage( fixedImage );
+  serialMetric->SetMovingImage( movingImage );
+  serialMetric->SetMaximumNumberOfThreads( 2 );
+  StartObserver::Pointer serialObserver = StartObserver::New();
+  MultiStartOptimizerType::Pointer serial = Optimize( serialMetric, 1, serialObserver );
+
+  // The concurrent metrics share a fixed domain cache with the metric
+  MeanSquaresMetricType::Pointer concurrentMetric = MeanSquaresMetricType::New();
+  concurrentMetric->SetFixedImage( fixedImage );
+  concurrentMetric->SetMovingImage( movingImage );
+  concurrentMetric->SetMaximumNumberOfThreads( 2 );
+  CacheType::Pointer cache = CacheType::New();
+  concurrentMetric->SetFixedDomainCache( cache );
+  StartObserver::Pointer concurrentObserver = StartObserver::New();
+  MultiStartOptimizerType::Pointer concurrent = Optimize( concurrentMetric, 3, concurrentObserver );
+  concurrent->Print( std::cout );
+
+  const MultiStartOptimizerType::MetricValuesListType & serialValues = serial->GetMetricValuesList();
+  const MultiStartOptimizerType::MetricValuesListType & concurrentValues = concurrent->GetMetricValuesList();
+  bool same = serialValues.size() == concurrentValues.size()
+    && serial->GetBestParametersIndex() == concurrent->GetBestParametersIndex()
+    && serial->GetBestParameters() == concurrent->GetBestParameters();
+  for( unsigned int i = 0; same && i < serialValues.size(); i++ )
+    {
+    same = serialValues[i] == concurrentValues[i]
+      && serial->GetParametersList()[i] == concurrent->GetParametersList()[i];
+    }
+  for( unsigned int i = 0; i < serialValues.size(); i++ )
+    {
+    std::cout << "Start " << i << ": " << serialValues[i] << std::endl;
+    }
+  if( !same )
+    {
+    std::cerr << "Concurrent starts: best index " << concurrent->GetBestParametersIndex()
+              << " parameters " << concurrent->GetBestParameters()
+              << "; serial starts: best index " << serial->GetBestParametersIndex()
+              << " parameters " << serial->GetBestParameters() << std::endl;
+    pass = false;
+    }
+  if( serialValues.size() != 9 || cache->GetNumberOfFills() != 1 )
+    {
+    std::cerr << "Expected 9 starts and one cache fill, got " << serialValues.size()
+              << " starts and " << cache->GetNumberOfFills() << " fills." << std::endl;
+    pass = false;
+    }
+
+  if( serialObserver->GetNumberOfMismatches() != 0 || concurrentObserver->GetNumberOfMismatches() != 0 )
+    {
+    std::cerr << "Observers found the metric away from the optimized parameters of "
+              << serialObserver->GetNumberOfMismatches() << " serial and "
+              << concurrentObserver->GetNumberOfMismatches() << " concurrent starts." << std::endl;
+    pass = false;
+    }
+
+  // A scales estimator is bound to the metric, so it cannot be used
+  typedef itk::RegistrationParameterScalesFromShift< MeanSquaresMetricType > ScalesEstimatorType;
+  ScalesEstimatorType::Pointer scalesEstimator = ScalesEstimatorType::New();
+  scalesEstimator->SetMetric( concurrentMetric );
+  LocalOptimizerType::Pointer estimatingOptimizer = LocalOptimizerType::New();
+  estimatingOptimizer->SetScalesEstimator( scalesEstimator );
+  concurrent->SetLocalOptimizer( estimatingOptimizer );
+  bool caught = false;
+  try
+    {
+    concurrent->StartOptimization();
+    }
+  catch( itk::ExceptionObject & e )
+    {
+    std::cout << "Caught expected exception: " << e.GetDescription() << std::endl;
+    caught = true;
+    }
+  pass &= caught;
+
+  // A clone has the settings of the metric and evaluates like it
+  MattesMetricType::Pointer mattes = MattesMetricType::New();
+  mattes->SetFixedImage( fixedImage );
+  mattes->SetMovingImage( movingImage );
+  mattes->SetMovingTransform( CreateRotation( fixedImage, 0.1 ) );
+  mattes->SetNumberOfHistogramBins( 30 );
+  mattes->SetUseExplicitPDFDerivatives( false );
+  mattes->SetMaximumNumberOfThreads( 2 );
+  mattes->Initialize();
+  MattesMetricType::Pointer mattesClone = mattes->Clone();
+  mattesClone->Initialize();
+  if( mattesClone->GetNumberOfHistogramBins() != 30 || mattesClone->GetUseExplicitPDFDerivatives()
+      || mattesClone->GetMovingTransform() == mattes->GetMovingTransform()
+      || mattesClone->GetMovingImage() != mattes->GetMovingImage()
+      || mattesClone->GetValue() != mattes->GetValue() )
+    {
+    std::cerr << "The Mattes clone differs from the metric: value " << mattesClone->GetValue()
+              << ", expected " << mattes->GetValue() << std::endl;
+    pass = false;
+    }
+
+  if( !pass )
+    {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+    }
+  std::cout << "Test passed." << std::endl;
+  return EXIT_SUCCESS;
+}